@@ -183,6 +183,7 @@ enum Flags {
     kRotate_Flag            = 1 << 1,
     kBilerp_Flag            = 1 << 2,
     kBicubic_Flag           = 1 << 3,
+    kPersp_Flag             = 1 << 4,
 };
 
 static bool isBilerp(uint32_t flags) {
@@ -212,6 +213,9 @@ protected:
         if (fFlags & kRotate_Flag) {
             fFullName.append("_rotate");
         }
+        if (fFlags & kPersp_Flag) {
+            fFullName.append("_persp");
+        }
         if (isBilerp(fFlags)) {
             fFullName.append("_bilerp");
         } else if (isBicubic(fFlags)) {
@@ -240,6 +244,18 @@ protected:
             canvas->rotate(SkIntToScalar(35));
             canvas->translate(-x, -y);
         }
+        if (fFlags & kPersp_Flag) {
+            const SkScalar x = SkIntToScalar(dim.fWidth) / 2;
+            const SkScalar y = SkIntToScalar(dim.fHeight) / 2;
+
+            // tilt back like a 3D-transformed layer
+            SkMatrix persp;
+            persp.setIdentity();
+            persp.setPerspY(SkScalarInvert(SkIntToScalar(dim.fHeight) * 4));
+            canvas->translate(x, y);
+            canvas->concat(persp);
+            canvas->translate(-x, -y);
+        }
         INHERITED::onDraw(loops, canvas);
     }
 
@@ -375,6 +391,11 @@ DEF_BENCH( return new FilterBitmapBench(true, SkBitmap::kARGB_8888_Config, false
 DEF_BENCH( return new FilterBitmapBench(true, SkBitmap::kARGB_8888_Config, true, true, kScale_Flag | kRotate_Flag | kBilerp_Flag); )
 DEF_BENCH( return new FilterBitmapBench(true, SkBitmap::kARGB_8888_Config, true, false, kScale_Flag | kRotate_Flag | kBilerp_Flag); )
 
+// perspective -> ClampX_ClampY_{nofilter,filter}_persp_SSE2
+DEF_BENCH( return new FilterBitmapBench(false, SkBitmap::kARGB_8888_Config, false, false, kPersp_Flag); )
+DEF_BENCH( return new FilterBitmapBench(false, SkBitmap::kARGB_8888_Config, false, false, kPersp_Flag | kBilerp_Flag); )
+DEF_BENCH( return new FilterBitmapBench(true, SkBitmap::kARGB_8888_Config, false, false, kPersp_Flag | kBilerp_Flag); )
+
 DEF_BENCH( return new FilterBitmapBench(false, SkBitmap::kARGB_8888_Config, false, false, kScale_Flag | kBilerp_Flag | kBicubic_Flag); )
 DEF_BENCH( return new FilterBitmapBench(false, SkBitmap::kARGB_8888_Config, false, false, kScale_Flag | kRotate_Flag | kBilerp_Flag | kBicubic_Flag); )
 
@@ -6,6 +6,8 @@
  */
 
 #include "SkBenchmark.h"
+#include "SkBitmapProcState.h"
+#include "SkBitmapScaler.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
@@ -104,6 +106,35 @@ private:
     typedef BitmapScaleBench INHERITED;
 };
 
+// Resizes with SkBitmapScaler directly, splitting the work across the given
+// number of threads, so that the names report the throughput for each count.
+class BitmapResizeBench: public BitmapScaleBench {
+ public:
+    BitmapResizeBench( int is, int os, int threads) : INHERITED(is, os), fThreads(threads) {
+        SkString name;
+        name.printf( "resize_%d_threads", threads );
+        setName( name.c_str() );
+    }
+protected:
+    virtual void preBenchSetup() SK_OVERRIDE {
+        sk_bzero(&fProcs, sizeof(fProcs));
+        SkBitmapProcState state;
+        state.platformConvolutionProcs(&fProcs);
+    }
+
+    virtual void doScaleImage() SK_OVERRIDE {
+        SkBitmap result;
+        SkBitmapScaler::Resize(&result, fInputBitmap, SkBitmapScaler::RESIZE_BEST,
+                               SkIntToScalar(outputSize()), SkIntToScalar(outputSize()),
+                               fProcs, NULL, fThreads);
+    }
+private:
+    int                 fThreads;
+    SkConvolutionProcs  fProcs;
+
+    typedef BitmapScaleBench INHERITED;
+};
+
 DEF_BENCH(return new BitmapFilterScaleBench(10, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(30, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(80, 90);)
@@ -113,3 +144,12 @@ DEF_BENCH(return new BitmapFilterScaleBench(90, 30);)
 DEF_BENCH(return new BitmapFilterScaleBench(90, 10);)
 DEF_BENCH(return new BitmapFilterScaleBench(256, 64);)
 DEF_BENCH(return new BitmapFilterScaleBench(64, 256);)
+
+DEF_BENCH(return new BitmapResizeBench(2048, 512, 1);)
+DEF_BENCH(return new BitmapResizeBench(2048, 512, 2);)
+DEF_BENCH(return new BitmapResizeBench(2048, 512, 4);)
+DEF_BENCH(return new BitmapResizeBench(2048, 512, 8);)
+DEF_BENCH(return new BitmapResizeBench(1024, 1536, 1);)
+DEF_BENCH(return new BitmapResizeBench(1024, 1536, 2);)
+DEF_BENCH(return new BitmapResizeBench(1024, 1536, 4);)
+DEF_BENCH(return new BitmapResizeBench(1024, 1536, 8);)
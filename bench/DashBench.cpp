@@ -440,6 +440,96 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+// Dashed rectangle outlines, e.g. selection and focus rings.
+class DashRectOutlineBench : public SkBenchmark {
+    SkString fName;
+    int      fStrokeWidth;
+    bool     fDoAA;
+
+    SkAutoTUnref<SkPathEffect> fPathEffect;
+
+public:
+    DashRectOutlineBench(int strokeWidth, bool doAA) {
+        fName.printf("dashrectoutline_%d%s", strokeWidth, doAA ? "_aa" : "_bw");
+        fStrokeWidth = strokeWidth;
+        fDoAA = doAA;
+
+        SkScalar vals[] = { SkIntToScalar(4), SkIntToScalar(3) };
+        fPathEffect.reset(SkDashPathEffect::Create(vals, 2, 0));
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint p;
+        this->setupPaint(&p);
+        p.setColor(SK_ColorBLACK);
+        p.setStyle(SkPaint::kStroke_Style);
+        p.setStrokeWidth(SkIntToScalar(fStrokeWidth));
+        p.setPathEffect(fPathEffect);
+        p.setAntiAlias(fDoAA);
+
+        for (int i = 0; i < loops; ++i) {
+            SkScalar inset = SkIntToScalar(i % 50);
+            SkRect r = SkRect::MakeLTRB(10.5f + inset, 10.5f + inset,
+                                        630.5f - inset, 470.5f - inset);
+            canvas->drawRect(r, p);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+// A dashed hairline chart: one long polyline, much of it outside the clip.
+class DashPolylineBench : public SkBenchmark {
+    SkString fName;
+    bool     fDoAA;
+    SkPath   fPath;
+
+    SkAutoTUnref<SkPathEffect> fPathEffect;
+
+public:
+    DashPolylineBench(bool doAA) {
+        fName.printf("dashpolyline%s", doAA ? "_aa" : "_bw");
+        fDoAA = doAA;
+
+        SkRandom rand;
+        fPath.moveTo(-640, 240);
+        for (int x = -640; x <= 1280; x += 8) {
+            fPath.lineTo(SkIntToScalar(x), rand.nextRangeScalar(20, 460));
+        }
+
+        SkScalar vals[] = { SkIntToScalar(6), SkIntToScalar(4) };
+        fPathEffect.reset(SkDashPathEffect::Create(vals, 2, 0));
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint p;
+        this->setupPaint(&p);
+        p.setColor(SK_ColorBLACK);
+        p.setStyle(SkPaint::kStroke_Style);
+        p.setStrokeWidth(0);
+        p.setPathEffect(fPathEffect);
+        p.setAntiAlias(fDoAA);
+
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, p);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const SkScalar gDots[] = { SK_Scalar1, SK_Scalar1 };
@@ -467,6 +557,13 @@ DEF_BENCH( return new DrawPointsDashingBench(3, 1, true); )
 DEF_BENCH( return new DrawPointsDashingBench(5, 5, false); )
 DEF_BENCH( return new DrawPointsDashingBench(5, 5, true); )
 
+DEF_BENCH( return new DashRectOutlineBench(0, false); )
+DEF_BENCH( return new DashRectOutlineBench(0, true); )
+DEF_BENCH( return new DashRectOutlineBench(2, false); )
+DEF_BENCH( return new DashRectOutlineBench(2, true); )
+DEF_BENCH( return new DashPolylineBench(false); )
+DEF_BENCH( return new DashPolylineBench(true); )
+
 /* Disable the GiantDashBench for Android devices until we can better control
  * the memory usage. (https://code.google.com/p/skia/issues/detail?id=1430)
  */
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBenchmark.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkColorTable.h"
+#include "SkMipMap.h"
+#include "SkString.h"
+
+// Builds a mipmap for a 512x512 bitmap, as a draw scaled to about a third
+// would. A lazy mipmap only computes the level that draw samples.
+class MipMapBench : public SkBenchmark {
+    SkString                fName;
+    SkColorType             fColorType;
+    SkMipMap::BuildMode     fMode;
+    SkBitmap                fBitmap;
+
+public:
+    MipMapBench(SkColorType ct, SkMipMap::BuildMode mode) : fColorType(ct), fMode(mode) {
+        static const char* gNames[] = {
+            "unknown", "a8", "565", "4444", "rgba", "bgra", "index8",
+        };
+        SK_COMPILE_ASSERT(SK_ARRAY_COUNT(gNames) == kLastEnum_SkColorType + 1, names_mismatch);
+        fName.printf("mipmap_build_%s%s", gNames[ct],
+                     SkMipMap::kLazy_BuildMode == mode ? "_lazy" : "");
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        SkColorTable* ctable = NULL;
+        if (kIndex_8_SkColorType == fColorType) {
+            SkPMColor colors[256];
+            for (int i = 0; i < 256; ++i) {
+                colors[i] = SkPackARGB32(0xFF, i, i, i);
+            }
+            ctable = SkNEW_ARGS(SkColorTable, (colors, 256, kOpaque_SkAlphaType));
+        }
+        fBitmap.allocPixels(SkImageInfo::Make(512, 512, fColorType, kPremul_SkAlphaType),
+                            NULL, ctable);
+        SkSafeUnref(ctable);
+        if (kIndex_8_SkColorType == fColorType) {
+            memset(fBitmap.getPixels(), 0x80, fBitmap.getSize());
+        } else {
+            fBitmap.eraseColor(SK_ColorWHITE);
+        }
+    }
+
+    virtual void onDraw(const int loops, SkCanvas*) SK_OVERRIDE {
+        for (int i = 0; i < loops; ++i) {
+            SkAutoTUnref<SkMipMap> mip(SkMipMap::Build(fBitmap, fMode));
+            SkMipMap::Level level;
+            mip->extractLevel(0.3f, &level);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+DEF_BENCH( return new MipMapBench(kN32_SkColorType, SkMipMap::kEager_BuildMode); )
+DEF_BENCH( return new MipMapBench(kN32_SkColorType, SkMipMap::kLazy_BuildMode); )
+DEF_BENCH( return new MipMapBench(kRGB_565_SkColorType, SkMipMap::kEager_BuildMode); )
+DEF_BENCH( return new MipMapBench(kARGB_4444_SkColorType, SkMipMap::kEager_BuildMode); )
+DEF_BENCH( return new MipMapBench(kAlpha_8_SkColorType, SkMipMap::kEager_BuildMode); )
+DEF_BENCH( return new MipMapBench(kIndex_8_SkColorType, SkMipMap::kEager_BuildMode); )
@@ -9,6 +9,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
+#include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
@@ -589,6 +590,145 @@ private:
     typedef RandomPathBench INHERITED;
 };
 
+// Fills anti-aliased paths with either the supersampling or the analytic scan converter (see
+// SkGraphics::SetAnalyticAA), so the two can be compared side by side.
+class AAFillPathBench : public SkBenchmark {
+public:
+    AAFillPathBench(bool analytic, bool big) : fAnalytic(analytic), fBig(big) {
+        fName.printf("path_aafill_%s_%s", big ? "big" : "small",
+                     analytic ? "analytic" : "supersampled");
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kRaster_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        // Big paths cover 16x the pixels of small ones, yet each loop still draws one path.
+        const SkScalar size = fBig ? SkIntToScalar(160) : SkIntToScalar(40);
+
+        // A star, which crosses itself.
+        SkPath* star = &fPaths.push_back();
+        for (int i = 0; i < 5; ++i) {
+            SkScalar angle = SK_ScalarPI * 4 * i / 5;
+            SkPoint pt = { size / 2 + SkScalarMul(size / 2, SkScalarSin(angle)),
+                           size / 2 - SkScalarMul(size / 2, SkScalarCos(angle)) };
+            if (0 == i) {
+                star->moveTo(pt);
+            } else {
+                star->lineTo(pt);
+            }
+        }
+        star->close();
+
+        // A circle with a hole.
+        SkPath* ring = &fPaths.push_back();
+        ring->addCircle(size / 2, size / 2, size / 2);
+        ring->addCircle(size / 2, size / 2, size / 4, SkPath::kCCW_Direction);
+
+        // Some wavy cubics.
+        SkPath* wave = &fPaths.push_back();
+        wave->moveTo(0, size);
+        for (int i = 0; i < 4; ++i) {
+            SkScalar x = size * i / 4;
+            wave->cubicTo(x + size / 12, 0, x + size / 6, 0, x + size / 4, size);
+        }
+        wave->close();
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(true);
+
+        const bool prev = SkGraphics::SetAnalyticAA(fAnalytic);
+        for (int i = 0; i < loops; ++i) {
+            const SkPath& path = fPaths[i % fPaths.count()];
+            // Nudge each fill by a fraction of a pixel, so edges land anywhere in their pixels.
+            canvas->save();
+            canvas->translate(SkIntToScalar(i % 7) / 7, SkIntToScalar(i % 5) / 5);
+            canvas->drawPath(path, paint);
+            canvas->restore();
+        }
+        SkGraphics::SetAnalyticAA(prev);
+    }
+
+private:
+    const bool fAnalytic;
+    const bool fBig;
+    SkString fName;
+    SkTArray<SkPath> fPaths;
+
+    typedef SkBenchmark INHERITED;
+};
+
+// Fills thousands of small paths, a la icons or glyph outlines, where the per-path setup of the
+// scan converters (building edges, allocating runs) is as much of the cost as the filling.
+class ManySmallPathsBench : public SkBenchmark {
+public:
+    ManySmallPathsBench(bool aa) : fAA(aa) {
+        fName.printf("path_fill_many_small_%s", aa ? "aa" : "bw");
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kRaster_Backend;
+    }
+
+protected:
+    enum {
+        kPathCount = 2000,
+    };
+
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        SkRandom rand;
+        for (int i = 0; i < kPathCount; ++i) {
+            const SkScalar x = rand.nextRangeScalar(0, 620);
+            const SkScalar y = rand.nextRangeScalar(0, 460);
+            const SkScalar size = rand.nextRangeScalar(4, 20);
+            SkPath* path = &fPaths.push_back();
+            switch (i % 3) {
+                case 0:
+                    path->addCircle(x, y, size / 2);
+                    break;
+                case 1:
+                    path->addRoundRect(SkRect::MakeXYWH(x, y, size, size), size / 4, size / 4);
+                    break;
+                default:
+                    path->moveTo(x, y);
+                    path->lineTo(x + size, y + size / 3);
+                    path->lineTo(x + size / 3, y + size);
+                    path->close();
+                    break;
+            }
+        }
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(fAA);
+
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPaths[i % kPathCount], paint);
+        }
+    }
+
+private:
+    const bool fAA;
+    SkString fName;
+    SkTArray<SkPath> fPaths;
+
+    typedef SkBenchmark INHERITED;
+};
 
 class CirclesBench : public SkBenchmark {
 protected:
@@ -1031,6 +1171,13 @@ DEF_BENCH( return new SkBench_AddPathTest(SkBench_AddPathTest::kAddMatrix_AddTyp
 DEF_BENCH( return new SkBench_AddPathTest(SkBench_AddPathTest::kReverseAdd_AddType); )
 DEF_BENCH( return new SkBench_AddPathTest(SkBench_AddPathTest::kReversePathTo_AddType); )
 
+DEF_BENCH( return new AAFillPathBench(false, false); )
+DEF_BENCH( return new AAFillPathBench(true, false); )
+DEF_BENCH( return new AAFillPathBench(false, true); )
+DEF_BENCH( return new AAFillPathBench(true, true); )
+DEF_BENCH( return new ManySmallPathsBench(false); )
+DEF_BENCH( return new ManySmallPathsBench(true); )
+
 DEF_BENCH( return new CirclesBench(FLAGS00); )
 DEF_BENCH( return new CirclesBench(FLAGS01); )
 DEF_BENCH( return new ArbRoundRectBench(false); )
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkBenchmark.h"
+#include "SkBlurImageFilter.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkString.h"
+
+// Measures SkPicture::clone(pictures, count), as used to hand one clone to each thread of a
+// multithreaded rasterizer.  The picture is about 4 screens of content drawn with many distinct
+// paints, which is what clones used to copy.  Optionally one paint needs a deep copy (it has an
+// image filter), which forces each clone to get its own paints.
+class PictureCloneBench : public SkBenchmark {
+public:
+    PictureCloneBench(int cloneCount, bool imageFilter)
+        : fCloneCount(cloneCount), fImageFilter(imageFilter) {
+        fName.printf("picture_clone_%d%s", cloneCount, imageFilter ? "_imagefilter" : "");
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        static const int kWidth = 1000, kHeight = 4000;
+
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kWidth, kHeight, NULL, 0);
+
+        SkPaint paint;
+        paint.setTextSize(12);
+        for (int y = 0; y < kHeight; y += 16) {
+            for (int x = 0; x < kWidth; x += 100) {
+                paint.setColor(SkColorSetRGB(x / 4, y % 256, (x + y) % 256));
+                canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(x), SkIntToScalar(y), 90, 14),
+                                 paint);
+                canvas->drawText("Hamburgefons", 12, SkIntToScalar(x), SkIntToScalar(y + 12),
+                                 paint);
+            }
+        }
+        if (fImageFilter) {
+            SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(2, 2));
+            paint.setImageFilter(blur);
+            canvas->drawRect(SkRect::MakeWH(100, 100), paint);
+        }
+        fPicture.reset(recorder.endRecording());
+    }
+
+    virtual void onDraw(const int loops, SkCanvas*) SK_OVERRIDE {
+        for (int i = 0; i < loops; i++) {
+            SkAutoTDeleteArray<SkPicture> clones(SkNEW_ARRAY(SkPicture, fCloneCount));
+            fPicture->clone(clones.get(), fCloneCount);
+        }
+    }
+
+private:
+    const int fCloneCount;
+    const bool fImageFilter;
+    SkString fName;
+    SkAutoTUnref<SkPicture> fPicture;
+
+    typedef SkBenchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PictureCloneBench, (1, false)); )
+DEF_BENCH( return SkNEW_ARGS(PictureCloneBench, (8, false)); )
+DEF_BENCH( return SkNEW_ARGS(PictureCloneBench, (8, true)); )
@@ -61,6 +61,50 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+// Benchmark that calls SkXfermode::xfer32() on rows of varied pixels, so none of the drawing
+// around it is measured.
+class XferRowBench : public SkBenchmark {
+public:
+    XferRowBench(SkXfermode::Mode mode) {
+        fXfermode.reset(SkXfermode::Create(mode));
+        SkASSERT(NULL != fXfermode.get());
+        fName.printf("xfer32_%s", SkXfermode::ModeName(mode));
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        SkRandom random;
+        for (int i = 0; i < kCount; ++i) {
+            fSrc[i] = SkPreMultiplyColor(random.nextU());
+            fDst[i] = SkPreMultiplyColor(random.nextU());
+        }
+    }
+
+    virtual void onDraw(const int loops, SkCanvas*) SK_OVERRIDE {
+        SkPMColor dst[kCount];
+        for (int i = 0; i < loops; ++i) {
+            memcpy(dst, fDst, sizeof(dst));
+            fXfermode->xfer32(dst, fSrc, kCount, NULL);
+        }
+    }
+
+private:
+    enum {
+        kCount = 1024,
+    };
+    SkAutoTUnref<SkXfermode> fXfermode;
+    SkPMColor fSrc[kCount], fDst[kCount];
+    SkString fName;
+
+    typedef SkBenchmark INHERITED;
+};
+
 class XferCreateBench : public SkBenchmark {
 public:
     virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
@@ -90,6 +134,8 @@ private:
 #define BENCH(...) \
     DEF_BENCH( return new XfermodeBench(__VA_ARGS__); );\
 
+#define ROW_BENCH(mode) \
+    DEF_BENCH( return new XferRowBench(mode); )
 
 BENCH(SkXfermode::kClear_Mode)
 BENCH(SkXfermode::kSrc_Mode)
@@ -124,4 +170,20 @@ BENCH(SkXfermode::kSaturation_Mode)
 BENCH(SkXfermode::kColor_Mode)
 BENCH(SkXfermode::kLuminosity_Mode)
 
+ROW_BENCH(SkXfermode::kOverlay_Mode)
+ROW_BENCH(SkXfermode::kDarken_Mode)
+ROW_BENCH(SkXfermode::kLighten_Mode)
+ROW_BENCH(SkXfermode::kColorDodge_Mode)
+ROW_BENCH(SkXfermode::kColorBurn_Mode)
+ROW_BENCH(SkXfermode::kHardLight_Mode)
+ROW_BENCH(SkXfermode::kSoftLight_Mode)
+ROW_BENCH(SkXfermode::kDifference_Mode)
+ROW_BENCH(SkXfermode::kExclusion_Mode)
+ROW_BENCH(SkXfermode::kMultiply_Mode)
+
+ROW_BENCH(SkXfermode::kHue_Mode)
+ROW_BENCH(SkXfermode::kSaturation_Mode)
+ROW_BENCH(SkXfermode::kColor_Mode)
+ROW_BENCH(SkXfermode::kLuminosity_Mode)
+
 DEF_BENCH(return new XferCreateBench;)
@@ -1421,6 +1421,7 @@ static SkString pdfRasterizerUsage() {
 #define TOSTRING(x) TOSTRING_INTERNAL(x)
 
 // Alphabetized ignoring "no" prefix ("readPath", "noreplay", "resourcePath").
+DEFINE_bool(analyticAA, false, "Fill anti-aliased paths with analytic coverage (raster only).");
 DEFINE_string(config, "", configUsage().c_str());
 DEFINE_string(pdfRasterizers, "default", pdfRasterizerUsage().c_str());
 DEFINE_bool(deferred, false, "Exercise the deferred rendering test pass.");
@@ -2243,6 +2244,7 @@ int tool_main(int argc, char** argv) {
 #endif
 
     SkGraphics::Init();
+    SkGraphics::SetAnalyticAA(FLAGS_analyticAA);
 
     setSystemPreferences();
     GMMain gmmain;
@@ -54,9 +54,18 @@
             '../src/opts/SkBlitRow_opts_SSE2.cpp',
             '../src/opts/SkBlitRect_opts_SSE2.cpp',
             '../src/opts/SkBlurImage_opts_SSE2.cpp',
+            '../src/opts/SkGradient_opts_SSE2.cpp',
+            '../src/opts/SkMipMap_opts_SSE2.cpp',
             '../src/opts/SkMorphology_opts_SSE2.cpp',
             '../src/opts/SkUtils_opts_SSE2.cpp',
             '../src/opts/SkXfermode_opts_SSE2.cpp',
+
+            # These need no -mavx2: only their functions marked
+            # SK_ATTRIBUTE_TARGET_AVX2 use AVX2, and those run only after
+            # opts_check_x86.cpp has checked the CPU (and OS) support it.
+            '../src/opts/SkBitmapFilter_opts_AVX2.cpp',
+            '../src/opts/SkBlitRow_opts_AVX2.cpp',
+            '../src/opts/SkXfermode_opts_AVX2.cpp',
           ],
         }],
         [ 'skia_arch_type == "arm" and arm_version >= 7', {
@@ -80,6 +89,8 @@
             '../src/opts/SkBlitMask_opts_arm.cpp',
             '../src/opts/SkBlitRow_opts_arm.cpp',
             '../src/opts/SkBlurImage_opts_arm.cpp',
+            '../src/opts/SkGradient_opts_arm.cpp',
+            '../src/opts/SkMipMap_opts_arm.cpp',
             '../src/opts/SkMorphology_opts_arm.cpp',
             '../src/opts/SkUtils_opts_arm.cpp',
             '../src/opts/SkXfermode_opts_arm.cpp',
@@ -108,6 +119,8 @@
             '../src/opts/SkBlitMask_opts_none.cpp',
             '../src/opts/SkBlitRow_opts_none.cpp',
             '../src/opts/SkBlurImage_opts_none.cpp',
+            '../src/opts/SkGradient_opts_none.cpp',
+            '../src/opts/SkMipMap_opts_none.cpp',
             '../src/opts/SkMorphology_opts_none.cpp',
             '../src/opts/SkUtils_opts_none.cpp',
             '../src/opts/SkXfermode_opts_none.cpp',
@@ -132,6 +145,10 @@
             '../src/opts/SkBlitRow_opts_arm_neon.cpp',
             '../src/opts/SkBlurImage_opts_arm.cpp',
             '../src/opts/SkBlurImage_opts_neon.cpp',
+            '../src/opts/SkGradient_opts_arm.cpp',
+            '../src/opts/SkGradient_opts_neon.cpp',
+            '../src/opts/SkMipMap_opts_arm.cpp',
+            '../src/opts/SkMipMap_opts_neon.cpp',
             '../src/opts/SkMorphology_opts_arm.cpp',
             '../src/opts/SkMorphology_opts_neon.cpp',
             '../src/opts/SkUtils_opts_none.cpp',
@@ -216,6 +233,8 @@
         '../src/opts/SkBlitMask_opts_arm_neon.cpp',
         '../src/opts/SkBlitRow_opts_arm_neon.cpp',
         '../src/opts/SkBlurImage_opts_neon.cpp',
+        '../src/opts/SkGradient_opts_neon.cpp',
+        '../src/opts/SkMipMap_opts_neon.cpp',
         '../src/opts/SkMorphology_opts_neon.cpp',
         '../src/opts/SkXfermode_opts_arm_neon.cpp',
       ],
@@ -332,10 +332,12 @@
       'type': 'executable',
       'sources': [
         '../tools/bench_playback.cpp',
+        '../tools/LazyDecodeBitmap.cpp',
       ],
       'include_dirs': [
         '../src/core/',
         '../src/images',
+        '../src/lazy',
         '../src/record',
       ],
       'dependencies': [
@@ -377,12 +379,15 @@
         '../tools/PictureRenderer.cpp',
         '../tools/PictureRenderingFlags.h',
         '../tools/PictureRenderingFlags.cpp',
+        '../tools/PlaybackProfile.h',
+        '../tools/PlaybackProfile.cpp',
         '../tools/CopyTilesRenderer.h',
         '../tools/CopyTilesRenderer.cpp',
         '../src/pipe/utils/SamplePipeControllers.h',
         '../src/pipe/utils/SamplePipeControllers.cpp',
       ],
       'include_dirs': [
+        '../bench',
         '../src/core',
         '../src/images',
         '../src/lazy',
@@ -397,6 +402,7 @@
         ],
       },
       'dependencies': [
+        'bench.gyp:bench_timer',
         'flags.gyp:flags',
         'jsoncpp.gyp:jsoncpp',
         'skia_lib.gyp:skia_lib',
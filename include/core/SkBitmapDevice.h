@@ -58,6 +58,23 @@ public:
      */
     virtual GrRenderTarget* accessRenderTarget() SK_OVERRIDE { return NULL; }
 
+    /**
+     *  Large draws (paths, rects and paints with shaders, high quality bitmaps) may be rasterized
+     *  in horizontal bands of the device, on a pool of threads shared by the whole process.
+     *  threads is how many threads to split a draw for: 0 or 1 (the default) draws everything
+     *  on the calling thread, and a negative count means one thread per core. The pool has one
+     *  thread per core, so more than that gains nothing. Layers created from this device
+     *  inherit it.
+     *
+     *  Every band is done before the draw returns, but the paint's shader and mask filter (and
+     *  the bitmaps they draw) are used from several threads at once while it runs, so they
+     *  must be safe to share; Skia's own lock whatever they cache. Paths with a path effect
+     *  are always drawn on the calling thread.
+     *  Like drawing in tiles, an edge may land a little differently where it crosses a band.
+     */
+    void setRasterThreads(int threads) { fRasterThreads = threads; }
+    int getRasterThreads() const { return fRasterThreads; }
+
 protected:
     /**
      *  Device may filter the text flags for drawing text here. If it wants to
@@ -219,6 +236,7 @@ private:
     virtual const void* peekPixels(SkImageInfo*, size_t* rowBytes) SK_OVERRIDE;
 
     SkBitmap    fBitmap;
+    int         fRasterThreads;     // See setRasterThreads().
 
     typedef SkBaseDevice INHERITED;
 };
@@ -23,6 +23,14 @@ public:
      */
     void reset();
 
+    /**
+     *  Like reset(), but keeps room for as much as has been allocated since
+     *  the last reset()/rewind(), in a single block, so the same allocations
+     *  can be made again without going back to the heap. This invalidates
+     *  all returned pointers.
+     */
+    void rewind();
+
     enum AllocFailType {
         kReturnNil_AllocFailType,
         kThrow_AllocFailType
@@ -157,6 +157,38 @@ SK_API SkPMColor SkPreMultiplyARGB(U8CPU a, U8CPU r, U8CPU g, U8CPU b);
 */
 SK_API SkPMColor SkPreMultiplyColor(SkColor c);
 
+/** Premultiplied color with float components, nominally in [0..1]. Unlike SkPMColor the
+    components are always stored in R, G, B, A order, whatever the platform's byte order.
+    This is the color type of the optional float span pipeline (see
+    SkShader::Context::shadeSpan4f), which lets shaders, color filters and xfermodes hand
+    colors to each other without rounding them to 8 bits between stages.
+*/
+struct SK_API SkPM4f {
+    enum {
+        R, G, B, A
+    };
+    float fVec[4];
+
+    float r() const { return fVec[R]; }
+    float g() const { return fVec[G]; }
+    float b() const { return fVec[B]; }
+    float a() const { return fVec[A]; }
+
+    static SkPM4f FromPMColor(SkPMColor);
+
+    /** Round back to a SkPMColor. Alpha is pinned to [0..1] and each color component is
+        pinned to [0..alpha], so the result is always a valid premultiplied color.
+    */
+    SkPMColor toPMColor() const;
+};
+
+/** Convert count SkPMColors to SkPM4f. src and dst may not overlap.
+*/
+SK_API void SkPMColorToPM4f(const SkPMColor src[], int count, SkPM4f dst[]);
+/** Convert count SkPM4f colors to SkPMColor, pinning as SkPM4f::toPMColor() does.
+*/
+SK_API void SkPM4fToPMColor(const SkPM4f src[], int count, SkPMColor dst[]);
+
 /** Define a function pointer type for combining two premultiplied colors
 */
 typedef SkPMColor (*SkXfermodeProc)(SkPMColor src, SkPMColor dst);
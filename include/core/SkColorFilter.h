@@ -81,6 +81,18 @@ public:
     virtual void filterSpan16(const uint16_t shader[], int count,
                               uint16_t result[]) const;
 
+    /** Called with a scanline of float colors, as produced by
+        SkShader::Context::shadeSpan4f(). The default implementation rounds
+        them to SkPMColor, calls filterSpan() and converts back; subclasses
+        that override it should also return kSupports4f_Flag from getFlags().
+        Note: src and result may be the same buffer.
+        @param src      array of colors, possibly generated by a shader
+        @param count    the number of entries in the src[] and result[] arrays
+        @param result   written by the filter
+    */
+    virtual void filterSpan4f(const SkPM4f src[], int count,
+                              SkPM4f result[]) const;
+
     enum Flags {
         /** If set the filter methods will not change the alpha channel of the
             colors.
@@ -89,7 +101,11 @@ public:
         /** If set, this subclass implements filterSpan16(). If this flag is
             set, then kAlphaUnchanged_Flag must also be set.
         */
-        kHasFilter16_Flag    = 0x02
+        kHasFilter16_Flag    = 0x02,
+        /** If set, this subclass implements filterSpan4f() without rounding
+            its colors to 8 bits.
+        */
+        kSupports4f_Flag     = 0x04
     };
 
     /** Returns the flags for this filter. Override in subclasses to return
@@ -40,8 +40,10 @@ public:
         virtual void shadeSpan(int x, int y, SkPMColor span[], int count) SK_OVERRIDE;
         virtual void shadeSpan16(int x, int y, uint16_t span[], int count) SK_OVERRIDE;
         virtual void shadeSpanAlpha(int x, int y, uint8_t alpha[], int count) SK_OVERRIDE;
+        virtual void shadeSpan4f(int x, int y, SkPM4f span[], int count) SK_OVERRIDE;
 
     private:
+        SkPM4f      fPM4f;
         SkPMColor   fPMColor;
         uint32_t    fFlags;
         uint16_t    fColor16;
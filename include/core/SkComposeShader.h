@@ -48,7 +48,9 @@ public:
 
         virtual ~ComposeShaderContext();
 
+        virtual uint32_t getFlags() const SK_OVERRIDE;
         virtual void shadeSpan(int x, int y, SkPMColor[], int count) SK_OVERRIDE;
+        virtual void shadeSpan4f(int x, int y, SkPM4f[], int count) SK_OVERRIDE;
 
     private:
         SkShader::Context* fShaderContextA;
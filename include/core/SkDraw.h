@@ -22,6 +22,7 @@ class SkPath;
 class SkRegion;
 class SkRasterClip;
 struct SkDrawProcs;
+class SkPathMaskCache;
 struct SkRect;
 class SkRRect;
 
@@ -120,6 +121,21 @@ private:
     void    drawPath(const SkPath&, const SkPaint&, const SkMatrix* preMatrix,
                      bool pathIsMutable, bool drawCoverage) const;
 
+    /**
+     *  Draw an anti-aliased path through fPathMaskCache, or the global
+     *  SkPathMaskCache if that is NULL, rendering and adding its mask first if
+     *  need be. Returns false (having drawn nothing) if the path or paint
+     *  cannot be cached, or the cache is disabled.
+     */
+    bool    drawCachedPathMask(const SkPath&, const SkPaint&, const SkMatrix&) const;
+
+    /**
+     *  Draw a dashed path made only of lines by blitting its dashes directly,
+     *  rather than expanding the dashes into a path. Returns false (having
+     *  drawn nothing) if the paint, path or matrix is not one it handles.
+     */
+    bool    drawDashedLines(const SkPath&, const SkPaint&, bool drawCoverage) const;
+
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -140,6 +156,7 @@ public:
     const SkClipStack* fClipStack;  // optional
     SkBaseDevice*   fDevice;        // optional
     SkDrawProcs*    fProcs;         // optional
+    SkPathMaskCache* fPathMaskCache; // optional, else the global cache
 
 #ifdef SK_DEBUG
     void validate() const;
@@ -83,10 +83,76 @@ public:
     static size_t GetImageCacheByteLimit();
     static size_t SetImageCacheByteLimit(size_t newLimit);
 
+    /**
+     *  The raster backend caches the coverage masks of small anti-aliased
+     *  paths, so that drawing the same path again with the same matrix (up to
+     *  an integer translation) does not re-scan it. A limit of 0 disables the
+     *  cache, and is the default: masks are rendered unclipped, so where a path
+     *  crosses the clip or the edge of the device its anti-aliasing can differ
+     *  slightly from drawing it directly. SetPathMaskCacheByteLimit returns the
+     *  previous limit.
+     */
+    static size_t GetPathMaskCacheBytesUsed();
+    static size_t GetPathMaskCacheByteLimit();
+    static size_t SetPathMaskCacheByteLimit(size_t newLimit);
+
+    /**
+     *  SkPaint::getFillPath() caches the outlines it computes for stroked and
+     *  path-effected paths, keyed on the source path's generation ID, so that
+     *  redrawing an unchanged path does not stroke or dash it again. A limit of
+     *  0 disables the cache, and is the default: it only pays off for clients
+     *  that redraw the same stroked paths, and otherwise costs a mutex on every
+     *  stroke. The hit and miss counts cover every cacheable lookup since
+     *  startup, for tuning the limit.
+     */
+    static size_t GetStrokeCacheBytesUsed();
+    static size_t GetStrokeCacheByteLimit();
+    static size_t SetStrokeCacheByteLimit(size_t newLimit);
+    static int GetStrokeCacheHitCount();
+    static int GetStrokeCacheMissCount();
+
+    /**
+     *  High quality bitmap scaling caches the filter weights it computes for
+     *  each source size, scale and method, so that scaling to the same size
+     *  again does not recompute them. A limit of 0 disables the cache.
+     *  SetConvolutionFilterCacheByteLimit returns the previous limit.
+     */
+    static size_t GetConvolutionFilterCacheBytesUsed();
+    static size_t GetConvolutionFilterCacheByteLimit();
+    static size_t SetConvolutionFilterCacheByteLimit(size_t newLimit);
+
+    /**
+     *  Gradient shaders share the color tables they build across every shader
+     *  with the same colors, positions, flags and paint alpha, so that creating
+     *  the same gradient many times builds its tables once. A limit of 0
+     *  disables sharing, and each shader builds its own tables.
+     */
+    static size_t GetGradientCacheBytesUsed();
+    static size_t GetGradientCacheByteLimit();
+    static size_t SetGradientCacheByteLimit(size_t newLimit);
+    static int GetGradientCacheHitCount();
+    static int GetGradientCacheMissCount();
+
+    /**
+     *  Anti-aliased path fills in raster normally supersample each pixel.  With analytic AA on,
+     *  they instead compute the exact area of each pixel the path covers, in one pass per row.
+     *  Off by default.  It's safe to change from any thread, even while others draw; each fill
+     *  uses whichever setting it sees when it starts.
+     *
+     *  SetAnalyticAA returns the previous setting.
+     */
+    static bool GetAnalyticAA();
+    static bool SetAnalyticAA(bool analytic);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
      *  font-cache-limit=12345678
+     *  analytic-aa=1
+     *  path-mask-cache-limit=1048576
+     *  stroke-cache-limit=1048576
+     *  convolution-filter-cache-limit=524288
+     *  gradient-cache-limit=1048576
      *
      *  The flags format is name=value[;name=value...] with no spaces.
      *  This format is subject to change.
@@ -1074,6 +1074,9 @@ private:
     uint32_t getBitfields() const { return fBitfields; }
     void setBitfields(uint32_t bitfields);
 
+    // getFillPath() without SkStrokeCache.
+    bool computeFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect) const;
+
     SkDrawCacheProc    getDrawCacheProc() const;
     SkMeasureCacheProc getMeasureCacheProc(TextBufferDirection dir,
                                            bool needFullMetrics) const;
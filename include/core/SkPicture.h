@@ -25,6 +25,7 @@ class SkDrawPictureCallback;
 class SkData;
 class SkPathHeap;
 class SkPicturePlayback;
+class SkPlaybackProfiler;
 class SkPictureRecord;
 class SkStream;
 class SkWStream;
@@ -103,6 +104,23 @@ public:
     static SkPicture* CreateFromStream(SkStream*,
                                        InstallPixelRefProc proc = &SkImageDecoder::DecodeMemory);
 
+    /**
+     *  Recreate a picture that was serialized into data, e.g. an SKP file mapped into memory with
+     *  SkData::NewFromFileName().  Unlike CreateFromStream(), the picture refs data and plays its
+     *  drawing commands back from it in place rather than copying them out, as long as data
+     *  starts 4-byte aligned (a mapped file does) and was written at version 29 or later; older
+     *  SKPs are copied as before.  Paints, paths and the like are still unflattened as the
+     *  picture loads, and bitmaps are installed by proc; pass one that installs lazily decoding
+     *  pixel refs to put off decoding them until they're drawn.
+     *  @param SkData Serialized picture data.  It must not be modified after this call.
+     *  @param proc Function pointer for installing pixelrefs on SkBitmaps representing the
+     *              encoded bitmap data.
+     *  @return A new SkPicture representing the serialized data, or NULL if the data is
+     *          invalid.
+     */
+    static SkPicture* CreateFromData(SkData*,
+                                     InstallPixelRefProc proc = &SkImageDecoder::DecodeMemory);
+
     /**
      *  Recreate a picture that was serialized into a buffer. If the creation requires bitmap
      *  decoding, the decoder must be set on the SkReadBuffer parameter by calling
@@ -204,6 +222,13 @@ public:
      */
     bool willPlayBackBitmaps() const;
 
+    /** PRIVATE / EXPERIMENTAL -- do not call
+        Tell profiler about each op as this picture draws it, until set back to NULL.  The
+        profiler is not owned, and is not shared with clones.  Drawing the picture from more than
+        one thread at a time while it has a profiler is not safe.
+    */
+    void EXPERIMENTAL_setProfiler(SkPlaybackProfiler* profiler);
+
 #ifdef SK_BUILD_FOR_ANDROID
     /** Signals that the caller is prematurely done replaying the drawing
         commands. This can be called from a canvas virtual while the picture
@@ -261,13 +286,15 @@ protected:
     // V26: Removed boolean from SkColorShader for inheriting color from SkPaint.
     // V27: Remove SkUnitMapper from gradients (and skia).
     // V28: No longer call bitmap::flatten inside SkWriteBuffer::writeBitmap.
+    // V29: In streams, pad SK_PICT_READER_TAG's op data to start 4-byte aligned, so that
+    //      CreateFromData() can play it back in place.
 
     // Note: If the picture version needs to be increased then please follow the
     // steps to generate new SKPs in (only accessible to Googlers): http://goo.gl/qATVcw
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t MIN_PICTURE_VERSION = 19;
-    static const uint32_t CURRENT_PICTURE_VERSION = 28;
+    static const uint32_t CURRENT_PICTURE_VERSION = 29;
 
     mutable uint32_t      fUniqueID;
 
@@ -397,6 +424,9 @@ private:
 
     void createHeader(SkPictInfo* info) const;
     static bool IsValidPictInfo(const SkPictInfo& info);
+    // If inPlace is not NULL, stream must be reading from it, and we may ref parts of it instead
+    // of copying them.
+    static SkPicture* CreateFromStream(SkStream*, InstallPixelRefProc, SkData* inPlace);
     static SkPicturePlayback* FakeEndRecording(const SkPicture* resourceSrc,
                                                const SkPictureRecord& record,
                                                bool deepCopy);
@@ -430,4 +460,25 @@ public:
     virtual bool abortDrawing() = 0;
 };
 
+/**
+ *  PRIVATE / EXPERIMENTAL -- do not use
+ *  Subclasses of this are told about each op a picture draws as it plays back, e.g. to time how
+ *  long each kind of op takes.  See SkPicture::EXPERIMENTAL_setProfiler().
+ */
+class SK_API SkPlaybackProfiler {
+public:
+    SkPlaybackProfiler() {}
+    virtual ~SkPlaybackProfiler() {}
+
+    /**
+     *  Called just before and just after an op draws.  These calls never nest.
+     *  opID identifies the op within its picture, and is the same each time it's drawn: it's the
+     *  op's index in an SkRecord, or its offset into an SkPicturePlayback's op data.  type is a
+     *  small non-negative integer identifying which kind of op it is, named by typeName, which
+     *  stays valid forever.  Both depend on which kind of playback is drawing.
+     */
+    virtual void beginOp(uint32_t opID, int type, const char* typeName) = 0;
+    virtual void endOp() = 0;
+};
+
 #endif
@@ -125,12 +125,18 @@
 #define SK_CPU_SSE_LEVEL_SSSE3    31
 #define SK_CPU_SSE_LEVEL_SSE41    41
 #define SK_CPU_SSE_LEVEL_SSE42    42
+#define SK_CPU_SSE_LEVEL_AVX      51
+#define SK_CPU_SSE_LEVEL_AVX2     52
 
 // Are we in GCC?
 #ifndef SK_CPU_SSE_LEVEL
     // These checks must be done in descending order to ensure we set the highest
     // available SSE level.
-    #if defined(__SSE4_2__)
+    #if defined(__AVX2__)
+        #define SK_CPU_SSE_LEVEL    SK_CPU_SSE_LEVEL_AVX2
+    #elif defined(__AVX__)
+        #define SK_CPU_SSE_LEVEL    SK_CPU_SSE_LEVEL_AVX
+    #elif defined(__SSE4_2__)
         #define SK_CPU_SSE_LEVEL    SK_CPU_SSE_LEVEL_SSE42
     #elif defined(__SSE4_1__)
         #define SK_CPU_SSE_LEVEL    SK_CPU_SSE_LEVEL_SSE41
@@ -261,4 +267,17 @@
 #   define SK_ATTRIBUTE_OPTIMIZE_O1 /* nothing */
 #endif
 
+/**
+ * SK_ATTRIBUTE_TARGET_AVX2 marks a function that may use AVX2 instructions,
+ * so that the rest of its file, and the inline functions that file shares
+ * with others, can be built without -mavx2 and stay safe to run on CPUs
+ * without AVX2. Only call such functions after checking for AVX2 at runtime.
+ * Visual Studio needs no flag to use AVX2 intrinsics.
+ */
+#if SK_HAS_ATTRIBUTE(target)
+#   define SK_ATTRIBUTE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#   define SK_ATTRIBUTE_TARGET_AVX2 /* nothing */
+#endif
+
 #endif
@@ -205,6 +205,10 @@ public:
 protected:
     SkReader32 fReader;
 
+    // Set by setTypefaceArray().
+    SkTypeface** fTFArray;
+    int        fTFCount;
+
 private:
     bool readArray(void* value, size_t size, size_t elementSize);
 
@@ -214,8 +218,6 @@ private:
     void* fMemoryPtr;
 
     SkBitmapHeapReader* fBitmapStorage;
-    SkTypeface** fTFArray;
-    int        fTFCount;
 
     SkTDArray<SkFlattenable::Factory>* fFactoryTDArray;
     SkFlattenable::Factory* fFactoryArray;
@@ -111,7 +111,14 @@ public:
             predithered, which would mean it was not const in Y, even though
             the 32bit shadeSpan() would be const.
          */
-        kConstInY16_Flag = 0x10
+        kConstInY16_Flag = 0x10,
+
+        /** set if this shader's shadeSpan4f() produces its colors directly,
+            rather than rounding them through shadeSpan() first. Consumers
+            such as SkComposeShader's shadeSpan4f() use this to decide whether
+            to keep a span in float until its final store.
+         */
+        kSupports4f_Flag = 0x20
     };
 
     /**
@@ -167,6 +174,16 @@ public:
          */
         virtual void shadeSpan(int x, int y, SkPMColor[], int count) = 0;
 
+        /**
+         *  Like shadeSpan(), but returns premultiplied float colors. Only
+         *  worth calling when getFlags() has kSupports4f_Flag set; the default
+         *  implementation calls shadeSpan() and converts its result. This is
+         *  opt-in: the blitters do not call it, and shadeSpan() never switches
+         *  to it on its own, so 8 bit output is unchanged. Shaders built on
+         *  other shaders call it on them only from their own shadeSpan4f().
+         */
+        virtual void shadeSpan4f(int x, int y, SkPM4f[], int count);
+
         typedef void (*ShadeProc)(void* ctx, int x, int y, SkPMColor[], int count);
         virtual ShadeProc asAShadeProc(void** ctx);
 
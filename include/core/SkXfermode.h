@@ -38,6 +38,13 @@ public:
                         const SkAlpha aa[]) const;
     virtual void xferA8(SkAlpha dst[], const SkPMColor src[], int count,
                         const SkAlpha aa[]) const;
+    /** Float counterpart of xfer32(), for colors produced by
+        SkShader::Context::shadeSpan4f(). The default implementation rounds
+        dst and src to SkPMColor and calls xfer32(); modes that can be
+        expressed with Coeffs (see asCoeff()) blend in float instead.
+    */
+    virtual void xfer4f(SkPM4f dst[], const SkPM4f src[], int count,
+                        const SkAlpha aa[]) const;
 
     /** Enum of possible coefficients to describe some xfermodes
      */
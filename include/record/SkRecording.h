@@ -14,8 +14,15 @@
 #include "SkTypes.h"      // SkNoncopyable
 
 // These are intentionally left opaque.
+class SkBBHFactory;
+class SkBBoxHierarchy;
+class SkBitmap;
+class SkData;
+class SkPlaybackProfiler;
 class SkRecord;
 class SkRecorder;
+class SkSerializedRecord;
+class SkWStream;
 
 namespace EXPERIMENTAL {
 
@@ -33,7 +40,16 @@ namespace EXPERIMENTAL {
  *  playback->draw(&someCanvas);
  *  playback->draw(&someOtherCanvas);
  *
- *  SkPlayback is thread safe; SkRecording is not.
+ *  If you pass an SkBBHFactory (e.g. SkRTreeFactory or SkTileGridFactory) to SkRecording, the
+ *  SkPlayback it returns will use a bounding box hierarchy to draw only the commands that may
+ *  affect pixels inside the destination canvas' clip.
+ *
+ *  An SkPlayback can be written to a stream with serialize() and loaded back with CreateFromData().
+ *  Loading is cheap: commands are played back in place out of the SkData, so an SkData mapping a
+ *  file (SkData::NewFromFileName()) costs little more than the page faults to read it.
+ *
+ *  SkPlayback is thread safe; SkRecording is not.  drawTiled() puts that to work, drawing one
+ *  SkPlayback into many tiles of a bitmap in parallel without copying anything per thread.
  */
 
 class SK_API SkPlayback : SkNoncopyable {
@@ -41,20 +57,41 @@ public:
     // Remember, if you've got an SkPlayback*, you probably own it.  Don't forget to delete it!
     ~SkPlayback();
 
-    // Draw recorded commands into a canvas.
-    void draw(SkCanvas*) const;
+    // Draw recorded commands into a canvas.  If profiler is non-NULL, it's told about each command
+    // as we draw it.
+    void draw(SkCanvas*, SkPlaybackProfiler* profiler = NULL) const;
+
+    // Draw recorded commands into a raster bitmap, split into tileWidth x tileHeight tiles.  If
+    // threaded, tiles are drawn in parallel on Skia's shared pool of one thread per core;
+    // otherwise every tile is drawn on the calling thread.  Returns once all tiles are drawn.
+    void drawTiled(const SkBitmap& dst, int tileWidth, int tileHeight, bool threaded = true) const;
+
+    // Write recorded commands to a stream in a versioned format readable by CreateFromData().
+    void serialize(SkWStream*) const;
+
+    // Play back commands written by serialize().  Takes a ref on the SkData.  Paints, paths and
+    // bitmaps are created the first time they're drawn; everything else is read from the SkData.
+    // Returns NULL if the data isn't a serialized SkPlayback of a version we understand.
+    static SkPlayback* CreateFromData(SkData*);
 
 private:
-    explicit SkPlayback(const SkRecord*);
+    // Takes ownership of the SkRecord, and takes a ref on the SkBBoxHierarchy if it's non-NULL.
+    SkPlayback(const SkRecord*, SkBBoxHierarchy*);
+    // Takes ownership of the SkSerializedRecord.
+    explicit SkPlayback(const SkSerializedRecord*);
 
+    // Exactly one of fRecord and fSerialized is non-NULL.
     SkAutoTDelete<const SkRecord> fRecord;
+    SkAutoTDelete<const SkSerializedRecord> fSerialized;
+    SkAutoTUnref<SkBBoxHierarchy> fBBH;
 
     friend class SkRecording;
 };
 
 class SK_API SkRecording : SkNoncopyable {
 public:
-    SkRecording(int width, int height);
+    // The SkBBHFactory is optional, and is only used during construction.
+    SkRecording(int width, int height, SkBBHFactory* = NULL);
     ~SkRecording();
 
     // Draws issued to this canvas will be replayed by SkPlayback::draw().
@@ -65,9 +102,15 @@ public:
     // Any refs held on canvas() must be dropped before you may call releasePlayback().
     SkPlayback* releasePlayback();
 
+    // Roughly how many bytes the commands recorded so far use, including the paints and paths
+    // they share.  Must be called before releasePlayback().
+    size_t approximateBytesUsed() const;
+
 private:
     SkAutoTDelete<SkRecord> fRecord;
     SkAutoTUnref<SkRecorder> fRecorder;
+    SkAutoTUnref<SkBBoxHierarchy> fBBH;
+    const int fWidth, fHeight;
 };
 
 }  // namespace EXPERIMENTAL
@@ -11,6 +11,7 @@
 #include "SkRasterClip.h"
 #include "SkShader.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
 
 #define CHECK_FOR_ANNOTATION(paint) \
     do { if (paint.getAnnotation()) { return; } } while (0)
@@ -57,13 +58,14 @@ static bool valid_for_bitmap_device(const SkImageInfo& info,
     return true;
 }
 
-SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap) : fBitmap(bitmap) {
+SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap) : fBitmap(bitmap), fRasterThreads(0) {
     SkASSERT(valid_for_bitmap_device(bitmap.info(), NULL));
 }
 
 SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap, const SkDeviceProperties& deviceProperties)
     : SkBaseDevice(deviceProperties)
     , fBitmap(bitmap)
+    , fRasterThreads(0)
 {
     SkASSERT(valid_for_bitmap_device(bitmap.info(), NULL));
 }
@@ -109,7 +111,11 @@ void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
 }
 
 SkBaseDevice* SkBitmapDevice::onCreateDevice(const SkImageInfo& info, Usage usage) {
-    return SkBitmapDevice::Create(info, &this->getDeviceProperties());
+    SkBitmapDevice* device = SkBitmapDevice::Create(info, &this->getDeviceProperties());
+    if (NULL != device) {
+        device->setRasterThreads(fRasterThreads);
+    }
+    return device;
 }
 
 void SkBitmapDevice::lockPixels() {
@@ -257,8 +263,94 @@ bool SkBitmapDevice::onReadPixels(const SkImageInfo& dstInfo, void* dstPixels, s
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Draws covering fewer pixels than this aren't worth splitting up.
+static const int kMinBandedArea = 256 * 256;
+
+// Each thread gets about this many bands, so that a thread that finishes its share early (say, the
+// rows near the top of a circle) can pick up another band from a slower one.
+static const int kBandsPerThread = 2;
+
+namespace {
+
+// One of SkBitmapDevice's draws, which we may repeat for each band with the clip reduced to the band.
+struct BandDrawer {
+    virtual ~BandDrawer() {}
+    virtual void draw(const SkDraw&) const = 0;
+};
+
+class Band : public SkRunnable {
+public:
+    Band() : fDrawer(NULL) {}
+
+    void init(const SkDraw& draw, const SkIRect& band, const BandDrawer* drawer) {
+        fRC = *draw.fRC;
+        fRC.op(band, SkRegion::kIntersect_Op);
+        fDraw = draw;
+        fDraw.fRC = &fRC;
+        fDraw.fClip = &fRC.forceGetBW();
+        fDrawer = drawer;
+    }
+
+    virtual void run() SK_OVERRIDE {
+        if (!fRC.isEmpty()) {
+            fDrawer->draw(fDraw);
+        }
+    }
+
+private:
+    SkDraw fDraw;
+    SkRasterClip fRC;
+    const BandDrawer* fDrawer;
+};
+
+}  // namespace
+
+// If devBounds covers enough of the clip, draws with drawer in bands across threads and returns
+// true.  Otherwise returns false, having drawn nothing.
+static bool draw_in_bands(int threads, const SkDraw& draw, const SkRect& devBounds,
+                          const BandDrawer& drawer) {
+    if (threads < 0) {
+        threads = SkTaskGroup::NumCores();
+    }
+    if (threads <= 1 || NULL != draw.fProcs || draw.fRC->isEmpty()) {
+        return false;
+    }
+
+    // Outset for anti-aliasing and hairlines.
+    SkIRect bounds;
+    devBounds.roundOut(&bounds);
+    bounds.outset(1, 1);
+    if (!bounds.intersect(draw.fRC->getBounds()) ||
+        (int64_t)bounds.width() * bounds.height() < kMinBandedArea) {
+        return false;
+    }
+
+    const int count = SkTMin(threads * kBandsPerThread, bounds.height());
+    SkAutoTArray<Band> bands(count);
+    SkTaskGroup group;
+    for (int i = 0; i < count; i++) {
+        const int top    = bounds.fTop + bounds.height() *  i      / count,
+                  bottom = bounds.fTop + bounds.height() * (i + 1) / count;
+        bands[i].init(draw, SkIRect::MakeLTRB(bounds.fLeft, top, bounds.fRight, bottom), &drawer);
+        group.add(&bands[i]);
+    }
+    group.wait();
+    return true;
+}
+
 void SkBitmapDevice::drawPaint(const SkDraw& draw, const SkPaint& paint) {
-    draw.drawPaint(paint);
+    struct PaintDrawer : public BandDrawer {
+        PaintDrawer(const SkPaint& paint) : fPaint(paint) {}
+        virtual void draw(const SkDraw& draw) const SK_OVERRIDE { draw.drawPaint(fPaint); }
+        const SkPaint& fPaint;
+    } drawer(paint);
+
+    // A solid color fill is about as quick as memory can go, but shading every pixel isn't.
+    if (NULL != paint.getShader() &&
+        draw_in_bands(fRasterThreads, draw, SkRect::Make(draw.fRC->getBounds()), drawer)) {
+        return;
+    }
+    drawer.draw(draw);
 }
 
 void SkBitmapDevice::drawPoints(const SkDraw& draw, SkCanvas::PointMode mode, size_t count,
@@ -269,7 +361,23 @@ void SkBitmapDevice::drawPoints(const SkDraw& draw, SkCanvas::PointMode mode, si
 
 void SkBitmapDevice::drawRect(const SkDraw& draw, const SkRect& r, const SkPaint& paint) {
     CHECK_FOR_ANNOTATION(paint);
-    draw.drawRect(r, paint);
+
+    struct RectDrawer : public BandDrawer {
+        RectDrawer(const SkRect& rect, const SkPaint& paint) : fRect(rect), fPaint(paint) {}
+        virtual void draw(const SkDraw& draw) const SK_OVERRIDE { draw.drawRect(fRect, fPaint); }
+        const SkRect& fRect;
+        const SkPaint& fPaint;
+    } drawer(r, paint);
+
+    if ((NULL != paint.getShader() || NULL != paint.getMaskFilter()) &&
+        paint.canComputeFastBounds()) {
+        SkRect storage, devBounds;
+        draw.fMatrix->mapRect(&devBounds, paint.computeFastBounds(r, &storage));
+        if (draw_in_bands(fRasterThreads, draw, devBounds, drawer)) {
+            return;
+        }
+    }
+    drawer.draw(draw);
 }
 
 void SkBitmapDevice::drawOval(const SkDraw& draw, const SkRect& oval, const SkPaint& paint) {
@@ -301,12 +409,71 @@ void SkBitmapDevice::drawPath(const SkDraw& draw, const SkPath& path,
                               const SkPaint& paint, const SkMatrix* prePathMatrix,
                               bool pathIsMutable) {
     CHECK_FOR_ANNOTATION(paint);
+
+    // Each band draws its own copy of the path, so none of them may change the shared one.
+    struct PathDrawer : public BandDrawer {
+        PathDrawer(const SkPath& path, const SkPaint& paint, const SkMatrix* prePathMatrix)
+            : fPath(path), fPaint(paint), fPrePathMatrix(prePathMatrix) {}
+        virtual void draw(const SkDraw& draw) const SK_OVERRIDE {
+            SkPath path(fPath);
+            draw.drawPath(path, fPaint, fPrePathMatrix, true);
+        }
+        const SkPath& fPath;
+        const SkPaint& fPaint;
+        const SkMatrix* fPrePathMatrix;
+    } drawer(path, paint, prePathMatrix);
+
+    // A path effect may keep its own caches, and would run once per band anyway.
+    if ((fRasterThreads > 1 || fRasterThreads < 0) && NULL == paint.getPathEffect()) {
+        // Copies share the path's SkPathRef, so compute everything it or the path caches lazily
+        // before the bands read it from several threads.
+        (void)path.getBounds();
+        (void)path.getGenerationID();
+        (void)path.getConvexity();
+        SkPath::Direction dir;
+        (void)path.cheapComputeDirection(&dir);
+
+        SkRect devBounds = SkRect::Make(draw.fRC->getBounds());
+        if (!path.isInverseFillType() && paint.canComputeFastBounds()) {
+            // The pre-path matrix applies before any stroking, the draw's matrix after it.
+            SkRect srcBounds = path.getBounds(), storage;
+            if (NULL != prePathMatrix) {
+                prePathMatrix->mapRect(&srcBounds);
+            }
+            draw.fMatrix->mapRect(&devBounds, paint.computeFastBounds(srcBounds, &storage));
+        }
+        if (draw_in_bands(fRasterThreads, draw, devBounds, drawer)) {
+            return;
+        }
+    }
     draw.drawPath(path, paint, prePathMatrix, pathIsMutable);
 }
 
 void SkBitmapDevice::drawBitmap(const SkDraw& draw, const SkBitmap& bitmap,
                                 const SkMatrix& matrix, const SkPaint& paint) {
-    draw.drawBitmap(bitmap, matrix, paint);
+    struct BitmapDrawer : public BandDrawer {
+        BitmapDrawer(const SkBitmap& bitmap, const SkMatrix& matrix, const SkPaint& paint)
+            : fBitmap(bitmap), fMatrix(matrix), fPaint(paint) {}
+        virtual void draw(const SkDraw& draw) const SK_OVERRIDE {
+            draw.drawBitmap(fBitmap, fMatrix, fPaint);
+        }
+        const SkBitmap& fBitmap;
+        const SkMatrix& fMatrix;
+        const SkPaint& fPaint;
+    } drawer(bitmap, matrix, paint);
+
+    // Only high quality filtering does enough work per pixel to be worth splitting.
+    if (SkPaint::kHigh_FilterLevel == paint.getFilterLevel()) {
+        SkMatrix total;
+        total.setConcat(*draw.fMatrix, matrix);
+        SkRect devBounds;
+        total.mapRect(&devBounds, SkRect::MakeWH(SkIntToScalar(bitmap.width()),
+                                                 SkIntToScalar(bitmap.height())));
+        if (draw_in_bands(fRasterThreads, draw, devBounds, drawer)) {
+            return;
+        }
+    }
+    drawer.draw(draw);
 }
 
 void SkBitmapDevice::drawBitmapRect(const SkDraw& draw, const SkBitmap& bitmap,
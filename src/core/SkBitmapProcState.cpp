@@ -266,7 +266,9 @@ bool SkBitmapProcState::possiblyScaleImage() {
         fScaledCacheID = SkScaledImageCache::FindAndLockMip(fOrigBitmap, &mip);
         if (!fScaledCacheID) {
             SkASSERT(NULL == mip);
-            mip = SkMipMap::Build(fOrigBitmap);
+            // Only compute levels as draws ask for them, so that a draw
+            // doesn't pay for the smaller levels it never samples.
+            mip = SkMipMap::Build(fOrigBitmap, SkMipMap::kLazy_BuildMode);
             if (mip) {
                 fScaledCacheID = SkScaledImageCache::AddAndLockMip(fOrigBitmap,
                                                                    mip);
@@ -288,6 +290,7 @@ bool SkBitmapProcState::possiblyScaleImage() {
                 SkImageInfo info = fOrigBitmap.info();
                 info.fWidth = level.fWidth;
                 info.fHeight = level.fHeight;
+                info.fColorType = level.fColorType;
                 fScaledBitmap.installPixels(info, level.fPixels, level.fRowBytes);
                 fBitmap = &fScaledBitmap;
                 fFilterLevel = SkPaint::kLow_FilterLevel;
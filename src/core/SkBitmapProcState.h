@@ -138,6 +138,7 @@ struct SkBitmapProcState {
 
 private:
     friend class SkBitmapProcShader;
+    friend class BitmapProcStateTester;     // for unit testing
 
     ShaderProc32        fShaderProc32;      // chooseProcs
     ShaderProc16        fShaderProc16;      // chooseProcs
@@ -220,6 +221,18 @@ void ClampX_ClampY_filter_affine(const SkBitmapProcState& s,
                                  uint32_t xy[], int count, int x, int y);
 void ClampX_ClampY_nofilter_affine(const SkBitmapProcState& s,
                                    uint32_t xy[], int count, int x, int y);
+void ClampX_ClampY_filter_persp(const SkBitmapProcState& s,
+                                uint32_t xy[], int count, int x, int y);
+void ClampX_ClampY_nofilter_persp(const SkBitmapProcState& s,
+                                  uint32_t xy[], int count, int x, int y);
+void RepeatX_RepeatY_filter_affine(const SkBitmapProcState& s,
+                                   uint32_t xy[], int count, int x, int y);
+void RepeatX_RepeatY_nofilter_affine(const SkBitmapProcState& s,
+                                     uint32_t xy[], int count, int x, int y);
+void RepeatX_RepeatY_filter_persp(const SkBitmapProcState& s,
+                                  uint32_t xy[], int count, int x, int y);
+void RepeatX_RepeatY_nofilter_persp(const SkBitmapProcState& s,
+                                    uint32_t xy[], int count, int x, int y);
 void S32_D16_filter_DX(const SkBitmapProcState& s,
                        const uint32_t* xy, int count, uint16_t* colors);
 
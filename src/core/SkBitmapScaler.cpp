@@ -1,5 +1,6 @@
 #include "SkBitmapScaler.h"
 #include "SkBitmapFilter.h"
+#include "SkConvolutionFilterCache.h"
 #include "SkRect.h"
 #include "SkTArray.h"
 #include "SkErrorInternals.h"
@@ -26,9 +27,11 @@ public:
 
 private:
 
+    SkBitmapScaler::ResizeMethod fMethod;
     SkBitmapFilter* fBitmapFilter;
 
-    // Computes one set of filters either horizontally or vertically. The caller
+    // Computes one set of filters either horizontally or vertically, or finds
+    // them in the SkConvolutionFilterCache if they were computed before. The caller
     // will specify the "min" and "max" rather than the bottom/top and
     // right/bottom so that the same code can be re-used in each dimension.
     //
@@ -53,7 +56,8 @@ SkResizeFilter::SkResizeFilter(SkBitmapScaler::ResizeMethod method,
                                int srcFullWidth, int srcFullHeight,
                                float destWidth, float destHeight,
                                const SkRect& destSubset,
-                               const SkConvolutionProcs& convolveProcs) {
+                               const SkConvolutionProcs& convolveProcs)
+    : fMethod(method) {
 
     // method will only ever refer to an "algorithm method".
     SkASSERT((SkBitmapScaler::RESIZE_FIRST_ALGORITHM_METHOD <= method) &&
@@ -114,6 +118,15 @@ void SkResizeFilter::computeFilters(int srcSize,
                                   float scale,
                                   SkConvolutionFilter1D* output,
                                   const SkConvolutionProcs& convolveProcs) {
+  SkConvolutionFilterCache::Key key;
+  SkConvolutionFilterCache::ComputeKey(fMethod, srcSize, scale,
+                                       destSubsetLo, destSubsetSize,
+                                       NULL != convolveProcs.fApplySIMDPadding,
+                                       &key);
+  if (SkConvolutionFilterCache::Find(key, output)) {
+    return;
+  }
+
   float destSubsetHi = destSubsetLo + destSubsetSize;  // [lo, hi)
 
   // When we're doing a magnification, the scale will be larger than one. This
@@ -205,6 +218,8 @@ void SkResizeFilter::computeFilters(int srcSize,
   if (convolveProcs.fApplySIMDPadding) {
       convolveProcs.fApplySIMDPadding( output );
   }
+
+  SkConvolutionFilterCache::Add(key, *output);
 }
 
 static SkBitmapScaler::ResizeMethod ResizeMethodToAlgorithmMethod(
@@ -247,7 +262,8 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
                             ResizeMethod method,
                             float destWidth, float destHeight,
                             const SkConvolutionProcs& convolveProcs,
-                            SkBitmap::Allocator* allocator) {
+                            SkBitmap::Allocator* allocator,
+                            int threads) {
 
   SkRect destSubset = { 0, 0, destWidth, destHeight };
 
@@ -308,7 +324,7 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
         !source.isOpaque(), filter.xFilter(), filter.yFilter(),
         static_cast<int>(result.rowBytes()),
         static_cast<unsigned char*>(result.getPixels()),
-        convolveProcs, true);
+        convolveProcs, true, threads);
 
     *resultPtr = result;
     resultPtr->lockPixels();
@@ -79,12 +79,18 @@ public:
         RESIZE_LAST_ALGORITHM_METHOD = RESIZE_MITCHELL,
     };
 
+    /** Resamples source to dest_width x dest_height into result. threads is how
+     *  many threads' worth of bands to split the work into, which run on the
+     *  shared SkTaskGroup pool: 0 or 1 (the default) uses the calling thread,
+     *  and a negative count uses one per core.
+     */
     static bool Resize(SkBitmap* result,
                        const SkBitmap& source,
                        ResizeMethod method,
                        float dest_width, float dest_height,
                        const SkConvolutionProcs&,
-                       SkBitmap::Allocator* allocator = NULL);
+                       SkBitmap::Allocator* allocator = NULL,
+                       int threads = 1);
 };
 
 #endif
@@ -69,6 +69,21 @@ void SkChunkAlloc::reset() {
     fBlockCount = 0;
 }
 
+void SkChunkAlloc::rewind() {
+    if (fBlockCount > 1) {
+        // Replace our blocks with one as big as all of them together.
+        const size_t capacity = fTotalCapacity;
+        this->reset();
+        fBlock = this->newBlock(capacity, kThrow_AllocFailType);
+        fBlock->fNext = NULL;
+        fChunkSize = fMinSize;
+    } else if (fBlock) {
+        fBlock->fFreeSize += fBlock->fFreePtr - fBlock->startOfData();
+        fBlock->fFreePtr = fBlock->startOfData();
+    }
+    fTotalUsed = 0;
+}
+
 SkChunkAlloc::Block* SkChunkAlloc::newBlock(size_t bytes, AllocFailType ftype) {
     size_t size = bytes;
     if (size < fChunkSize) {
@@ -111,3 +111,43 @@ SkColor SkHSVToColor(U8CPU a, const SkScalar hsv[3]) {
     }
     return SkColorSetARGB(a, r, g, b);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPM4f SkPM4f::FromPMColor(SkPMColor c) {
+    const float scale = 1.0f / 255;
+    SkPM4f c4;
+    c4.fVec[R] = SkGetPackedR32(c) * scale;
+    c4.fVec[G] = SkGetPackedG32(c) * scale;
+    c4.fVec[B] = SkGetPackedB32(c) * scale;
+    c4.fVec[A] = SkGetPackedA32(c) * scale;
+    return c4;
+}
+
+static inline unsigned pin_unit_to_byte(float v, float max) {
+    // written so that a NaN component ends up as 0
+    if (!(v > 0)) {
+        return 0;
+    }
+    return (unsigned)(SkTMin(v, max) * 255 + 0.5f);
+}
+
+SkPMColor SkPM4f::toPMColor() const {
+    float a = fVec[A] > 0 ? SkTMin(fVec[A], 1.0f) : 0;
+    return SkPackARGB32(pin_unit_to_byte(a, 1),
+                        pin_unit_to_byte(fVec[R], a),
+                        pin_unit_to_byte(fVec[G], a),
+                        pin_unit_to_byte(fVec[B], a));
+}
+
+void SkPMColorToPM4f(const SkPMColor src[], int count, SkPM4f dst[]) {
+    for (int i = 0; i < count; ++i) {
+        dst[i] = SkPM4f::FromPMColor(src[i]);
+    }
+}
+
+void SkPM4fToPMColor(const SkPM4f src[], int count, SkPMColor dst[]) {
+    for (int i = 0; i < count; ++i) {
+        dst[i] = src[i].toPMColor();
+    }
+}
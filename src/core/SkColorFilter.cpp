@@ -34,6 +34,21 @@ void SkColorFilter::filterSpan16(const uint16_t s[], int count, uint16_t d[]) co
     }
 }
 
+void SkColorFilter::filterSpan4f(const SkPM4f src[], int count, SkPM4f result[]) const {
+    const int kTmpCount = 64;
+    SkPMColor tmp[kTmpCount];
+
+    while (count > 0) {
+        int n = SkMin32(count, kTmpCount);
+        SkPM4fToPMColor(src, n, tmp);
+        this->filterSpan(tmp, n, tmp);
+        SkPMColorToPM4f(tmp, n, result);
+        src += n;
+        result += n;
+        count -= n;
+    }
+}
+
 SkColor SkColorFilter::filterColor(SkColor c) const {
     SkPMColor dst, src = SkPreMultiplyColor(c);
     this->filterSpan(&src, 1, &dst);
@@ -131,6 +131,19 @@ bool SkComposeShader::asACompose(ComposeRec* rec) const {
 }
 
 
+uint32_t SkComposeShader::ComposeShaderContext::getFlags() const {
+    // We can keep the span in float only if both shaders can produce it, and
+    // the mode can blend it without rounding (a NULL mode is SRC_OVER).
+    SkXfermode* mode = static_cast<const SkComposeShader&>(fShader).fMode;
+    uint32_t flagsA = fShaderContextA->getFlags();
+    uint32_t flagsB = fShaderContextB->getFlags();
+
+    if ((flagsA & flagsB & kSupports4f_Flag) && SkXfermode::AsCoeff(mode, NULL, NULL)) {
+        return kSupports4f_Flag;
+    }
+    return 0;
+}
+
 // larger is better (fewer times we have to loop), but we shouldn't
 // take up too much stack-space (each element is 4 bytes)
 #define TMP_COLOR_COUNT     64
@@ -198,6 +211,49 @@ void SkComposeShader::ComposeShaderContext::shadeSpan(int x, int y, SkPMColor re
     }
 }
 
+void SkComposeShader::ComposeShaderContext::shadeSpan4f(int x, int y, SkPM4f result[], int count) {
+    SkShader::Context* shaderContextA = fShaderContextA;
+    SkShader::Context* shaderContextB = fShaderContextB;
+    SkXfermode*        mode = static_cast<const SkComposeShader&>(fShader).fMode;
+    float              scale = this->getPaintAlpha() * (1.0f / 255);
+
+#ifdef SK_BUILD_FOR_ANDROID
+    scale = 1;      // match shadeSpan()
+#endif
+
+    SkPM4f  tmp[TMP_COLOR_COUNT];
+
+    do {
+        int n = SkMin32(count, TMP_COLOR_COUNT);
+
+        shaderContextA->shadeSpan4f(x, y, result, n);
+        shaderContextB->shadeSpan4f(x, y, tmp, n);
+
+        if (NULL == mode) {   // implied SRC_OVER
+            for (int i = 0; i < n; i++) {
+                float isa = 1 - tmp[i].a();
+                for (int c = 0; c < 4; c++) {
+                    result[i].fVec[c] = tmp[i].fVec[c] + result[i].fVec[c] * isa;
+                }
+            }
+        } else {
+            mode->xfer4f(result, tmp, n, NULL);
+        }
+
+        if (1 != scale) {
+            for (int i = 0; i < n; i++) {
+                for (int c = 0; c < 4; c++) {
+                    result[i].fVec[c] *= scale;
+                }
+            }
+        }
+
+        result += n;
+        x += n;
+        count -= n;
+    } while (count > 0);
+}
+
 #ifndef SK_IGNORE_TO_STRING
 void SkComposeShader::toString(SkString* str) const {
     str->append("SkComposeShader: (");
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkConvolutionFilterCache.h"
+#include "SkChecksum.h"
+#include "SkThread.h"
+
+#ifndef SK_DEFAULT_CONVOLUTION_FILTER_CACHE_LIMIT
+    #define SK_DEFAULT_CONVOLUTION_FILTER_CACHE_LIMIT   (512 * 1024)
+#endif
+
+struct SkConvolutionFilterCache::Rec {
+    Rec(const Key& key, const SkConvolutionFilter1D& filter)
+        : fKey(key)
+        , fFilter(filter)
+        , fBytesUsed(filter.bytesUsed()) {}
+
+    static const Key& GetKey(const Rec& rec) { return rec.fKey; }
+    static uint32_t Hash(const Key& key) { return key.fHash; }
+    static size_t BytesUsed(const Rec& rec) { return rec.fBytesUsed; }
+    static bool CanPurge(const Rec&) { return true; }
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Rec);
+
+    Key                     fKey;
+    SkConvolutionFilter1D   fFilter;
+    size_t                  fBytesUsed;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkConvolutionFilterCache::ComputeKey(int method, int srcSize, float scale,
+                                          float destSubsetLo, float destSubsetSize,
+                                          bool padded, Key* key) {
+    sk_bzero(key, sizeof(*key));
+    key->fMethod = method;
+    key->fSrcSize = srcSize;
+    key->fScale = scale;
+    key->fDestSubsetLo = destSubsetLo;
+    key->fDestSubsetSize = destSubsetSize;
+    key->fPadded = padded;
+    key->fHash = SkChecksum::Murmur3(&key->fHash + 1,
+                                     sizeof(Key) - sizeof(key->fHash));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkConvolutionFilterCache::SkConvolutionFilterCache(size_t byteLimit) : fCache(byteLimit) {}
+
+SkConvolutionFilterCache::~SkConvolutionFilterCache() {}
+
+bool SkConvolutionFilterCache::find(const Key& key, SkConvolutionFilter1D* filter) {
+    Rec* rec = fCache.find(key);
+    if (NULL == rec) {
+        return false;
+    }
+    *filter = rec->fFilter;
+    return true;
+}
+
+void SkConvolutionFilterCache::add(const Key& key, const SkConvolutionFilter1D& filter) {
+    if (filter.bytesUsed() > fCache.getByteLimit()) {
+        return;     // don't bother copying it
+    }
+    Rec* rec = SkNEW_ARGS(Rec, (key, filter));
+    if (!fCache.add(rec)) {
+        SkDELETE(rec);
+    }
+}
+
+size_t SkConvolutionFilterCache::setByteLimit(size_t newLimit) {
+    return fCache.setByteLimit(newLimit);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+static SkConvolutionFilterCache* gConvolutionFilterCache = NULL;
+static void cleanup_gConvolutionFilterCache() { SkDELETE(gConvolutionFilterCache); }
+
+/** Must hold gMutex when calling. */
+static SkConvolutionFilterCache* get_cache() {
+    // gMutex is always held when this is called, so we don't need to be fancy in here.
+    if (NULL == gConvolutionFilterCache) {
+        gConvolutionFilterCache = SkNEW_ARGS(SkConvolutionFilterCache,
+                                             (SK_DEFAULT_CONVOLUTION_FILTER_CACHE_LIMIT));
+        atexit(cleanup_gConvolutionFilterCache);
+    }
+    return gConvolutionFilterCache;
+}
+
+bool SkConvolutionFilterCache::Find(const Key& key, SkConvolutionFilter1D* filter) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->find(key, filter);
+}
+
+void SkConvolutionFilterCache::Add(const Key& key, const SkConvolutionFilter1D& filter) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->add(key, filter);
+}
+
+size_t SkConvolutionFilterCache::GetBytesUsed() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getBytesUsed();
+}
+
+size_t SkConvolutionFilterCache::GetByteLimit() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getByteLimit();
+}
+
+size_t SkConvolutionFilterCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->setByteLimit(newLimit);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkGraphics.h"
+
+size_t SkGraphics::GetConvolutionFilterCacheBytesUsed() {
+    return SkConvolutionFilterCache::GetBytesUsed();
+}
+
+size_t SkGraphics::GetConvolutionFilterCacheByteLimit() {
+    return SkConvolutionFilterCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetConvolutionFilterCacheByteLimit(size_t newLimit) {
+    return SkConvolutionFilterCache::SetByteLimit(newLimit);
+}
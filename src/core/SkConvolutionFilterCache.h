@@ -0,0 +1,98 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkConvolutionFilterCache_DEFINED
+#define SkConvolutionFilterCache_DEFINED
+
+#include "SkConvolver.h"
+#include "SkTLRUCache.h"
+
+/**
+ *  Cache of the one-dimensional filters that SkBitmapScaler computes for a
+ *  resize, so that resizing to the same size again (tiles of one image, an
+ *  animation at a constant scale, high quality draws of the same bitmap at
+ *  the same scale) does not re-evaluate the filter function for every tap.
+ *
+ *  An entry is keyed by the resize method, the source size, the scale and the
+ *  destination subset along one axis, and whether the filter values were
+ *  padded for SIMD procs. The x and y filters of a resize are separate
+ *  entries, so a square resize finds both in one.
+ *
+ *  Entries are purged least-recently-used first once the byte limit is passed.
+ *  The cache is not thread-safe; the static methods wrap a global instance
+ *  with a mutex.
+ */
+class SkConvolutionFilterCache {
+public:
+    struct Key {
+        uint32_t    fHash;
+        int32_t     fMethod;
+        int32_t     fSrcSize;
+        float       fScale;
+        float       fDestSubsetLo;
+        float       fDestSubsetSize;
+        uint32_t    fPadded;
+
+        bool operator==(const Key& other) const {
+            return 0 == memcmp(this, &other, sizeof(Key));
+        }
+    };
+
+    static void ComputeKey(int method, int srcSize, float scale,
+                           float destSubsetLo, float destSubsetSize,
+                           bool padded, Key* key);
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static bool Find(const Key&, SkConvolutionFilter1D* filter);
+    static void Add(const Key&, const SkConvolutionFilter1D& filter);
+
+    static size_t GetBytesUsed();
+    static size_t GetByteLimit();
+    static size_t SetByteLimit(size_t newLimit);
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    explicit SkConvolutionFilterCache(size_t byteLimit);
+    ~SkConvolutionFilterCache();
+
+    /**
+     *  Search the cache for key. If found, copy its filter into filter and
+     *  return true.
+     */
+    bool find(const Key& key, SkConvolutionFilter1D* filter);
+
+    /**
+     *  Add filter to the cache under key, unless it is already present or the
+     *  filter alone would exceed the byte limit.
+     */
+    void add(const Key& key, const SkConvolutionFilter1D& filter);
+
+    size_t getBytesUsed() const { return fCache.getBytesUsed(); }
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+
+    /**
+     *  Set the maximum number of bytes available to this cache. If the current
+     *  cache exceeds this new value, it will be purged to try to fit within
+     *  this new limit. A limit of 0 disables the cache.
+     */
+    size_t setByteLimit(size_t newLimit);
+
+    int getHitCount() const { return fCache.getHitCount(); }
+    int getMissCount() const { return fCache.getMissCount(); }
+
+public:
+    struct Rec;
+
+private:
+    SkTLRUCache<Rec, Key>   fCache;
+};
+
+#endif
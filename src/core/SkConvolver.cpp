@@ -4,6 +4,7 @@
 
 #include "SkConvolver.h"
 #include "SkSize.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 
 namespace {
@@ -330,132 +331,228 @@ const SkConvolutionFilter1D::ConvolutionFixed* SkConvolutionFilter1D::GetSingleF
     return &fFilterValues[filter.fDataLocation];
 }
 
-void BGRAConvolve2D(const unsigned char* sourceData,
-                    int sourceByteRowStride,
-                    bool sourceHasAlpha,
-                    const SkConvolutionFilter1D& filterX,
-                    const SkConvolutionFilter1D& filterY,
-                    int outputByteRowStride,
-                    unsigned char* output,
-                    const SkConvolutionProcs& convolveProcs,
-                    bool useSimdIfPossible) {
-
-    int maxYFilterSize = filterY.maxFilter();
-
-    // The next row in the input that we will generate a horizontally
-    // convolved row for. If the filter doesn't start at the beginning of the
-    // image (this is the case when we are only resizing a subset), then we
-    // don't want to generate any output rows before that. Compute the starting
-    // row for convolution as the first pixel for the first vertical filter.
-    int filterOffset, filterLength;
-    const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
-        filterY.FilterForValue(0, &filterOffset, &filterLength);
-    int nextXRow = filterOffset;
-
-    // We loop over each row in the input doing a horizontal convolution. This
-    // will result in a horizontally convolved image. We write the results into
-    // a circular buffer of convolved rows and do vertical convolution as rows
-    // are available. This prevents us from having to store the entire
-    // intermediate image and helps cache coherency.
-    // We will need four extra rows to allow horizontal convolution could be done
-    // simultaneously. We also pad each row in row buffer to be aligned-up to
-    // 16 bytes.
-    // TODO(jiesun): We do not use aligned load from row buffer in vertical
-    // convolution pass yet. Somehow Windows does not like it.
-    int rowBufferWidth = (filterX.numValues() + 15) & ~0xF;
-    int rowBufferHeight = maxYFilterSize +
-                          (convolveProcs.fConvolve4RowsHorizontally ? 4 : 0);
-    CircularRowBuffer rowBuffer(rowBufferWidth,
-                                rowBufferHeight,
-                                filterOffset);
-
-    // Loop over every possible output row, processing just enough horizontal
-    // convolutions to run each subsequent vertical convolution.
-    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
-    int numOutputRows = filterY.numValues();
+namespace {
 
-    // We need to check which is the last line to convolve before we advance 4
-    // lines in one iteration.
-    int lastFilterOffset, lastFilterLength;
-
-    // SSE2 can access up to 3 extra pixels past the end of the
-    // buffer. At the bottom of the image, we have to be careful
-    // not to access data past the end of the buffer. Normally
-    // we fall back to the C++ implementation for the last row.
-    // If the last row is less than 3 pixels wide, we may have to fall
-    // back to the C++ version for more rows. Compute how many
-    // rows we need to avoid the SSE implementation for here.
-    filterX.FilterForValue(filterX.numValues() - 1, &lastFilterOffset,
-                           &lastFilterLength);
-    int avoidSimdRows = 1 + convolveProcs.fExtraHorizontalReads /
-        (lastFilterOffset + lastFilterLength);
-
-    filterY.FilterForValue(numOutputRows - 1, &lastFilterOffset,
-                           &lastFilterLength);
-
-    for (int outY = 0; outY < numOutputRows; outY++) {
-        filterValues = filterY.FilterForValue(outY,
-                                              &filterOffset, &filterLength);
-
-        // Generate output rows until we have enough to run the current filter.
-        while (nextXRow < filterOffset + filterLength) {
-            if (convolveProcs.fConvolve4RowsHorizontally &&
-                nextXRow + 3 < lastFilterOffset + lastFilterLength -
-                avoidSimdRows) {
-                const unsigned char* src[4];
-                unsigned char* outRow[4];
-                for (int i = 0; i < 4; ++i) {
-                    src[i] = &sourceData[(nextXRow + i) * sourceByteRowStride];
-                    outRow[i] = rowBuffer.advanceRow();
-                }
-                convolveProcs.fConvolve4RowsHorizontally(src, filterX, outRow);
-                nextXRow += 4;
-            } else {
-                // Check if we need to avoid SSE2 for this row.
-                if (convolveProcs.fConvolveHorizontally &&
-                    nextXRow < lastFilterOffset + lastFilterLength -
+    // Output images with fewer pixels than this aren't worth splitting across
+    // threads.
+    const int kMinBandedPixels = 256 * 256;
+
+    // Each thread gets about this many bands of output rows, so that a thread
+    // which finishes early can pick up another band from a slower one.
+    const int kBandsPerThread = 2;
+
+    // The arguments of BGRAConvolve2D() shared by all of its bands.
+    struct ConvolveArgs {
+        const unsigned char* fSourceData;
+        int fSourceByteRowStride;
+        bool fSourceHasAlpha;
+        const SkConvolutionFilter1D* fFilterX;
+        const SkConvolutionFilter1D* fFilterY;
+        int fOutputByteRowStride;
+        unsigned char* fOutput;
+        const SkConvolutionProcs* fConvolveProcs;
+    };
+
+    // Produces the output rows [startY, endY). Each call has its own circular
+    // buffer of horizontally convolved rows, so calls for different bands of
+    // rows can run at the same time. The input rows a band shares with its
+    // neighbours are convolved horizontally by each of them.
+    void ConvolveRows(const ConvolveArgs& args, int startY, int endY) {
+        const SkConvolutionFilter1D& filterX = *args.fFilterX;
+        const SkConvolutionFilter1D& filterY = *args.fFilterY;
+        const SkConvolutionProcs& convolveProcs = *args.fConvolveProcs;
+        const unsigned char* sourceData = args.fSourceData;
+        const int sourceByteRowStride = args.fSourceByteRowStride;
+        const bool sourceHasAlpha = args.fSourceHasAlpha;
+
+        int maxYFilterSize = filterY.maxFilter();
+
+        // The next row in the input that we will generate a horizontally
+        // convolved row for. If the filter doesn't start at the beginning of the
+        // image (this is the case when we are only resizing a subset, or when
+        // this is not the first band), then we don't want to generate any output
+        // rows before that. Compute the starting row for convolution as the first
+        // pixel for the first vertical filter. Trimming leading zeros can start
+        // a filter later than the ones after it, so take the earliest in the band.
+        int filterOffset, filterLength;
+        const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+            filterY.FilterForValue(startY, &filterOffset, &filterLength);
+        int nextXRow = filterOffset;
+        for (int y = startY + 1; y < endY; y++) {
+            filterY.FilterForValue(y, &filterOffset, &filterLength);
+            if (filterLength > 0) {
+                nextXRow = SkTMin(nextXRow, filterOffset);
+            }
+        }
+        filterOffset = nextXRow;
+
+        // We loop over each row in the input doing a horizontal convolution. This
+        // will result in a horizontally convolved image. We write the results into
+        // a circular buffer of convolved rows and do vertical convolution as rows
+        // are available. This prevents us from having to store the entire
+        // intermediate image and helps cache coherency.
+        // We will need four extra rows to allow horizontal convolution could be done
+        // simultaneously. We also pad each row in row buffer to be aligned-up to
+        // 16 bytes.
+        // TODO(jiesun): We do not use aligned load from row buffer in vertical
+        // convolution pass yet. Somehow Windows does not like it.
+        int rowBufferWidth = (filterX.numValues() + 15) & ~0xF;
+        int rowBufferHeight = maxYFilterSize +
+                              (convolveProcs.fConvolve4RowsHorizontally ? 4 : 0);
+        CircularRowBuffer rowBuffer(rowBufferWidth,
+                                    rowBufferHeight,
+                                    filterOffset);
+
+        // We need to check which is the last line to convolve before we advance 4
+        // lines in one iteration.
+        int lastFilterOffset, lastFilterLength;
+
+        // SSE2 can access up to 3 extra pixels past the end of the
+        // buffer. At the bottom of the image, we have to be careful
+        // not to access data past the end of the buffer. Normally
+        // we fall back to the C++ implementation for the last row.
+        // If the last row is less than 3 pixels wide, we may have to fall
+        // back to the C++ version for more rows. Compute how many
+        // rows we need to avoid the SSE implementation for here.
+        filterX.FilterForValue(filterX.numValues() - 1, &lastFilterOffset,
+                               &lastFilterLength);
+        int avoidSimdRows = 1 + convolveProcs.fExtraHorizontalReads /
+            (lastFilterOffset + lastFilterLength);
+
+        filterY.FilterForValue(filterY.numValues() - 1, &lastFilterOffset,
+                               &lastFilterLength);
+
+        // Loop over every output row in this band, processing just enough
+        // horizontal convolutions to run each subsequent vertical convolution.
+        for (int outY = startY; outY < endY; outY++) {
+            filterValues = filterY.FilterForValue(outY,
+                                                  &filterOffset, &filterLength);
+
+            // Generate output rows until we have enough to run the current filter.
+            while (nextXRow < filterOffset + filterLength) {
+                if (convolveProcs.fConvolve4RowsHorizontally &&
+                    nextXRow + 3 < lastFilterOffset + lastFilterLength -
                     avoidSimdRows) {
-                    convolveProcs.fConvolveHorizontally(
-                        &sourceData[nextXRow * sourceByteRowStride],
-                        filterX, rowBuffer.advanceRow(), sourceHasAlpha);
+                    const unsigned char* src[4];
+                    unsigned char* outRow[4];
+                    for (int i = 0; i < 4; ++i) {
+                        src[i] = &sourceData[(nextXRow + i) * sourceByteRowStride];
+                        outRow[i] = rowBuffer.advanceRow();
+                    }
+                    convolveProcs.fConvolve4RowsHorizontally(src, filterX, outRow);
+                    nextXRow += 4;
                 } else {
-                    if (sourceHasAlpha) {
-                        ConvolveHorizontally<true>(
+                    // Check if we need to avoid SSE2 for this row.
+                    if (convolveProcs.fConvolveHorizontally &&
+                        nextXRow < lastFilterOffset + lastFilterLength -
+                        avoidSimdRows) {
+                        convolveProcs.fConvolveHorizontally(
                             &sourceData[nextXRow * sourceByteRowStride],
-                            filterX, rowBuffer.advanceRow());
+                            filterX, rowBuffer.advanceRow(), sourceHasAlpha);
                     } else {
-                        ConvolveHorizontally<false>(
-                            &sourceData[nextXRow * sourceByteRowStride],
-                            filterX, rowBuffer.advanceRow());
+                        if (sourceHasAlpha) {
+                            ConvolveHorizontally<true>(
+                                &sourceData[nextXRow * sourceByteRowStride],
+                                filterX, rowBuffer.advanceRow());
+                        } else {
+                            ConvolveHorizontally<false>(
+                                &sourceData[nextXRow * sourceByteRowStride],
+                                filterX, rowBuffer.advanceRow());
+                        }
                     }
+                    nextXRow++;
                 }
-                nextXRow++;
             }
-        }
 
-        // Compute where in the output image this row of final data will go.
-        unsigned char* curOutputRow = &output[outY * outputByteRowStride];
+            // Compute where in the output image this row of final data will go.
+            unsigned char* curOutputRow = &args.fOutput[outY * args.fOutputByteRowStride];
 
-        // Get the list of rows that the circular buffer has, in order.
-        int firstRowInCircularBuffer;
-        unsigned char* const* rowsToConvolve =
-            rowBuffer.GetRowAddresses(&firstRowInCircularBuffer);
+            // Get the list of rows that the circular buffer has, in order.
+            int firstRowInCircularBuffer;
+            unsigned char* const* rowsToConvolve =
+                rowBuffer.GetRowAddresses(&firstRowInCircularBuffer);
 
-        // Now compute the start of the subset of those rows that the filter
-        // needs.
-        unsigned char* const* firstRowForFilter =
-            &rowsToConvolve[filterOffset - firstRowInCircularBuffer];
+            // Now compute the start of the subset of those rows that the filter
+            // needs.
+            unsigned char* const* firstRowForFilter =
+                &rowsToConvolve[filterOffset - firstRowInCircularBuffer];
 
-        if (convolveProcs.fConvolveVertically) {
-            convolveProcs.fConvolveVertically(filterValues, filterLength,
-                                               firstRowForFilter,
-                                               filterX.numValues(), curOutputRow,
-                                               sourceHasAlpha);
-        } else {
-            ConvolveVertically(filterValues, filterLength,
-                               firstRowForFilter,
-                               filterX.numValues(), curOutputRow,
-                               sourceHasAlpha);
+            if (convolveProcs.fConvolveVertically) {
+                convolveProcs.fConvolveVertically(filterValues, filterLength,
+                                                   firstRowForFilter,
+                                                   filterX.numValues(), curOutputRow,
+                                                   sourceHasAlpha);
+            } else {
+                ConvolveVertically(filterValues, filterLength,
+                                   firstRowForFilter,
+                                   filterX.numValues(), curOutputRow,
+                                   sourceHasAlpha);
+            }
         }
     }
+
+    class ConvolveBand : public SkRunnable {
+    public:
+        ConvolveBand() : fArgs(NULL), fStartY(0), fEndY(0) {}
+
+        void init(const ConvolveArgs* args, int startY, int endY) {
+            fArgs = args;
+            fStartY = startY;
+            fEndY = endY;
+        }
+
+        virtual void run() SK_OVERRIDE {
+            ConvolveRows(*fArgs, fStartY, fEndY);
+        }
+
+    private:
+        const ConvolveArgs* fArgs;
+        int fStartY;
+        int fEndY;
+    };
+
+}  // namespace
+
+void BGRAConvolve2D(const unsigned char* sourceData,
+                    int sourceByteRowStride,
+                    bool sourceHasAlpha,
+                    const SkConvolutionFilter1D& filterX,
+                    const SkConvolutionFilter1D& filterY,
+                    int outputByteRowStride,
+                    unsigned char* output,
+                    const SkConvolutionProcs& convolveProcs,
+                    bool useSimdIfPossible,
+                    int threads) {
+    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
+
+    ConvolveArgs args;
+    args.fSourceData = sourceData;
+    args.fSourceByteRowStride = sourceByteRowStride;
+    args.fSourceHasAlpha = sourceHasAlpha;
+    args.fFilterX = &filterX;
+    args.fFilterY = &filterY;
+    args.fOutputByteRowStride = outputByteRowStride;
+    args.fOutput = output;
+    args.fConvolveProcs = &convolveProcs;
+
+    int numOutputRows = filterY.numValues();
+    if (threads < 0) {
+        threads = SkTaskGroup::NumCores();
+    }
+    if (threads <= 1 ||
+        (int64_t)filterX.numValues() * numOutputRows < kMinBandedPixels) {
+        ConvolveRows(args, 0, numOutputRows);
+        return;
+    }
+
+    // Every band writes its own output rows, so they need no locking.
+    const int count = SkTMin(threads * kBandsPerThread, numOutputRows);
+    SkAutoTArray<ConvolveBand> bands(count);
+    SkTaskGroup group;
+    for (int i = 0; i < count; i++) {
+        bands[i].init(&args, numOutputRows *  i      / count,
+                             numOutputRows * (i + 1) / count);
+        group.add(&bands[i]);
+    }
+    group.wait();
 }
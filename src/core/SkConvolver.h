@@ -56,6 +56,12 @@ public:
     // output image.
     int numValues() const { return static_cast<int>(fFilters.count()); }
 
+    // Returns roughly how many bytes of memory this filter takes up.
+    size_t bytesUsed() const {
+        return sizeof(*this) + fFilters.count() * sizeof(FilterInstance) +
+               fFilterValues.count() * sizeof(ConvolutionFixed);
+    }
+
     // Appends the given list of scaling values for generating a given output
     // pixel. |filterOffset| is the distance from the edge of the image to where
     // the scaling factors start. The scaling factors apply to the source pixels
@@ -190,6 +196,11 @@ struct SkConvolutionProcs {
 //
 // The layout in memory is assumed to be 4-bytes per pixel in B-G-R-A order
 // (this is ARGB when loaded into 32-bit words on a little-endian machine).
+//
+// |threads| is how many threads' worth of bands to split the output rows into,
+// which then run on the shared SkTaskGroup pool: 0 or 1 (the default) does all
+// the work on the calling thread, and a negative count uses one per core.
+// Small images are always done on the calling thread.
 SK_API void BGRAConvolve2D(const unsigned char* sourceData,
     int sourceByteRowStride,
     bool sourceHasAlpha,
@@ -198,6 +209,7 @@ SK_API void BGRAConvolve2D(const unsigned char* sourceData,
     int outputByteRowStride,
     unsigned char* output,
     const SkConvolutionProcs&,
-    bool useSimdIfPossible);
+    bool useSimdIfPossible,
+    int threads = 1);
 
 #endif  // SK_CONVOLVER_H
@@ -15,6 +15,7 @@
 #include "SkMaskFilter.h"
 #include "SkPaint.h"
 #include "SkPathEffect.h"
+#include "SkPathMaskCache.h"
 #include "SkRasterClip.h"
 #include "SkRasterizer.h"
 #include "SkRRect.h"
@@ -989,6 +990,590 @@ DRAW_PATH:
     this->drawPath(path, paint, NULL, true);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/**
+ *  Draws dashed polylines by blitting each dash directly, instead of having
+ *  SkDashPathEffect build a path with one contour per dash that we then stroke
+ *  and scan convert. Hairline dashes are drawn as hairline segments. Thicker
+ *  dashes along axis-aligned lines are blitted as device rects. The few dashes
+ *  that come near a join are collected in fJoinPath and stroked as usual, so
+ *  their joins match the general case. Dashes outside the clip are skipped
+ *  without being visited one at a time.
+ *
+ *  The walk along each contour matches SkDashPathEffect::filterPath().
+ */
+class DashedLineDrawer {
+public:
+    typedef void (*HairProc)(const SkPoint&, const SkPoint&, const SkRasterClip&, SkBlitter*);
+    typedef void (*RectProc)(const SkRect&, const SkRasterClip&, SkBlitter*);
+
+    DashedLineDrawer(const SkScalar intervals[], int count, SkScalar intervalLength,
+                     SkScalar phase, const SkMatrix& matrix, const SkRasterClip& rc,
+                     SkBlitter* blitter)
+        : fIntervals(intervals)
+        , fCount(count)
+        , fIntervalLength(intervalLength)
+        , fMatrix(matrix)
+        , fRC(rc)
+        , fBlitter(blitter)
+        , fHalfWidth(0)
+        , fCapExtension(0)
+        , fJoinRadius(0)
+        , fHairProc(NULL)
+        , fRectProc(NULL) {
+        fInitialDashIndex = 0;
+        fInitialDashLength = intervals[0];
+        for (int i = 0; i < count; ++i) {
+            if (phase > intervals[i]) {
+                phase -= intervals[i];
+            } else {
+                fInitialDashIndex = i;
+                fInitialDashLength = intervals[i] - phase;
+                break;
+            }
+        }
+    }
+
+    void setHairline(bool doAA) {
+        fHairProc = doAA ? SkScan::AntiHairLine : SkScan::HairLine;
+        fCullOutset = SK_Scalar1;
+    }
+
+    /**
+     *  Draw thick dashes. Dashes whose caps come within joinRadius (in local
+     *  coordinates) of a join are added to the path returned by joinPath().
+     */
+    void setThick(SkScalar width, SkScalar capExtension, SkScalar joinRadius, bool doAA) {
+        fHalfWidth = SkScalarHalf(width);
+        fCapExtension = capExtension;
+        fJoinRadius = joinRadius;
+        if (doAA) {
+            fRectProc = SkScan::AntiFillRect;
+        } else {
+            fRectProc = SkScan::FillRect;
+        }
+        SkVector outset = { fHalfWidth + capExtension, fHalfWidth + capExtension };
+        fMatrix.mapVectors(&outset, 1);
+        fCullOutset = SkMaxScalar(SkScalarAbs(outset.fX), SkScalarAbs(outset.fY)) + SK_Scalar1;
+    }
+
+    const SkPath& joinPath() const { return fJoinPath; }
+
+    /**
+     *  Draw the dashes along pts, in local coordinates. If closed, the last
+     *  point must equal the first.
+     */
+    void drawContour(const SkPoint pts[], int count, bool closed);
+
+private:
+    struct Span {
+        double fStart, fStop;
+    };
+
+    const SkScalar*     fIntervals;
+    int                 fCount;
+    SkScalar            fIntervalLength;
+    int                 fInitialDashIndex;
+    SkScalar            fInitialDashLength;
+
+    const SkMatrix&     fMatrix;
+    const SkRasterClip& fRC;
+    SkBlitter*          fBlitter;
+
+    SkScalar            fHalfWidth;
+    SkScalar            fCapExtension;
+    SkScalar            fJoinRadius;
+    SkScalar            fCullOutset;    // in device pixels
+    HairProc            fHairProc;
+    RectProc            fRectProc;
+    SkPath              fJoinPath;
+
+    // the current contour
+    const SkPoint*      fPts;
+    SkScalar*           fDist;          // distance along the contour to each point
+    int                 fPtCount;
+    bool                fClosed;
+
+    int findSegment(double d) const;
+    SkPoint pointAt(int seg, double d) const;
+    void drawDash(double start, double stop, bool continueContour);
+    bool nearJoin(double start, double stop) const;
+};
+
+static inline bool is_even(int x) {
+    return 0 == (x & 1);
+}
+
+// Returns the first segment whose end is past d (skipping empty segments).
+int DashedLineDrawer::findSegment(double d) const {
+    int seg = 0;
+    while (seg < fPtCount - 2 && !(d < fDist[seg + 1])) {
+        ++seg;
+    }
+    return seg;
+}
+
+SkPoint DashedLineDrawer::pointAt(int seg, double d) const {
+    const SkScalar segStart = fDist[seg];
+    const SkScalar segStop = fDist[seg + 1];
+    if (SkDoubleToScalar(d) >= segStop) {
+        return fPts[seg + 1];
+    }
+    SkScalar t = (SkDoubleToScalar(d) - segStart) / (segStop - segStart);
+    SkPoint pt;
+    pt.set(SkScalarInterp(fPts[seg].fX, fPts[seg + 1].fX, t),
+           SkScalarInterp(fPts[seg].fY, fPts[seg + 1].fY, t));
+    return pt;
+}
+
+// Returns true if the dash from start to stop, with its caps, comes within
+// fJoinRadius of a join.
+bool DashedLineDrawer::nearJoin(double start, double stop) const {
+    const double lo = start - fCapExtension - fJoinRadius;
+    const double hi = stop + fCapExtension + fJoinRadius;
+    const int first = fClosed ? 0 : 1;
+    const int last = fClosed ? fPtCount - 1 : fPtCount - 2;
+    for (int i = first; i <= last; ++i) {
+        if (fDist[i] > lo && fDist[i] < hi) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DashedLineDrawer::drawDash(double start, double stop, bool continueContour) {
+    const SkScalar length = fDist[fPtCount - 1];
+    if (stop > length) {
+        stop = length;
+    }
+    if (start >= stop) {
+        return;
+    }
+
+    int seg = this->findSegment(start);
+
+    if (fRectProc) {
+        if (continueContour || this->nearJoin(start, stop)) {
+            SkPoint pt = this->pointAt(seg, start);
+            if (continueContour) {
+                fJoinPath.lineTo(pt);
+            } else {
+                fJoinPath.moveTo(pt);
+            }
+            while (seg < fPtCount - 2 && stop > fDist[seg + 1]) {
+                ++seg;
+                fJoinPath.lineTo(fPts[seg]);
+            }
+            fJoinPath.lineTo(this->pointAt(seg, stop));
+            return;
+        }
+
+        // The whole dash is on one axis-aligned segment.
+        SkPoint p0 = this->pointAt(seg, start);
+        SkPoint p1 = this->pointAt(seg, stop);
+        SkRect r;
+        r.set(p0, p1);
+        if (fPts[seg].fY == fPts[seg + 1].fY) {
+            r.outset(fCapExtension, fHalfWidth);
+        } else {
+            r.outset(fHalfWidth, fCapExtension);
+        }
+        SkRect devRect;
+        fMatrix.mapRect(&devRect, r);
+        fRectProc(devRect, fRC, fBlitter);
+        return;
+    }
+
+    SkPoint devPts[2];
+    devPts[0] = this->pointAt(seg, start);
+    while (seg < fPtCount - 2 && stop > fDist[seg + 1]) {
+        devPts[1] = fPts[seg + 1];
+        fMatrix.mapPoints(devPts, 2);
+        fHairProc(devPts[0], devPts[1], fRC, fBlitter);
+        ++seg;
+        devPts[0] = fPts[seg];
+    }
+    devPts[1] = this->pointAt(seg, stop);
+    fMatrix.mapPoints(devPts, 2);
+    fHairProc(devPts[0], devPts[1], fRC, fBlitter);
+}
+
+// Sets [t0, t1] to the part of the line from p0 to p1 inside bounds, and
+// returns false if the line misses bounds.
+static bool clip_line_to_rect(const SkPoint& p0, const SkPoint& p1, const SkRect& bounds,
+                              double* t0, double* t1) {
+    const double dx = (double)p1.fX - p0.fX;
+    const double dy = (double)p1.fY - p0.fY;
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] = {
+        (double)p0.fX - bounds.fLeft, (double)bounds.fRight - p0.fX,
+        (double)p0.fY - bounds.fTop, (double)bounds.fBottom - p0.fY,
+    };
+    double lo = 0, hi = 1;
+    for (int i = 0; i < 4; ++i) {
+        if (0 == p[i]) {
+            if (q[i] < 0) {
+                return false;
+            }
+        } else {
+            double r = q[i] / p[i];
+            if (p[i] < 0) {
+                lo = SkTMax(lo, r);
+            } else {
+                hi = SkTMin(hi, r);
+            }
+        }
+    }
+    *t0 = lo;
+    *t1 = hi;
+    return lo <= hi;
+}
+
+void DashedLineDrawer::drawContour(const SkPoint pts[], int count, bool closed) {
+    SkAutoSTMalloc<32, SkScalar> dist(count);
+    dist[0] = 0;
+    for (int i = 1; i < count; ++i) {
+        dist[i] = dist[i - 1] + SkPoint::Distance(pts[i - 1], pts[i]);
+    }
+    const SkScalar length = dist[count - 1];
+    if (!(length > 0)) {
+        return;
+    }
+
+    fPts = pts;
+    fDist = dist.get();
+    fPtCount = count;
+    fClosed = closed;
+
+    // Find the parts of the contour that can touch the clip.
+    SkRect bounds = SkRect::Make(fRC.getBounds());
+    bounds.outset(fCullOutset, fCullOutset);
+    SkAutoSTMalloc<32, Span> visible(count);
+    int visibleCount = 0;
+    for (int i = 0; i < count - 1; ++i) {
+        SkPoint devPts[2] = { pts[i], pts[i + 1] };
+        fMatrix.mapPoints(devPts, 2);
+        double t0, t1;
+        if (dist[i + 1] > dist[i] && clip_line_to_rect(devPts[0], devPts[1], bounds, &t0, &t1)) {
+            const double segLength = (double)dist[i + 1] - dist[i];
+            const double start = dist[i] + t0 * segLength;
+            const double stop = dist[i] + t1 * segLength;
+            if (visibleCount > 0 && start <= visible[visibleCount - 1].fStop) {
+                visible[visibleCount - 1].fStop = stop;
+            } else {
+                visible[visibleCount].fStart = start;
+                visible[visibleCount].fStop = stop;
+                visibleCount += 1;
+            }
+        }
+    }
+
+    bool        skipFirstSegment = closed;
+    bool        addedSegment = false;
+    int         index = fInitialDashIndex;
+    double      distance = 0;
+    double      dlen = fInitialDashLength;
+    int         span = 0;
+
+    while (distance < length) {
+        while (span < visibleCount && distance >= visible[span].fStop) {
+            span += 1;
+        }
+        if (span == visibleCount) {
+            addedSegment = false;
+            break;
+        }
+
+        addedSegment = false;
+        if (distance + dlen >= visible[span].fStart) {
+            if (is_even(index) && dlen > 0 && !skipFirstSegment) {
+                addedSegment = true;
+                this->drawDash(distance, distance + dlen, false);
+            }
+        }
+        distance += dlen;
+
+        // clear this so we only respect it the first time around
+        skipFirstSegment = false;
+
+        index += 1;
+        if (index == fCount) {
+            index = 0;
+        }
+        dlen = fIntervals[index];
+
+        // Jump whole periods of the pattern to reach the next visible span.
+        if (distance < visible[span].fStart) {
+            distance += floor((visible[span].fStart - distance) / fIntervalLength) *
+                        fIntervalLength;
+        }
+    }
+
+    // extend if we ended on a segment and we need to join up with the (skipped) initial segment
+    if (closed && is_even(fInitialDashIndex) && fInitialDashLength > 0) {
+        this->drawDash(0, fInitialDashLength, addedSegment && fRectProc);
+    }
+}
+
+}  // namespace
+
+bool SkDraw::drawDashedLines(const SkPath& path, const SkPaint& paint,
+                             bool drawCoverage) const {
+    SkPathEffect* pe = paint.getPathEffect();
+    if (NULL == pe || paint.getMaskFilter() || paint.getRasterizer() ||
+            SkPaint::kStroke_Style != paint.getStyle() || path.isInverseFillType() ||
+            SkPath::kLine_SegmentMask != path.getSegmentMasks() || fMatrix->hasPerspective()) {
+        return false;
+    }
+
+    SkPathEffect::DashInfo info;
+    if (SkPathEffect::kDash_DashType != pe->asADash(&info)) {
+        return false;
+    }
+    SkAutoSTMalloc<8, SkScalar> intervals(info.fCount);
+    info.fIntervals = intervals.get();
+    pe->asADash(&info);
+
+    // Leave bad dashes to SkDashPathEffect, which draws them undashed.
+    if (info.fCount < 2 || !is_even(info.fCount)) {
+        return false;
+    }
+    SkScalar intervalLength = 0;
+    SkScalar minOff = SK_ScalarMax;
+    for (int i = 0; i < info.fCount; ++i) {
+        if (intervals[i] < 0) {
+            return false;
+        }
+        intervalLength += intervals[i];
+        if (!is_even(i)) {
+            minOff = SkMinScalar(minOff, intervals[i]);
+        }
+    }
+    if (!(intervalLength > 0) || !SkScalarIsFinite(intervalLength) ||
+            !(info.fPhase >= 0 && info.fPhase < intervalLength)) {
+        return false;
+    }
+
+    // Collect the contours. The last point of a closed contour repeats its first.
+    SkTDArray<SkPoint> pts;
+    SkTDArray<int> contourEnds;     // one past the last point of each contour
+    SkTDArray<bool> contourClosed;
+    {
+        SkPath::RawIter iter(path);
+        SkPoint verbPts[4];
+        SkPath::Verb verb;
+        int contourStart = 0;
+        while ((verb = iter.next(verbPts)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kMove_Verb:
+                    if (pts.count() - contourStart > 1) {
+                        *contourEnds.append() = pts.count();
+                        *contourClosed.append() = false;
+                    } else {
+                        pts.setCount(contourStart);
+                    }
+                    contourStart = pts.count();
+                    *pts.append() = verbPts[0];
+                    break;
+                case SkPath::kLine_Verb:
+                    *pts.append() = verbPts[1];
+                    break;
+                case SkPath::kClose_Verb:
+                    if (pts.count() - contourStart > 1) {
+                        if (pts.top() != pts[contourStart]) {
+                            *pts.append() = pts[contourStart];
+                        }
+                        *contourEnds.append() = pts.count();
+                        *contourClosed.append() = true;
+                    } else {
+                        pts.setCount(contourStart);
+                    }
+                    contourStart = pts.count();
+                    break;
+                default:
+                    return false;
+            }
+        }
+        if (pts.count() - contourStart > 1) {
+            *contourEnds.append() = pts.count();
+            *contourClosed.append() = false;
+        }
+    }
+    if (contourEnds.isEmpty()) {
+        return false;
+    }
+
+    // SkDashPathEffect gives up on paths with too many dashes (see its
+    // kMaxDashCount), so leave those to it as well.
+    {
+        SkScalar length = 0;
+        for (int i = 1; i < pts.count(); ++i) {
+            length += SkPoint::Distance(pts[i - 1], pts[i]);
+        }
+        if (!(length * (info.fCount >> 1) / intervalLength <= 1000000)) {
+            return false;
+        }
+    }
+
+    const SkScalar width = paint.getStrokeWidth();
+    const bool doAA = paint.isAntiAlias();
+    SkAutoBlitterChoose blitter(*fBitmap, *fMatrix, paint, drawCoverage);
+    DashedLineDrawer drawer(intervals.get(), info.fCount, intervalLength, info.fPhase,
+                            *fMatrix, *fRC, blitter.get());
+
+    if (0 == width) {
+        drawer.setHairline(doAA);
+    } else {
+        // Thick dashes are blitted as rects, which must not overlap one another
+        // since each would blend on its own: so we take a single line, or the
+        // outline of a rect whose sides are far enough apart, with butt or
+        // square caps and gaps between dashes.
+        SkScalar capExtension;
+        switch (paint.getStrokeCap()) {
+            case SkPaint::kButt_Cap:
+                capExtension = 0;
+                break;
+            case SkPaint::kSquare_Cap:
+                capExtension = SkScalarHalf(width);
+                break;
+            default:
+                return false;
+        }
+        if (!fMatrix->rectStaysRect() || 1 != contourEnds.count()) {
+            return false;
+        }
+        for (int i = 1; i < pts.count(); ++i) {
+            if (pts[i - 1].fX != pts[i].fX && pts[i - 1].fY != pts[i].fY) {
+                return false;
+            }
+        }
+
+        SkVector scale[2] = { { SK_Scalar1, 0 }, { 0, SK_Scalar1 } };
+        fMatrix->mapVectors(scale, 2);
+        const SkScalar minScale = SkMinScalar(scale[0].length(), scale[1].length());
+        if (!(minScale > 0)) {
+            return false;
+        }
+        // one device pixel of slack, in local units
+        const SkScalar slack = SkScalarInvert(minScale);
+        if ((minOff - 2 * capExtension) * minScale < (doAA ? SK_Scalar1 : 0)) {
+            return false;
+        }
+
+        SkPoint line[2];
+        bool isClosed;
+        if (!contourClosed[0] && path.isLine(line)) {
+            // no joins
+        } else if (contourClosed[0] && path.isRect(&isClosed, NULL) && isClosed) {
+            const SkRect& bounds = path.getBounds();
+            if (SkMinScalar(bounds.width(), bounds.height()) <
+                    width + 2 * capExtension + 2 * slack) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+        drawer.setThick(width, capExtension, SkScalarHalf(width) + slack, doAA);
+    }
+
+    int start = 0;
+    for (int i = 0; i < contourEnds.count(); ++i) {
+        drawer.drawContour(&pts[start], contourEnds[i] - start, contourClosed[i]);
+        start = contourEnds[i];
+    }
+
+    // Stroke the dashes that cross or come near a join as one path, so their
+    // joins and any overlap come out as they would without this fast path.
+    if (!drawer.joinPath().isEmpty()) {
+        SkStrokeRec rec(paint);
+        SkPath strokedPath;
+        rec.applyToPath(&strokedPath, drawer.joinPath());
+        strokedPath.transform(*fMatrix);
+        if (doAA) {
+            SkScan::AntiFillPath(strokedPath, *fRC, blitter.get());
+        } else {
+            SkScan::FillPath(strokedPath, *fRC, blitter.get());
+        }
+    }
+    return true;
+}
+
+bool SkDraw::drawCachedPathMask(const SkPath& path, const SkPaint& paint,
+                                const SkMatrix& matrix) const {
+    SkPathMaskCache* cache = fPathMaskCache;
+    if (0 == (cache ? cache->getByteLimit() : SkPathMaskCache::GetByteLimit())) {
+        return false;
+    }
+
+    SkPathMaskCache::Key key;
+    SkIPoint offset;
+    if (!SkPathMaskCache::ComputeKey(path, paint, matrix, &key, &offset)) {
+        return false;
+    }
+
+    // Our own cache is only ours to use, so it needs no locking.
+    SkMask mask;
+    SkPathMaskCache::ID* id = cache ? cache->findAndLock(key, &mask)
+                                    : SkPathMaskCache::FindAndLock(key, &mask);
+    if (NULL == id) {
+        // Render the whole path, unclipped, with the integer part of the
+        // translation removed so the mask can be reused at other offsets.
+        SkMatrix maskMatrix(matrix);
+        maskMatrix.postTranslate(-SkIntToScalar(offset.fX), -SkIntToScalar(offset.fY));
+
+        SkPath fillPath;
+        const SkPath* srcPtr = &path;
+        if (SkPaint::kFill_Style != paint.getStyle()) {
+            paint.getFillPath(path, &fillPath);
+            srcPtr = &fillPath;
+        }
+        SkPath devPath;
+        srcPtr->transform(maskMatrix, &devPath);
+
+        devPath.getBounds().roundOut(&mask.fBounds);
+        if (mask.fBounds.isEmpty()) {
+            return false;
+        }
+        mask.fFormat = SkMask::kA8_Format;
+        mask.fRowBytes = mask.fBounds.width();
+        size_t size = mask.computeImageSize();
+        if (0 == size) {
+            return false;
+        }
+        mask.fImage = SkMask::AllocImage(size);
+        memset(mask.fImage, 0, size);
+
+        SkBitmap bm;
+        bm.installPixels(SkImageInfo::MakeA8(mask.fBounds.width(), mask.fBounds.height()),
+                         mask.fImage, mask.fRowBytes);
+        SkRasterClip clip(SkIRect::MakeWH(mask.fBounds.width(), mask.fBounds.height()));
+        SkMatrix identity;
+        identity.reset();
+        SkPaint coveragePaint;
+        coveragePaint.setAntiAlias(true);
+        SkAutoBlitterChoose blitter(bm, identity, coveragePaint, true);
+
+        devPath.offset(-SkIntToScalar(mask.fBounds.fLeft), -SkIntToScalar(mask.fBounds.fTop));
+        SkScan::AntiFillPath(devPath, clip, blitter.get());
+
+        id = cache ? cache->addAndLock(key, mask) : SkPathMaskCache::AddAndLock(key, &mask);
+    }
+
+    mask.fBounds.offset(offset.fX, offset.fY);
+    this->drawDevMask(mask, paint);
+    if (NULL == id) {
+        SkMask::FreeImage(mask.fImage);     // too big to cache
+    } else if (cache) {
+        cache->unlock(id);
+    } else {
+        SkPathMaskCache::Unlock(id);
+    }
+    return true;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage) const {
@@ -1050,6 +1635,19 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         }
     }
 
+    if (paint->getPathEffect()) {
+        // The path effect has already forced any prePathMatrix into pathPtr.
+        SkASSERT(matrix == fMatrix);
+        if (this->drawDashedLines(*pathPtr, *paint, drawCoverage)) {
+            return;
+        }
+    }
+
+    if (!drawCoverage && pathPtr == &origSrcPath &&
+            this->drawCachedPathMask(*pathPtr, *paint, *matrix)) {
+        return;
+    }
+
     if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
         SkRect cullRect;
         const SkRect* cullRectPtr = NULL;
@@ -2454,7 +3052,14 @@ static void draw_into_mask(const SkMask& mask, const SkPath& devPath,
     draw.fMatrix    = &matrix;
     paint.setAntiAlias(true);
     paint.setStyle(style);
-    draw.drawPath(devPath, paint);
+    if (SkPaint::kFill_Style == style) {
+        // The mask starts out cleared and each pixel of a fill is blitted
+        // once, so coverage gives the same result. It also keeps these
+        // temporary device-space paths out of the path mask cache.
+        draw.drawPathCoverage(devPath, paint);
+    } else {
+        draw.drawPath(devPath, paint);
+    }
 }
 
 bool SkDraw::DrawToMask(const SkPath& devPath, const SkIRect* clipBounds,
@@ -18,7 +18,7 @@ template <typename T> static T* typedAllocThrow(SkChunkAlloc& alloc) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SkEdgeBuilder::SkEdgeBuilder() : fAlloc(16*1024) {
+SkEdgeBuilder::SkEdgeBuilder() : fAlloc(fScratch->fAlloc), fList(fScratch->fList) {
     fEdgeList = NULL;
 }
 
@@ -163,8 +163,8 @@ static void handle_quad(SkEdgeBuilder* builder, const SkPoint pts[3]) {
 
 int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip,
                          int shiftUp) {
-    fAlloc.reset();
-    fList.reset();
+    fAlloc.rewind();
+    fList.rewind();
     fShiftUp = shiftUp;
 
     SkScalar conicTol = SK_ScalarHalf * (1 << shiftUp);
@@ -10,6 +10,7 @@
 
 #include "SkChunkAlloc.h"
 #include "SkRect.h"
+#include "SkScanScratch.h"
 #include "SkTDArray.h"
 
 struct SkEdge;
@@ -27,8 +28,10 @@ public:
     SkEdge** edgeList() { return fEdgeList; }
 
 private:
-    SkChunkAlloc        fAlloc;
-    SkTDArray<SkEdge*>  fList;
+    // Our edges live in the calling thread's scratch, reused from one build to the next.
+    SkAutoEdgeScratch   fScratch;
+    SkChunkAlloc&       fAlloc;
+    SkTDArray<SkEdge*>& fList;
 
     /*
      *  If we're in general mode, we allcoate the pointers in fList, and this
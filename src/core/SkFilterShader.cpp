@@ -52,6 +52,10 @@ uint32_t SkFilterShader::FilterShaderContext::getFlags() const {
     if (!(filterF & SkColorFilter::kAlphaUnchanged_Flag)) {
         shaderF &= ~(SkShader::kOpaqueAlpha_Flag | SkShader::kHasSpan16_Flag);
     }
+    // we can only stay in float if the filter can
+    if (!(filterF & SkColorFilter::kSupports4f_Flag)) {
+        shaderF &= ~SkShader::kSupports4f_Flag;
+    }
     return shaderF;
 }
 
@@ -85,6 +89,13 @@ void SkFilterShader::FilterShaderContext::shadeSpan(int x, int y, SkPMColor resu
     filterShader.fFilter->filterSpan(result, count, result);
 }
 
+void SkFilterShader::FilterShaderContext::shadeSpan4f(int x, int y, SkPM4f result[], int count) {
+    const SkFilterShader& filterShader = static_cast<const SkFilterShader&>(fShader);
+
+    fShaderContext->shadeSpan4f(x, y, result, count);
+    filterShader.fFilter->filterSpan4f(result, count, result);
+}
+
 void SkFilterShader::FilterShaderContext::shadeSpan16(int x, int y, uint16_t result[], int count) {
     const SkFilterShader& filterShader = static_cast<const SkFilterShader&>(fShader);
 
@@ -29,6 +29,7 @@ public:
 
         virtual void shadeSpan(int x, int y, SkPMColor[], int count) SK_OVERRIDE;
         virtual void shadeSpan16(int x, int y, uint16_t[], int count) SK_OVERRIDE;
+        virtual void shadeSpan4f(int x, int y, SkPM4f[], int count) SK_OVERRIDE;
 
     private:
         SkShader::Context* fShaderContext;
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradientCache.h"
+#include "SkChecksum.h"
+#include "SkTemplates.h"
+#include "SkThread.h"
+
+#ifndef SK_DEFAULT_GRADIENT_CACHE_LIMIT
+    #define SK_DEFAULT_GRADIENT_CACHE_LIMIT     (1024 * 1024)
+#endif
+
+struct SkGradientCache::Rec {
+    Rec(const Key& key, SkRefCnt* value, size_t bytes)
+        : fData(key.fCount)
+        , fKey(key)
+        , fValue(SkRef(value))
+        , fBytesUsed(bytes) {
+        memcpy(fData.get(), key.fData, key.fCount * sizeof(uint32_t));
+        fKey.fData = fData.get();
+    }
+
+    ~Rec() {
+        fValue->unref();
+    }
+
+    static const Key& GetKey(const Rec& rec) { return rec.fKey; }
+    static uint32_t Hash(const Key& key) { return key.fHash; }
+    static size_t BytesUsed(const Rec& rec) { return rec.fBytesUsed; }
+    static bool CanPurge(const Rec&) { return true; }
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Rec);
+
+    SkAutoTMalloc<uint32_t> fData;
+    Key                     fKey;   // points at our copy in fData
+    SkRefCnt*               fValue;
+    size_t                  fBytesUsed;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkGradientCache::Key::Key(const uint32_t data[], int count)
+    : fHash(SkChecksum::Murmur3(data, count * sizeof(uint32_t)))
+    , fCount(count)
+    , fData(data) {}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkGradientCache::SkGradientCache(size_t byteLimit) : fCache(byteLimit) {}
+
+SkGradientCache::~SkGradientCache() {}
+
+SkRefCnt* SkGradientCache::findAndRef(const Key& key) {
+    Rec* rec = fCache.find(key);
+    return rec ? SkRef(rec->fValue) : NULL;
+}
+
+void SkGradientCache::add(const Key& key, SkRefCnt* value, size_t bytes) {
+    if (bytes > fCache.getByteLimit()) {
+        return;     // don't bother copying the key
+    }
+    Rec* rec = SkNEW_ARGS(Rec, (key, value, bytes));
+    if (!fCache.add(rec)) {
+        SkDELETE(rec);
+    }
+}
+
+size_t SkGradientCache::setByteLimit(size_t newLimit) {
+    return fCache.setByteLimit(newLimit);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+static SkGradientCache* gGradientCache = NULL;
+static void cleanup_gGradientCache() { SkDELETE(gGradientCache); }
+
+/** Must hold gMutex when calling. */
+static SkGradientCache* get_cache() {
+    // gMutex is always held when this is called, so we don't need to be fancy in here.
+    if (NULL == gGradientCache) {
+        gGradientCache = SkNEW_ARGS(SkGradientCache, (SK_DEFAULT_GRADIENT_CACHE_LIMIT));
+        atexit(cleanup_gGradientCache);
+    }
+    return gGradientCache;
+}
+
+SkRefCnt* SkGradientCache::FindAndRef(const Key& key) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->findAndRef(key);
+}
+
+void SkGradientCache::Add(const Key& key, SkRefCnt* value, size_t bytes) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->add(key, value, bytes);
+}
+
+size_t SkGradientCache::GetBytesUsed() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getBytesUsed();
+}
+
+size_t SkGradientCache::GetByteLimit() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getByteLimit();
+}
+
+size_t SkGradientCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->setByteLimit(newLimit);
+}
+
+int SkGradientCache::GetHitCount() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getHitCount();
+}
+
+int SkGradientCache::GetMissCount() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getMissCount();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkGraphics.h"
+
+size_t SkGraphics::GetGradientCacheBytesUsed() {
+    return SkGradientCache::GetBytesUsed();
+}
+
+size_t SkGraphics::GetGradientCacheByteLimit() {
+    return SkGradientCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetGradientCacheByteLimit(size_t newLimit) {
+    return SkGradientCache::SetByteLimit(newLimit);
+}
+
+int SkGraphics::GetGradientCacheHitCount() {
+    return SkGradientCache::GetHitCount();
+}
+
+int SkGraphics::GetGradientCacheMissCount() {
+    return SkGradientCache::GetMissCount();
+}
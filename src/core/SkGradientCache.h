@@ -0,0 +1,101 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradientCache_DEFINED
+#define SkGradientCache_DEFINED
+
+#include "SkRefCnt.h"
+#include "SkTLRUCache.h"
+
+/**
+ *  Process-wide cache of the color lookup tables that gradient shaders build,
+ *  so that creating the same gradient many times (e.g. the same CSS gradient
+ *  on every row of a list) builds its tables once. Every gradient type, and
+ *  the texture the GPU backend uploads from the table, shares an entry.
+ *
+ *  An entry is keyed by an array of words that the gradient fills in from its
+ *  colors, positions, flags and paint alpha. The cached value is an opaque
+ *  SkRefCnt (the gradient's table holder) that the cache holds a ref on, with
+ *  the number of bytes it costs when fully built.
+ *
+ *  Entries are purged least-recently-used first once the byte limit is passed.
+ *  The cache is not thread-safe; the static methods wrap a global instance
+ *  with a mutex. The cached values must be safe to share across threads.
+ */
+class SkGradientCache {
+public:
+    struct Key {
+        /**
+         *  The key does not copy data, which must outlive it. count is the
+         *  number of words in data.
+         */
+        Key(const uint32_t data[], int count);
+
+        uint32_t        fHash;
+        int             fCount;
+        const uint32_t* fData;
+
+        bool operator==(const Key& other) const {
+            return fHash == other.fHash && fCount == other.fCount &&
+                   0 == memcmp(fData, other.fData, fCount * sizeof(uint32_t));
+        }
+    };
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static SkRefCnt* FindAndRef(const Key&);
+    static void Add(const Key&, SkRefCnt* value, size_t bytes);
+
+    static size_t GetBytesUsed();
+    static size_t GetByteLimit();
+    static size_t SetByteLimit(size_t newLimit);
+
+    static int GetHitCount();
+    static int GetMissCount();
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    explicit SkGradientCache(size_t byteLimit);
+    ~SkGradientCache();
+
+    /**
+     *  Search the cache for key. If found, return its value with an extra ref
+     *  that the caller must unref. If not, return NULL.
+     */
+    SkRefCnt* findAndRef(const Key& key);
+
+    /**
+     *  Add value to the cache under key, with its cost in bytes, unless the
+     *  key is already present or bytes alone would exceed the byte limit. The
+     *  cache copies the key's data and refs value.
+     */
+    void add(const Key& key, SkRefCnt* value, size_t bytes);
+
+    size_t getBytesUsed() const { return fCache.getBytesUsed(); }
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+
+    /**
+     *  Set the maximum number of bytes available to this cache. If the current
+     *  cache exceeds this new value, it will be purged to try to fit within
+     *  this new limit. A limit of 0 disables the cache.
+     */
+    size_t setByteLimit(size_t newLimit);
+
+    int getHitCount() const { return fCache.getHitCount(); }
+    int getMissCount() const { return fCache.getMissCount(); }
+
+public:
+    struct Rec;
+
+private:
+    SkTLRUCache<Rec, Key>   fCache;
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include "SkPixelRef.h"
 #include "SkRefCnt.h"
 #include "SkRTConf.h"
+#include "SkScan.h"
 #include "SkScalerContext.h"
 #include "SkShader.h"
 #include "SkStream.h"
@@ -133,15 +134,47 @@ void SkGraphics::Term() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool SkGraphics::GetAnalyticAA() {
+    return SkScan::GetAnalyticAA();
+}
+
+bool SkGraphics::SetAnalyticAA(bool analytic) {
+    bool prev = SkScan::GetAnalyticAA();
+    SkScan::SetAnalyticAA(analytic);
+    return prev;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 static const char kFontCacheLimitStr[] = "font-cache-limit";
 static const size_t kFontCacheLimitLen = sizeof(kFontCacheLimitStr) - 1;
+static const char kAnalyticAAStr[] = "analytic-aa";
+static const size_t kAnalyticAALen = sizeof(kAnalyticAAStr) - 1;
+static const char kPathMaskCacheLimitStr[] = "path-mask-cache-limit";
+static const size_t kPathMaskCacheLimitLen = sizeof(kPathMaskCacheLimitStr) - 1;
+static const char kStrokeCacheLimitStr[] = "stroke-cache-limit";
+static const size_t kStrokeCacheLimitLen = sizeof(kStrokeCacheLimitStr) - 1;
+static const char kConvolutionFilterCacheLimitStr[] = "convolution-filter-cache-limit";
+static const size_t kConvolutionFilterCacheLimitLen = sizeof(kConvolutionFilterCacheLimitStr) - 1;
+static const char kGradientCacheLimitStr[] = "gradient-cache-limit";
+static const size_t kGradientCacheLimitLen = sizeof(kGradientCacheLimitStr) - 1;
+
+static size_t set_analytic_aa(size_t analytic) {
+    return SkGraphics::SetAnalyticAA(0 != analytic);
+}
 
 static const struct {
     const char* fStr;
     size_t fLen;
     size_t (*fFunc)(size_t);
 } gFlags[] = {
-    { kFontCacheLimitStr, kFontCacheLimitLen, SkGraphics::SetFontCacheLimit }
+    { kFontCacheLimitStr, kFontCacheLimitLen, SkGraphics::SetFontCacheLimit },
+    { kAnalyticAAStr,     kAnalyticAALen,     set_analytic_aa },
+    { kPathMaskCacheLimitStr, kPathMaskCacheLimitLen, SkGraphics::SetPathMaskCacheByteLimit },
+    { kStrokeCacheLimitStr,   kStrokeCacheLimitLen,   SkGraphics::SetStrokeCacheByteLimit },
+    { kConvolutionFilterCacheLimitStr, kConvolutionFilterCacheLimitLen,
+      SkGraphics::SetConvolutionFilterCacheByteLimit },
+    { kGradientCacheLimitStr, kGradientCacheLimitLen, SkGraphics::SetGradientCacheByteLimit },
 };
 
 /* flags are of the form param; or param=value; */
@@ -8,33 +8,25 @@
 #include "SkMipMap.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
+#include "SkMipMap_opts.h"
 
-static void downsampleby2_proc32(SkBitmap* dst, int x, int y,
-                                 const SkBitmap& src) {
-    x <<= 1;
-    y <<= 1;
-    const SkPMColor* p = src.getAddr32(x, y);
-    const SkPMColor* baseP = p;
-    SkPMColor c, ag, rb;
+static void downsample_row_32(void* dst, const void* src0, const void* src1, int count) {
+    const uint32_t* p0 = static_cast<const uint32_t*>(src0);
+    const uint32_t* p1 = static_cast<const uint32_t*>(src1);
+    uint32_t* d = static_cast<uint32_t*>(dst);
 
-    c = *p; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
-    if (x < src.width() - 1) {
-        p += 1;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+    for (int i = 0; i < count; ++i) {
+        uint32_t c, ag, rb;
 
-    p = baseP;
-    if (y < src.height() - 1) {
-        p += src.rowBytes() >> 2;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-    if (x < src.width() - 1) {
-        p += 1;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p0[0]; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
+        c = p0[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[0]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
 
-    *dst->getAddr32(x >> 1, y >> 1) =
-    ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        d[i] = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        p0 += 2;
+        p1 += 2;
+    }
 }
 
 static inline uint32_t expand16(U16CPU c) {
@@ -47,31 +39,17 @@ static inline U16CPU pack16(uint32_t c) {
     return (c & ~SK_G16_MASK_IN_PLACE) | ((c >> 16) & SK_G16_MASK_IN_PLACE);
 }
 
-static void downsampleby2_proc16(SkBitmap* dst, int x, int y,
-                                 const SkBitmap& src) {
-    x <<= 1;
-    y <<= 1;
-    const uint16_t* p = src.getAddr16(x, y);
-    const uint16_t* baseP = p;
-    SkPMColor       c;
-
-    c = expand16(*p);
-    if (x < src.width() - 1) {
-        p += 1;
-    }
-    c += expand16(*p);
+static void downsample_row_565(void* dst, const void* src0, const void* src1, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(src0);
+    const uint16_t* p1 = static_cast<const uint16_t*>(src1);
+    uint16_t* d = static_cast<uint16_t*>(dst);
 
-    p = baseP;
-    if (y < src.height() - 1) {
-        p += src.rowBytes() >> 1;
-    }
-    c += expand16(*p);
-    if (x < src.width() - 1) {
-        p += 1;
+    for (int i = 0; i < count; ++i) {
+        uint32_t c = expand16(p0[0]) + expand16(p0[1]) + expand16(p1[0]) + expand16(p1[1]);
+        d[i] = (uint16_t)pack16(c >> 2);
+        p0 += 2;
+        p1 += 2;
     }
-    c += expand16(*p);
-
-    *dst->getAddr16(x >> 1, y >> 1) = (uint16_t)pack16(c >> 2);
 }
 
 static uint32_t expand4444(U16CPU c) {
@@ -82,31 +60,73 @@ static U16CPU collaps4444(uint32_t c) {
     return (c & 0xF0F) | ((c >> 12) & ~0xF0F);
 }
 
-static void downsampleby2_proc4444(SkBitmap* dst, int x, int y,
-                                   const SkBitmap& src) {
-    x <<= 1;
-    y <<= 1;
-    const uint16_t* p = src.getAddr16(x, y);
-    const uint16_t* baseP = p;
-    uint32_t        c;
-
-    c = expand4444(*p);
-    if (x < src.width() - 1) {
-        p += 1;
+static void downsample_row_4444(void* dst, const void* src0, const void* src1, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(src0);
+    const uint16_t* p1 = static_cast<const uint16_t*>(src1);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t c = expand4444(p0[0]) + expand4444(p0[1]) +
+                     expand4444(p1[0]) + expand4444(p1[1]);
+        d[i] = (uint16_t)collaps4444(c >> 2);
+        p0 += 2;
+        p1 += 2;
     }
-    c += expand4444(*p);
+}
 
-    p = baseP;
-    if (y < src.height() - 1) {
-        p += src.rowBytes() >> 1;
+static void downsample_row_A8(void* dst, const void* src0, const void* src1, int count) {
+    const uint8_t* p0 = static_cast<const uint8_t*>(src0);
+    const uint8_t* p1 = static_cast<const uint8_t*>(src1);
+    uint8_t* d = static_cast<uint8_t*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        d[i] = (p0[0] + p0[1] + p1[0] + p1[1]) >> 2;
+        p0 += 2;
+        p1 += 2;
     }
-    c += expand4444(*p);
-    if (x < src.width() - 1) {
-        p += 1;
+}
+
+static const SkMipMap::DownsampleRowProc gPortableProcs[] = {
+    downsample_row_32,      // k32_SkMipMapProcType
+    downsample_row_565,     // k565_SkMipMapProcType
+    downsample_row_4444,    // k4444_SkMipMapProcType
+    downsample_row_A8,      // kA8_SkMipMapProcType
+};
+
+static void downsample(const SkMipMap::Level& dst, const void* srcPixels, size_t srcRowBytes,
+                       SkMipMap::DownsampleRowProc proc) {
+    const char* src = static_cast<const char*>(srcPixels);
+    char* d = static_cast<char*>(dst.fPixels);
+    for (uint32_t y = 0; y < dst.fHeight; ++y) {
+        proc(d, src, src + srcRowBytes, dst.fWidth);
+        src += 2 * srcRowBytes;
+        d += dst.fRowBytes;
     }
-    c += expand4444(*p);
+}
 
-    *dst->getAddr16(x >> 1, y >> 1) = (uint16_t)collaps4444(c >> 2);
+// Like downsample(), but reads an Index8 src by expanding each pair of rows
+// through its color table.
+static void downsample_index8(const SkMipMap::Level& dst, const SkBitmap& src,
+                              SkMipMap::DownsampleRowProc proc) {
+    SkAutoLockColors alc(src);
+    const SkPMColor* table = alc.colors();
+    const int srcWidth = 2 * dst.fWidth;
+
+    SkAutoSTMalloc<512, SkPMColor> storage(2 * srcWidth);
+    SkPMColor* row0 = storage.get();
+    SkPMColor* row1 = row0 + srcWidth;
+
+    char* d = static_cast<char*>(dst.fPixels);
+    for (uint32_t y = 0; y < dst.fHeight; ++y) {
+        const uint8_t* s0 = src.getAddr8(0, 2 * y);
+        const uint8_t* s1 = src.getAddr8(0, 2 * y + 1);
+        for (int x = 0; x < srcWidth; ++x) {
+            row0[x] = table[s0[x]];
+            row1[x] = table[s1[x]];
+        }
+        proc(d, row0, row1, dst.fWidth);
+        d += dst.fRowBytes;
+    }
 }
 
 SkMipMap::Level* SkMipMap::AllocLevels(int levelCount, size_t pixelSize) {
@@ -120,26 +140,37 @@ SkMipMap::Level* SkMipMap::AllocLevels(int levelCount, size_t pixelSize) {
     return (Level*)sk_malloc_throw(sk_64_asS32(size));
 }
 
-SkMipMap* SkMipMap::Build(const SkBitmap& src) {
-    void (*proc)(SkBitmap* dst, int x, int y, const SkBitmap& src);
-
-    const SkColorType ct = src.colorType();
-    const SkAlphaType at = src.alphaType();
+SkMipMap* SkMipMap::Build(const SkBitmap& src, BuildMode mode) {
+    SkMipMapProcType type;
+    SkColorType ct = src.colorType();
     switch (ct) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
-            proc = downsampleby2_proc32;
+            type = k32_SkMipMapProcType;
             break;
         case kRGB_565_SkColorType:
-            proc = downsampleby2_proc16;
+            type = k565_SkMipMapProcType;
             break;
         case kARGB_4444_SkColorType:
-            proc = downsampleby2_proc4444;
+            type = k4444_SkMipMapProcType;
+            break;
+        case kAlpha_8_SkColorType:
+            type = kA8_SkMipMapProcType;
+            break;
+        case kIndex_8_SkColorType:
+            // the levels are expanded as we build the first one
+            type = k32_SkMipMapProcType;
+            ct = kN32_SkColorType;
             break;
         default:
             return NULL; // don't build mipmaps for any other colortypes (yet)
     }
 
+    DownsampleRowProc proc = SkMipMapGetPlatformProc(type);
+    if (NULL == proc) {
+        proc = gPortableProcs[type];
+    }
+
     SkAutoLockPixels alp(src);
     if (!src.readyToDraw()) {
         return NULL;
@@ -175,7 +206,6 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src) {
     int         width = src.width();
     int         height = src.height();
     uint32_t    rowBytes;
-    SkBitmap    srcBM(src);
 
     for (int i = 0; i < countLevels; ++i) {
         width >>= 1;
@@ -187,32 +217,52 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src) {
         levels[i].fHeight   = height;
         levels[i].fRowBytes = rowBytes;
         levels[i].fScale    = (float)width / src.width();
+        levels[i].fColorType = ct;
 
-        SkBitmap dstBM;
-        dstBM.installPixels(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
-
-        srcBM.lockPixels();
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                proc(&dstBM, x, y, srcBM);
-            }
-        }
-        srcBM.unlockPixels();
-
-        srcBM = dstBM;
         addr += height * rowBytes;
     }
     SkASSERT(addr == baseAddr + size);
 
-    return SkNEW_ARGS(SkMipMap, (levels, countLevels, size));
+    SkMipMap* mip = SkNEW_ARGS(SkMipMap, (levels, countLevels, size, proc));
+    mip->fSrc = src;
+    if (kEager_BuildMode == mode && !mip->buildLevels(countLevels)) {
+        mip->unref();
+        return NULL;
+    }
+    return mip;
+}
+
+bool SkMipMap::buildLevels(int count) const {
+    for (int i = fBuiltCount; i < count; ++i) {
+        if (0 == i) {
+            {
+                SkAutoLockPixels alp(fSrc);
+                if (!fSrc.readyToDraw()) {
+                    return false;
+                }
+                if (kIndex_8_SkColorType == fSrc.colorType()) {
+                    downsample_index8(fLevels[0], fSrc, fProc);
+                } else {
+                    downsample(fLevels[0], fSrc.getPixels(), fSrc.rowBytes(), fProc);
+                }
+            }
+            // the other levels are built from level 0
+            fSrc.reset();
+        } else {
+            downsample(fLevels[i], fLevels[i - 1].fPixels, fLevels[i - 1].fRowBytes, fProc);
+        }
+        // publish the level's pixels to extractLevel()
+        sk_release_store(&fBuiltCount, i + 1);
+    }
+    return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 //static int gCounter;
 
-SkMipMap::SkMipMap(Level* levels, int count, size_t size)
-    : fSize(size), fLevels(levels), fCount(count) {
+SkMipMap::SkMipMap(Level* levels, int count, size_t size, DownsampleRowProc proc)
+    : fSize(size), fLevels(levels), fCount(count), fProc(proc), fBuiltCount(0) {
     SkASSERT(levels);
     SkASSERT(count > 0);
 //    SkDebugf("mips %d\n", ++gCounter);
@@ -223,6 +273,11 @@ SkMipMap::~SkMipMap() {
 //    SkDebugf("mips %d\n", --gCounter);
 }
 
+size_t SkMipMap::getSize() const {
+    SkAutoMutexAcquire ama(fMutex);
+    return fSize + fSrc.getSize();
+}
+
 static SkFixed compute_level(SkScalar scale) {
     SkFixed s = SkAbs32(SkScalarToFixed(SkScalarInvert(scale)));
 
@@ -249,6 +304,12 @@ bool SkMipMap::extractLevel(SkScalar scale, Level* levelPtr) const {
         level = fCount;
     }
     if (levelPtr) {
+        if (sk_acquire_load(&fBuiltCount) < level) {
+            SkAutoMutexAcquire ama(fMutex);
+            if (!this->buildLevels(level)) {
+                return false;
+            }
+        }
         *levelPtr = fLevels[level - 1];
     }
     return true;
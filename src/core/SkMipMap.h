@@ -8,36 +8,82 @@
 #ifndef SkMipMap_DEFINED
 #define SkMipMap_DEFINED
 
+#include "SkBitmap.h"
 #include "SkRefCnt.h"
 #include "SkScalar.h"
-
-class SkBitmap;
+#include "SkThread.h"
 
 class SkMipMap : public SkRefCnt {
 public:
-    static SkMipMap* Build(const SkBitmap& src);
+    enum BuildMode {
+        /** Compute every level in Build(). */
+        kEager_BuildMode,
+        /**
+         *  Compute the levels the first time extractLevel() asks for them. The
+         *  mipmap holds a ref to the source's pixels until the first level is
+         *  computed. Each level is downsampled from the one above it, so
+         *  asking for a small level computes every larger level too.
+         */
+        kLazy_BuildMode,
+    };
+
+    /**
+     *  Returns a mipmap for src, or NULL if src is too small or its color type
+     *  is not supported. 8888, 565, 4444 and A8 levels keep the source's
+     *  color type; Index8 levels are expanded to N32.
+     */
+    static SkMipMap* Build(const SkBitmap& src, BuildMode = kEager_BuildMode);
 
     struct Level {
         void*       fPixels;
         uint32_t    fRowBytes;
         uint32_t    fWidth, fHeight;
         float       fScale; // < 1.0
+        SkColorType fColorType;
     };
 
+    /**
+     *  Returns true (and sets Level if it is not NULL) if there is a level
+     *  that suits drawing at scale. For a lazy mipmap this computes that level
+     *  (and the larger ones) if need be, and returns false if the source's
+     *  pixels can no longer be locked.
+     */
     bool extractLevel(SkScalar scale, Level*) const;
 
-    size_t getSize() const { return fSize; }
+    /**
+     *  Returns the bytes used by the levels, plus the source's pixels if a lazy
+     *  mipmap still holds them.
+     */
+    size_t getSize() const;
+
+    /**
+     *  Averages each 2x2 block of the rows src0 and src1 (which hold at least
+     *  2 * count pixels) into count pixels in dst.
+     */
+    typedef void (*DownsampleRowProc)(void* dst, const void* src0, const void* src1,
+                                      int count);
 
 private:
     size_t  fSize;
     Level*  fLevels;
     int     fCount;
 
+    DownsampleRowProc   fProc;
+
+    // Only used by lazy mipmaps, which compute their levels in a const method.
+    mutable SkMutex     fMutex;
+    mutable SkBitmap    fSrc;           // until level 0 is computed
+    mutable int         fBuiltCount;    // levels [0, fBuiltCount) are computed
+
     // we take ownership of levels, and will free it with sk_free()
-    SkMipMap(Level* levels, int count, size_t size);
+    SkMipMap(Level* levels, int count, size_t size, DownsampleRowProc proc);
     virtual ~SkMipMap();
 
     static Level* AllocLevels(int levelCount, size_t pixelSize);
+
+    // Computes levels [fBuiltCount, count). Returns false if fSrc is needed
+    // but its pixels can't be locked.
+    bool buildLevels(int count) const;
 };
 
 #endif
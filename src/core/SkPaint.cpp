@@ -28,6 +28,7 @@
 #include "SkShader.h"
 #include "SkStringUtils.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkTextFormatParams.h"
 #include "SkTextToPathIter.h"
 #include "SkTLazy.h"
@@ -2166,6 +2167,9 @@ void SkPaint::flatten(SkWriteBuffer& buffer) const {
 void SkPaint::unflatten(SkReadBuffer& buffer) {
     SkASSERT(SkAlign4(kPODPaintSize) == kPODPaintSize);
     const void* podData = buffer.skip(kPODPaintSize);
+    if (!buffer.isValid()) {
+        return;
+    }
     const uint32_t* pod = reinterpret_cast<const uint32_t*>(podData);
 
     // the order we read must match the order we wrote in flatten()
@@ -2280,6 +2284,25 @@ SkMaskFilter* SkPaint::setMaskFilter(SkMaskFilter* filter) {
 
 bool SkPaint::getFillPath(const SkPath& src, SkPath* dst,
                           const SkRect* cullRect) const {
+    SkStrokeCache::Key key;
+    const bool cacheable = 0 != SkStrokeCache::GetByteLimit() &&
+                           SkStrokeCache::ComputeKey(src, *this, cullRect, &key);
+    if (cacheable) {
+        bool doFill;
+        if (SkStrokeCache::Find(key, dst, &doFill)) {
+            return doFill;
+        }
+    }
+
+    bool doFill = this->computeFillPath(src, dst, cullRect);
+    if (cacheable) {
+        SkStrokeCache::Add(key, *dst, doFill);
+    }
+    return doFill;
+}
+
+bool SkPaint::computeFillPath(const SkPath& src, SkPath* dst,
+                              const SkRect* cullRect) const {
     SkStrokeRec rec(*this);
 
     const SkPath* srcPtr = &src;
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPathMaskCache.h"
+#include "SkChecksum.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkScan.h"
+#include "SkThread.h"
+
+#ifndef SK_DEFAULT_PATH_MASK_CACHE_LIMIT
+    #define SK_DEFAULT_PATH_MASK_CACHE_LIMIT    0
+#endif
+
+// Paths whose device bounds are larger than this (in either direction) are
+// drawn directly; the cache is meant for icon and glyph-like paths.
+#ifndef SK_MAX_CACHED_PATH_MASK_DIM
+    #define SK_MAX_CACHED_PATH_MASK_DIM         256
+#endif
+
+struct SkPathMaskCache::Rec {
+    Rec(const Key& key, const SkMask& mask) : fKey(key), fMask(mask), fLockCount(1) {}
+
+    ~Rec() {
+        SkMask::FreeImage(fMask.fImage);
+    }
+
+    static const Key& GetKey(const Rec& rec) { return rec.fKey; }
+    static uint32_t Hash(const Key& key) { return key.fHash; }
+    static size_t BytesUsed(const Rec& rec) { return rec.fMask.computeImageSize(); }
+    static bool CanPurge(const Rec& rec) { return 0 == rec.fLockCount; }
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Rec);
+
+    Key     fKey;
+    SkMask  fMask;
+    int32_t fLockCount;
+};
+
+static inline SkPathMaskCache::ID* rec_to_id(SkPathMaskCache::Rec* rec) {
+    return reinterpret_cast<SkPathMaskCache::ID*>(rec);
+}
+
+static inline SkPathMaskCache::Rec* id_to_rec(SkPathMaskCache::ID* id) {
+    return reinterpret_cast<SkPathMaskCache::Rec*>(id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkPathMaskCache::ComputeKey(const SkPath& path, const SkPaint& paint,
+                                 const SkMatrix& matrix, Key* key, SkIPoint* offset) {
+    // Anything that rewrites the path or the mask, or depends on the clip,
+    // is drawn directly.
+    if (!paint.isAntiAlias() || paint.getPathEffect() || paint.getMaskFilter() ||
+            paint.getRasterizer() || !paint.canComputeFastBounds()) {
+        return false;
+    }
+    if (path.isInverseFillType() || path.isEmpty() || matrix.hasPerspective()) {
+        return false;
+    }
+    const SkPaint::Style style = paint.getStyle();
+    if (SkPaint::kFill_Style != style && 0 == paint.getStrokeWidth()) {
+        return false;   // hairlines are cheap enough to draw directly
+    }
+
+    SkRect storage, devBounds;
+    matrix.mapRect(&devBounds, paint.computeFastBounds(path.getBounds(), &storage));
+    // written so that NaNs fail the test
+    if (!(devBounds.width() <= SK_MAX_CACHED_PATH_MASK_DIM &&
+          devBounds.height() <= SK_MAX_CACHED_PATH_MASK_DIM)) {
+        return false;
+    }
+
+    const SkScalar tx = matrix.getTranslateX();
+    const SkScalar ty = matrix.getTranslateY();
+    if (!(SkScalarAbs(tx) < SK_MaxS16 && SkScalarAbs(ty) < SK_MaxS16)) {
+        return false;
+    }
+
+    offset->set(SkScalarFloorToInt(tx), SkScalarFloorToInt(ty));
+
+    sk_bzero(key, sizeof(*key));
+    key->fGenID = path.getGenerationID();
+    key->fFlags = path.getFillType() |
+                  (style << 2) |
+                  (paint.getStrokeCap() << 4) |
+                  (paint.getStrokeJoin() << 6) |
+                  (SkScan::GetAnalyticAA() << 8);
+    if (SkPaint::kFill_Style != style) {
+        key->fStrokeWidth = paint.getStrokeWidth();
+        key->fStrokeMiter = paint.getStrokeMiter();
+    }
+    key->fMatrix[0] = matrix.getScaleX();
+    key->fMatrix[1] = matrix.getSkewX();
+    key->fMatrix[2] = matrix.getSkewY();
+    key->fMatrix[3] = matrix.getScaleY();
+    key->fMatrix[4] = tx - SkIntToScalar(offset->fX);
+    key->fMatrix[5] = ty - SkIntToScalar(offset->fY);
+    key->fHash = SkChecksum::Murmur3(&key->fGenID, sizeof(Key) - sizeof(key->fHash));
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPathMaskCache::SkPathMaskCache(size_t byteLimit) : fCache(byteLimit) {}
+
+SkPathMaskCache::~SkPathMaskCache() {}
+
+SkPathMaskCache::ID* SkPathMaskCache::findAndLock(const Key& key, SkMask* mask) {
+    Rec* rec = fCache.find(key);
+    if (rec) {
+        rec->fLockCount += 1;
+        *mask = rec->fMask;
+    }
+    return rec_to_id(rec);
+}
+
+SkPathMaskCache::ID* SkPathMaskCache::addAndLock(const Key& key, const SkMask& mask) {
+    Rec* rec = SkNEW_ARGS(Rec, (key, mask));
+    if (!fCache.add(rec)) {
+        rec->fMask.fImage = NULL;   // still the caller's
+        SkDELETE(rec);
+        return NULL;
+    }
+    return rec_to_id(rec);
+}
+
+void SkPathMaskCache::unlock(ID* id) {
+    SkASSERT(id);
+
+    Rec* rec = id_to_rec(id);
+    SkASSERT(rec->fLockCount > 0);
+    rec->fLockCount -= 1;
+
+    // we may have been over-budget, but now have released something, so check
+    // if we should purge.
+    if (0 == rec->fLockCount) {
+        fCache.purgeAsNeeded();
+    }
+}
+
+size_t SkPathMaskCache::setByteLimit(size_t newLimit) {
+    return fCache.setByteLimit(newLimit);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+static SkPathMaskCache* gPathMaskCache = NULL;
+// The global cache's limit, which every anti-aliased path draw checks, so we
+// keep a copy that can be read without gMutex.
+static size_t gPathMaskCacheByteLimit = SK_DEFAULT_PATH_MASK_CACHE_LIMIT;
+static void cleanup_gPathMaskCache() { SkDELETE(gPathMaskCache); }
+
+/** Must hold gMutex when calling. */
+static SkPathMaskCache* get_cache() {
+    // gMutex is always held when this is called, so we don't need to be fancy in here.
+    if (NULL == gPathMaskCache) {
+        gPathMaskCache = SkNEW_ARGS(SkPathMaskCache, (SK_DEFAULT_PATH_MASK_CACHE_LIMIT));
+        atexit(cleanup_gPathMaskCache);
+    }
+    return gPathMaskCache;
+}
+
+SkPathMaskCache::ID* SkPathMaskCache::FindAndLock(const Key& key, SkMask* mask) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->findAndLock(key, mask);
+}
+
+SkPathMaskCache::ID* SkPathMaskCache::AddAndLock(const Key& key, SkMask* mask) {
+    SkAutoMutexAcquire am(gMutex);
+    SkPathMaskCache* cache = get_cache();
+
+    // Another thread may have added the same mask since we looked for it. If
+    // so, keep theirs and free ours.
+    SkMask existing;
+    ID* id = cache->findAndLock(key, &existing);
+    if (id) {
+        SkMask::FreeImage(mask->fImage);
+        *mask = existing;
+        return id;
+    }
+    return cache->addAndLock(key, *mask);
+}
+
+void SkPathMaskCache::Unlock(ID* id) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->unlock(id);
+}
+
+size_t SkPathMaskCache::GetBytesUsed() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getBytesUsed();
+}
+
+size_t SkPathMaskCache::GetByteLimit() {
+    return sk_acquire_load(&gPathMaskCacheByteLimit);
+}
+
+size_t SkPathMaskCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    sk_release_store(&gPathMaskCacheByteLimit, newLimit);
+    return get_cache()->setByteLimit(newLimit);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkGraphics.h"
+
+size_t SkGraphics::GetPathMaskCacheBytesUsed() {
+    return SkPathMaskCache::GetBytesUsed();
+}
+
+size_t SkGraphics::GetPathMaskCacheByteLimit() {
+    return SkPathMaskCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetPathMaskCacheByteLimit(size_t newLimit) {
+    return SkPathMaskCache::SetByteLimit(newLimit);
+}
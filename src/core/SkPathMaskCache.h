@@ -0,0 +1,112 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathMaskCache_DEFINED
+#define SkPathMaskCache_DEFINED
+
+#include "SkMask.h"
+#include "SkTLRUCache.h"
+
+class SkMatrix;
+class SkPaint;
+class SkPath;
+
+/**
+ *  Cache of A8 coverage masks for anti-aliased paths, so the raster backend
+ *  need not re-scan a small path (e.g. an icon) that it draws over and over
+ *  with the same matrix. A mask is keyed by the path's generation ID and fill
+ *  type, the paint's style and stroke parameters, and the matrix without its
+ *  integer translation, so the same mask is reused at any whole pixel offset.
+ *
+ *  Masks are rendered unclipped, so that one mask serves every clip. Where a
+ *  path crosses the clip that can change its anti-aliasing slightly, so the
+ *  global cache is off (its limit is 0) unless the client turns it on.
+ *
+ *  Masks are purged least-recently-used first once the byte limit is passed.
+ *  The cache is not thread-safe; as with SkScaledImageCache, the static
+ *  methods wrap a global instance with a mutex.
+ */
+class SkPathMaskCache {
+public:
+    struct ID;
+
+    struct Key {
+        uint32_t    fHash;
+        uint32_t    fGenID;
+        uint32_t    fFlags;         // fill type, style, cap, join and AA method
+        float       fStrokeWidth;
+        float       fStrokeMiter;
+        float       fMatrix[6];     // scale and skew, then the fractional translation
+
+        bool operator==(const Key& other) const {
+            return 0 == memcmp(this, &other, sizeof(Key));
+        }
+    };
+
+    /**
+     *  Returns true if drawing path with paint and matrix can use the cache.
+     *  If so, sets key, and sets offset to the integer part of the matrix's
+     *  translation. The cached mask is drawn with matrix translated by -offset,
+     *  so the caller must add offset to its bounds.
+     */
+    static bool ComputeKey(const SkPath& path, const SkPaint& paint,
+                           const SkMatrix& matrix, Key* key, SkIPoint* offset);
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static ID* FindAndLock(const Key&, SkMask* mask);
+    // If another thread added key since we looked, frees our mask's image and
+    // sets mask to theirs.
+    static ID* AddAndLock(const Key&, SkMask* mask);
+    static void Unlock(ID*);
+
+    static size_t GetBytesUsed();
+    static size_t GetByteLimit();   // doesn't take the mutex, so cheap to check per draw
+    static size_t SetByteLimit(size_t newLimit);
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    explicit SkPathMaskCache(size_t byteLimit);
+    ~SkPathMaskCache();
+
+    /**
+     *  Search the cache for key. If found, return its mask in mask, and return
+     *  its ID. The mask's image stays valid until the ID is passed to unlock().
+     */
+    ID* findAndLock(const Key& key, SkMask* mask);
+
+    /**
+     *  Add mask to the cache under key, which must not already be present, and
+     *  return its ID. The cache takes ownership of mask.fImage, which must have
+     *  been allocated with SkMask::AllocImage(). If the mask is too big for the
+     *  cache, return NULL and leave mask.fImage with the caller.
+     */
+    ID* addAndLock(const Key& key, const SkMask& mask);
+
+    void unlock(ID*);
+
+    size_t getBytesUsed() const { return fCache.getBytesUsed(); }
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+
+    /**
+     *  Set the maximum number of bytes available to this cache. If the current
+     *  cache exceeds this new value, it will be purged to try to fit within
+     *  this new limit. A limit of 0 disables the cache.
+     */
+    size_t setByteLimit(size_t newLimit);
+
+public:
+    struct Rec;
+
+private:
+    SkTLRUCache<Rec, Key>   fCache;
+};
+
+#endif
@@ -53,7 +53,6 @@ template <typename T> int SafeCount(const T* obj) {
 // #define SK_DEBUG_VALIDATE
 #endif
 
-#if defined SK_DEBUG_TRACE || defined SK_DEBUG_DUMP
 const char* DrawTypeToString(DrawType drawType) {
     switch (drawType) {
         case UNUSED: SkDebugf("DrawType UNUSED\n"); SkASSERT(0); break;
@@ -93,6 +92,12 @@ const char* DrawTypeToString(DrawType drawType) {
         case SKEW: return "SKEW";
         case TRANSLATE: return "TRANSLATE";
         case NOOP: return "NOOP";
+        case BEGIN_COMMENT_GROUP: return "BEGIN_COMMENT_GROUP";
+        case COMMENT: return "COMMENT";
+        case END_COMMENT_GROUP: return "END_COMMENT_GROUP";
+        case DRAW_DRRECT: return "DRAW_DRRECT";
+        case PUSH_CULL: return "PUSH_CULL";
+        case POP_CULL: return "POP_CULL";
         default:
             SkDebugf("DrawType error 0x%08x\n", drawType);
             SkASSERT(0);
@@ -101,7 +106,6 @@ const char* DrawTypeToString(DrawType drawType) {
     SkASSERT(0);
     return NULL;
 }
-#endif
 
 #ifdef SK_DEBUG_VALIDATE
 static void validateMatrix(const SkMatrix* matrix) {
@@ -254,12 +258,13 @@ void SkPicture::clone(SkPicture* pictures, int count) const {
                 }
 
                 SkDEBUGCODE(int heapSize = SafeCount(fPlayback->fBitmapHeap.get());)
+                copyInfo.sharePaints = true;
                 for (int i = 0; i < paintCount; i++) {
                     if (NeedsDeepCopy(fPlayback->fPaints->at(i))) {
                         copyInfo.paintData[i] =
                             SkFlatData::Create<SkPaint::FlatteningTraits>(&copyInfo.controller,
                                                               fPlayback->fPaints->at(i), 0);
-
+                        copyInfo.sharePaints = false;
                     } else {
                         // this is our sentinel, which we use in the unflatten loop
                         copyInfo.paintData[i] = NULL;
@@ -315,6 +320,12 @@ size_t SkPicture::EXPERIMENTAL_curOpID() const {
     return 0;
 }
 
+void SkPicture::EXPERIMENTAL_setProfiler(SkPlaybackProfiler* profiler) {
+    if (NULL != fPlayback) {
+        fPlayback->setProfiler(profiler);
+    }
+}
+
 void SkPicture::draw(SkCanvas* surface, SkDrawPictureCallback* callback) const {
     SkASSERT(NULL != fPlayback);
     if (NULL != fPlayback) {
@@ -382,6 +393,19 @@ SkPicture::SkPicture(SkPicturePlayback* playback, int width, int height)
 }
 
 SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc proc) {
+    return CreateFromStream(stream, proc, NULL);
+}
+
+SkPicture* SkPicture::CreateFromData(SkData* data, InstallPixelRefProc proc) {
+    if (NULL == data) {
+        return NULL;
+    }
+    SkMemoryStream stream(data);
+    return CreateFromStream(&stream, proc, data);
+}
+
+SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc proc,
+                                       SkData* inPlace) {
     SkPictInfo info;
 
     if (!InternalOnly_StreamIsSKP(stream, &info)) {
@@ -393,7 +417,7 @@ SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc pro
     // Check to see if there is a playback to recreate.
     if (stream->readBool()) {
         SkPicturePlayback* playback = SkPicturePlayback::CreateFromStream(newPict, stream,
-                                                                          info, proc);
+                                                                          info, proc, inPlace);
         if (NULL == playback) {
             SkDELETE(newPict);
             return NULL;
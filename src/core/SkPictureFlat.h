@@ -71,6 +71,9 @@ enum DrawType {
     LAST_DRAWTYPE_ENUM = POP_CULL
 };
 
+// Returns the name of a DrawType, e.g. "DRAW_RECT".
+const char* DrawTypeToString(DrawType);
+
 // In the 'match' method, this constant will match any flavor of DRAW_BITMAP*
 static const int kDRAW_BITMAP_FLAVOR = LAST_DRAWTYPE_ENUM+1;
 
@@ -186,21 +186,28 @@ SkPicturePlayback::SkPicturePlayback(const SkPicture* picture, const SkPicturePl
 
         int paintCount = SafeCount(src.fPaints);
 
+        // Locking an SkBitmap's pixels isn't thread safe, so each copy gets its own SkBitmaps.
+        // They still share their pixels.
         if (src.fBitmaps) {
             fBitmaps = SkTRefArray<SkBitmap>::Create(src.fBitmaps->begin(), src.fBitmaps->count());
         }
 
-        fPaints = SkTRefArray<SkPaint>::Create(paintCount);
-        SkASSERT(deepCopyInfo->paintData.count() == paintCount);
-        SkBitmapHeap* bmHeap = deepCopyInfo->controller.getBitmapHeap();
-        SkTypefacePlayback* tfPlayback = deepCopyInfo->controller.getTypefacePlayback();
-        for (int i = 0; i < paintCount; i++) {
-            if (deepCopyInfo->paintData[i]) {
-                deepCopyInfo->paintData[i]->unflatten<SkPaint::FlatteningTraits>(
-                    &fPaints->writableAt(i), bmHeap, tfPlayback);
-            } else {
-                // needs_deep_copy was false, so just need to assign
-                fPaints->writableAt(i) = src.fPaints->at(i);
+        if (deepCopyInfo->sharePaints) {
+            // None of the paints has any state that changes as it draws, so we can share them.
+            fPaints = SkSafeRef(src.fPaints);
+        } else {
+            fPaints = SkTRefArray<SkPaint>::Create(paintCount);
+            SkASSERT(deepCopyInfo->paintData.count() == paintCount);
+            SkBitmapHeap* bmHeap = deepCopyInfo->controller.getBitmapHeap();
+            SkTypefacePlayback* tfPlayback = deepCopyInfo->controller.getTypefacePlayback();
+            for (int i = 0; i < paintCount; i++) {
+                if (deepCopyInfo->paintData[i]) {
+                    deepCopyInfo->paintData[i]->unflatten<SkPaint::FlatteningTraits>(
+                        &fPaints->writableAt(i), bmHeap, tfPlayback);
+                } else {
+                    // needs_deep_copy was false, so just need to assign
+                    fPaints->writableAt(i) = src.fPaints->at(i);
+                }
             }
         }
 
@@ -236,6 +243,7 @@ void SkPicturePlayback::init() {
     fStart = 0;
     fStop = 0;
     fReplacements = NULL;
+    fProfiler = NULL;
 }
 
 SkPicturePlayback::~SkPicturePlayback() {
@@ -364,6 +372,12 @@ void SkPicturePlayback::flattenToBuffer(SkWriteBuffer& buffer) const {
 void SkPicturePlayback::serialize(SkWStream* stream,
                                   SkPicture::EncodeBitmap encoder) const {
     SkPicture::WriteTagSize(stream, SK_PICT_READER_TAG, fOpData->size());
+    // Pad so the ops start 4-byte aligned in the stream (see V29), recording how much we padded.
+    static const uint8_t kZeros[3] = { 0, 0, 0 };
+    const size_t start = stream->bytesWritten() + sizeof(uint32_t);
+    const size_t pad = SkAlign4(start) - start;
+    stream->write32(SkToU32(pad));
+    stream->write(kZeros, pad);
     stream->write(fOpData->bytes(), fOpData->size());
 
     if (fPictureCount > 0) {
@@ -440,11 +454,31 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+// Reads the next size bytes of stream into an SkData.  If the stream is reading from inPlace and
+// those bytes are suitably aligned for SkReader32, we skip the copy and just ref them in inPlace.
+static SkData* read_data(SkStream* stream, size_t size, SkData* inPlace) {
+    if (NULL != inPlace) {
+        const size_t offset = stream->getPosition();
+        if (SkIsAlign4(reinterpret_cast<uintptr_t>(inPlace->bytes() + offset)) &&
+            size <= inPlace->size() - offset &&
+            stream->skip(size) == size) {
+            return SkData::NewSubset(inPlace, offset, size);
+        }
+    }
+
+    SkAutoMalloc storage(size);
+    if (stream->read(storage.get(), size) != size) {
+        return NULL;
+    }
+    return SkData::NewFromMalloc(storage.detach(), size);
+}
+
 bool SkPicturePlayback::parseStreamTag(SkPicture* picture,
                                        SkStream* stream,
                                        uint32_t tag,
                                        uint32_t size,
-                                       SkPicture::InstallPixelRefProc proc) {
+                                       SkPicture::InstallPixelRefProc proc,
+                                       SkData* inPlace) {
     /*
      *  By the time we encounter BUFFER_SIZE_TAG, we need to have already seen
      *  its dependents: FACTORY_TAG and TYPEFACE_TAG. These two are not required
@@ -458,12 +492,18 @@ bool SkPicturePlayback::parseStreamTag(SkPicture* picture,
 
     switch (tag) {
         case SK_PICT_READER_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            // Remove this code when v28 and below are no longer supported.
+            if (fInfo.fVersion >= 29) {
+                const uint32_t pad = stream->readU32();
+                if (pad > 3 || stream->skip(pad) != pad) {
+                    return false;
+                }
             }
             SkASSERT(NULL == fOpData);
-            fOpData = SkData::NewFromMalloc(storage.detach(), size);
+            fOpData = read_data(stream, size, inPlace);
+            if (NULL == fOpData) {
+                return false;
+            }
         } break;
         case SK_PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
@@ -509,7 +549,7 @@ bool SkPicturePlayback::parseStreamTag(SkPicture* picture,
             bool success = true;
             int i = 0;
             for ( ; i < fPictureCount; i++) {
-                fPictureRefs[i] = SkPicture::CreateFromStream(stream, proc);
+                fPictureRefs[i] = SkPicture::CreateFromStream(stream, proc, inPlace);
                 if (NULL == fPictureRefs[i]) {
                     success = false;
                     break;
@@ -527,12 +567,12 @@ bool SkPicturePlayback::parseStreamTag(SkPicture* picture,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            SkAutoTUnref<SkData> storage(read_data(stream, size, inPlace));
+            if (NULL == storage.get()) {
                 return false;
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(storage->data(), size);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.fVersion);
 
@@ -621,10 +661,11 @@ bool SkPicturePlayback::parseBufferTag(SkPicture* picture,
 SkPicturePlayback* SkPicturePlayback::CreateFromStream(SkPicture* picture,
                                                        SkStream* stream,
                                                        const SkPictInfo& info,
-                                                       SkPicture::InstallPixelRefProc proc) {
+                                                       SkPicture::InstallPixelRefProc proc,
+                                                       SkData* inPlace) {
     SkAutoTDelete<SkPicturePlayback> playback(SkNEW_ARGS(SkPicturePlayback, (picture, info)));
 
-    if (!playback->parseStream(picture, stream, proc)) {
+    if (!playback->parseStream(picture, stream, proc, inPlace)) {
         return NULL;
     }
     return playback.detach();
@@ -644,7 +685,8 @@ SkPicturePlayback* SkPicturePlayback::CreateFromBuffer(SkPicture* picture,
 
 bool SkPicturePlayback::parseStream(SkPicture* picture,
                                     SkStream* stream,
-                                    SkPicture::InstallPixelRefProc proc) {
+                                    SkPicture::InstallPixelRefProc proc,
+                                    SkData* inPlace) {
     for (;;) {
         uint32_t tag = stream->readU32();
         if (SK_PICT_EOF_TAG == tag) {
@@ -652,7 +694,7 @@ bool SkPicturePlayback::parseStream(SkPicture* picture,
         }
 
         uint32_t size = stream->readU32();
-        if (!this->parseStreamTag(picture, stream, tag, size, proc)) {
+        if (!this->parseStreamTag(picture, stream, tag, size, proc, inPlace)) {
             return false; // we're invalid
         }
     }
@@ -986,6 +1028,10 @@ void SkPicturePlayback::draw(SkCanvas& canvas, SkDrawPictureCallback* callback)
             continue;
         }
 
+        if (NULL != fProfiler) {
+            fProfiler->beginOp(SkToU32(fCurOffset), op, DrawTypeToString(op));
+        }
+
         switch (op) {
             case CLIP_PATH: {
                 const SkPath& path = getPath(reader);
@@ -1308,6 +1354,10 @@ void SkPicturePlayback::draw(SkCanvas& canvas, SkDrawPictureCallback* callback)
                 SkASSERT(0);
         }
 
+        if (NULL != fProfiler) {
+            fProfiler->endOp();
+        }
+
 #ifdef SK_DEVELOPER
         this->postDraw(opIndex);
 #endif
@@ -67,9 +67,11 @@ struct SkPictInfo {
  * enables the data to be generated once and reused for subsequent copies.
  */
 struct SkPictCopyInfo {
-    SkPictCopyInfo() : initialized(false), controller(1024) {}
+    SkPictCopyInfo() : initialized(false), sharePaints(false), controller(1024) {}
 
     bool initialized;
+    // True if no paint needs a deep copy, so all copies can share the source's paints.
+    bool sharePaints;
     SkChunkFlatController controller;
     SkTDArray<SkFlatData*> paintData;
 };
@@ -80,10 +82,13 @@ public:
                       SkPictCopyInfo* deepCopyInfo = NULL);
     SkPicturePlayback(const SkPicture* picture, const SkPictureRecord& record, const SkPictInfo&,
                       bool deepCopy = false);
+    // If inPlace is not NULL, the stream must be reading from it, and we may ref parts of it
+    // (e.g. the op data) rather than copying them.
     static SkPicturePlayback* CreateFromStream(SkPicture* picture,
                                                SkStream*,
                                                const SkPictInfo&,
-                                               SkPicture::InstallPixelRefProc);
+                                               SkPicture::InstallPixelRefProc,
+                                               SkData* inPlace = NULL);
     static SkPicturePlayback* CreateFromBuffer(SkPicture* picture,
                                                SkReadBuffer&,
                                                const SkPictInfo&);
@@ -115,7 +120,8 @@ public:
 protected:
     explicit SkPicturePlayback(const SkPicture* picture, const SkPictInfo& info);
 
-    bool parseStream(SkPicture* picture, SkStream*, SkPicture::InstallPixelRefProc);
+    bool parseStream(SkPicture* picture, SkStream*, SkPicture::InstallPixelRefProc,
+                     SkData* inPlace = NULL);
     bool parseBuffer(SkPicture* picture, SkReadBuffer& buffer);
 #ifdef SK_DEVELOPER
     virtual bool preDraw(int opIndex, int type);
@@ -224,7 +230,7 @@ public:
 
 private:    // these help us with reading/writing
     bool parseStreamTag(SkPicture* picture, SkStream*, uint32_t tag, uint32_t size,
-                        SkPicture::InstallPixelRefProc);
+                        SkPicture::InstallPixelRefProc, SkData* inPlace);
     bool parseBufferTag(SkPicture* picture, SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
@@ -308,10 +314,14 @@ private:
         fReplacements = replacements;
     }
 
+    // Tell profiler about each op as we draw it, or stop if it's NULL.  Not copied to clones.
+    void setProfiler(SkPlaybackProfiler* profiler) { fProfiler = profiler; }
+
     bool   fUseBBH;
     size_t fStart;
     size_t fStop;
     PlaybackReplacements* fReplacements;
+    SkPlaybackProfiler* fProfiler;
 
     class CachedOperationList : public SkPicture::OperationList {
     public:
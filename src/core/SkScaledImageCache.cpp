@@ -103,12 +103,16 @@ struct SkScaledImageCache::Rec {
     Rec(const Key& key, const SkBitmap& bm) : fKey(key), fBitmap(bm) {
         fLockCount = 1;
         fMip = NULL;
+        fBytesUsed = bm.getSize();
     }
 
     Rec(const Key& key, const SkMipMap* mip) : fKey(key) {
         fLockCount = 1;
         fMip = mip;
         mip->ref();
+        // A lazy mipmap shrinks when it lets go of its source, but the cache's
+        // total must not change under it, so we keep the size it had when added.
+        fBytesUsed = mip->getSize();
     }
 
     ~Rec() {
@@ -118,9 +122,7 @@ struct SkScaledImageCache::Rec {
     static const Key& GetKey(const Rec& rec) { return rec.fKey; }
     static uint32_t Hash(const Key& key) { return key.fHash; }
 
-    size_t bytesUsed() const {
-        return fMip ? fMip->getSize() : fBitmap.getSize();
-    }
+    size_t bytesUsed() const { return fBytesUsed; }
 
     Rec*    fNext;
     Rec*    fPrev;
@@ -133,6 +135,7 @@ struct SkScaledImageCache::Rec {
     // we use either fBitmap or fMip, but not both
     SkBitmap fBitmap;
     const SkMipMap* fMip;
+    size_t fBytesUsed;
 };
 
 #include "SkTDynamicHash.h"
@@ -50,6 +50,15 @@ public:
     static void HairPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiHairPath(const SkPath&, const SkRasterClip&, SkBlitter*);
 
+    // When set, AntiFillPath computes each pixel's coverage analytically rather than by
+    // supersampling.  See SkGraphics::SetAnalyticAA().
+    static bool GetAnalyticAA();
+    static void SetAnalyticAA(bool);
+
+    // Fills path with analytic coverage, whatever GetAnalyticAA() says.  Returns false (having
+    // drawn nothing) if it can't fill path, e.g. because it's inverse filled.
+    static bool AnalyticFillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
+
 private:
     friend class SkAAClip;
     friend class SkRegion;
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanScratch.h"
+#include "SkTLS.h"
+
+static void* create_scratch() {
+    return SkNEW(SkScanScratch);
+}
+
+static void delete_scratch(void* scratch) {
+    SkDELETE(static_cast<SkScanScratch*>(scratch));
+}
+
+SkScanScratch* SkScanScratch::PerThread() {
+    return static_cast<SkScanScratch*>(SkTLS::Get(create_scratch, delete_scratch));
+}
+
+void SkScanScratch::Edges::rewind() {
+    if (fAlloc.totalCapacity() + fList.reserved() * sizeof(SkEdge*) > kMaxRetainedBytes) {
+        fAlloc.reset();
+        fList.reset();
+    } else {
+        fAlloc.rewind();
+        fList.rewind();
+    }
+}
+
+int16_t* SkScanScratch::Runs::reserve(size_t count) {
+    if (count > fCount) {
+        fStorage.reset(count);
+        fCount = count;
+    }
+    return fStorage.get();
+}
+
+void SkScanScratch::Runs::rewind() {
+    if (fCount * sizeof(int16_t) > kMaxRetainedBytes) {
+        fStorage.reset(0);
+        fCount = 0;
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkScanScratch_DEFINED
+#define SkScanScratch_DEFINED
+
+#include "SkChunkAlloc.h"
+#include "SkTDArray.h"
+#include "SkTLazy.h"
+#include "SkTemplates.h"
+
+struct SkEdge;
+
+/**
+ *  Storage the scan converters keep per-thread and reuse from one path fill to the next, rather
+ *  than allocating afresh for every path, which shows up when drawing many small paths.
+ *
+ *  Between fills we hold on to whatever the biggest fill so far needed, unless that is more than
+ *  kMaxRetainedBytes, in which case we free it, so one huge path doesn't pin its memory for the
+ *  life of the thread.
+ *
+ *  Borrow it with SkAutoScanScratch.
+ */
+struct SkScanScratch {
+    enum {
+        kMaxRetainedBytes = 256 * 1024,
+    };
+
+    /** Edges and the list of pointers to them, for SkEdgeBuilder. */
+    struct Edges {
+        Edges() : fAlloc(16*1024), fInUse(false) {}
+
+        SkChunkAlloc        fAlloc;
+        SkTDArray<SkEdge*>  fList;
+        bool                fInUse;
+
+        void rewind();
+    };
+
+    /** Run-length storage for SkAlphaRuns, for the supersampling blitter. */
+    struct Runs {
+        Runs() : fCount(0), fInUse(false) {}
+
+        // Returns room for count int16_t, good until the next call to reserve() or rewind().
+        int16_t* reserve(size_t count);
+
+        SkAutoTMalloc<int16_t>  fStorage;
+        size_t                  fCount;
+        bool                    fInUse;
+
+        void rewind();
+    };
+
+    /** Returns the calling thread's scratch. */
+    static SkScanScratch* PerThread();
+
+    Edges   fEdges;
+    Runs    fRuns;
+};
+
+/**
+ *  Borrows one part (SkScanScratch::Edges or Runs) of the calling thread's scratch for the life of
+ *  this object. If that part is already borrowed further up the stack, we make a private one
+ *  instead.
+ */
+template <typename T, T SkScanScratch::*Part> class SkAutoScanScratch : SkNoncopyable {
+public:
+    SkAutoScanScratch() {
+        fScratch = &(SkScanScratch::PerThread()->*Part);
+        if (fScratch->fInUse) {
+            fScratch = fPrivate.init();
+        }
+        fScratch->fInUse = true;
+    }
+
+    ~SkAutoScanScratch() {
+        if (!fPrivate.isValid()) {
+            fScratch->rewind();
+            fScratch->fInUse = false;
+        }
+    }
+
+    T* operator->() const { return fScratch; }
+    T* get() const { return fScratch; }
+
+private:
+    T*          fScratch;
+    SkTLazy<T>  fPrivate;
+};
+
+typedef SkAutoScanScratch<SkScanScratch::Edges, &SkScanScratch::fEdges> SkAutoEdgeScratch;
+typedef SkAutoScanScratch<SkScanScratch::Runs, &SkScanScratch::fRuns> SkAutoRunScratch;
+
+#endif
@@ -0,0 +1,362 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanPriv.h"
+
+#include "SkGeometry.h"
+#include "SkPath.h"
+#include "SkRegion.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+/*
+ *  Analytic anti-aliased path filling.
+ *
+ *  Rather than supersampling, we flatten the path into lines and work out exactly how much of each
+ *  pixel each line covers.  For every row a line crosses, it adds to the cells of that row the
+ *  change in (signed) coverage it causes going from each pixel to the next, so that summing a row's
+ *  cells from left to right gives every pixel's winding area.  The fill type turns that into
+ *  coverage.  Each row is visited once, touching only the lines that cross it, and blitted with a
+ *  single blitAntiH.
+ *
+ *  Where contours overlap inside one pixel, the winding area is only an estimate of the coverage
+ *  (we'd need the geometry, not just the area, to know how the overlap falls), but for paths that
+ *  don't cross themselves the coverage is exact, to within the flattening tolerance.
+ */
+
+// How far (in pixels) the lines we flatten curves into may stray from the curve.
+static const SkScalar kFlattenTolerance = SK_Scalar1 / 32;
+
+// Never flatten a single curve into more lines than this.
+static const int kMaxLinesPerCurve = 256;
+
+static inline float pin(float value, float min, float max) {
+    return SkTMax(min, SkTMin(value, max));
+}
+
+namespace {
+
+// One line from the path, going down, with x relative to the left of the fill bounds.
+struct Line {
+    float fX0, fY0;
+    float fY1;
+    float fDXDY;
+    float fDir;     // +1 if the path went down this line, -1 if it went up.
+
+    bool operator<(const Line& other) const { return fY0 < other.fY0; }
+};
+
+// Turns a path into Lines, splitting lines where they cross the left or right of the bounds and
+// pinning the parts outside onto the edge.  A vertical line along the edge covers the pixels inside
+// the bounds exactly as the part of the path outside them would have.
+class LineBuilder {
+public:
+    explicit LineBuilder(const SkIRect& bounds)
+        : fLeft(SkIntToScalar(bounds.fLeft))
+        , fTop(SkIntToScalar(bounds.fTop))
+        , fBottom(SkIntToScalar(bounds.fBottom))
+        , fWidth((float)bounds.width()) {}
+
+    void addPath(const SkPath& path) {
+        SkPath::Iter iter(path, true);
+        SkPoint pts[4];
+        SkPath::Verb verb;
+        while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kLine_Verb:
+                    this->addLine(pts[0], pts[1]);
+                    break;
+                case SkPath::kQuad_Verb:
+                    this->addQuad(pts);
+                    break;
+                case SkPath::kConic_Verb: {
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(),
+                                                                  kFlattenTolerance);
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        this->addQuad(quadPts + 2 * i);
+                    }
+                    break;
+                }
+                case SkPath::kCubic_Verb:
+                    this->addCubic(pts);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    SkTDArray<Line>& lines() { return fLines; }
+
+private:
+    // True if every point is above, below, left of, or right of the bounds.  Such a curve covers
+    // the pixels inside the bounds the same way as the line joining its ends does.
+    bool outside(const SkPoint pts[], int count) const {
+        SkRect r;
+        r.set(pts, count);
+        return r.fBottom <= fTop || r.fTop >= fBottom ||
+               r.fRight <= fLeft || r.fLeft >= fLeft + fWidth;
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        if (this->outside(pts, 3)) {
+            this->addLine(pts[0], pts[2]);
+            return;
+        }
+        // A quad strays from the chord of a 1/n step by at most |p0 - 2p1 + p2| / 4n^2.
+        SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+        int n = SkScalarCeilToInt(SkScalarSqrt(dd.length() / (4 * kFlattenTolerance)));
+        this->addCurve(pts, n, false);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        if (this->outside(pts, 4)) {
+            this->addLine(pts[0], pts[3]);
+            return;
+        }
+        // A cubic's second derivative is at most 6 times its largest second difference, and a
+        // curve strays from the chord of a 1/n step by at most 1/8n^2 times that.
+        SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2],
+                 dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+        SkScalar dd = SkTMax(dd0.length(), dd1.length());
+        int n = SkScalarCeilToInt(SkScalarSqrt(6 * dd / (8 * kFlattenTolerance)));
+        this->addCurve(pts, n, true);
+    }
+
+    void addCurve(const SkPoint pts[], int n, bool cubic) {
+        n = SkPin32(n, 1, kMaxLinesPerCurve);
+        const SkScalar dt = SK_Scalar1 / n;
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next;
+            if (cubic) {
+                SkEvalCubicAt(pts, i * dt, &next, NULL, NULL);
+            } else {
+                SkEvalQuadAt(pts, i * dt, &next, NULL);
+            }
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[cubic ? 3 : 2]);
+    }
+
+    void addLine(const SkPoint& p0, const SkPoint& p1) {
+        float x0 = p0.fX - fLeft, y0 = p0.fY,
+              x1 = p1.fX - fLeft, y1 = p1.fY,
+              dir = 1;
+        if (y0 == y1) {
+            return;
+        }
+        if (y0 > y1) {
+            SkTSwap(x0, x1);
+            SkTSwap(y0, y1);
+            dir = -1;
+        }
+        if (y1 <= fTop || y0 >= fBottom) {
+            return;
+        }
+
+        // Split at the left and right edges of the bounds.
+        const float dxdy = (x1 - x0) / (y1 - y0);
+        float ys[4];
+        int count = 0;
+        ys[count++] = y0;
+        const float edges[2] = { 0, fWidth };
+        for (int i = 0; i < 2; ++i) {
+            const float edge = edges[i];
+            if ((x0 < edge && edge < x1) || (x1 < edge && edge < x0)) {
+                ys[count++] = pin(y0 + (edge - x0) / dxdy, y0, y1);
+            }
+        }
+        ys[count++] = y1;
+        if (4 == count && ys[1] > ys[2]) {
+            SkTSwap(ys[1], ys[2]);
+        }
+
+        for (int i = 0; i + 1 < count; ++i) {
+            const float top = ys[i], bot = ys[i + 1];
+            if (top >= bot) {
+                continue;
+            }
+            const float xTop = pin(x0 + (top - y0) * dxdy, 0, fWidth),
+                        xBot = pin(x0 + (bot - y0) * dxdy, 0, fWidth);
+            Line* line = fLines.append();
+            line->fX0   = xTop;
+            line->fY0   = top;
+            line->fY1   = bot;
+            line->fDXDY = (xBot - xTop) / (bot - top);
+            line->fDir  = dir;
+        }
+    }
+
+    const float fLeft, fTop, fBottom, fWidth;
+    SkTDArray<Line> fLines;
+};
+
+}  // namespace
+
+// Adds to cells the coverage changes for the part of line within row y, and widens [min, max] to
+// include every cell we touch.  cells must have room for 2 more cells than the bounds are wide.
+static void accumulate(const Line& line, int y, float cells[], int* min, int* max) {
+    const float top = SkTMax(line.fY0, (float)y),
+                bot = SkTMin(line.fY1, (float)(y + 1));
+    if (top >= bot) {
+        return;
+    }
+    const float xTop = line.fX0 + (top - line.fY0) * line.fDXDY,
+                xBot = line.fX0 + (bot - line.fY0) * line.fDXDY;
+    const float d = (bot - top) * line.fDir;
+
+    const float x0 = SkTMin(xTop, xBot), x1 = SkTMax(xTop, xBot);
+    const float x0Floor = floorf(x0), x1Ceil = ceilf(x1);
+    const int x0i = (int)x0Floor, x1i = (int)x1Ceil;
+
+    if (x1i <= x0i + 1) {
+        // Within one pixel: it covers the part of the pixel right of its midpoint.
+        const float mid = 0.5f * (xTop + xBot) - x0Floor;
+        cells[x0i]     += d - d * mid;
+        cells[x0i + 1] += d * mid;
+        *min = SkTMin(*min, x0i);
+        *max = SkTMax(*max, x0i + 1);
+        return;
+    }
+
+    // Across several pixels: the area right of the line grows quadratically through the first and
+    // last pixels, and linearly (by s per pixel) through the ones in between.
+    const float s = 1 / (x1 - x0);
+    const float x0Frac = x0 - x0Floor;
+    const float a0 = 0.5f * s * (1 - x0Frac) * (1 - x0Frac);
+    const float x1Frac = x1 - x1Ceil + 1;
+    const float aLast = 0.5f * s * x1Frac * x1Frac;
+
+    cells[x0i] += d * a0;
+    if (x1i == x0i + 2) {
+        cells[x0i + 1] += d * (1 - a0 - aLast);
+    } else {
+        const float a1 = s * (1.5f - x0Frac);
+        cells[x0i + 1] += d * (a1 - a0);
+        for (int x = x0i + 2; x < x1i - 1; ++x) {
+            cells[x] += d * s;
+        }
+        const float a2 = a1 + (x1i - x0i - 3) * s;
+        cells[x1i - 1] += d * (1 - a2 - aLast);
+    }
+    cells[x1i] += d * aLast;
+    *min = SkTMin(*min, x0i);
+    *max = SkTMax(*max, x1i);
+}
+
+static inline SkAlpha winding_to_alpha(float winding, bool evenOdd) {
+    float coverage = fabsf(winding);
+    if (evenOdd) {
+        coverage -= 2 * floorf(coverage * 0.5f);
+        if (coverage > 1) {
+            coverage = 2 - coverage;
+        }
+    } else if (coverage > 1) {
+        coverage = 1;
+    }
+    return (SkAlpha)(coverage * 255 + 0.5f);
+}
+
+bool SkScan::AnalyticFillPath(const SkPath& path, const SkRegion& clip, SkBlitter* blitter) {
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect bounds;
+    path.getBounds().roundOut(&bounds);
+    if (!bounds.intersect(clip.getBounds())) {
+        return true;
+    }
+    // Our runs are int16_t, so we can only blit so wide.
+    if (bounds.width() > SK_MaxS16) {
+        return false;
+    }
+
+    SkRgnClipBlitter rgnBlitter;
+    if (!clip.isRect()) {
+        rgnBlitter.init(blitter, &clip);
+        blitter = &rgnBlitter;
+    }
+
+    LineBuilder builder(bounds);
+    builder.addPath(path);
+    SkTDArray<Line>& lines = builder.lines();
+    if (lines.isEmpty()) {
+        return true;
+    }
+    SkTQSort(lines.begin(), lines.end() - 1);
+
+    const int width = bounds.width();
+    SkAutoSTMalloc<256, float> cells(width + 2);
+    SkAutoSTMalloc<256, int16_t> runs(width + 1);
+    SkAutoSTMalloc<256, SkAlpha> alphas(width + 1);
+    sk_bzero(cells.get(), (width + 2) * sizeof(float));
+
+    const bool evenOdd = SkPath::kEvenOdd_FillType == path.getFillType();
+    SkTDArray<const Line*> active;
+    int next = 0;
+    for (int y = bounds.fTop; y < bounds.fBottom; ++y) {
+        while (next < lines.count() && lines[next].fY0 < y + 1) {
+            *active.append() = &lines[next++];
+        }
+        int min = width + 2, max = -1;
+        for (int i = 0; i < active.count(); ) {
+            if (active[i]->fY1 <= y) {
+                active.removeShuffle(i);
+                continue;
+            }
+            accumulate(*active[i], y, cells.get(), &min, &max);
+            ++i;
+        }
+        if (max < 0) {
+            if (next == lines.count() && active.isEmpty()) {
+                break;
+            }
+            continue;
+        }
+
+        // Sum the cells into runs of equal alpha, clearing them for the next row as we go.  Most
+        // cells of a big fill are empty, and leave the winding (so the alpha) as it was.  Cell
+        // width only catches coverage pinned to the right edge, so we never blit it.
+        const int stop = SkTMin(max, width - 1) + 1;
+        float winding = 0;
+        int runStart = min;
+        SkAlpha runAlpha = 0;
+        bool anyCoverage = false;
+        for (int x = min; x < stop; ++x) {
+            if (0 == cells[x]) {
+                continue;
+            }
+            winding += cells[x];
+            cells[x] = 0;
+            const SkAlpha alpha = winding_to_alpha(winding, evenOdd);
+            if (alpha == runAlpha) {
+                continue;
+            }
+            anyCoverage |= 0 != alpha;
+            if (x > runStart) {
+                runs[runStart] = SkToS16(x - runStart);
+                alphas[runStart] = runAlpha;
+                runStart = x;
+            }
+            runAlpha = alpha;
+        }
+        for (int x = stop; x <= max; ++x) {
+            cells[x] = 0;
+        }
+        if (!anyCoverage) {
+            continue;
+        }
+        runs[runStart] = SkToS16(stop - runStart);
+        alphas[runStart] = runAlpha;
+        runs[stop] = 0;
+        blitter->blitAntiH(bounds.fLeft + min, y, alphas.get() + min, runs.get() + min);
+    }
+    return true;
+}
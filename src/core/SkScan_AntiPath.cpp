@@ -13,6 +13,8 @@
 #include "SkBlitter.h"
 #include "SkRegion.h"
 #include "SkAntiRun.h"
+#include "SkScanScratch.h"
+#include "SkThread.h"
 
 #define SHIFT   2
 #define SCALE   (1 << SHIFT)
@@ -108,7 +110,6 @@ public:
 
     virtual ~SuperBlitter() {
         this->flush();
-        sk_free(fRuns.fRuns);
     }
 
     /// Once fRuns contains a complete supersampled row, flush() blits
@@ -123,8 +124,9 @@ public:
     virtual void blitRect(int x, int y, int width, int height) SK_OVERRIDE;
 
 private:
-    SkAlphaRuns fRuns;
-    int         fOffsetX;
+    SkAutoRunScratch    fScratch;
+    SkAlphaRuns         fRuns;
+    int                 fOffsetX;
 };
 
 SuperBlitter::SuperBlitter(SkBlitter* realBlitter, const SkIRect& ir,
@@ -133,7 +135,7 @@ SuperBlitter::SuperBlitter(SkBlitter* realBlitter, const SkIRect& ir,
     const int width = fWidth;
 
     // extra one to store the zero at the end
-    fRuns.fRuns = (int16_t*)sk_malloc_throw((width + 1 + (width + 2)/2) * sizeof(int16_t));
+    fRuns.fRuns = fScratch->reserve(width + 1 + (width + 2)/2);
     fRuns.fAlpha = (uint8_t*)(fRuns.fRuns + width + 1);
     fRuns.reset(width);
 
@@ -598,6 +600,17 @@ static bool safeRoundOut(const SkRect& src, SkIRect* dst, int32_t maxInt) {
     return false;
 }
 
+// Set from any thread while others draw, so read and written atomically.
+static int32_t gAnalyticAA = false;
+
+bool SkScan::GetAnalyticAA() {
+    return 0 != sk_acquire_load(&gAnalyticAA);
+}
+
+void SkScan::SetAnalyticAA(bool analytic) {
+    sk_release_store(&gAnalyticAA, (int32_t)analytic);
+}
+
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
                           SkBlitter* blitter, bool forceRLE) {
     if (origClip.isEmpty()) {
@@ -632,6 +645,11 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
        if (!clippedIR.intersect(ir, origClip.getBounds())) {
            return;
        }
+       // Analytic coverage has no supersampled coordinates to overflow.  It doesn't do inverse
+       // fills, which the supersamplers handle by blitting around the path.
+       if (GetAnalyticAA() && AnalyticFillPath(path, origClip, blitter)) {
+           return;
+       }
     }
     if (rect_overflows_short_shift(clippedIR, SHIFT)) {
         SkScan::FillPath(path, origClip, blitter);
@@ -185,6 +185,21 @@ void SkShader::Context::shadeSpanAlpha(int x, int y, uint8_t alpha[], int count)
 #endif
 }
 
+void SkShader::Context::shadeSpan4f(int x, int y, SkPM4f dst[], int count) {
+    SkASSERT(count > 0);
+
+    SkPMColor   colors[kTempColorCount];
+
+    do {
+        int n = SkMin32(count, kTempColorCount);
+        this->shadeSpan(x, y, colors, n);
+        SkPMColorToPM4f(colors, n, dst);
+        dst += n;
+        x += n;
+        count -= n;
+    } while (count > 0);
+}
+
 SkShader::Context::MatrixClass SkShader::Context::ComputeMatrixClass(const SkMatrix& mat) {
     MatrixClass mc = kLinear_MatrixClass;
 
@@ -303,7 +318,15 @@ SkColorShader::ColorShaderContext::ColorShaderContext(const SkColorShader& shade
     }
     fPMColor = SkPackARGB32(a, r, g, b);
 
-    fFlags = kConstInY32_Flag;
+    // the float color skips the 8 bit rounding of the paint's alpha
+    const float scale = 1.0f / 255;
+    float a4f = SkColorGetA(color) * rec.fPaint->getAlpha() * (scale * scale);
+    fPM4f.fVec[SkPM4f::R] = SkColorGetR(color) * scale * a4f;
+    fPM4f.fVec[SkPM4f::G] = SkColorGetG(color) * scale * a4f;
+    fPM4f.fVec[SkPM4f::B] = SkColorGetB(color) * scale * a4f;
+    fPM4f.fVec[SkPM4f::A] = a4f;
+
+    fFlags = kConstInY32_Flag | kSupports4f_Flag;
     if (255 == a) {
         fFlags |= kOpaqueAlpha_Flag;
         if (rec.fPaint->isDither() == false) {
@@ -324,6 +347,12 @@ void SkColorShader::ColorShaderContext::shadeSpanAlpha(int x, int y, uint8_t alp
     memset(alpha, SkGetPackedA32(fPMColor), count);
 }
 
+void SkColorShader::ColorShaderContext::shadeSpan4f(int x, int y, SkPM4f span[], int count) {
+    for (int i = 0; i < count; ++i) {
+        span[i] = fPM4f;
+    }
+}
+
 // if we had a asAColor method, that would be more efficient...
 SkShader::BitmapType SkColorShader::asABitmap(SkBitmap* bitmap, SkMatrix* matrix,
                                               TileMode modes[]) const {
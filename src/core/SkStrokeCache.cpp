@@ -0,0 +1,201 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokeCache.h"
+#include "SkChecksum.h"
+#include "SkPaint.h"
+#include "SkPathEffect.h"
+#include "SkStrokeRec.h"
+#include "SkThread.h"
+
+#ifndef SK_DEFAULT_STROKE_CACHE_LIMIT
+    #define SK_DEFAULT_STROKE_CACHE_LIMIT   0
+#endif
+
+static size_t path_bytes_used(const SkPath& path) {
+    return sizeof(SkPath) + path.countPoints() * sizeof(SkPoint) + path.countVerbs();
+}
+
+struct SkStrokeCache::Rec {
+    Rec(const Key& key, const SkPath& path, bool doFill)
+        : fKey(key)
+        , fPath(path)
+        , fBytesUsed(path_bytes_used(path))
+        , fDoFill(doFill) {
+        SkSafeRef(fKey.fPathEffect);
+    }
+
+    ~Rec() {
+        SkSafeUnref(fKey.fPathEffect);
+    }
+
+    static const Key& GetKey(const Rec& rec) { return rec.fKey; }
+    static uint32_t Hash(const Key& key) { return key.fHash; }
+    static size_t BytesUsed(const Rec& rec) { return rec.fBytesUsed; }
+    static bool CanPurge(const Rec&) { return true; }
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Rec);
+
+    Key     fKey;
+    SkPath  fPath;
+    size_t  fBytesUsed;
+    bool    fDoFill;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkStrokeCache::ComputeKey(const SkPath& src, const SkPaint& paint,
+                               const SkRect* cullRect, Key* key) {
+    SkStrokeRec rec(paint);
+    SkPathEffect* pe = paint.getPathEffect();
+
+    // Filling or hairlining without a path effect leaves the path as is, so
+    // there is nothing worth caching.
+    if (NULL == pe && rec.getWidth() <= 0) {
+        return false;
+    }
+    if (src.isEmpty()) {
+        return false;
+    }
+    // The path effect may cull to cullRect, in which case its result is only
+    // good for this clip.
+    if (pe && cullRect) {
+        SkRect storage;
+        if (!paint.canComputeFastBounds() ||
+                !cullRect->contains(paint.computeFastBounds(src.getBounds(), &storage))) {
+            return false;
+        }
+    }
+    sk_bzero(key, sizeof(*key));
+    key->fGenID = src.getGenerationID();
+    key->fFlags = src.getFillType() |
+                  (rec.getStyle() << 2) |
+                  (rec.getCap() << 4) |
+                  (rec.getJoin() << 6);
+    key->fWidth = rec.getWidth();
+    key->fMiter = rec.getMiter();
+    key->fPad = 0;
+    key->fPathEffect = pe;
+    // operator== and the hash read the key's raw bytes, so it must have no implicit padding.
+    SK_COMPILE_ASSERT(sizeof(Key) == 6 * sizeof(uint32_t) + sizeof(SkPathEffect*),
+                      StrokeCacheKeyHasPadding);
+    key->fHash = SkChecksum::Murmur3(&key->fGenID, sizeof(Key) - sizeof(key->fHash));
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkStrokeCache::SkStrokeCache(size_t byteLimit) : fCache(byteLimit) {
+    sk_bzero(fSeen, sizeof(fSeen));
+}
+
+SkStrokeCache::~SkStrokeCache() {}
+
+bool SkStrokeCache::find(const Key& key, SkPath* dst, bool* doFill) {
+    Rec* rec = fCache.find(key);
+    if (NULL == rec) {
+        return false;
+    }
+    *dst = rec->fPath;
+    *doFill = rec->fDoFill;
+    return true;
+}
+
+void SkStrokeCache::add(const Key& key, const SkPath& path, bool doFill) {
+    uint32_t* seen = &fSeen[key.fHash & (kSeenCount - 1)];
+    if (*seen != key.fHash) {
+        *seen = key.fHash;
+        return;
+    }
+
+    Rec* rec = SkNEW_ARGS(Rec, (key, path, doFill));
+    if (!fCache.add(rec)) {
+        SkDELETE(rec);
+    }
+}
+
+size_t SkStrokeCache::setByteLimit(size_t newLimit) {
+    return fCache.setByteLimit(newLimit);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+static SkStrokeCache* gStrokeCache = NULL;
+// The global cache's limit, which every stroke checks, so we keep a copy that
+// can be read without gMutex.
+static size_t gStrokeCacheByteLimit = SK_DEFAULT_STROKE_CACHE_LIMIT;
+static void cleanup_gStrokeCache() { SkDELETE(gStrokeCache); }
+
+/** Must hold gMutex when calling. */
+static SkStrokeCache* get_cache() {
+    // gMutex is always held when this is called, so we don't need to be fancy in here.
+    if (NULL == gStrokeCache) {
+        gStrokeCache = SkNEW_ARGS(SkStrokeCache, (SK_DEFAULT_STROKE_CACHE_LIMIT));
+        atexit(cleanup_gStrokeCache);
+    }
+    return gStrokeCache;
+}
+
+bool SkStrokeCache::Find(const Key& key, SkPath* dst, bool* doFill) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->find(key, dst, doFill);
+}
+
+void SkStrokeCache::Add(const Key& key, const SkPath& path, bool doFill) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->add(key, path, doFill);
+}
+
+size_t SkStrokeCache::GetBytesUsed() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getBytesUsed();
+}
+
+size_t SkStrokeCache::GetByteLimit() {
+    return sk_acquire_load(&gStrokeCacheByteLimit);
+}
+
+size_t SkStrokeCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    sk_release_store(&gStrokeCacheByteLimit, newLimit);
+    return get_cache()->setByteLimit(newLimit);
+}
+
+int SkStrokeCache::GetHitCount() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getHitCount();
+}
+
+int SkStrokeCache::GetMissCount() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getMissCount();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkGraphics.h"
+
+size_t SkGraphics::GetStrokeCacheBytesUsed() {
+    return SkStrokeCache::GetBytesUsed();
+}
+
+size_t SkGraphics::GetStrokeCacheByteLimit() {
+    return SkStrokeCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetStrokeCacheByteLimit(size_t newLimit) {
+    return SkStrokeCache::SetByteLimit(newLimit);
+}
+
+int SkGraphics::GetStrokeCacheHitCount() {
+    return SkStrokeCache::GetHitCount();
+}
+
+int SkGraphics::GetStrokeCacheMissCount() {
+    return SkStrokeCache::GetMissCount();
+}
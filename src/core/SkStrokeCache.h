@@ -0,0 +1,122 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkPath.h"
+#include "SkTLRUCache.h"
+
+class SkPaint;
+class SkPathEffect;
+struct SkRect;
+
+/**
+ *  Cache of the fill paths that SkPaint::getFillPath() computes by applying a
+ *  path effect and/or stroking, so that redrawing the same stroked or dashed
+ *  path (e.g. a polyline in a map that is redrawn with a new matrix each
+ *  frame) does not re-run the stroker. The outline is in the path's own
+ *  coordinates, so one entry serves every matrix.
+ *
+ *  An entry is keyed by the source path's generation ID and fill type, the
+ *  paint's stroke parameters, and the path effect. Each entry holds a ref on
+ *  its path effect, so the effect's address cannot be reused while the entry
+ *  is alive.
+ *
+ *  A path is only added the second time it is stroked, so that temporary
+ *  paths, which get a new generation ID each time they are built, don't push
+ *  the paths that are redrawn out of the cache.
+ *
+ *  Entries are purged least-recently-used first once the byte limit is passed.
+ *  The cache is not thread-safe; the static methods wrap a global instance
+ *  with a mutex. The global cache is off (its limit is 0) unless the client
+ *  turns it on.
+ */
+class SkStrokeCache {
+public:
+    struct Key {
+        uint32_t        fHash;
+        uint32_t        fGenID;
+        uint32_t        fFlags;     // fill type, style, cap and join
+        float           fWidth;
+        float           fMiter;
+        uint32_t        fPad;       // always 0, so no padding gets hashed or compared
+        SkPathEffect*   fPathEffect;
+
+        bool operator==(const Key& other) const {
+            return 0 == memcmp(this, &other, sizeof(Key));
+        }
+    };
+
+    /**
+     *  Returns true if the fill path for src with paint can use the cache.
+     *  If so, sets key. A cullRect that could change the result of the path
+     *  effect (i.e. that does not contain the stroked path) makes the path
+     *  uncacheable.
+     */
+    static bool ComputeKey(const SkPath& src, const SkPaint& paint,
+                           const SkRect* cullRect, Key* key);
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static bool Find(const Key&, SkPath* dst, bool* doFill);
+    static void Add(const Key&, const SkPath& path, bool doFill);
+
+    static size_t GetBytesUsed();
+    static size_t GetByteLimit();   // doesn't take the mutex, so cheap to check per stroke
+    static size_t SetByteLimit(size_t newLimit);
+
+    static int GetHitCount();
+    static int GetMissCount();
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    explicit SkStrokeCache(size_t byteLimit);
+    ~SkStrokeCache();
+
+    /**
+     *  Search the cache for key. If found, copy its path into dst (this shares
+     *  the path's storage rather than copying its points), set doFill to what
+     *  getFillPath() returned for it, and return true.
+     */
+    bool find(const Key& key, SkPath* dst, bool* doFill);
+
+    /**
+     *  Add path to the cache under key, unless it is already present, the path
+     *  alone would exceed the byte limit, or this is the first time (lately)
+     *  that key has been added, in which case just remember the key.
+     */
+    void add(const Key& key, const SkPath& path, bool doFill);
+
+    size_t getBytesUsed() const { return fCache.getBytesUsed(); }
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+
+    /**
+     *  Set the maximum number of bytes available to this cache. If the current
+     *  cache exceeds this new value, it will be purged to try to fit within
+     *  this new limit. A limit of 0 disables the cache.
+     */
+    size_t setByteLimit(size_t newLimit);
+
+    int getHitCount() const { return fCache.getHitCount(); }
+    int getMissCount() const { return fCache.getMissCount(); }
+
+public:
+    struct Rec;
+
+private:
+    SkTLRUCache<Rec, Key>   fCache;
+
+    // Hashes of keys we've been asked to add once, indexed by their low bits.
+    enum { kSeenCount = 256 };
+    uint32_t                fSeen[kSeenCount];
+};
+
+#endif
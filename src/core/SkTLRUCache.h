@@ -0,0 +1,159 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTLRUCache_DEFINED
+#define SkTLRUCache_DEFINED
+
+#include "SkTDynamicHash.h"
+#include "SkTInternalLList.h"
+
+/**
+ *  A cache of entries T, found by Key, that holds at most byteLimit bytes of
+ *  them and purges the least-recently-used first. The cache owns its entries
+ *  and deletes them with SkDELETE. It is not thread-safe; the caches built on
+ *  it wrap a global instance with a mutex.
+ *
+ *  Traits requires, as well as what SkTDynamicHash requires:
+ *    static size_t BytesUsed(const T&) { ... }
+ *    static bool CanPurge(const T&) { ... }  // e.g. false while locked
+ *  and T must have SK_DECLARE_INTERNAL_LLIST_INTERFACE(T) where we can see it.
+ */
+template <typename T, typename Key, typename Traits = T>
+class SkTLRUCache : SkNoncopyable {
+public:
+    explicit SkTLRUCache(size_t byteLimit)
+        : fBytesUsed(0)
+        , fByteLimit(byteLimit)
+        , fHitCount(0)
+        , fMissCount(0) {}
+
+    ~SkTLRUCache() {
+        T* rec = fLRU.head();
+        while (rec) {
+            T* next = rec->fNext;
+            SkDELETE(rec);
+            rec = next;
+        }
+    }
+
+    /**
+     *  Search the cache for key. If found, make it the most recently used
+     *  entry and return it. If not, return NULL.
+     */
+    T* find(const Key& key) {
+        T* rec = fHash.find(key);
+        if (NULL == rec) {
+            fMissCount += 1;
+            return NULL;
+        }
+        fHitCount += 1;
+
+        // move to the head for our LRU
+        fLRU.remove(rec);
+        fLRU.addToHead(rec);
+        return rec;
+    }
+
+    /**
+     *  Add rec to the cache, which takes ownership of it, and return true.
+     *  If rec's key is already present, or rec alone would exceed the byte
+     *  limit, return false and leave rec with the caller.
+     */
+    bool add(T* rec) {
+        const size_t bytes = Traits::BytesUsed(*rec);
+        if (fHash.find(Traits::GetKey(*rec)) || bytes > fByteLimit) {
+            return false;
+        }
+
+        fLRU.addToHead(rec);
+        fHash.add(rec);
+        fBytesUsed += bytes;
+
+        // We may (now) be overbudget, so see if we need to purge something.
+        this->purgeAsNeeded();
+        this->validate();
+        return true;
+    }
+
+    /**
+     *  Purge least-recently-used entries that Traits::CanPurge() until we fit
+     *  within the byte limit, or have nothing left to purge. Call this when an
+     *  entry that couldn't be purged becomes purgeable.
+     */
+    void purgeAsNeeded() {
+        T* rec = fLRU.tail();
+        while (rec && fBytesUsed > fByteLimit) {
+            T* prev = rec->fPrev;
+            if (Traits::CanPurge(*rec)) {
+                this->purgeRec(rec);
+            }
+            rec = prev;
+        }
+    }
+
+    size_t getBytesUsed() const { return fBytesUsed; }
+    size_t getByteLimit() const { return fByteLimit; }
+
+    /**
+     *  Set the maximum number of bytes available to this cache. If the current
+     *  cache exceeds this new value, it will be purged to try to fit within
+     *  this new limit. A limit of 0 disables the cache.
+     */
+    size_t setByteLimit(size_t newLimit) {
+        size_t prevLimit = fByteLimit;
+        fByteLimit = newLimit;
+        if (newLimit < prevLimit) {
+            this->purgeAsNeeded();
+        }
+        return prevLimit;
+    }
+
+    int count() const { return fHash.count(); }
+    int getHitCount() const { return fHitCount; }
+    int getMissCount() const { return fMissCount; }
+
+private:
+    SkTInternalLList<T>                 fLRU;   // most recently used at the head
+    SkTDynamicHash<T, Key, Traits>      fHash;
+
+    size_t  fBytesUsed;
+    size_t  fByteLimit;
+
+    int     fHitCount;
+    int     fMissCount;
+
+    void purgeRec(T* rec) {
+        const size_t bytes = Traits::BytesUsed(*rec);
+        SkASSERT(bytes <= fBytesUsed);
+
+        fBytesUsed -= bytes;
+        fLRU.remove(rec);
+        fHash.remove(Traits::GetKey(*rec));
+        SkDELETE(rec);
+    }
+
+#ifdef SK_DEBUG
+    void validate() const {
+        fLRU.validate();
+
+        size_t used = 0;
+        int count = 0;
+        typename SkTInternalLList<T>::Iter iter;
+        for (T* rec = iter.init(fLRU, SkTInternalLList<T>::Iter::kHead_IterStart);
+             rec; rec = iter.next()) {
+            used += Traits::BytesUsed(*rec);
+            count += 1;
+        }
+        SkASSERT(used == fBytesUsed);
+        SkASSERT(count == fHash.count());
+    }
+#else
+    void validate() const {}
+#endif
+};
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTaskGroup.h"
+#include "SkOnce.h"
+#include "SkTDArray.h"
+
+#if defined(SK_BUILD_FOR_WIN32)
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+int SkTaskGroup::NumCores() {
+#if defined(SK_BUILD_FOR_WIN32)
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return sysinfo.dwNumberOfProcessors;
+#elif defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_ANDROID)
+    return (int) sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    return 1;
+#endif
+}
+
+namespace {
+
+// A lock with one condition, which is all the pool needs. This is SkCondVar,
+// which lives in utils, where core can't use it.
+class CondVar : SkNoncopyable {
+public:
+#if defined(SK_BUILD_FOR_WIN32)
+    CondVar() {
+        InitializeCriticalSection(&fCriticalSection);
+        InitializeConditionVariable(&fCondition);
+    }
+    void lock() { EnterCriticalSection(&fCriticalSection); }
+    void unlock() { LeaveCriticalSection(&fCriticalSection); }
+    void wait() { SleepConditionVariableCS(&fCondition, &fCriticalSection, INFINITE); }
+    void broadcast() { WakeAllConditionVariable(&fCondition); }
+
+private:
+    CRITICAL_SECTION    fCriticalSection;
+    CONDITION_VARIABLE  fCondition;
+#else
+    CondVar() {
+        pthread_mutex_init(&fMutex, NULL);
+        pthread_cond_init(&fCond, NULL);
+    }
+    void lock() { pthread_mutex_lock(&fMutex); }
+    void unlock() { pthread_mutex_unlock(&fMutex); }
+    void wait() { pthread_cond_wait(&fCond, &fMutex); }
+    void broadcast() { pthread_cond_broadcast(&fCond); }
+
+private:
+    pthread_mutex_t fMutex;
+    pthread_cond_t  fCond;
+#endif
+};
+
+class ThreadPool : SkNoncopyable {
+public:
+    // Returns the pool, or NULL if this machine has one core, so work should run right away.
+    static ThreadPool* Get() {
+        SK_DECLARE_STATIC_ONCE(once);
+        SkOnce(&once, Create);
+        return gPool;
+    }
+
+    void add(SkRunnable* runnable, int* pending) {
+        fReady.lock();
+        Work* work = fWork.append();
+        work->fRunnable = runnable;
+        work->fPending = pending;
+        *pending += 1;
+        fReady.broadcast();
+        fReady.unlock();
+    }
+
+    void wait(int* pending) {
+        fReady.lock();
+        while (*pending > 0) {
+            // Rather than just sleep, run work (anyone's) ourselves. That way a
+            // group waited on from inside a pool thread can't starve for threads.
+            if (!this->runOne()) {
+                fReady.wait();
+            }
+        }
+        fReady.unlock();
+    }
+
+private:
+    struct Work {
+        SkRunnable* fRunnable;
+        int*        fPending;
+    };
+
+    static ThreadPool* gPool;
+
+    static void Create() {
+        const int threads = SkTaskGroup::NumCores();
+        if (threads > 1) {
+            gPool = SkNEW_ARGS(ThreadPool, (threads));
+        }
+    }
+
+    explicit ThreadPool(int threads) {
+        // The threads, like the pool, live until the process exits.
+        for (int i = 0; i < threads; i++) {
+#if defined(SK_BUILD_FOR_WIN32)
+            HANDLE thread = CreateThread(NULL, 0, &ThreadPool::Loop, this, 0, NULL);
+            SkASSERT(NULL != thread);
+            CloseHandle(thread);
+#else
+            pthread_t thread;
+            SkAssertResult(0 == pthread_create(&thread, NULL, &ThreadPool::Loop, this));
+            pthread_detach(thread);
+#endif
+        }
+    }
+
+    // Must hold fReady. Runs the oldest queued work, if there is any, and returns
+    // true, or returns false. Unlocks fReady while the work runs.
+    bool runOne() {
+        if (fWork.isEmpty()) {
+            return false;
+        }
+        Work work = fWork[0];
+        fWork.remove(0);
+
+        fReady.unlock();
+        work.fRunnable->run();
+        fReady.lock();
+
+        *work.fPending -= 1;
+        if (0 == *work.fPending) {
+            fReady.broadcast();     // wake whoever is waiting on that group
+        }
+        return true;
+    }
+
+#if defined(SK_BUILD_FOR_WIN32)
+    static DWORD WINAPI Loop(void* arg) {
+#else
+    static void* Loop(void* arg) {
+#endif
+        ThreadPool* pool = static_cast<ThreadPool*>(arg);
+        pool->fReady.lock();
+        while (true) {
+            if (!pool->runOne()) {
+                pool->fReady.wait();
+            }
+        }
+        return 0;   // Unreachable.
+    }
+
+    SkTDArray<Work> fWork;
+    CondVar         fReady;     // Guards fWork and every group's fPending.
+};
+
+ThreadPool* ThreadPool::gPool = NULL;
+
+}  // namespace
+
+SkTaskGroup::SkTaskGroup() : fPending(0) {}
+
+void SkTaskGroup::add(SkRunnable* runnable) {
+    ThreadPool* pool = ThreadPool::Get();
+    if (NULL == pool) {
+        runnable->run();
+    } else {
+        pool->add(runnable, &fPending);
+    }
+}
+
+void SkTaskGroup::wait() {
+    ThreadPool* pool = ThreadPool::Get();
+    if (NULL != pool) {
+        pool->wait(&fPending);
+    }
+}
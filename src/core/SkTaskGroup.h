@@ -0,0 +1,44 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTaskGroup_DEFINED
+#define SkTaskGroup_DEFINED
+
+#include "SkRunnable.h"
+#include "SkTypes.h"
+
+/**
+ *  Runs SkRunnables on a process-wide pool of threads, one per core, which is
+ *  created the first time any group adds work and lives as long as the
+ *  process. Groups themselves are cheap, so make one for each batch of work.
+ *
+ *  wait() runs queued work on the calling thread until all of this group's
+ *  work is done, so work in one group may itself make and wait on a group.
+ */
+class SkTaskGroup : SkNoncopyable {
+public:
+    /** Returns the number of cores on this machine. */
+    static int NumCores();
+
+    SkTaskGroup();
+    ~SkTaskGroup() { this->wait(); }
+
+    /**
+     *  Queue runnable to run on the pool. Does not take ownership; runnable
+     *  must live until wait() returns. If the pool has no threads (one core),
+     *  runs it right away.
+     */
+    void add(SkRunnable* runnable);
+
+    /** Block until all the runnables added to this group have run. */
+    void wait();
+
+private:
+    int fPending;   // Added and not yet done. Guarded by the pool's lock.
+};
+
+#endif
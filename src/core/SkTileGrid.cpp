@@ -8,8 +8,7 @@
 
 #include "SkTileGrid.h"
 
-SkTileGrid::SkTileGrid(int xTileCount, int yTileCount, const SkTileGridFactory::TileGridInfo& info,
-                       SkTileGridNextDatumFunctionPtr nextDatumFunction) {
+SkTileGrid::SkTileGrid(int xTileCount, int yTileCount, const SkTileGridFactory::TileGridInfo& info) {
     fXTileCount = xTileCount;
     fYTileCount = yTileCount;
     fInfo = info;
@@ -21,8 +20,7 @@ SkTileGrid::SkTileGrid(int xTileCount, int yTileCount, const SkTileGridFactory::
     fInsertionCount = 0;
     fGridBounds = SkIRect::MakeXYWH(0, 0, fInfo.fTileInterval.width() * fXTileCount,
         fInfo.fTileInterval.height() * fYTileCount);
-    fNextDatumFunction = nextDatumFunction;
-    fTileData = SkNEW_ARRAY(SkTDArray<void *>, fTileCount);
+    fTileData = SkNEW_ARRAY(SkTDArray<Entry>, fTileCount);
 }
 
 SkTileGrid::~SkTileGrid() {
@@ -33,7 +31,7 @@ int SkTileGrid::tileCount(int x, int y) {
     return this->tile(x, y).count();
 }
 
-SkTDArray<void *>& SkTileGrid::tile(int x, int y) {
+SkTDArray<SkTileGrid::Entry>& SkTileGrid::tile(int x, int y) {
     return fTileData[y * fXTileCount + x];
 }
 
@@ -57,9 +55,10 @@ void SkTileGrid::insert(void* data, const SkIRect& bounds, bool) {
     int maxTileY = SkMax32(SkMin32((dilatedBounds.bottom() -1) / fInfo.fTileInterval.height(),
         fYTileCount -1), 0);
 
+    const Entry entry = { data, fInsertionCount };
     for (int x = minTileX; x <= maxTileX; x++) {
         for (int y = minTileY; y <= maxTileY; y++) {
-            this->tile(x, y).push(data);
+            this->tile(x, y).push(entry);
         }
     }
     fInsertionCount++;
@@ -90,13 +89,17 @@ void SkTileGrid::search(const SkIRect& query, SkTDArray<void*>* results) {
 
     int queryTileCount = (tileEndX - tileStartX) * (tileEndY - tileStartY);
     SkASSERT(queryTileCount);
+    results->reset();
     if (queryTileCount == 1) {
-        *results = this->tile(tileStartX, tileStartY);
+        const SkTDArray<Entry>& tile = this->tile(tileStartX, tileStartY);
+        void** data = results->append(tile.count());
+        for (int i = 0; i < tile.count(); i++) {
+            data[i] = tile[i].fData;
+        }
     } else {
-        results->reset();
         SkAutoSTArray<kStackAllocationTileCount, int> curPositions(queryTileCount);
-        SkAutoSTArray<kStackAllocationTileCount, SkTDArray<void *>*> storage(queryTileCount);
-        SkTDArray<void *>** tileRange = storage.get();
+        SkAutoSTArray<kStackAllocationTileCount, SkTDArray<Entry>*> storage(queryTileCount);
+        SkTDArray<Entry>** tileRange = storage.get();
         int tile = 0;
         for (int x = tileStartX; x < tileEndX; ++x) {
             for (int y = tileStartY; y < tileEndY; ++y) {
@@ -105,13 +108,52 @@ void SkTileGrid::search(const SkIRect& query, SkTDArray<void*>* results) {
                 ++tile;
             }
         }
-        void *nextElement;
-        while(NULL != (nextElement = fNextDatumFunction(tileRange, curPositions))) {
+        void* nextElement;
+        while (NextDatum(tileRange, curPositions, &nextElement)) {
             results->push(nextElement);
         }
     }
 }
 
+bool SkTileGrid::NextDatum(SkTDArray<Entry>** tileData,
+                           SkAutoSTArray<kStackAllocationTileCount, int>& tileIndices,
+                           void** datum) {
+    const Entry* minVal = NULL;
+    int tileCount = tileIndices.count();
+    int minIndex = tileCount;
+    int maxIndex = 0;
+    // Find the next Datum; track where it's found so we reduce the size of the second loop.
+    for (int tile = 0; tile < tileCount; ++tile) {
+        int pos = tileIndices[tile];
+        if (pos != kTileFinished) {
+            const Entry* candidate = &(*tileData[tile])[pos];
+            if (NULL == minVal || candidate->fOrder < minVal->fOrder) {
+                minVal = candidate;
+                minIndex = tile;
+                maxIndex = tile;
+            } else if (candidate->fOrder == minVal->fOrder) {
+                // The same datum was inserted into several tiles; consume it from all of them.
+                maxIndex = tile;
+            }
+        }
+    }
+    if (NULL == minVal) {
+        return false;
+    }
+    // Increment indices past the next datum
+    const int order = minVal->fOrder;
+    *datum = minVal->fData;
+    for (int tile = minIndex; tile <= maxIndex; ++tile) {
+        int pos = tileIndices[tile];
+        if (pos != kTileFinished && (*tileData[tile])[pos].fOrder == order) {
+            if (++(tileIndices[tile]) >= tileData[tile]->count()) {
+                tileIndices[tile] = kTileFinished;
+            }
+        }
+    }
+    return true;
+}
+
 void SkTileGrid::clear() {
     for (int i = 0; i < fTileCount; i++) {
         fTileData[i].reset();
@@ -125,7 +167,7 @@ int SkTileGrid::getCount() const {
 void SkTileGrid::rewindInserts() {
     SkASSERT(fClient);
     for (int i = 0; i < fTileCount; ++i) {
-        while (!fTileData[i].isEmpty() && fClient->shouldRewind(fTileData[i].top())) {
+        while (!fTileData[i].isEmpty() && fClient->shouldRewind(fTileData[i].top().fData)) {
             fTileData[i].pop();
         }
     }
@@ -211,8 +211,13 @@ uint32_t SkValidatingReadBuffer::getArrayCount() {
 }
 
 SkTypeface* SkValidatingReadBuffer::readTypeface() {
-    // TODO: Implement this (securely) when needed
-    return NULL;
+    // 0 means no typeface, otherwise this is a 1-based index into the array from
+    // setTypefaceArray().
+    const uint32_t index = this->readUInt();
+    if (!this->validate(index <= (uint32_t)fTFCount) || 0 == index) {
+        return NULL;
+    }
+    return fTFArray[index - 1];
 }
 
 bool SkValidatingReadBuffer::validateAvailable(size_t size) {
@@ -774,6 +774,29 @@ void SkXfermode::xferA8(SkAlpha* SK_RESTRICT dst,
     }
 }
 
+void SkXfermode::xfer4f(SkPM4f* SK_RESTRICT dst,
+                        const SkPM4f* SK_RESTRICT src, int count,
+                        const SkAlpha* SK_RESTRICT aa) const {
+    SkASSERT(dst && src && count >= 0);
+
+    const int kTmpCount = 64;
+    SkPMColor srcC[kTmpCount], dstC[kTmpCount];
+
+    while (count > 0) {
+        int n = SkMin32(count, kTmpCount);
+        SkPM4fToPMColor(src, n, srcC);
+        SkPM4fToPMColor(dst, n, dstC);
+        this->xfer32(dstC, srcC, n, aa);
+        SkPMColorToPM4f(dstC, n, dst);
+        src += n;
+        dst += n;
+        if (aa) {
+            aa += n;
+        }
+        count -= n;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 #if SK_SUPPORT_GPU
@@ -1362,6 +1385,86 @@ void SkProcCoeffXfermode::xferA8(SkAlpha* SK_RESTRICT dst,
     }
 }
 
+static inline void coeff_4f(SkXfermode::Coeff coeff, const SkPM4f& s, const SkPM4f& d,
+                            float f[4]) {
+    switch (coeff) {
+        case SkXfermode::kZero_Coeff:
+            f[0] = f[1] = f[2] = f[3] = 0;
+            break;
+        case SkXfermode::kOne_Coeff:
+            f[0] = f[1] = f[2] = f[3] = 1;
+            break;
+        case SkXfermode::kSC_Coeff:
+            for (int i = 0; i < 4; ++i) {
+                f[i] = s.fVec[i];
+            }
+            break;
+        case SkXfermode::kISC_Coeff:
+            for (int i = 0; i < 4; ++i) {
+                f[i] = 1 - s.fVec[i];
+            }
+            break;
+        case SkXfermode::kDC_Coeff:
+            for (int i = 0; i < 4; ++i) {
+                f[i] = d.fVec[i];
+            }
+            break;
+        case SkXfermode::kIDC_Coeff:
+            for (int i = 0; i < 4; ++i) {
+                f[i] = 1 - d.fVec[i];
+            }
+            break;
+        case SkXfermode::kSA_Coeff:
+            f[0] = f[1] = f[2] = f[3] = s.a();
+            break;
+        case SkXfermode::kISA_Coeff:
+            f[0] = f[1] = f[2] = f[3] = 1 - s.a();
+            break;
+        case SkXfermode::kDA_Coeff:
+            f[0] = f[1] = f[2] = f[3] = d.a();
+            break;
+        case SkXfermode::kIDA_Coeff:
+            f[0] = f[1] = f[2] = f[3] = 1 - d.a();
+            break;
+        default:
+            SkDEBUGFAIL("unknown coeff");
+            f[0] = f[1] = f[2] = f[3] = 0;
+            break;
+    }
+}
+
+void SkProcCoeffXfermode::xfer4f(SkPM4f* SK_RESTRICT dst,
+                                 const SkPM4f* SK_RESTRICT src, int count,
+                                 const SkAlpha* SK_RESTRICT aa) const {
+    SkASSERT(dst && src && count >= 0);
+
+    if (CANNOT_USE_COEFF == fSrcCoeff) {
+        this->INHERITED::xfer4f(dst, src, count, aa);
+        return;
+    }
+
+    const Coeff sc = fSrcCoeff;
+    const Coeff dc = fDstCoeff;
+
+    for (int i = count - 1; i >= 0; --i) {
+        unsigned a = aa ? aa[i] : 0xFF;
+        if (0 == a) {
+            continue;
+        }
+        const SkPM4f s = src[i];
+        const SkPM4f d = dst[i];
+        float fs[4], fd[4];
+        coeff_4f(sc, s, d, fs);
+        coeff_4f(dc, s, d, fd);
+
+        const float scale = a * (1.0f / 255);
+        for (int c = 0; c < 4; ++c) {
+            float v = SkTMin(s.fVec[c] * fs[c] + d.fVec[c] * fd[c], 1.0f);
+            dst[i].fVec[c] = d.fVec[c] + (v - d.fVec[c]) * scale;
+        }
+    }
+}
+
 #if SK_SUPPORT_GPU
 bool SkProcCoeffXfermode::asNewEffect(GrEffectRef** effect,
                                       GrTexture* background) const {
@@ -25,6 +25,8 @@ public:
                         const SkAlpha aa[]) const SK_OVERRIDE;
     virtual void xferA8(SkAlpha dst[], const SkPMColor src[], int count,
                         const SkAlpha aa[]) const SK_OVERRIDE;
+    virtual void xfer4f(SkPM4f dst[], const SkPM4f src[], int count,
+                        const SkAlpha aa[]) const SK_OVERRIDE;
 
     virtual bool asMode(Mode* mode) const SK_OVERRIDE;
 
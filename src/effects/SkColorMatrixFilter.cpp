@@ -217,7 +217,7 @@ SkColorMatrixFilter::SkColorMatrixFilter(const SkScalar array[20]) {
 }
 
 uint32_t SkColorMatrixFilter::getFlags() const {
-    return this->INHERITED::getFlags() | fFlags;
+    return this->INHERITED::getFlags() | fFlags | kSupports4f_Flag;
 }
 
 void SkColorMatrixFilter::filterSpan(const SkPMColor src[], int count,
@@ -266,6 +266,50 @@ void SkColorMatrixFilter::filterSpan(const SkPMColor src[], int count,
     }
 }
 
+static inline float pin_unit(float value) {
+    return value > 0 ? SkTMin(value, 1.0f) : 0;
+}
+
+void SkColorMatrixFilter::filterSpan4f(const SkPM4f src[], int count,
+                                       SkPM4f dst[]) const {
+    if (NULL == fProc) {
+        if (src != dst) {
+            memcpy(dst, src, count * sizeof(SkPM4f));
+        }
+        return;
+    }
+
+    // fMatrix's translate column is in 0..255 units
+    const SkScalar* m = fMatrix.fMat;
+    const float transScale = 1.0f / 255;
+
+    for (int i = 0; i < count; i++) {
+        float r = src[i].r();
+        float g = src[i].g();
+        float b = src[i].b();
+        float a = src[i].a();
+
+        // need our components to be un-premultiplied
+        if (a > 0) {
+            float invA = 1 / a;
+            r *= invA;
+            g *= invA;
+            b *= invA;
+        }
+
+        float rr = m[0] * r + m[1] * g + m[2] * b + m[3] * a + m[4] * transScale;
+        float gg = m[5] * r + m[6] * g + m[7] * b + m[8] * a + m[9] * transScale;
+        float bb = m[10] * r + m[11] * g + m[12] * b + m[13] * a + m[14] * transScale;
+        float aa = m[15] * r + m[16] * g + m[17] * b + m[18] * a + m[19] * transScale;
+
+        aa = pin_unit(aa);
+        dst[i].fVec[SkPM4f::R] = pin_unit(rr) * aa;
+        dst[i].fVec[SkPM4f::G] = pin_unit(gg) * aa;
+        dst[i].fVec[SkPM4f::B] = pin_unit(bb) * aa;
+        dst[i].fVec[SkPM4f::A] = aa;
+    }
+}
+
 void SkColorMatrixFilter::filterSpan16(const uint16_t src[], int count,
                                        uint16_t dst[]) const {
     SkASSERT(fFlags & SkColorFilter::kHasFilter16_Flag);
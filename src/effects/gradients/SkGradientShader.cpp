@@ -6,6 +6,7 @@
  */
 
 #include "SkGradientShaderPriv.h"
+#include "SkGradientCache.h"
 #include "SkLinearGradient.h"
 #include "SkRadialGradient.h"
 #include "SkTwoPointRadialGradient.h"
@@ -255,6 +256,8 @@ SkGradientShaderBase::GradientShaderBaseContext::GradientShaderBaseContext(
         const SkGradientShaderBase& shader, const ContextRec& rec)
     : INHERITED(shader, rec)
     , fCache(shader.refCache(getPaintAlpha()))
+    , fColors4f(shader.fColorCount)
+    , fPos4f(shader.fColorCount)
 {
     const SkMatrix& inverse = this->getTotalInverse();
 
@@ -263,6 +266,8 @@ SkGradientShaderBase::GradientShaderBaseContext::GradientShaderBaseContext(
     fDstToIndexProc = fDstToIndex.getMapXYProc();
     fDstToIndexClass = (uint8_t)SkShader::Context::ComputeMatrixClass(fDstToIndex);
 
+    SkGradientGetPlatformSpanProcs(&fSpanProcs);
+
     // now convert our colors in to PMColors
     unsigned paintAlpha = this->getPaintAlpha();
 
@@ -275,15 +280,134 @@ SkGradientShaderBase::GradientShaderBaseContext::GradientShaderBaseContext(
     if (shader.fColorsAreOpaque) {
         fFlags |= kHasSpan16_Flag;
     }
+
+    const bool interpInPremul = SkToBool(shader.fGradFlags &
+                                         SkGradientShader::kInterpolateColorsInPremul_Flag);
+    const float scale = 1.0f / 255;
+    for (int i = 0; i < shader.fColorCount; ++i) {
+        SkColor c = shader.fOrigColors[i];
+        float a = SkColorGetA(c) * paintAlpha * (scale * scale);
+        float rgbScale = interpInPremul ? a * scale : scale;
+        fColors4f[i].fVec[SkPM4f::R] = SkColorGetR(c) * rgbScale;
+        fColors4f[i].fVec[SkPM4f::G] = SkColorGetG(c) * rgbScale;
+        fColors4f[i].fVec[SkPM4f::B] = SkColorGetB(c) * rgbScale;
+        fColors4f[i].fVec[SkPM4f::A] = a;
+    }
+    if (shader.fColorCount > 2) {
+        for (int i = 0; i < shader.fColorCount; ++i) {
+            fPos4f[i] = SkFixedToFloat(shader.fRecs[i].fPos);
+        }
+    } else {
+        fPos4f[0] = 0;
+        fPos4f[1] = 1;
+    }
+}
+
+static inline float tile_4f(float t, SkShader::TileMode mode) {
+    switch (mode) {
+        case SkShader::kRepeat_TileMode:
+            return t - sk_float_floor(t);
+        case SkShader::kMirror_TileMode: {
+            // fold the period [0..2) back onto [0..1]
+            float t2 = t * 0.5f;
+            t2 = (t2 - sk_float_floor(t2)) * 2;
+            return t2 > 1 ? 2 - t2 : t2;
+        }
+        default:
+            // written so that a NaN ends up as 0
+            return t > 0 ? SkTMin(t, 1.0f) : 0;
+    }
+}
+
+void SkGradientShaderBase::GradientShaderBaseContext::mapSpan4f(int x, int y, SkPoint pts[],
+                                                               int count) const {
+    SkScalar dstX = SkIntToScalar(x) + SK_ScalarHalf;
+    SkScalar dstY = SkIntToScalar(y) + SK_ScalarHalf;
+
+    if (fDstToIndexClass != kLinear_MatrixClass) {
+        for (int i = 0; i < count; ++i) {
+            fDstToIndexProc(fDstToIndex, dstX + SkIntToScalar(i), dstY, &pts[i]);
+        }
+    } else {
+        fDstToIndexProc(fDstToIndex, dstX, dstY, &pts[0]);
+        SkScalar dx = fDstToIndex.getScaleX();
+        SkScalar dy = fDstToIndex.getSkewY();
+        for (int i = 1; i < count; ++i) {
+            pts[i].set(pts[0].fX + dx * i, pts[0].fY + dy * i);
+        }
+    }
+}
+
+void SkGradientShaderBase::GradientShaderBaseContext::shadeT4f(const SkScalar ts[], int count,
+                                                              SkPM4f dstC[]) const {
+    const SkGradientShaderBase& shader = static_cast<const SkGradientShaderBase&>(fShader);
+    const SkShader::TileMode mode = shader.fTileMode;
+    const bool premulAfterInterp = !(shader.fGradFlags &
+                                     SkGradientShader::kInterpolateColorsInPremul_Flag);
+    const SkPM4f* colors = fColors4f.get();
+    const float* pos = fPos4f.get();
+    const int last = shader.fColorCount - 1;
+
+    for (int i = 0; i < count; ++i) {
+        float t = tile_4f(ts[i], mode);
+
+        // find the stop interval [index - 1, index] that holds t
+        int index = 1;
+        while (index < last && t > pos[index]) {
+            ++index;
+        }
+        float range = pos[index] - pos[index - 1];
+        float f = range > 0 ? (t - pos[index - 1]) / range : 1;
+
+        const SkPM4f& c0 = colors[index - 1];
+        const SkPM4f& c1 = colors[index];
+        SkPM4f c;
+        for (int j = 0; j < 4; ++j) {
+            c.fVec[j] = c0.fVec[j] + (c1.fVec[j] - c0.fVec[j]) * f;
+        }
+        if (premulAfterInterp) {
+            c.fVec[SkPM4f::R] *= c.a();
+            c.fVec[SkPM4f::G] *= c.a();
+            c.fVec[SkPM4f::B] *= c.a();
+        }
+        dstC[i] = c;
+    }
+}
+
+void SkGradientShaderBase::GradientShaderBaseContext::shadeSpan4fWithProc(
+        int x, int y, SkPM4f dstC[], int count, PointsToTProc proc) const {
+    SkASSERT(count > 0);
+
+    SkPoint     pts[kTmp4fCount];
+    SkScalar    ts[kTmp4fCount];
+
+    do {
+        int n = SkMin32(count, kTmp4fCount);
+        this->mapSpan4f(x, y, pts, n);
+        proc(pts, n, ts);
+        this->shadeT4f(ts, n, dstC);
+        dstC += n;
+        x += n;
+        count -= n;
+    } while (count > 0);
 }
 
 SkGradientShaderBase::GradientShaderCache::GradientShaderCache(
         U8CPU alpha, const SkGradientShaderBase& shader)
     : fCacheAlpha(alpha)
-    , fShader(shader)
+    , fColorCount(shader.fColorCount)
+    , fGradFlags(shader.fGradFlags)
+    , fColors(shader.fColorCount)
+    , fPos(shader.fColorCount)
     , fCache16Inited(false)
     , fCache32Inited(false)
 {
+    memcpy(fColors.get(), shader.fOrigColors, fColorCount * sizeof(SkColor));
+    // fRecs is only set up for more than two colors.
+    for (int i = 0; i < fColorCount; i++) {
+        fPos[i] = fColorCount > 2 ? shader.fRecs[i].fPos : 0;
+    }
+
     // Only initialize the cache in getCache16/32.
     fCache16 = NULL;
     fCache32 = NULL;
@@ -499,19 +623,19 @@ void SkGradientShaderBase::GradientShaderCache::initCache16(GradientShaderCache*
     SkASSERT(NULL == cache->fCache16Storage);
     cache->fCache16Storage = (uint16_t*)sk_malloc_throw(allocSize);
     cache->fCache16 = cache->fCache16Storage;
-    if (cache->fShader.fColorCount == 2) {
-        Build16bitCache(cache->fCache16, cache->fShader.fOrigColors[0],
-                        cache->fShader.fOrigColors[1], kCache16Count);
+    if (cache->fColorCount == 2) {
+        Build16bitCache(cache->fCache16, cache->fColors[0],
+                        cache->fColors[1], kCache16Count);
     } else {
-        Rec* rec = cache->fShader.fRecs;
+        const SkFixed* pos = cache->fPos.get();
         int prevIndex = 0;
-        for (int i = 1; i < cache->fShader.fColorCount; i++) {
-            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache16Shift;
+        for (int i = 1; i < cache->fColorCount; i++) {
+            int nextIndex = SkFixedToFFFF(pos[i]) >> kCache16Shift;
             SkASSERT(nextIndex < kCache16Count);
 
             if (nextIndex > prevIndex)
-                Build16bitCache(cache->fCache16 + prevIndex, cache->fShader.fOrigColors[i-1],
-                                cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1);
+                Build16bitCache(cache->fCache16 + prevIndex, cache->fColors[i-1],
+                                cache->fColors[i], nextIndex - prevIndex + 1);
             prevIndex = nextIndex;
         }
     }
@@ -534,34 +658,70 @@ void SkGradientShaderBase::GradientShaderCache::initCache32(GradientShaderCache*
     SkASSERT(NULL == cache->fCache32PixelRef);
     cache->fCache32PixelRef = SkMallocPixelRef::NewAllocate(info, 0, NULL);
     cache->fCache32 = (SkPMColor*)cache->fCache32PixelRef->getAddr();
-    if (cache->fShader.fColorCount == 2) {
-        Build32bitCache(cache->fCache32, cache->fShader.fOrigColors[0],
-                        cache->fShader.fOrigColors[1], kCache32Count, cache->fCacheAlpha,
-                        cache->fShader.fGradFlags);
+    if (cache->fColorCount == 2) {
+        Build32bitCache(cache->fCache32, cache->fColors[0],
+                        cache->fColors[1], kCache32Count, cache->fCacheAlpha,
+                        cache->fGradFlags);
     } else {
-        Rec* rec = cache->fShader.fRecs;
+        const SkFixed* pos = cache->fPos.get();
         int prevIndex = 0;
-        for (int i = 1; i < cache->fShader.fColorCount; i++) {
-            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache32Shift;
+        for (int i = 1; i < cache->fColorCount; i++) {
+            int nextIndex = SkFixedToFFFF(pos[i]) >> kCache32Shift;
             SkASSERT(nextIndex < kCache32Count);
 
             if (nextIndex > prevIndex)
-                Build32bitCache(cache->fCache32 + prevIndex, cache->fShader.fOrigColors[i-1],
-                                cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1,
-                                cache->fCacheAlpha, cache->fShader.fGradFlags);
+                Build32bitCache(cache->fCache32 + prevIndex, cache->fColors[i-1],
+                                cache->fColors[i], nextIndex - prevIndex + 1,
+                                cache->fCacheAlpha, cache->fGradFlags);
             prevIndex = nextIndex;
         }
     }
 }
 
+/*
+ *  Fills storage with the words that identify our color tables when built with
+ *  alpha: [alpha + numColors + colors[] + {positions[]} + flags], and returns
+ *  how many there are.
+ */
+int SkGradientShaderBase::makeCacheKey(U8CPU alpha, SkAutoSTMalloc<16, uint32_t>* storage) const {
+    int count = 1 + 1 + fColorCount + 1;
+    if (fColorCount > 2) {
+        count += fColorCount - 1;    // fRecs[].fPos
+    }
+
+    uint32_t* buffer = storage->reset(count);
+    *buffer++ = alpha;
+    *buffer++ = fColorCount;
+    memcpy(buffer, fOrigColors, fColorCount * sizeof(SkColor));
+    buffer += fColorCount;
+    if (fColorCount > 2) {
+        for (int i = 1; i < fColorCount; i++) {
+            *buffer++ = fRecs[i].fPos;
+        }
+    }
+    *buffer++ = fGradFlags;
+    SkASSERT(buffer - storage->get() == count);
+    return count;
+}
+
+// What a GradientShaderCache costs once both of its tables are built.
+static size_t gradient_cache_bytes(int colorCount, int keyCount) {
+    return sizeof(SkGradientShaderBase::GradientShaderCache) +
+           SkGradientShaderBase::kCache16Count * 2 * sizeof(uint16_t) +
+           SkGradientShaderBase::kCache32Count * 4 * sizeof(SkPMColor) +
+           colorCount * (sizeof(SkColor) + sizeof(SkFixed)) +
+           keyCount * sizeof(uint32_t);
+}
+
 /*
  *  The gradient holds a cache for the most recent value of alpha. Successive
- *  callers with the same alpha value will share the same cache.
+ *  callers with the same alpha value will share the same cache. Gradients with
+ *  the same colors, positions and flags share caches through SkGradientCache.
  */
 SkGradientShaderBase::GradientShaderCache* SkGradientShaderBase::refCache(U8CPU alpha) const {
     SkAutoMutexAcquire ama(fCacheMutex);
     if (!fCache || fCache->getAlpha() != alpha) {
-        fCache.reset(SkNEW_ARGS(GradientShaderCache, (alpha, *this)));
+        fCache.reset(this->findOrMakeCache(alpha, NULL));
     }
     // Increment the ref counter inside the mutex to ensure the returned pointer is still valid.
     // Otherwise, the pointer may have been overwritten on a different thread before the object's
@@ -570,60 +730,43 @@ SkGradientShaderBase::GradientShaderCache* SkGradientShaderBase::refCache(U8CPU
     return fCache;
 }
 
+SkGradientShaderBase::GradientShaderCache* SkGradientShaderBase::findOrMakeCache(
+        U8CPU alpha, SkGradientCache* cache) const {
+    SkAutoSTMalloc<16, uint32_t> storage;
+    int count = this->makeCacheKey(alpha, &storage);
+    SkGradientCache::Key key(storage.get(), count);
+
+    SkRefCnt* found = cache ? cache->findAndRef(key) : SkGradientCache::FindAndRef(key);
+    GradientShaderCache* tables = static_cast<GradientShaderCache*>(found);
+    if (NULL == tables) {
+        tables = SkNEW_ARGS(GradientShaderCache, (alpha, *this));
+        const size_t bytes = gradient_cache_bytes(fColorCount, count);
+        if (cache) {
+            cache->add(key, tables, bytes);
+        } else {
+            SkGradientCache::Add(key, tables, bytes);
+        }
+    }
+    return tables;
+}
+
 /*
  *  Because our caller might rebuild the same (logically the same) gradient
  *  over and over, we'd like to return exactly the same "bitmap" if possible,
  *  allowing the client to utilize a cache of our bitmap (e.g. with a GPU).
- *  To do that, we maintain a private cache of built-bitmaps, based on our
- *  colors and positions. Note: we don't try to flatten the fMapper, so if one
- *  is present, we skip the cache for now.
+ *  Gradients with the same colors, positions and flags share their table's
+ *  pixelref through SkGradientCache, so while it is cached they all return
+ *  the same bitmap.
  */
 void SkGradientShaderBase::getGradientTableBitmap(SkBitmap* bitmap) const {
     // our caller assumes no external alpha, so we ensure that our cache is
     // built with 0xFF
     SkAutoTUnref<GradientShaderCache> cache(this->refCache(0xFF));
 
-    // build our key: [numColors + colors[] + {positions[]} + flags ]
-    int count = 1 + fColorCount + 1;
-    if (fColorCount > 2) {
-        count += fColorCount - 1;    // fRecs[].fPos
-    }
-
-    SkAutoSTMalloc<16, int32_t> storage(count);
-    int32_t* buffer = storage.get();
-
-    *buffer++ = fColorCount;
-    memcpy(buffer, fOrigColors, fColorCount * sizeof(SkColor));
-    buffer += fColorCount;
-    if (fColorCount > 2) {
-        for (int i = 1; i < fColorCount; i++) {
-            *buffer++ = fRecs[i].fPos;
-        }
-    }
-    *buffer++ = fGradFlags;
-    SkASSERT(buffer - storage.get() == count);
-
-    ///////////////////////////////////
-
-    SK_DECLARE_STATIC_MUTEX(gMutex);
-    static SkBitmapCache* gCache;
-    // each cache cost 1K of RAM, since each bitmap will be 1x256 at 32bpp
-    static const int MAX_NUM_CACHED_GRADIENT_BITMAPS = 32;
-    SkAutoMutexAcquire ama(gMutex);
-
-    if (NULL == gCache) {
-        gCache = SkNEW_ARGS(SkBitmapCache, (MAX_NUM_CACHED_GRADIENT_BITMAPS));
-    }
-    size_t size = count * sizeof(int32_t);
-
-    if (!gCache->find(storage.get(), size, bitmap)) {
-        // force our cahce32pixelref to be built
-        (void)cache->getCache32();
-        bitmap->setInfo(SkImageInfo::MakeN32Premul(kCache32Count, 1));
-        bitmap->setPixelRef(cache->getCache32PixelRef());
-
-        gCache->add(storage.get(), size, *bitmap);
-    }
+    // force our cache32pixelref to be built
+    (void)cache->getCache32();
+    bitmap->setInfo(SkImageInfo::MakeN32Premul(kCache32Count, 1));
+    bitmap->setPixelRef(cache->getCache32PixelRef());
 }
 
 void SkGradientShaderBase::commonAsAGradient(GradientInfo* info, bool flipGrad) const {
@@ -11,15 +11,17 @@
 #include "SkGradientShader.h"
 #include "SkClampRange.h"
 #include "SkColorPriv.h"
+#include "SkGradient_opts.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkMallocPixelRef.h"
 #include "SkUtils.h"
 #include "SkTemplates.h"
-#include "SkBitmapCache.h"
 #include "SkShader.h"
 #include "SkOnce.h"
 
+class SkGradientCache;
+
 static inline void sk_memset32_dither(uint32_t dst[], uint32_t v0, uint32_t v1,
                                int count) {
     if (count > 0) {
@@ -100,7 +102,9 @@ public:
     SkGradientShaderBase(const Descriptor& desc, const SkMatrix* localMatrix);
     virtual ~SkGradientShaderBase();
 
-    // The cache is initialized on-demand when getCache16/32 is called.
+    // The cache is initialized on-demand when getCache16/32 is called. It copies
+    // the shader's colors and positions, so that shaders with the same ones can
+    // share it through SkGradientCache, and it may outlive the shader.
     class GradientShaderCache : public SkRefCnt {
     public:
         GradientShaderCache(U8CPU alpha, const SkGradientShaderBase& shader);
@@ -124,7 +128,13 @@ public:
                                               // Larger than 8bits so we can store uninitialized
                                               // value.
 
-        const SkGradientShaderBase& fShader;
+        enum {
+            kStopStorageCount = 4   // beyond this many stops, the arrays below use sk_malloc
+        };
+        const int       fColorCount;
+        const uint8_t   fGradFlags;
+        SkAutoSTMalloc<kStopStorageCount, SkColor> fColors;    // the shader's fOrigColors
+        SkAutoSTMalloc<kStopStorageCount, SkFixed> fPos;       // the shader's fRecs[].fPos
 
         // Make sure we only initialize the caches once.
         bool    fCache16Inited, fCache32Inited;
@@ -152,7 +162,36 @@ public:
 
         SkAutoTUnref<GradientShaderCache> fCache;
 
+        // The SIMD span procs for this CPU; NULL ones fall back to the portable loops.
+        SkGradientSpanProcs fSpanProcs;
+
+        // Maps count device points to gradient t values (before tiling).
+        typedef void (*PointsToTProc)(const SkPoint pts[], int count, SkScalar t[]);
+
+        /**
+         *  Implements shadeSpan4f() for a subclass: maps each pixel center through
+         *  fDstToIndex, converts it to t with proc, then evaluates the stops in float,
+         *  bypassing the 256 entry color cache. Subclasses that use this should also
+         *  set kSupports4f_Flag.
+         */
+        void shadeSpan4fWithProc(int x, int y, SkPM4f dstC[], int count,
+                                 PointsToTProc proc) const;
+
     private:
+        enum {
+            kTmp4fCount = 64,
+            kColor4fStorageCount = 4    // beyond this many colors, the arrays below use sk_malloc
+        };
+
+        // Our colors in float, already modulated by the paint's alpha, and
+        // premultiplied if the shader interpolates in premul. Positions run from
+        // 0 to 1, like fRecs[].fPos.
+        SkAutoSTMalloc<kColor4fStorageCount, SkPM4f> fColors4f;
+        SkAutoSTMalloc<kColor4fStorageCount, float>  fPos4f;
+
+        void mapSpan4f(int x, int y, SkPoint pts[], int count) const;
+        void shadeT4f(const SkScalar t[], int count, SkPM4f dstC[]) const;
+
         typedef SkShader::Context INHERITED;
     };
 
@@ -194,6 +233,13 @@ public:
 
     uint32_t getGradFlags() const { return fGradFlags; }
 
+    /**
+     *  Return a ref on the tables for alpha from cache, building and adding
+     *  them if need be. A NULL cache means the global SkGradientCache, which
+     *  is what drawing uses; tests pass their own.
+     */
+    GradientShaderCache* findOrMakeCache(U8CPU alpha, SkGradientCache* cache) const;
+
 protected:
     SkGradientShaderBase(SkReadBuffer& );
     virtual void flatten(SkWriteBuffer&) const SK_OVERRIDE;
@@ -240,6 +286,7 @@ private:
     bool        fColorsAreOpaque;
 
     GradientShaderCache* refCache(U8CPU alpha) const;
+    int makeCacheKey(U8CPU alpha, SkAutoSTMalloc<16, uint32_t>* storage) const;
     mutable SkMutex                           fCacheMutex;
     mutable SkAutoTUnref<GradientShaderCache> fCache;
 
@@ -84,6 +84,8 @@ SkLinearGradient::LinearGradientContext::LinearGradientContext(
         const SkLinearGradient& shader, const ContextRec& rec)
     : INHERITED(shader, rec)
 {
+    fFlags |= SkShader::kSupports4f_Flag;
+
     unsigned mask = SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask;
     if ((fDstToIndex.getType() & ~mask) == 0) {
         // when we dither, we are (usually) not const-in-Y
@@ -253,6 +255,17 @@ void SkLinearGradient::LinearGradientContext::shadeSpan(int x, int y, SkPMColor*
     }
 }
 
+static void linear_points_to_t(const SkPoint pts[], int count, SkScalar t[]) {
+    for (int i = 0; i < count; ++i) {
+        t[i] = pts[i].fX;
+    }
+}
+
+void SkLinearGradient::LinearGradientContext::shadeSpan4f(int x, int y, SkPM4f dstC[],
+                                                          int count) {
+    this->shadeSpan4fWithProc(x, y, dstC, count, linear_points_to_t);
+}
+
 SkShader::BitmapType SkLinearGradient::asABitmap(SkBitmap* bitmap,
                                                 SkMatrix* matrix,
                                                 TileMode xy[]) const {
@@ -167,7 +167,9 @@ SkShader::Context* SkRadialGradient::onCreateContext(const ContextRec& rec, void
 
 SkRadialGradient::RadialGradientContext::RadialGradientContext(
         const SkRadialGradient& shader, const ContextRec& rec)
-    : INHERITED(shader, rec) {}
+    : INHERITED(shader, rec) {
+    fFlags |= SkShader::kSupports4f_Flag;
+}
 
 void SkRadialGradient::RadialGradientContext::shadeSpan16(int x, int y, uint16_t* dstCParam,
                                                           int count) {
@@ -309,13 +311,13 @@ inline bool no_need_for_radial_pin(int fx, int dx,
 typedef void (* RadialShadeProc)(SkScalar sfx, SkScalar sdx,
         SkScalar sfy, SkScalar sdy,
         SkPMColor* dstC, const SkPMColor* cache,
-        int count, int toggle);
+        int count, int toggle, const SkGradientSpanProcs& procs);
 
 // On Linux, this is faster with SkPMColor[] params than SkPMColor* SK_RESTRICT
 void shadeSpan_radial_clamp(SkScalar sfx, SkScalar sdx,
         SkScalar sfy, SkScalar sdy,
         SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
-        int count, int toggle) {
+        int count, int toggle, const SkGradientSpanProcs& procs) {
     // Floating point seems to be slower than fixed point,
     // even when we have float hardware.
     const uint8_t* SK_RESTRICT sqrt_table = gSqrt8Table;
@@ -329,6 +331,14 @@ void shadeSpan_radial_clamp(SkScalar sfx, SkScalar sdx,
             cache[toggle + fi],
             cache[next_dither_toggle(toggle) + fi],
             count);
+    } else if (procs.fRadialClamp) {
+        // The proc pins like the loops below, and writes the table indices
+        // into dstC, which we then replace with their colors.
+        procs.fRadialClamp(fx, dx, fy, dy, count, dstC);
+        for (int i = 0; i < count; ++i) {
+            dstC[i] = cache[toggle + (sqrt_table[dstC[i]] >> SkGradientShaderBase::kSqrt32Shift)];
+            toggle = next_dither_toggle(toggle);
+        }
     } else if ((count > 4) &&
                no_need_for_radial_pin(fx, dx, fy, dy, count)) {
         unsigned fi;
@@ -377,7 +387,20 @@ void shadeSpan_radial_clamp(SkScalar sfx, SkScalar sdx,
 template <SkFixed (*TileProc)(SkFixed)>
 void shadeSpan_radial(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
                       SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
-                      int count, int toggle) {
+                      int count, int toggle, const SkGradientSpanProcs& procs) {
+    if (procs.fRadial) {
+        // The proc writes the distances into dstC, which we then tile and
+        // replace with their colors.
+        procs.fRadial(fx, dx, fy, dy, count, reinterpret_cast<SkFixed*>(dstC));
+        for (int i = 0; i < count; ++i) {
+            const unsigned fi = TileProc(dstC[i]);
+            SkASSERT(fi <= 0xFFFF);
+            dstC[i] = cache[toggle + (fi >> SkGradientShaderBase::kCache32Shift)];
+            toggle = next_dither_toggle(toggle);
+        }
+        return;
+    }
+
     do {
         const SkFixed dist = SkFloatToFixed(sk_float_sqrt(fx*fx + fy*fy));
         const unsigned fi = TileProc(dist);
@@ -391,14 +414,16 @@ void shadeSpan_radial(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
 
 void shadeSpan_radial_mirror(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
                              SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
-                             int count, int toggle) {
-    shadeSpan_radial<mirror_tileproc_nonstatic>(fx, dx, fy, dy, dstC, cache, count, toggle);
+                             int count, int toggle, const SkGradientSpanProcs& procs) {
+    shadeSpan_radial<mirror_tileproc_nonstatic>(fx, dx, fy, dy, dstC, cache, count, toggle,
+                                                procs);
 }
 
 void shadeSpan_radial_repeat(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
                              SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
-                             int count, int toggle) {
-    shadeSpan_radial<repeat_tileproc_nonstatic>(fx, dx, fy, dy, dstC, cache, count, toggle);
+                             int count, int toggle, const SkGradientSpanProcs& procs) {
+    shadeSpan_radial<repeat_tileproc_nonstatic>(fx, dx, fy, dy, dstC, cache, count, toggle,
+                                                procs);
 }
 
 }  // namespace
@@ -439,7 +464,7 @@ void SkRadialGradient::RadialGradientContext::shadeSpan(int x, int y,
         } else {
             SkASSERT(SkShader::kRepeat_TileMode == radialGradient.fTileMode);
         }
-        (*shadeProc)(srcPt.fX, sdx, srcPt.fY, sdy, dstC, cache, count, toggle);
+        (*shadeProc)(srcPt.fX, sdx, srcPt.fY, sdy, dstC, cache, count, toggle, fSpanProcs);
     } else {    // perspective case
         SkScalar dstX = SkIntToScalar(x);
         SkScalar dstY = SkIntToScalar(y);
@@ -453,6 +478,17 @@ void SkRadialGradient::RadialGradientContext::shadeSpan(int x, int y,
     }
 }
 
+static void radial_points_to_t(const SkPoint pts[], int count, SkScalar t[]) {
+    for (int i = 0; i < count; ++i) {
+        t[i] = sk_float_sqrt(pts[i].fX * pts[i].fX + pts[i].fY * pts[i].fY);
+    }
+}
+
+void SkRadialGradient::RadialGradientContext::shadeSpan4f(int x, int y, SkPM4f dstC[],
+                                                          int count) {
+    this->shadeSpan4fWithProc(x, y, dstC, count, radial_points_to_t);
+}
+
 /////////////////////////////////////////////////////////////////////
 
 #if SK_SUPPORT_GPU
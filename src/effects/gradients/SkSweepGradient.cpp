@@ -62,7 +62,9 @@ SkShader::Context* SkSweepGradient::onCreateContext(const ContextRec& rec, void*
 
 SkSweepGradient::SweepGradientContext::SweepGradientContext(
         const SkSweepGradient& shader, const ContextRec& rec)
-    : INHERITED(shader, rec) {}
+    : INHERITED(shader, rec) {
+    fFlags |= SkShader::kSupports4f_Flag;
+}
 
 //  returns angle in a circle [0..2PI) -> [0..255]
 static unsigned SkATan2_255(float y, float x) {
@@ -107,6 +109,18 @@ void SkSweepGradient::SweepGradientContext::shadeSpan(int x, int y, SkPMColor* S
             dy = matrix.getSkewY();
         }
 
+        if (fSpanProcs.fSweep) {
+            // The proc writes the indices into dstC, which we then replace
+            // with their colors.
+            fSpanProcs.fSweep(fx, dx, fy, dy, count, dstC);
+            for (int i = 0; i < count; ++i) {
+                SkASSERT(dstC[i] <= 255);
+                dstC[i] = cache[toggle + dstC[i]];
+                toggle = next_dither_toggle(toggle);
+            }
+            return;
+        }
+
         for (; count > 0; --count) {
             *dstC++ = cache[toggle + SkATan2_255(fy, fx)];
             fx += dx;
@@ -169,6 +183,24 @@ void SkSweepGradient::SweepGradientContext::shadeSpan16(int x, int y, uint16_t*
     }
 }
 
+//  maps the angle in a circle [0..2PI) -> [0..1)
+static void sweep_points_to_t(const SkPoint pts[], int count, SkScalar t[]) {
+    static const float g1Over2PI = 0.15915494309189535f;
+
+    for (int i = 0; i < count; ++i) {
+        float angle = sk_float_atan2(pts[i].fY, pts[i].fX);
+        if (angle < 0) {
+            angle += 2 * SK_ScalarPI;
+        }
+        t[i] = angle * g1Over2PI;
+    }
+}
+
+void SkSweepGradient::SweepGradientContext::shadeSpan4f(int x, int y, SkPM4f dstC[],
+                                                        int count) {
+    this->shadeSpan4fWithProc(x, y, dstC, count, sweep_points_to_t);
+}
+
 /////////////////////////////////////////////////////////////////////
 
 #if SK_SUPPORT_GPU
@@ -133,14 +133,29 @@ SkFixed TwoPtRadialContext::nextT() {
     return SkFloatToFixed(t);
 }
 
-typedef void (*TwoPointConicalProc)(TwoPtRadialContext* rec, SkPMColor* dstC,
-                                    const SkPMColor* cache, int toggle, int count);
+// Fills span with rec's coefficients and its current point and steps.
+static void init_span(const TwoPtRadialContext& rec, SkTwoPointConicalSpan* span) {
+    span->fA = rec.fRec.fA;
+    span->fRadius = rec.fRec.fRadius;
+    span->fDRadius = rec.fRec.fDRadius;
+    span->fRadius2 = rec.fRec.fRadius2;
+    span->fFlipped = rec.fRec.fFlipped;
+    span->fRelX = rec.fRelX;
+    span->fRelY = rec.fRelY;
+    span->fIncX = rec.fIncX;
+    span->fIncY = rec.fIncY;
+    span->fB = rec.fB;
+    span->fDB = rec.fDB;
+}
+
+// These replace the t values in dstC, from nextT() or a span proc, with their colors.
+typedef void (*TwoPointConicalProc)(SkPMColor* dstC, const SkPMColor* cache, int toggle,
+                                    int count);
 
-static void twopoint_clamp(TwoPtRadialContext* rec, SkPMColor* SK_RESTRICT dstC,
-                           const SkPMColor* SK_RESTRICT cache, int toggle,
-                           int count) {
+static void twopoint_clamp(SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
+                           int toggle, int count) {
     for (; count > 0; --count) {
-        SkFixed t = rec->nextT();
+        SkFixed t = *dstC;
         if (TwoPtRadial::DontDrawT(t)) {
             *dstC++ = 0;
         } else {
@@ -153,11 +168,10 @@ static void twopoint_clamp(TwoPtRadialContext* rec, SkPMColor* SK_RESTRICT dstC,
     }
 }
 
-static void twopoint_repeat(TwoPtRadialContext* rec, SkPMColor* SK_RESTRICT dstC,
-                            const SkPMColor* SK_RESTRICT cache, int toggle,
-                            int count) {
+static void twopoint_repeat(SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
+                            int toggle, int count) {
     for (; count > 0; --count) {
-        SkFixed t = rec->nextT();
+        SkFixed t = *dstC;
         if (TwoPtRadial::DontDrawT(t)) {
             *dstC++ = 0;
         } else {
@@ -170,11 +184,10 @@ static void twopoint_repeat(TwoPtRadialContext* rec, SkPMColor* SK_RESTRICT dstC
     }
 }
 
-static void twopoint_mirror(TwoPtRadialContext* rec, SkPMColor* SK_RESTRICT dstC,
-                            const SkPMColor* SK_RESTRICT cache, int toggle,
-                            int count) {
+static void twopoint_mirror(SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
+                            int toggle, int count) {
     for (; count > 0; --count) {
-        SkFixed t = rec->nextT();
+        SkFixed t = *dstC;
         if (TwoPtRadial::DontDrawT(t)) {
             *dstC++ = 0;
         } else {
@@ -281,7 +294,16 @@ void SkTwoPointConicalGradient::TwoPointConicalGradientContext::shadeSpan(
         }
 
         TwoPtRadialContext rec(twoPointConicalGradient.fRec, fx, fy, dx, dy);
-        (*shadeProc)(&rec, dstC, cache, toggle, count);
+        if (fSpanProcs.fTwoPointConical) {
+            SkTwoPointConicalSpan span;
+            init_span(rec, &span);
+            fSpanProcs.fTwoPointConical(span, count, reinterpret_cast<SkFixed*>(dstC));
+        } else {
+            for (int i = 0; i < count; ++i) {
+                dstC[i] = rec.nextT();
+            }
+        }
+        (*shadeProc)(dstC, cache, toggle, count);
     } else {    // perspective case
         SkScalar dstX = SkIntToScalar(x) + SK_ScalarHalf;
         SkScalar dstY = SkIntToScalar(y) + SK_ScalarHalf;
@@ -289,7 +311,8 @@ void SkTwoPointConicalGradient::TwoPointConicalGradientContext::shadeSpan(
             SkPoint srcPt;
             dstProc(fDstToIndex, dstX, dstY, &srcPt);
             TwoPtRadialContext rec(twoPointConicalGradient.fRec, srcPt.fX, srcPt.fY, 0, 0);
-            (*shadeProc)(&rec, dstC, cache, toggle, 1);
+            *dstC = rec.nextT();
+            (*shadeProc)(dstC, cache, toggle, 1);
 
             dstX += SK_Scalar1;
             toggle = next_dither_toggle(toggle);
@@ -0,0 +1,355 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <immintrin.h>
+#include "SkBitmapFilter_opts_AVX2.h"
+#include "SkConvolver.h"
+
+// These give exactly the same results as their SSE2 counterparts in SkBitmapFilter_opts_SSE2.cpp,
+// and read no further past the ends of their rows and filters than those do. Instead of widening
+// each channel and multiplying it by one coefficient, they use madd to apply two filter taps to
+// a channel at once, and the vertical pass does 8 pixels at a time instead of 4.
+
+#if !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK) || SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+typedef SkConvolutionFilter1D::ConvolutionFixed ConvolutionFixed;
+
+// Returns the 32 bits holding c0 in the low 16 and c1 in the high 16.
+static inline int pack_taps(ConvolutionFixed c0, ConvolutionFixed c1) {
+    return static_cast<int>(static_cast<uint16_t>(c0) |
+                            (static_cast<uint32_t>(static_cast<uint16_t>(c1)) << 16));
+}
+
+// Convolves horizontally along kRows rows at once. The row data is given in |src_data| and
+// continues for the numValues() of the filter.
+template <int kRows>
+SK_ATTRIBUTE_TARGET_AVX2
+static void convolve_rows_horizontally(const unsigned char* const* src_data,
+                                       const SkConvolutionFilter1D& filter,
+                                       unsigned char* const* out_row) {
+    // Interleaves the channels of each pair of adjacent pixels:
+    // [8] a3 b3 g3 r3 a2 b2 g2 r2 a1 b1 g1 r1 a0 b0 g0 r0 =>
+    // [8] a3 a2 b3 b2 g3 g2 r3 r2 a1 a0 b1 b0 g1 g0 r1 r0
+    // so that once widened to 16 bits, madd can apply a pair of taps to each channel.
+    const __m128i pairs = _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+    const __m256i pairs256 = _mm256_broadcastsi128_si256(pairs);
+    // Which 32 bit pairs of the 8 coefficients go with the low and high pixel pairs of each lane.
+    const __m256i lo_taps = _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2);
+    const __m256i hi_taps = _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3);
+    const __m128i zero = _mm_setzero_si128();
+    const __m256i zero256 = _mm256_setzero_si256();
+    // |mask| will be used to decimate all extra filter coefficients that are
+    // loaded by SIMD when |filter_length| is not divisible by 4.
+    // mask[0] is not used in following algorithm.
+    __m128i mask[4];
+    mask[1] = _mm_set_epi16(0, 0, 0, 0, 0, 0, 0, -1);
+    mask[2] = _mm_set_epi16(0, 0, 0, 0, 0, 0, -1, -1);
+    mask[3] = _mm_set_epi16(0, 0, 0, 0, 0, -1, -1, -1);
+
+    int num_values = filter.numValues();
+    int filter_offset, filter_length;
+
+    // Output one pixel of each row per iteration, calculating all channels (RGBA) together.
+    for (int out_x = 0; out_x < num_values; out_x++) {
+        const ConvolutionFixed* filter_values =
+            filter.FilterForValue(out_x, &filter_offset, &filter_length);
+        int start = filter_offset << 2;
+
+        // Eight taps per iteration: the low lane takes the first four, the high lane the rest.
+        __m256i accum256[kRows];
+        for (int r = 0; r < kRows; r++) {
+            accum256[r] = zero256;
+        }
+        int filter_x = 0;
+        for (; filter_x + 8 <= filter_length; filter_x += 8) {
+            // [16] c7 c6 c5 c4 c3 c2 c1 c0 | c7 c6 c5 c4 c3 c2 c1 c0
+            __m256i coeff = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(filter_values)));
+            // [16] c1 c0 c1 c0 c1 c0 c1 c0 | c5 c4 c5 c4 c5 c4 c5 c4
+            __m256i coeff_lo = _mm256_permutevar8x32_epi32(coeff, lo_taps);
+            // [16] c3 c2 c3 c2 c3 c2 c3 c2 | c7 c6 c7 c6 c7 c6 c7 c6
+            __m256i coeff_hi = _mm256_permutevar8x32_epi32(coeff, hi_taps);
+
+            for (int r = 0; r < kRows; r++) {
+                __m256i src8 = _mm256_shuffle_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_data[r] + start)),
+                    pairs256);
+                // [32] a0*c0+a1*c1 b0*c0+b1*c1 g0*c0+g1*c1 r0*c0+r1*c1 | (pixels 4 and 5)
+                __m256i t = _mm256_madd_epi16(_mm256_unpacklo_epi8(src8, zero256), coeff_lo);
+                accum256[r] = _mm256_add_epi32(accum256[r], t);
+                // [32] a2*c2+a3*c3 b2*c2+b3*c3 g2*c2+g3*c3 r2*c2+r3*c3 | (pixels 6 and 7)
+                t = _mm256_madd_epi16(_mm256_unpackhi_epi8(src8, zero256), coeff_hi);
+                accum256[r] = _mm256_add_epi32(accum256[r], t);
+            }
+
+            start += 32;
+            filter_values += 8;
+        }
+
+        __m128i accum[kRows];
+        for (int r = 0; r < kRows; r++) {
+            accum[r] = _mm_add_epi32(_mm256_castsi256_si128(accum256[r]),
+                                     _mm256_extracti128_si256(accum256[r], 1));
+        }
+
+        // Then at most two more iterations of four taps, masking off any loaded past the end.
+        for (; filter_x < filter_length; filter_x += 4) {
+            // Note: filter_values must be padded to align_up(filter_offset, 8).
+            // [16] xx xx xx xx c3 c2 c1 c0
+            __m128i coeff = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(filter_values));
+            int remaining = filter_length - filter_x;
+            if (remaining < 4) {
+                coeff = _mm_and_si128(coeff, mask[remaining]);
+            }
+            // [16] c1 c0 c1 c0 c1 c0 c1 c0
+            __m128i coeff_lo = _mm_shuffle_epi32(coeff, _MM_SHUFFLE(0, 0, 0, 0));
+            // [16] c3 c2 c3 c2 c3 c2 c3 c2
+            __m128i coeff_hi = _mm_shuffle_epi32(coeff, _MM_SHUFFLE(1, 1, 1, 1));
+
+            for (int r = 0; r < kRows; r++) {
+                // Note: line buffer must be padded to align_up(filter_offset, 16).
+                // We resolve this by use C-version for the last horizontal line.
+                __m128i src8 = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_data[r] + start)),
+                    pairs);
+                __m128i t = _mm_madd_epi16(_mm_unpacklo_epi8(src8, zero), coeff_lo);
+                accum[r] = _mm_add_epi32(accum[r], t);
+                t = _mm_madd_epi16(_mm_unpackhi_epi8(src8, zero), coeff_hi);
+                accum[r] = _mm_add_epi32(accum[r], t);
+            }
+
+            start += 16;
+            filter_values += 4;
+        }
+
+        for (int r = 0; r < kRows; r++) {
+            // Shift right for fixed point implementation.
+            __m128i pixel = _mm_srai_epi32(accum[r], SkConvolutionFilter1D::kShiftBits);
+            // Packing 32 bits |accum| to 16 bits per channel (signed saturation).
+            pixel = _mm_packs_epi32(pixel, zero);
+            // Packing 16 bits |accum| to 8 bits per channel (unsigned saturation).
+            pixel = _mm_packus_epi16(pixel, zero);
+            // Store the pixel value of 32 bits.
+            *(reinterpret_cast<int*>(out_row[r] + (out_x << 2))) = _mm_cvtsi128_si32(pixel);
+        }
+    }
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+void convolveHorizontally_AVX2(const unsigned char* src_data,
+                               const SkConvolutionFilter1D& filter,
+                               unsigned char* out_row,
+                               bool /*has_alpha*/) {
+    convolve_rows_horizontally<1>(&src_data, filter, &out_row);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+void convolve4RowsHorizontally_AVX2(const unsigned char* src_data[4],
+                                    const SkConvolutionFilter1D& filter,
+                                    unsigned char* out_row[4]) {
+    convolve_rows_horizontally<4>(src_data, filter, out_row);
+}
+
+// Makes sure the value of the alpha channel of each pixel is at least the
+// maximum of its color channels, or sets it to 0xFF if the image is opaque.
+template<bool has_alpha>
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i fix_alpha(__m256i pixels) {
+    if (has_alpha) {
+        // [8] xx xx xx max(r,g) ...
+        __m256i b = _mm256_max_epu8(_mm256_srli_epi32(pixels, 8), pixels);
+        // [8] xx xx xx max(r,g,b) ...
+        b = _mm256_max_epu8(_mm256_srli_epi32(pixels, 16), b);
+        // [8] max 00 00 00 ...
+        b = _mm256_slli_epi32(b, 24);
+        return _mm256_max_epu8(b, pixels);
+    }
+    return _mm256_or_si256(pixels, _mm256_set1_epi32(0xff000000));
+}
+
+template<bool has_alpha>
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m128i fix_alpha(__m128i pixels) {
+    if (has_alpha) {
+        __m128i b = _mm_max_epu8(_mm_srli_epi32(pixels, 8), pixels);
+        b = _mm_max_epu8(_mm_srli_epi32(pixels, 16), b);
+        b = _mm_slli_epi32(b, 24);
+        return _mm_max_epu8(b, pixels);
+    }
+    return _mm_or_si128(pixels, _mm_set1_epi32(0xff000000));
+}
+
+// Does vertical convolution to produce one output row. The filter values and
+// length are given in the first two parameters. These are applied to each
+// of the rows pointed to in the |source_data_rows| array, with each row
+// being |pixel_width| wide.
+//
+// The output must have room for |pixel_width * 4| bytes.
+template<bool has_alpha>
+SK_ATTRIBUTE_TARGET_AVX2
+static void convolveVertically_AVX2(const ConvolutionFixed* filter_values,
+                                    int filter_length,
+                                    unsigned char* const* source_data_rows,
+                                    int pixel_width,
+                                    unsigned char* out_row) {
+    const __m256i zero256 = _mm256_setzero_si256();
+    const __m128i zero = _mm_setzero_si128();
+    int out_x = 0;
+
+    // Output eight pixels per iteration (32 bytes), convolving two rows at a time.
+    for (; out_x + 8 <= pixel_width; out_x += 8) {
+        // Accumulated result for each pixel. 32 bits per RGBA channel.
+        // Each accumulator holds one pixel of each lane: 0 and 4, 1 and 5, and so on.
+        __m256i accum0 = zero256;
+        __m256i accum1 = zero256;
+        __m256i accum2 = zero256;
+        __m256i accum3 = zero256;
+
+        for (int filter_y = 0; filter_y < filter_length; filter_y += 2) {
+            // An odd last row is paired with a zero coefficient and zero pixels.
+            const bool pair = filter_y + 1 < filter_length;
+            // [16] cj+1 cj cj+1 cj ...
+            __m256i coeff = _mm256_set1_epi32(
+                pack_taps(filter_values[filter_y], pair ? filter_values[filter_y + 1] : 0));
+
+            // [8] a3 b3 g3 r3 a2 b2 g2 r2 a1 b1 g1 r1 a0 b0 g0 r0 | (pixels 4 to 7)
+            __m256i src0 = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(&source_data_rows[filter_y][out_x << 2]));
+            __m256i src1 = pair ? _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(&source_data_rows[filter_y + 1][out_x << 2]))
+                                : zero256;
+
+            // Interleave the two rows, so that once widened to 16 bits each
+            // channel of row j is next to the same channel of row j+1.
+            __m256i lo = _mm256_unpacklo_epi8(src0, src1);
+            __m256i hi = _mm256_unpackhi_epi8(src0, src1);
+
+            accum0 = _mm256_add_epi32(accum0,
+                _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero256), coeff));
+            accum1 = _mm256_add_epi32(accum1,
+                _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero256), coeff));
+            accum2 = _mm256_add_epi32(accum2,
+                _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero256), coeff));
+            accum3 = _mm256_add_epi32(accum3,
+                _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero256), coeff));
+        }
+
+        // Shift right for fixed point implementation.
+        accum0 = _mm256_srai_epi32(accum0, SkConvolutionFilter1D::kShiftBits);
+        accum1 = _mm256_srai_epi32(accum1, SkConvolutionFilter1D::kShiftBits);
+        accum2 = _mm256_srai_epi32(accum2, SkConvolutionFilter1D::kShiftBits);
+        accum3 = _mm256_srai_epi32(accum3, SkConvolutionFilter1D::kShiftBits);
+
+        // Packing within each lane puts the pixels back in order:
+        // [16] pixels 1 0 | 5 4, then [16] pixels 3 2 | 7 6,
+        // then [8] pixels 3 2 1 0 | 7 6 5 4.
+        accum0 = _mm256_packs_epi32(accum0, accum1);
+        accum2 = _mm256_packs_epi32(accum2, accum3);
+        accum0 = _mm256_packus_epi16(accum0, accum2);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_row), fix_alpha<has_alpha>(accum0));
+        out_row += 32;
+    }
+
+    // Then four pixels at a time, the same way. Like the SSE2 version, this
+    // reads whole groups of four pixels, even past the end of the row.
+    for (; out_x < pixel_width; out_x += 4) {
+        __m128i accum0 = zero;
+        __m128i accum1 = zero;
+        __m128i accum2 = zero;
+        __m128i accum3 = zero;
+
+        for (int filter_y = 0; filter_y < filter_length; filter_y += 2) {
+            const bool pair = filter_y + 1 < filter_length;
+            __m128i coeff = _mm_set1_epi32(
+                pack_taps(filter_values[filter_y], pair ? filter_values[filter_y + 1] : 0));
+
+            __m128i src0 = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(&source_data_rows[filter_y][out_x << 2]));
+            __m128i src1 = pair ? _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(&source_data_rows[filter_y + 1][out_x << 2]))
+                                : zero;
+
+            __m128i lo = _mm_unpacklo_epi8(src0, src1);
+            __m128i hi = _mm_unpackhi_epi8(src0, src1);
+
+            accum0 = _mm_add_epi32(accum0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), coeff));
+            accum1 = _mm_add_epi32(accum1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), coeff));
+            accum2 = _mm_add_epi32(accum2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), coeff));
+            accum3 = _mm_add_epi32(accum3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), coeff));
+        }
+
+        accum0 = _mm_srai_epi32(accum0, SkConvolutionFilter1D::kShiftBits);
+        accum1 = _mm_srai_epi32(accum1, SkConvolutionFilter1D::kShiftBits);
+        accum2 = _mm_srai_epi32(accum2, SkConvolutionFilter1D::kShiftBits);
+        accum3 = _mm_srai_epi32(accum3, SkConvolutionFilter1D::kShiftBits);
+        accum0 = _mm_packs_epi32(accum0, accum1);
+        accum2 = _mm_packs_epi32(accum2, accum3);
+        accum0 = fix_alpha<has_alpha>(_mm_packus_epi16(accum0, accum2));
+
+        if (out_x + 4 <= pixel_width) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out_row), accum0);
+            out_row += 16;
+        } else {
+            // When the width of the output is not divisible by 4, we need to
+            // save one pixel (4 bytes) each time.
+            for (int x = out_x; x < pixel_width; x++) {
+                *(reinterpret_cast<int*>(out_row)) = _mm_cvtsi128_si32(accum0);
+                accum0 = _mm_srli_si128(accum0, 4);
+                out_row += 4;
+            }
+        }
+    }
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+void convolveVertically_AVX2(const ConvolutionFixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+    if (has_alpha) {
+        convolveVertically_AVX2<true>(filter_values,
+                                      filter_length,
+                                      source_data_rows,
+                                      pixel_width,
+                                      out_row);
+    } else {
+        convolveVertically_AVX2<false>(filter_values,
+                                       filter_length,
+                                       source_data_rows,
+                                       pixel_width,
+                                       out_row);
+    }
+}
+
+#else // !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK) || SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+void convolveVertically_AVX2(const SkConvolutionFilter1D::ConvolutionFixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+    sk_throw();
+}
+
+void convolve4RowsHorizontally_AVX2(const unsigned char* src_data[4],
+                                    const SkConvolutionFilter1D& filter,
+                                    unsigned char* out_row[4]) {
+    sk_throw();
+}
+
+void convolveHorizontally_AVX2(const unsigned char* src_data,
+                               const SkConvolutionFilter1D& filter,
+                               unsigned char* out_row,
+                               bool has_alpha) {
+    sk_throw();
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
+#include "SkPerspIter.h"
 #include "SkUtils.h"
 
 void S32_opaque_D32_filter_DX_SSE2(const SkBitmapProcState& s,
@@ -633,6 +634,335 @@ void ClampX_ClampY_nofilter_affine_SSE2(const SkBitmapProcState& s,
     }
 }
 
+/*  Tile procs for the matrix procs below, 4 coordinates at a time.
+ *  The portable versions are TILEX_PROCF and TILEX_LOW_BITS in
+ *  core/SkBitmapProcState_matrixProcs.cpp.
+ */
+struct ClampTile_SSE2 {
+    // SkClampMax(f >> 16, max), without assuming f >> 16 fits in 16 bits,
+    // since perspective can send coordinates far off the bitmap.
+    static __m128i Proc(const __m128i& f, const __m128i& max) {
+        __m128i i = _mm_srai_epi32(f, 16);
+        i = _mm_andnot_si128(_mm_cmplt_epi32(i, _mm_setzero_si128()), i);
+        __m128i cmp = _mm_cmpgt_epi32(i, max);
+        return _mm_or_si128(_mm_and_si128(cmp, max), _mm_andnot_si128(cmp, i));
+    }
+    // (f >> 12) & 0xF
+    static __m128i LowBits(const __m128i& f, const __m128i&) {
+        return _mm_and_si128(_mm_srli_epi32(f, 12), _mm_set1_epi32(0xF));
+    }
+    static unsigned Proc(SkFixed f, unsigned max) {
+        return SkClampMax(f >> 16, max);
+    }
+    static unsigned LowBits(SkFixed f, unsigned) {
+        return (f >> 12) & 0xF;
+    }
+};
+
+// Callers must check that max + 1 fits in 16 bits.
+struct RepeatTile_SSE2 {
+    // ((f & 0xFFFF) * (max + 1)) >> 16
+    static __m128i Proc(const __m128i& f, const __m128i& max) {
+        return _mm_mulhi_epu16(_mm_and_si128(f, _mm_set1_epi32(0xFFFF)),
+                               _mm_add_epi32(max, _mm_set1_epi32(1)));
+    }
+    // (((f & 0xFFFF) * (max + 1)) >> 12) & 0xF
+    static __m128i LowBits(const __m128i& f, const __m128i& max) {
+        __m128i lo = _mm_mullo_epi16(_mm_and_si128(f, _mm_set1_epi32(0xFFFF)),
+                                     _mm_add_epi32(max, _mm_set1_epi32(1)));
+        return _mm_srli_epi32(_mm_and_si128(lo, _mm_set1_epi32(0xFFFF)), 12);
+    }
+    static unsigned Proc(SkFixed f, unsigned max) {
+        return ((f & 0xFFFF) * (max + 1)) >> 16;
+    }
+    static unsigned LowBits(SkFixed f, unsigned max) {
+        return (((f & 0xFFFF) * (max + 1)) >> 12) & 0xF;
+    }
+};
+
+template <typename Tile>
+static inline __m128i pack_filter_SSE2(const __m128i& f, const __m128i& max,
+                                       const __m128i& one) {
+    __m128i i = Tile::Proc(f, max);
+    i = _mm_or_si128(_mm_slli_epi32(i, 4), Tile::LowBits(f, max));
+    return _mm_or_si128(_mm_slli_epi32(i, 14),
+                        Tile::Proc(_mm_add_epi32(f, one), max));
+}
+
+template <typename Tile>
+static inline uint32_t pack_filter(SkFixed f, unsigned max, SkFixed one) {
+    unsigned i = Tile::Proc(f, max);
+    i = (i << 4) | Tile::LowBits(f, max);
+    return (i << 14) | Tile::Proc(f + one, max);
+}
+
+// Splits the next 4 x,y pairs from SkPerspIter into 4 x's and 4 y's.
+static inline void load_persp_xy_SSE2(const SkFixed* srcXY,
+                                      __m128i* x, __m128i* y) {
+    __m128i xy01 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcXY));
+    __m128i xy23 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcXY + 4));
+    xy01 = _mm_shuffle_epi32(xy01, _MM_SHUFFLE(3, 1, 2, 0));  // x0 x1 y0 y1
+    xy23 = _mm_shuffle_epi32(xy23, _MM_SHUFFLE(3, 1, 2, 0));  // x2 x3 y2 y3
+    *x = _mm_unpacklo_epi64(xy01, xy23);
+    *y = _mm_unpackhi_epi64(xy01, xy23);
+}
+
+/*  SSE version of the filter_affine procs
+ *  portable version is in core/SkBitmapProcState_matrix.h
+ */
+template <typename Tile>
+static void filter_affine_SSE2(const SkBitmapProcState& s,
+                               uint32_t xy[], int count, int x, int y) {
+    SkPoint srcPt;
+    s.fInvProc(s.fInvMatrix,
+               SkIntToScalar(x) + SK_ScalarHalf,
+               SkIntToScalar(y) + SK_ScalarHalf, &srcPt);
+
+    SkFixed oneX = s.fFilterOneX;
+    SkFixed oneY = s.fFilterOneY;
+    SkFixed fx = SkScalarToFixed(srcPt.fX) - (oneX >> 1);
+    SkFixed fy = SkScalarToFixed(srcPt.fY) - (oneY >> 1);
+    SkFixed dx = s.fInvSx;
+    SkFixed dy = s.fInvKy;
+    unsigned maxX = s.fBitmap->width() - 1;
+    unsigned maxY = s.fBitmap->height() - 1;
+
+    if (count >= 4) {
+        __m128i wide_fx = _mm_set_epi32(fx + dx * 3, fx + dx * 2, fx + dx, fx);
+        __m128i wide_fy = _mm_set_epi32(fy + dy * 3, fy + dy * 2, fy + dy, fy);
+        __m128i wide_dx4 = _mm_set1_epi32(dx * 4);
+        __m128i wide_dy4 = _mm_set1_epi32(dy * 4);
+        __m128i wide_oneX = _mm_set1_epi32(oneX);
+        __m128i wide_oneY = _mm_set1_epi32(oneY);
+        __m128i wide_maxX = _mm_set1_epi32(maxX);
+        __m128i wide_maxY = _mm_set1_epi32(maxY);
+
+        while (count >= 4) {
+            __m128i wide_x = pack_filter_SSE2<Tile>(wide_fx, wide_maxX, wide_oneX);
+            __m128i wide_y = pack_filter_SSE2<Tile>(wide_fy, wide_maxY, wide_oneY);
+
+            // store interleaved as y-x-y-x
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(xy),
+                             _mm_unpacklo_epi32(wide_y, wide_x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(xy + 4),
+                             _mm_unpackhi_epi32(wide_y, wide_x));
+
+            wide_fx = _mm_add_epi32(wide_fx, wide_dx4);
+            wide_fy = _mm_add_epi32(wide_fy, wide_dy4);
+
+            fx += dx * 4;
+            fy += dy * 4;
+            xy += 8;
+            count -= 4;
+        }
+    }
+
+    while (count-- > 0) {
+        *xy++ = pack_filter<Tile>(fy, maxY, oneY);
+        fy += dy;
+        *xy++ = pack_filter<Tile>(fx, maxX, oneX);
+        fx += dx;
+    }
+}
+
+/*  SSE version of the nofilter_affine procs
+ *  portable version is NoFilterProc_Affine in core/SkBitmapProcState_matrix_template.h
+ */
+template <typename Tile>
+static void nofilter_affine_SSE2(const SkBitmapProcState& s,
+                                 uint32_t xy[], int count, int x, int y) {
+    SkPoint srcPt;
+    s.fInvProc(s.fInvMatrix,
+               SkIntToScalar(x) + SK_ScalarHalf,
+               SkIntToScalar(y) + SK_ScalarHalf, &srcPt);
+
+    // Step in SkFractionalInt like the portable version, so we land on the
+    // same pixels; only the tiling is done 4 at a time.
+    SkFractionalInt fx = SkScalarToFractionalInt(srcPt.fX);
+    SkFractionalInt fy = SkScalarToFractionalInt(srcPt.fY);
+    SkFractionalInt dx = s.fInvSxFractionalInt;
+    SkFractionalInt dy = s.fInvKyFractionalInt;
+    unsigned maxX = s.fBitmap->width() - 1;
+    unsigned maxY = s.fBitmap->height() - 1;
+
+    __m128i wide_maxX = _mm_set1_epi32(maxX);
+    __m128i wide_maxY = _mm_set1_epi32(maxY);
+
+    while (count >= 4) {
+        SkFixed x0 = SkFractionalIntToFixed(fx); fx += dx;
+        SkFixed x1 = SkFractionalIntToFixed(fx); fx += dx;
+        SkFixed x2 = SkFractionalIntToFixed(fx); fx += dx;
+        SkFixed x3 = SkFractionalIntToFixed(fx); fx += dx;
+        SkFixed y0 = SkFractionalIntToFixed(fy); fy += dy;
+        SkFixed y1 = SkFractionalIntToFixed(fy); fy += dy;
+        SkFixed y2 = SkFractionalIntToFixed(fy); fy += dy;
+        SkFixed y3 = SkFractionalIntToFixed(fy); fy += dy;
+
+        __m128i wide_x = Tile::Proc(_mm_set_epi32(x3, x2, x1, x0), wide_maxX);
+        __m128i wide_y = Tile::Proc(_mm_set_epi32(y3, y2, y1, y0), wide_maxY);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(xy),
+                         _mm_or_si128(_mm_slli_epi32(wide_y, 16), wide_x));
+
+        xy += 4;
+        count -= 4;
+    }
+
+    while (count-- > 0) {
+        *xy++ = (Tile::Proc(SkFractionalIntToFixed(fy), maxY) << 16) |
+                 Tile::Proc(SkFractionalIntToFixed(fx), maxX);
+        fx += dx;
+        fy += dy;
+    }
+}
+
+/*  SSE version of the filter_persp procs
+ *  portable version is in core/SkBitmapProcState_matrix.h
+ */
+template <typename Tile>
+static void filter_persp_SSE2(const SkBitmapProcState& s,
+                              uint32_t xy[], int count, int x, int y) {
+    SkASSERT(s.fInvType & SkMatrix::kPerspective_Mask);
+
+    unsigned maxX = s.fBitmap->width() - 1;
+    unsigned maxY = s.fBitmap->height() - 1;
+    SkFixed oneX = s.fFilterOneX;
+    SkFixed oneY = s.fFilterOneY;
+
+    __m128i wide_oneX = _mm_set1_epi32(oneX);
+    __m128i wide_oneY = _mm_set1_epi32(oneY);
+    __m128i wide_halfX = _mm_set1_epi32(oneX >> 1);
+    __m128i wide_halfY = _mm_set1_epi32(oneY >> 1);
+    __m128i wide_maxX = _mm_set1_epi32(maxX);
+    __m128i wide_maxY = _mm_set1_epi32(maxY);
+
+    SkPerspIter iter(s.fInvMatrix,
+                     SkIntToScalar(x) + SK_ScalarHalf,
+                     SkIntToScalar(y) + SK_ScalarHalf, count);
+
+    while ((count = iter.next()) != 0) {
+        const SkFixed* SK_RESTRICT srcXY = iter.getXY();
+
+        while (count >= 4) {
+            __m128i wide_fx, wide_fy;
+            load_persp_xy_SSE2(srcXY, &wide_fx, &wide_fy);
+            wide_fx = _mm_sub_epi32(wide_fx, wide_halfX);
+            wide_fy = _mm_sub_epi32(wide_fy, wide_halfY);
+
+            __m128i wide_x = pack_filter_SSE2<Tile>(wide_fx, wide_maxX, wide_oneX);
+            __m128i wide_y = pack_filter_SSE2<Tile>(wide_fy, wide_maxY, wide_oneY);
+
+            // we read x/y, we write y/x
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(xy),
+                             _mm_unpacklo_epi32(wide_y, wide_x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(xy + 4),
+                             _mm_unpackhi_epi32(wide_y, wide_x));
+
+            srcXY += 8;
+            xy += 8;
+            count -= 4;
+        }
+
+        while (--count >= 0) {
+            *xy++ = pack_filter<Tile>(srcXY[1] - (oneY >> 1), maxY, oneY);
+            *xy++ = pack_filter<Tile>(srcXY[0] - (oneX >> 1), maxX, oneX);
+            srcXY += 2;
+        }
+    }
+}
+
+/*  SSE version of the nofilter_persp procs
+ *  portable version is NoFilterProc_Persp in core/SkBitmapProcState_matrix_template.h
+ */
+template <typename Tile>
+static void nofilter_persp_SSE2(const SkBitmapProcState& s,
+                                uint32_t xy[], int count, int x, int y) {
+    SkASSERT(s.fInvType & SkMatrix::kPerspective_Mask);
+
+    unsigned maxX = s.fBitmap->width() - 1;
+    unsigned maxY = s.fBitmap->height() - 1;
+
+    __m128i wide_maxX = _mm_set1_epi32(maxX);
+    __m128i wide_maxY = _mm_set1_epi32(maxY);
+
+    SkPerspIter iter(s.fInvMatrix,
+                     SkIntToScalar(x) + SK_ScalarHalf,
+                     SkIntToScalar(y) + SK_ScalarHalf, count);
+
+    while ((count = iter.next()) != 0) {
+        const SkFixed* SK_RESTRICT srcXY = iter.getXY();
+
+        while (count >= 4) {
+            __m128i wide_fx, wide_fy;
+            load_persp_xy_SSE2(srcXY, &wide_fx, &wide_fy);
+
+            __m128i wide_x = Tile::Proc(wide_fx, wide_maxX);
+            __m128i wide_y = Tile::Proc(wide_fy, wide_maxY);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(xy),
+                             _mm_or_si128(_mm_slli_epi32(wide_y, 16), wide_x));
+
+            srcXY += 8;
+            xy += 4;
+            count -= 4;
+        }
+
+        while (--count >= 0) {
+            *xy++ = (Tile::Proc(srcXY[1], maxY) << 16) | Tile::Proc(srcXY[0], maxX);
+            srcXY += 2;
+        }
+    }
+}
+
+// The repeat procs multiply 16 bit fractions by the width and height.
+static inline bool repeat_fits_16_bits_SSE2(const SkBitmapProcState& s) {
+    return s.fBitmap->width() <= 0xFFFF && s.fBitmap->height() <= 0xFFFF;
+}
+
+void ClampX_ClampY_filter_persp_SSE2(const SkBitmapProcState& s,
+                                     uint32_t xy[], int count, int x, int y) {
+    filter_persp_SSE2<ClampTile_SSE2>(s, xy, count, x, y);
+}
+
+void ClampX_ClampY_nofilter_persp_SSE2(const SkBitmapProcState& s,
+                                       uint32_t xy[], int count, int x, int y) {
+    nofilter_persp_SSE2<ClampTile_SSE2>(s, xy, count, x, y);
+}
+
+void RepeatX_RepeatY_filter_affine_SSE2(const SkBitmapProcState& s,
+                                        uint32_t xy[], int count, int x, int y) {
+    if (!repeat_fits_16_bits_SSE2(s)) {
+        RepeatX_RepeatY_filter_affine(s, xy, count, x, y);
+        return;
+    }
+    filter_affine_SSE2<RepeatTile_SSE2>(s, xy, count, x, y);
+}
+
+void RepeatX_RepeatY_nofilter_affine_SSE2(const SkBitmapProcState& s,
+                                          uint32_t xy[], int count, int x, int y) {
+    if (!repeat_fits_16_bits_SSE2(s)) {
+        RepeatX_RepeatY_nofilter_affine(s, xy, count, x, y);
+        return;
+    }
+    nofilter_affine_SSE2<RepeatTile_SSE2>(s, xy, count, x, y);
+}
+
+void RepeatX_RepeatY_filter_persp_SSE2(const SkBitmapProcState& s,
+                                       uint32_t xy[], int count, int x, int y) {
+    if (!repeat_fits_16_bits_SSE2(s)) {
+        RepeatX_RepeatY_filter_persp(s, xy, count, x, y);
+        return;
+    }
+    filter_persp_SSE2<RepeatTile_SSE2>(s, xy, count, x, y);
+}
+
+void RepeatX_RepeatY_nofilter_persp_SSE2(const SkBitmapProcState& s,
+                                         uint32_t xy[], int count, int x, int y) {
+    if (!repeat_fits_16_bits_SSE2(s)) {
+        RepeatX_RepeatY_nofilter_persp(s, xy, count, x, y);
+        return;
+    }
+    nofilter_persp_SSE2<RepeatTile_SSE2>(s, xy, count, x, y);
+}
+
 /*  SSE version of S32_D16_filter_DX_SSE2
  *  Definition is in section of "D16 functions for SRC == 8888" in SkBitmapProcState.cpp
  *  It combines S32_opaque_D32_filter_DX_SSE2 and SkPixel32ToPixel16
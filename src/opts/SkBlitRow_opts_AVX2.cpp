@@ -0,0 +1,366 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <immintrin.h>
+#include "SkBitmapProcState_opts_SSE2.h"
+#include "SkBlitRow_opts_AVX2.h"
+#include "SkBlitRow_opts_SSE2.h"
+#include "SkColorPriv.h"
+#include "SkUtils.h"
+
+// These work just like their SSE2 counterparts in SkBlitRow_opts_SSE2.cpp, only 8 pixels at a
+// time instead of 4. Each leaves whatever is left at the end of a row to its SSE2 counterpart.
+
+#if !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK) || SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+/* AVX2 version of S32A_Opaque_BlitRow32()
+ * portable version is in core/SkBlitRow_D32.cpp
+ */
+SK_ATTRIBUTE_TARGET_AVX2
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                                const SkPMColor* SK_RESTRICT src,
+                                int count, U8CPU alpha) {
+    SkASSERT(alpha == 255);
+#ifndef SK_USE_ACCURATE_BLENDING
+    if (count >= 8) {
+        SkASSERT(((size_t)dst & 0x03) == 0);
+        while (((size_t)dst & 0x1F) != 0) {
+            *dst = SkPMSrcOver(*src, *dst);
+            src++;
+            dst++;
+            count--;
+        }
+
+        const __m256i* s = reinterpret_cast<const __m256i*>(src);
+        __m256i* d = reinterpret_cast<__m256i*>(dst);
+        __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+        __m256i a_mask = _mm256_set1_epi32(SK_A32_MASK << SK_A32_SHIFT);
+        __m256i c_256 = _mm256_set1_epi16(0x0100);  // 16 copies of 256 (16-bit)
+        while (count >= 8) {
+            // Load 8 pixels
+            __m256i src_pixel = _mm256_loadu_si256(s);
+
+            if (_mm256_testz_si256(src_pixel, src_pixel)) {
+                // All 8 are transparent, so dst stays as it is.
+            } else if (_mm256_testc_si256(src_pixel, a_mask)) {
+                // All 8 are opaque, so they replace dst.
+                _mm256_store_si256(d, src_pixel);
+            } else {
+                __m256i dst_pixel = _mm256_load_si256(d);
+
+                __m256i dst_rb = _mm256_and_si256(rb_mask, dst_pixel);
+                __m256i dst_ag = _mm256_srli_epi16(dst_pixel, 8);
+
+                // (a0, g0, a1, g1, ... a7, g7)  (low byte of each word)
+                __m256i alpha = _mm256_srli_epi16(src_pixel, 8);
+
+                // (a0, a0, a1, a1, ... a7, a7)
+                alpha = _mm256_shufflehi_epi16(alpha, 0xF5);
+                alpha = _mm256_shufflelo_epi16(alpha, 0xF5);
+
+                // Subtract alphas from 256, to get 1..256
+                alpha = _mm256_sub_epi16(c_256, alpha);
+
+                // Multiply by red and blue by src alpha.
+                dst_rb = _mm256_mullo_epi16(dst_rb, alpha);
+                // Multiply by alpha and green by src alpha.
+                dst_ag = _mm256_mullo_epi16(dst_ag, alpha);
+
+                // Divide by 256.
+                dst_rb = _mm256_srli_epi16(dst_rb, 8);
+
+                // Mask out high bits (already in the right place)
+                dst_ag = _mm256_andnot_si256(rb_mask, dst_ag);
+
+                // Combine back into RGBA.
+                dst_pixel = _mm256_or_si256(dst_rb, dst_ag);
+
+                // Add result
+                __m256i result = _mm256_add_epi8(src_pixel, dst_pixel);
+                _mm256_store_si256(d, result);
+            }
+            s++;
+            d++;
+            count -= 8;
+        }
+        src = reinterpret_cast<const SkPMColor*>(s);
+        dst = reinterpret_cast<SkPMColor*>(d);
+    }
+#endif
+    // With SK_USE_ACCURATE_BLENDING, SSE2 does all the work.
+    S32A_Opaque_BlitRow32_SSE2(dst, src, count, alpha);
+}
+
+/* AVX2 version of S32A_Blend_BlitRow32()
+ * portable version is in core/SkBlitRow_D32.cpp
+ */
+SK_ATTRIBUTE_TARGET_AVX2
+void S32A_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                               const SkPMColor* SK_RESTRICT src,
+                               int count, U8CPU alpha) {
+    SkASSERT(alpha <= 255);
+    if (count >= 8) {
+        while (((size_t)dst & 0x1F) != 0) {
+            *dst = SkBlendARGB32(*src, *dst, alpha);
+            src++;
+            dst++;
+            count--;
+        }
+
+        uint32_t src_scale = SkAlpha255To256(alpha);
+
+        const __m256i* s = reinterpret_cast<const __m256i*>(src);
+        __m256i* d = reinterpret_cast<__m256i*>(dst);
+        __m256i src_scale_wide = _mm256_set1_epi16(src_scale << 8);
+        __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+        __m256i c_256 = _mm256_set1_epi16(256);  // 16 copies of 256 (16-bit)
+        while (count >= 8) {
+            // Load 8 pixels each of src and dest.
+            __m256i src_pixel = _mm256_loadu_si256(s);
+            __m256i dst_pixel = _mm256_load_si256(d);
+
+            // Get red and blue pixels into lower byte of each word.
+            __m256i dst_rb = _mm256_and_si256(rb_mask, dst_pixel);
+            __m256i src_rb = _mm256_and_si256(rb_mask, src_pixel);
+
+            // Get alpha and green into lower byte of each word.
+            __m256i dst_ag = _mm256_srli_epi16(dst_pixel, 8);
+            __m256i src_ag = _mm256_srli_epi16(src_pixel, 8);
+
+            // Put per-pixel alpha in low byte of each word.
+            __m256i dst_alpha = _mm256_shufflehi_epi16(src_ag, 0xF5);
+            dst_alpha = _mm256_shufflelo_epi16(dst_alpha, 0xF5);
+
+            // dst_alpha = dst_alpha * src_scale
+            // Because src_scales are in the higher byte of each word and
+            // we use mulhi here, the resulting alpha values are already
+            // in the right place and don't need to be divided by 256.
+            dst_alpha = _mm256_mulhi_epu16(dst_alpha, src_scale_wide);
+
+            // Subtract alphas from 256, to get 1..256
+            dst_alpha = _mm256_sub_epi16(c_256, dst_alpha);
+
+            // Multiply red and blue by dst pixel alpha.
+            dst_rb = _mm256_mullo_epi16(dst_rb, dst_alpha);
+            // Multiply alpha and green by dst pixel alpha.
+            dst_ag = _mm256_mullo_epi16(dst_ag, dst_alpha);
+
+            // Multiply red and blue, and alpha and green, by global alpha.
+            // Again, because we use mulhi, the results are already in the
+            // right place and don't need to be divided by 256.
+            src_rb = _mm256_mulhi_epu16(src_rb, src_scale_wide);
+            src_ag = _mm256_mulhi_epu16(src_ag, src_scale_wide);
+
+            // Divide by 256.
+            dst_rb = _mm256_srli_epi16(dst_rb, 8);
+
+            // Mask out low bits (goodies already in the right place; no need to divide)
+            dst_ag = _mm256_andnot_si256(rb_mask, dst_ag);
+            // Shift alpha and green to higher byte of each word.
+            src_ag = _mm256_slli_epi16(src_ag, 8);
+
+            // Combine back into RGBA.
+            dst_pixel = _mm256_or_si256(dst_rb, dst_ag);
+            src_pixel = _mm256_or_si256(src_rb, src_ag);
+
+            // Add two pixels into result.
+            __m256i result = _mm256_add_epi8(src_pixel, dst_pixel);
+            _mm256_store_si256(d, result);
+            s++;
+            d++;
+            count -= 8;
+        }
+        src = reinterpret_cast<const SkPMColor*>(s);
+        dst = reinterpret_cast<SkPMColor*>(d);
+    }
+
+    S32A_Blend_BlitRow32_SSE2(dst, src, count, alpha);
+}
+
+/* AVX2 version of Color32()
+ * portable version is in core/SkBlitRow_D32.cpp
+ */
+SK_ATTRIBUTE_TARGET_AVX2
+void Color32_AVX2(SkPMColor dst[], const SkPMColor src[], int count,
+                  SkPMColor color) {
+    unsigned colorA = SkGetPackedA32(color);
+    if (0 != color && 255 != colorA && count >= 8) {
+        unsigned scale = 256 - SkAlpha255To256(colorA);
+
+        SkASSERT(((size_t)dst & 0x03) == 0);
+        while (((size_t)dst & 0x1F) != 0) {
+            *dst = color + SkAlphaMulQ(*src, scale);
+            src++;
+            dst++;
+            count--;
+        }
+
+        const __m256i* s = reinterpret_cast<const __m256i*>(src);
+        __m256i* d = reinterpret_cast<__m256i*>(dst);
+        __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+        __m256i src_scale_wide = _mm256_set1_epi16(scale);
+        __m256i color_wide = _mm256_set1_epi32(color);
+        while (count >= 8) {
+            // Load 8 pixels of src.
+            __m256i src_pixel = _mm256_loadu_si256(s);
+
+            // Get red and blue pixels into lower byte of each word.
+            __m256i src_rb = _mm256_and_si256(rb_mask, src_pixel);
+
+            // Get alpha and green into lower byte of each word.
+            __m256i src_ag = _mm256_srli_epi16(src_pixel, 8);
+
+            // Multiply by scale.
+            src_rb = _mm256_mullo_epi16(src_rb, src_scale_wide);
+            src_ag = _mm256_mullo_epi16(src_ag, src_scale_wide);
+
+            // Divide by 256.
+            src_rb = _mm256_srli_epi16(src_rb, 8);
+            src_ag = _mm256_andnot_si256(rb_mask, src_ag);
+
+            // Combine back into RGBA.
+            src_pixel = _mm256_or_si256(src_rb, src_ag);
+
+            // Add color to result.
+            __m256i result = _mm256_add_epi8(color_wide, src_pixel);
+
+            // Store result.
+            _mm256_store_si256(d, result);
+            s++;
+            d++;
+            count -= 8;
+        }
+        src = reinterpret_cast<const SkPMColor*>(s);
+        dst = reinterpret_cast<SkPMColor*>(d);
+    }
+
+    // This also takes care of clear and opaque colors, which are just a memcpy or memset.
+    Color32_SSE2(dst, src, count, color);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+void SkARGB32_A8_BlitMask_AVX2(void* device, size_t dstRB, const void* maskPtr,
+                               size_t maskRB, SkColor origColor,
+                               int width, int height) {
+    SkPMColor color = SkPreMultiplyColor(origColor);
+    SkPMColor* dst = (SkPMColor *)device;
+    const uint8_t* mask = (const uint8_t*)maskPtr;
+
+    __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+    __m256i c_256 = _mm256_set1_epi16(256);
+    __m256i c_1 = _mm256_set1_epi16(1);
+    __m256i src_pixel = _mm256_set1_epi32(color);
+    do {
+        SkPMColor* d32 = dst;
+        const uint8_t* m = mask;
+        int count = width;
+        if (count >= 8) {
+            while (((size_t)d32 & 0x1F) != 0) {
+                *d32 = SkBlendARGB32(color, *d32, *m);
+                m++;
+                d32++;
+                count--;
+            }
+            __m256i* d = reinterpret_cast<__m256i*>(d32);
+            while (count >= 8) {
+                // Load 8 pixels of dest.
+                __m256i dst_pixel = _mm256_load_si256(d);
+
+                // Set the alpha value: (0, m0, 0, m0, 0, m1, 0, m1, ... 0, m7, 0, m7)
+                __m256i src_scale_wide = _mm256_cvtepu8_epi32(
+                        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(m)));
+                src_scale_wide = _mm256_or_si256(src_scale_wide,
+                                                 _mm256_slli_epi32(src_scale_wide, 16));
+
+                //call SkAlpha255To256()
+                src_scale_wide = _mm256_add_epi16(src_scale_wide, c_1);
+
+                // Get red and blue pixels into lower byte of each word.
+                __m256i dst_rb = _mm256_and_si256(rb_mask, dst_pixel);
+                __m256i src_rb = _mm256_and_si256(rb_mask, src_pixel);
+
+                // Get alpha and green into lower byte of each word.
+                __m256i dst_ag = _mm256_srli_epi16(dst_pixel, 8);
+                __m256i src_ag = _mm256_srli_epi16(src_pixel, 8);
+
+                // Put per-pixel alpha in low byte of each word.
+                __m256i dst_alpha = _mm256_shufflehi_epi16(src_ag, 0xF5);
+                dst_alpha = _mm256_shufflelo_epi16(dst_alpha, 0xF5);
+
+                // dst_alpha = dst_alpha * src_scale
+                dst_alpha = _mm256_mullo_epi16(dst_alpha, src_scale_wide);
+
+                // Divide by 256.
+                dst_alpha = _mm256_srli_epi16(dst_alpha, 8);
+
+                // Subtract alphas from 256, to get 1..256
+                dst_alpha = _mm256_sub_epi16(c_256, dst_alpha);
+                // Multiply red and blue by dst pixel alpha.
+                dst_rb = _mm256_mullo_epi16(dst_rb, dst_alpha);
+                // Multiply alpha and green by dst pixel alpha.
+                dst_ag = _mm256_mullo_epi16(dst_ag, dst_alpha);
+
+                // Multiply red and blue by global alpha.
+                src_rb = _mm256_mullo_epi16(src_rb, src_scale_wide);
+                // Multiply alpha and green by global alpha.
+                src_ag = _mm256_mullo_epi16(src_ag, src_scale_wide);
+                // Divide by 256.
+                dst_rb = _mm256_srli_epi16(dst_rb, 8);
+                src_rb = _mm256_srli_epi16(src_rb, 8);
+
+                // Mask out low bits (goodies already in the right place; no need to divide)
+                dst_ag = _mm256_andnot_si256(rb_mask, dst_ag);
+                src_ag = _mm256_andnot_si256(rb_mask, src_ag);
+
+                // Combine back into RGBA.
+                dst_pixel = _mm256_or_si256(dst_rb, dst_ag);
+                __m256i tmp_src_pixel = _mm256_or_si256(src_rb, src_ag);
+
+                // Add two pixels into result.
+                __m256i result = _mm256_add_epi8(tmp_src_pixel, dst_pixel);
+                _mm256_store_si256(d, result);
+                // load the next 8 pixels
+                m += 8;
+                d++;
+                count -= 8;
+            }
+            d32 = reinterpret_cast<SkPMColor*>(d);
+        }
+        if (count > 0) {
+            SkARGB32_A8_BlitMask_SSE2(d32, dstRB, m, maskRB, origColor, count, 1);
+        }
+        dst = (SkPMColor*)((char*)dst + dstRB);
+        mask += maskRB;
+    } while (--height != 0);
+}
+
+#else // !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK) || SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                                const SkPMColor* SK_RESTRICT src,
+                                int count, U8CPU alpha) {
+    sk_throw();
+}
+
+void S32A_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                               const SkPMColor* SK_RESTRICT src,
+                               int count, U8CPU alpha) {
+    sk_throw();
+}
+
+void Color32_AVX2(SkPMColor dst[], const SkPMColor src[], int count,
+                  SkPMColor color) {
+    sk_throw();
+}
+
+void SkARGB32_A8_BlitMask_AVX2(void* device, size_t dstRB, const void* mask,
+                               size_t maskRB, SkColor color,
+                               int width, int height) {
+    sk_throw();
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradient_opts_DEFINED
+#define SkGradient_opts_DEFINED
+
+#include "SkFixed.h"
+
+/*
+ *  Span procs that compute the t values of count consecutive pixels of a
+ *  gradient, four at a time, for the gradient shaders whose t costs more than
+ *  a few adds per pixel. The shaders tile t and look it up in their color
+ *  cache afterwards.
+ *
+ *  The point for pixel i is the first point advanced by the step i times, one
+ *  add per pixel as the portable loops do, so a proc whose math is exact gives
+ *  the same results as the portable code in src/effects/gradients. NEON has no
+ *  exact divide or square root, so its radial and conical t may be off by a few
+ *  float ulps, and a pixel whose radius is nearly 0 may take the other root.
+ */
+
+/**
+ *  Radial gradient, clamp tile mode. fx, fy, dx and dy are 16.16 fixed point,
+ *  already halved. For each point, pins x and y to +-0x7FFF and writes
+ *  min((x*x + y*y) >> 19, 0x7FF), the index into SkRadialGradient's table of
+ *  square roots.
+ */
+typedef void (*SkRadialClampSpanProc)(SkFixed fx, SkFixed dx, SkFixed fy, SkFixed dy,
+                                      int count, uint32_t fi[]);
+
+/**
+ *  Radial gradient, repeat and mirror tile modes. Writes
+ *  SkFloatToFixed(sqrt(x*x + y*y)) for each point.
+ */
+typedef void (*SkRadialSpanProc)(float fx, float dx, float fy, float dy,
+                                 int count, SkFixed t[]);
+
+/**
+ *  Sweep gradient. Writes the angle of each point about the origin, mapped
+ *  from [0, 2pi) to [0, 255]. This uses a polynomial arctangent, so an index
+ *  may differ by one from the portable sk_float_atan2 result (0 and 254 are
+ *  neighbors across the positive x axis).
+ */
+typedef void (*SkSweepSpanProc)(float fx, float dx, float fy, float dy,
+                                int count, uint32_t index[]);
+
+/**
+ *  The coefficients of SkTwoPointConicalGradient's quadratic for a span: the
+ *  fields of its TwoPtRadial, and the starting values and steps of its
+ *  TwoPtRadialContext.
+ */
+struct SkTwoPointConicalSpan {
+    float   fA;
+    float   fRadius;
+    float   fDRadius;
+    float   fRadius2;
+    bool    fFlipped;
+
+    float   fRelX, fRelY;
+    float   fIncX, fIncY;
+    float   fB;
+    float   fDB;
+};
+
+/**
+ *  Two point conical gradient. Writes the t of each point, as
+ *  TwoPtRadialContext::nextT() computes it, or TwoPtRadial::kDontDrawT for
+ *  points the gradient does not cover.
+ */
+typedef void (*SkTwoPointConicalSpanProc)(const SkTwoPointConicalSpan&, int count, SkFixed t[]);
+
+struct SkGradientSpanProcs {
+    SkRadialClampSpanProc       fRadialClamp;
+    SkRadialSpanProc            fRadial;
+    SkSweepSpanProc             fSweep;
+    SkTwoPointConicalSpanProc   fTwoPointConical;
+};
+
+/**
+ *  Fills procs with the SIMD span procs for this CPU, or NULL for each one
+ *  that there is none for (then the shader uses its portable loop).
+ */
+void SkGradientGetPlatformSpanProcs(SkGradientSpanProcs* procs);
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkGradient_opts_SSE2.h"
+#include "SkScalar.h"
+
+/* SSE2 versions of the gradient span procs.
+ * portable versions are in src/effects/gradients. The radial and two point
+ * conical procs give exactly the same results: they step the points with the
+ * same adds and do the same IEEE float math, four pixels at a time. The sweep
+ * proc uses a polynomial arctangent instead of sk_float_atan2.
+ */
+
+// Stores the first count (at most 4) lanes of v to dst.
+static inline void store_lanes(uint32_t dst[], __m128i v, int count) {
+    if (4 == count) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+    } else {
+        uint32_t tmp[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(tmp), v);
+        for (int i = 0; i < count; ++i) {
+            dst[i] = tmp[i];
+        }
+    }
+}
+
+// Returns the next four values of x, advancing it by dx after each one, as
+// the portable loops do (so not x + i*dx, which rounds differently).
+static inline __m128 next4(float* x, float dx) {
+    float x0 = *x;
+    float x1 = x0 + dx;
+    float x2 = x1 + dx;
+    float x3 = x2 + dx;
+    *x = x3 + dx;
+    return _mm_setr_ps(x0, x1, x2, x3);
+}
+
+static inline __m128i float_to_fixed(__m128 x) {
+    // Truncates like SkFloatToFixed; out of range gives 0x80000000 in both.
+    return _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(SK_Fixed1)));
+}
+
+static inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void SkRadialClampSpan_SSE2(SkFixed fx, SkFixed dx, SkFixed fy, SkFixed dy,
+                            int count, uint32_t fi[]) {
+    // Integer steps are exact, so lane i can start at fx + i*dx.
+    __m128i x = _mm_setr_epi32(fx, fx + dx, fx + 2 * dx, fx + 3 * dx);
+    __m128i y = _mm_setr_epi32(fy, fy + dy, fy + 2 * dy, fy + 3 * dy);
+    const __m128i dx4 = _mm_set1_epi32(4 * dx);
+    const __m128i dy4 = _mm_set1_epi32(4 * dy);
+    const __m128i maxIndex = _mm_set1_epi32(0x7FF);
+
+    while (count > 0) {
+        // Saturating to 16 bits pins to [-0x8000, 0x7FFF], not +-0x7FFF, but
+        // either square is big enough to give 0x7FF once clamped below.
+        __m128i xs = _mm_packs_epi32(x, x);
+        __m128i ys = _mm_packs_epi32(y, y);
+        __m128i xy = _mm_unpacklo_epi16(xs, ys);
+        // x*x + y*y in each lane. Only 2 * 0x8000^2 overflows, and the
+        // logical shift still treats it as 0x80000000.
+        __m128i d2 = _mm_madd_epi16(xy, xy);
+        __m128i index = _mm_srli_epi32(d2, 14 + 16 - 11);
+        // The indices fit in 16 bits, and their high halves are 0.
+        index = _mm_min_epi16(index, maxIndex);
+
+        int n = count < 4 ? count : 4;
+        store_lanes(fi, index, n);
+        fi += n;
+        count -= n;
+        x = _mm_add_epi32(x, dx4);
+        y = _mm_add_epi32(y, dy4);
+    }
+}
+
+void SkRadialSpan_SSE2(float fx, float dx, float fy, float dy, int count, SkFixed t[]) {
+    while (count > 0) {
+        __m128 x = next4(&fx, dx);
+        __m128 y = next4(&fy, dy);
+        __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+
+        int n = count < 4 ? count : 4;
+        store_lanes(reinterpret_cast<uint32_t*>(t), float_to_fixed(dist), n);
+        t += n;
+        count -= n;
+    }
+}
+
+void SkSweepSpan_SSE2(float fx, float dx, float fy, float dy, int count, uint32_t index[]) {
+    // atan(a) for a in [0, 1], within 2e-6.
+    static const float kC1 =  0.99997726f;
+    static const float kC3 = -0.33262347f;
+    static const float kC5 =  0.19354346f;
+    static const float kC7 = -0.11643287f;
+    static const float kC9 =  0.05265332f;
+    static const float kC11 = -0.01172120f;
+    // 255 / (2 * SK_ScalarPI)
+    static const float g255Over2PI = 40.584510488433314f;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 halfPi = _mm_set1_ps(SK_ScalarPI / 2);
+    const __m128 pi = _mm_set1_ps(SK_ScalarPI);
+    const __m128 twoPi = _mm_set1_ps(2 * SK_ScalarPI);
+
+    while (count > 0) {
+        __m128 x = next4(&fx, dx);
+        __m128 y = next4(&fy, dy);
+        __m128 ax = _mm_and_ps(x, absMask);
+        __m128 ay = _mm_and_ps(y, absMask);
+        __m128 mn = _mm_min_ps(ax, ay);
+        __m128 mx = _mm_max_ps(ax, ay);
+
+        // a = mn / mx, or 0 at the origin, where atan2 gives 0 too.
+        __m128 a = _mm_and_ps(_mm_div_ps(mn, mx), _mm_cmpgt_ps(mx, zero));
+        __m128 a2 = _mm_mul_ps(a, a);
+        __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kC11), a2), _mm_set1_ps(kC9));
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(kC7));
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(kC5));
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(kC3));
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(kC1));
+        r = _mm_mul_ps(r, a);
+
+        // Unfold from the first octant into [0, 2pi).
+        r = select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(halfPi, r), r);
+        r = select(_mm_cmplt_ps(x, zero), _mm_sub_ps(pi, r), r);
+        r = select(_mm_cmplt_ps(y, zero), _mm_sub_ps(twoPi, r), r);
+
+        // Keep rounding at the ends in [0, 255], as the portable code asserts.
+        __m128 ir = _mm_mul_ps(r, _mm_set1_ps(g255Over2PI));
+        ir = _mm_max_ps(_mm_min_ps(ir, _mm_set1_ps(255)), zero);
+
+        int n = count < 4 ? count : 4;
+        store_lanes(index, _mm_cvttps_epi32(ir), n);
+        index += n;
+        count -= n;
+    }
+}
+
+void SkTwoPointConicalSpan_SSE2(const SkTwoPointConicalSpan& span, int count, SkFixed t[]) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 radius = _mm_set1_ps(span.fRadius);
+    const __m128 dRadius = _mm_set1_ps(span.fDRadius);
+    const __m128 radius2 = _mm_set1_ps(span.fRadius2);
+    const __m128 a = _mm_set1_ps(span.fA);
+    const __m128 fourA = _mm_set1_ps(4 * span.fA);
+    const __m128i dontDraw = _mm_set1_epi32(0x80000000);
+
+    float relX = span.fRelX;
+    float relY = span.fRelY;
+    float b = span.fB;
+
+    while (count > 0) {
+        __m128 x = next4(&relX, span.fIncX);
+        __m128 y = next4(&relY, span.fIncY);
+        __m128 B = next4(&b, span.fDB);
+        __m128 C = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), radius2);
+
+        __m128 root, skip;
+        if (0 == span.fA) {
+            // One root, -C/B, unless B is 0.
+            __m128 negC = _mm_xor_ps(C, _mm_set1_ps(-0.0f));
+            root = _mm_div_ps(negC, B);
+            __m128 r = _mm_add_ps(radius, _mm_mul_ps(root, dRadius));
+            skip = _mm_or_ps(_mm_cmpeq_ps(B, zero), _mm_cmple_ps(r, zero));
+        } else {
+            __m128 R = _mm_sub_ps(_mm_mul_ps(B, B), _mm_mul_ps(fourA, C));
+            __m128 noRoots = _mm_cmplt_ps(R, zero);
+            R = _mm_sqrt_ps(R);
+
+            __m128 Q = select(_mm_cmplt_ps(B, zero), _mm_sub_ps(B, R), _mm_add_ps(B, R));
+            Q = _mm_mul_ps(Q, _mm_set1_ps(-0.5f));
+            __m128 oneRoot = _mm_cmpeq_ps(Q, zero);
+
+            __m128 r0 = _mm_div_ps(Q, a);
+            __m128 r1 = _mm_div_ps(C, Q);
+            // These are r0 < r1 ? r0 : r1 and r0 > r1 ? r0 : r1, NaNs and all.
+            __m128 lo = _mm_min_ps(r0, r1);
+            __m128 hi = _mm_max_ps(r0, r1);
+            __m128 first = span.fFlipped ? hi : lo;
+            __m128 last = span.fFlipped ? lo : hi;
+
+            // Prefer the last root if it gives a radius > 0, then the first.
+            __m128 useFirst = _mm_cmple_ps(_mm_add_ps(radius, _mm_mul_ps(last, dRadius)), zero);
+            __m128 firstBad = _mm_cmple_ps(_mm_add_ps(radius, _mm_mul_ps(first, dRadius)), zero);
+            root = select(useFirst, first, last);
+            skip = _mm_and_ps(useFirst, firstBad);
+
+            // When Q is 0 the only root is 0.
+            __m128 zeroBad = _mm_cmple_ps(_mm_add_ps(radius, _mm_mul_ps(zero, dRadius)), zero);
+            root = select(oneRoot, zero, root);
+            skip = select(oneRoot, zeroBad, skip);
+            skip = _mm_or_ps(skip, noRoots);
+        }
+
+        __m128i fixed = float_to_fixed(root);
+        __m128i skipi = _mm_castps_si128(skip);
+        fixed = _mm_or_si128(_mm_and_si128(skipi, dontDraw), _mm_andnot_si128(skipi, fixed));
+
+        int n = count < 4 ? count : 4;
+        store_lanes(reinterpret_cast<uint32_t*>(t), fixed, n);
+        t += n;
+        count -= n;
+    }
+}
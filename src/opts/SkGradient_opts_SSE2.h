@@ -0,0 +1,19 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradient_opts_SSE2_DEFINED
+#define SkGradient_opts_SSE2_DEFINED
+
+#include "SkGradient_opts.h"
+
+void SkRadialClampSpan_SSE2(SkFixed fx, SkFixed dx, SkFixed fy, SkFixed dy,
+                            int count, uint32_t fi[]);
+void SkRadialSpan_SSE2(float fx, float dx, float fy, float dy, int count, SkFixed t[]);
+void SkSweepSpan_SSE2(float fx, float dx, float fy, float dy, int count, uint32_t index[]);
+void SkTwoPointConicalSpan_SSE2(const SkTwoPointConicalSpan&, int count, SkFixed t[]);
+
+#endif
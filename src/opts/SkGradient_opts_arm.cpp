@@ -0,0 +1,25 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradient_opts.h"
+#include "SkGradient_opts_neon.h"
+#include "SkUtilsArm.h"
+
+void SkGradientGetPlatformSpanProcs(SkGradientSpanProcs* procs) {
+    sk_bzero(procs, sizeof(*procs));
+#if !SK_ARM_NEON_IS_NONE
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return;
+    }
+#endif
+    procs->fRadialClamp = SkRadialClampSpan_neon;
+    procs->fRadial = SkRadialSpan_neon;
+    procs->fSweep = SkSweepSpan_neon;
+    procs->fTwoPointConical = SkTwoPointConicalSpan_neon;
+#endif
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradient_opts_neon.h"
+#include "SkScalar.h"
+
+#include <arm_neon.h>
+
+/* neon versions of the gradient span procs.
+ * portable versions are in src/effects/gradients. The radial clamp proc gives
+ * exactly the same results; the sweep proc uses a polynomial arctangent and an
+ * estimated reciprocal instead of sk_float_atan2. ARMv7 NEON has no divide or
+ * square root, so the radial and conical procs refine the reciprocal and
+ * reciprocal square root estimates with two Newton-Raphson steps each, which
+ * leaves them within a few float ulps of the portable math.
+ */
+
+// Stores the first count (at most 4) lanes of v to dst.
+static inline void store_lanes(uint32_t dst[], uint32x4_t v, int count) {
+    if (4 == count) {
+        vst1q_u32(dst, v);
+    } else {
+        uint32_t tmp[4];
+        vst1q_u32(tmp, v);
+        for (int i = 0; i < count; ++i) {
+            dst[i] = tmp[i];
+        }
+    }
+}
+
+// Returns the next four values of x, advancing it by dx after each one, as
+// the portable loops do.
+static inline float32x4_t next4(float* x, float dx) {
+    float lanes[4];
+    lanes[0] = *x;
+    lanes[1] = lanes[0] + dx;
+    lanes[2] = lanes[1] + dx;
+    lanes[3] = lanes[2] + dx;
+    *x = lanes[3] + dx;
+    return vld1q_f32(lanes);
+}
+
+// 1 / x, from the estimate refined twice to nearly full precision. 1 / 0 stays infinite.
+static inline float32x4_t reciprocal(float32x4_t x) {
+    float32x4_t e = vrecpeq_f32(x);
+    e = vmulq_f32(vrecpsq_f32(x, e), e);
+    e = vmulq_f32(vrecpsq_f32(x, e), e);
+    return e;
+}
+
+// sqrt(x) as x times 1 / sqrt(x), from the estimate refined twice. Lanes <= 0 give 0.
+static inline float32x4_t square_root(float32x4_t x) {
+    float32x4_t e = vrsqrteq_f32(x);
+    e = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, e), e), e);
+    e = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, e), e), e);
+    // At 0 the estimate is infinite, and the steps above leave NaN.
+    uint32x4_t positive = vcgtq_f32(x, vdupq_n_f32(0));
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(x, e)), positive));
+}
+
+static inline uint32x4_t float_to_fixed(float32x4_t x) {
+    // Truncates like SkFloatToFixed, which on ARM saturates out of range too.
+    return vreinterpretq_u32_s32(vcvtq_s32_f32(vmulq_f32(x, vdupq_n_f32(SK_Fixed1))));
+}
+
+void SkRadialClampSpan_neon(SkFixed fx, SkFixed dx, SkFixed fy, SkFixed dy,
+                            int count, uint32_t fi[]) {
+    const int32_t xLanes[4] = { fx, fx + dx, fx + 2 * dx, fx + 3 * dx };
+    const int32_t yLanes[4] = { fy, fy + dy, fy + 2 * dy, fy + 3 * dy };
+    int32x4_t x = vld1q_s32(xLanes);
+    int32x4_t y = vld1q_s32(yLanes);
+    const int32x4_t dx4 = vdupq_n_s32(4 * dx);
+    const int32x4_t dy4 = vdupq_n_s32(4 * dy);
+    const uint32x4_t maxIndex = vdupq_n_u32(0x7FF);
+
+    while (count > 0) {
+        // Saturating to 16 bits pins to [-0x8000, 0x7FFF]; see the SSE2 proc.
+        int16x4_t xs = vqmovn_s32(x);
+        int16x4_t ys = vqmovn_s32(y);
+        // Only 2 * 0x8000^2 overflows, and as unsigned it is 0x80000000.
+        int32x4_t d2 = vmlal_s16(vmull_s16(xs, xs), ys, ys);
+        uint32x4_t index = vshrq_n_u32(vreinterpretq_u32_s32(d2), 14 + 16 - 11);
+        index = vminq_u32(index, maxIndex);
+
+        int n = count < 4 ? count : 4;
+        store_lanes(fi, index, n);
+        fi += n;
+        count -= n;
+        x = vaddq_s32(x, dx4);
+        y = vaddq_s32(y, dy4);
+    }
+}
+
+void SkRadialSpan_neon(float fx, float dx, float fy, float dy, int count, SkFixed t[]) {
+    while (count > 0) {
+        float32x4_t x = next4(&fx, dx);
+        float32x4_t y = next4(&fy, dy);
+        float32x4_t dist = square_root(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)));
+
+        int n = count < 4 ? count : 4;
+        store_lanes(reinterpret_cast<uint32_t*>(t), float_to_fixed(dist), n);
+        t += n;
+        count -= n;
+    }
+}
+
+void SkSweepSpan_neon(float fx, float dx, float fy, float dy, int count, uint32_t index[]) {
+    // atan(a) for a in [0, 1], within 2e-6; see the SSE2 proc.
+    static const float kC1 =  0.99997726f;
+    static const float kC3 = -0.33262347f;
+    static const float kC5 =  0.19354346f;
+    static const float kC7 = -0.11643287f;
+    static const float kC9 =  0.05265332f;
+    static const float kC11 = -0.01172120f;
+    // 255 / (2 * SK_ScalarPI)
+    static const float g255Over2PI = 40.584510488433314f;
+
+    const float32x4_t zero = vdupq_n_f32(0);
+    const float32x4_t halfPi = vdupq_n_f32(SK_ScalarPI / 2);
+    const float32x4_t pi = vdupq_n_f32(SK_ScalarPI);
+    const float32x4_t twoPi = vdupq_n_f32(2 * SK_ScalarPI);
+
+    while (count > 0) {
+        float32x4_t x = next4(&fx, dx);
+        float32x4_t y = next4(&fy, dy);
+        float32x4_t ax = vabsq_f32(x);
+        float32x4_t ay = vabsq_f32(y);
+        float32x4_t mn = vminq_f32(ax, ay);
+        float32x4_t mx = vmaxq_f32(ax, ay);
+
+        // 1 / mx, refined twice to nearly full precision.
+        float32x4_t inv = vrecpeq_f32(mx);
+        inv = vmulq_f32(vrecpsq_f32(mx, inv), inv);
+        inv = vmulq_f32(vrecpsq_f32(mx, inv), inv);
+
+        // a = mn / mx, or 0 at the origin, where atan2 gives 0 too.
+        uint32x4_t nonZero = vcgtq_f32(mx, zero);
+        float32x4_t a = vreinterpretq_f32_u32(
+                vandq_u32(vreinterpretq_u32_f32(vmulq_f32(mn, inv)), nonZero));
+        float32x4_t a2 = vmulq_f32(a, a);
+        float32x4_t r = vmlaq_f32(vdupq_n_f32(kC9), a2, vdupq_n_f32(kC11));
+        r = vmlaq_f32(vdupq_n_f32(kC7), r, a2);
+        r = vmlaq_f32(vdupq_n_f32(kC5), r, a2);
+        r = vmlaq_f32(vdupq_n_f32(kC3), r, a2);
+        r = vmlaq_f32(vdupq_n_f32(kC1), r, a2);
+        r = vmulq_f32(r, a);
+
+        // Unfold from the first octant into [0, 2pi).
+        r = vbslq_f32(vcgtq_f32(ay, ax), vsubq_f32(halfPi, r), r);
+        r = vbslq_f32(vcltq_f32(x, zero), vsubq_f32(pi, r), r);
+        r = vbslq_f32(vcltq_f32(y, zero), vsubq_f32(twoPi, r), r);
+
+        // Keep rounding at the ends in [0, 255], as the portable code asserts.
+        float32x4_t ir = vmulq_f32(r, vdupq_n_f32(g255Over2PI));
+        ir = vmaxq_f32(vminq_f32(ir, vdupq_n_f32(255)), zero);
+
+        int n = count < 4 ? count : 4;
+        store_lanes(index, vcvtq_u32_f32(ir), n);
+        index += n;
+        count -= n;
+    }
+}
+
+void SkTwoPointConicalSpan_neon(const SkTwoPointConicalSpan& span, int count, SkFixed t[]) {
+    const float32x4_t zero = vdupq_n_f32(0);
+    const float32x4_t radius = vdupq_n_f32(span.fRadius);
+    const float32x4_t dRadius = vdupq_n_f32(span.fDRadius);
+    const float32x4_t radius2 = vdupq_n_f32(span.fRadius2);
+    const float32x4_t fourA = vdupq_n_f32(4 * span.fA);
+    // Only used when A isn't 0.
+    const float32x4_t invA = vdupq_n_f32(0 == span.fA ? 0 : 1 / span.fA);
+    const uint32x4_t dontDraw = vdupq_n_u32(0x80000000);
+
+    float relX = span.fRelX;
+    float relY = span.fRelY;
+    float b = span.fB;
+
+    while (count > 0) {
+        float32x4_t x = next4(&relX, span.fIncX);
+        float32x4_t y = next4(&relY, span.fIncY);
+        float32x4_t B = next4(&b, span.fDB);
+        float32x4_t C = vsubq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)), radius2);
+
+        float32x4_t root;
+        uint32x4_t skip;
+        if (0 == span.fA) {
+            // One root, -C/B, unless B is 0.
+            root = vmulq_f32(vnegq_f32(C), reciprocal(B));
+            float32x4_t r = vmlaq_f32(radius, root, dRadius);
+            skip = vorrq_u32(vceqq_f32(B, zero), vcleq_f32(r, zero));
+        } else {
+            float32x4_t R = vsubq_f32(vmulq_f32(B, B), vmulq_f32(fourA, C));
+            uint32x4_t noRoots = vcltq_f32(R, zero);
+            R = square_root(R);
+
+            float32x4_t Q = vbslq_f32(vcltq_f32(B, zero), vsubq_f32(B, R), vaddq_f32(B, R));
+            Q = vmulq_f32(Q, vdupq_n_f32(-0.5f));
+            uint32x4_t oneRoot = vceqq_f32(Q, zero);
+
+            // r1 is not finite when Q is 0, but then both roots are replaced by 0 below.
+            float32x4_t r0 = vmulq_f32(Q, invA);
+            float32x4_t r1 = vmulq_f32(C, reciprocal(Q));
+            float32x4_t lo = vminq_f32(r0, r1);
+            float32x4_t hi = vmaxq_f32(r0, r1);
+            float32x4_t first = span.fFlipped ? hi : lo;
+            float32x4_t last = span.fFlipped ? lo : hi;
+
+            // Prefer the last root if it gives a radius > 0, then the first.
+            uint32x4_t useFirst = vcleq_f32(vmlaq_f32(radius, last, dRadius), zero);
+            uint32x4_t firstBad = vcleq_f32(vmlaq_f32(radius, first, dRadius), zero);
+            root = vbslq_f32(useFirst, first, last);
+            skip = vandq_u32(useFirst, firstBad);
+
+            // When Q is 0 the only root is 0.
+            root = vbslq_f32(oneRoot, zero, root);
+            skip = vbslq_u32(oneRoot, vcleq_f32(radius, zero), skip);
+            skip = vorrq_u32(skip, noRoots);
+        }
+
+        uint32x4_t fixed = vbslq_u32(skip, dontDraw, float_to_fixed(root));
+
+        int n = count < 4 ? count : 4;
+        store_lanes(reinterpret_cast<uint32_t*>(t), fixed, n);
+        t += n;
+        count -= n;
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMath_opts_AVX2_DEFINED
+#define SkMath_opts_AVX2_DEFINED
+
+#include <immintrin.h>
+#include "SkTypes.h"
+
+// There's no integer division in AVX2 either, so as in SkMath_opts_SSE2.h we divide as floats.
+// When using this function, make sure a and b don't exceed float's precision.
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i shim_mm256_div_epi32(const __m256i& a, const __m256i& b) {
+    __m256 x = _mm256_cvtepi32_ps(a);
+    __m256 y = _mm256_cvtepi32_ps(b);
+    return _mm256_cvttps_epi32(_mm256_div_ps(x, y));
+}
+
+// Portable version of SkSqrtBits is in SkMath.cpp.
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i SkSqrtBits_AVX2(const __m256i& x, int count) {
+    __m256i root =  _mm256_setzero_si256();
+    __m256i remHi = _mm256_setzero_si256();
+    __m256i remLo = x;
+    __m256i one256 = _mm256_set1_epi32(1);
+
+    do {
+        root = _mm256_slli_epi32(root, 1);
+
+        remHi = _mm256_or_si256(_mm256_slli_epi32(remHi, 2),
+                                _mm256_srli_epi32(remLo, 30));
+        remLo = _mm256_slli_epi32(remLo, 2);
+
+        __m256i testDiv = _mm256_slli_epi32(root, 1);
+        testDiv = _mm256_add_epi32(testDiv, one256);
+
+        // remHi < testDiv
+        __m256i cmp = _mm256_cmpgt_epi32(testDiv, remHi);
+        remHi = _mm256_blendv_epi8(_mm256_sub_epi32(remHi, testDiv), remHi, cmp);
+        root = _mm256_blendv_epi8(_mm256_add_epi32(root, one256), root, cmp);
+    } while (--count >= 0);
+
+    return root;
+}
+
+#endif // SkMath_opts_AVX2_DEFINED
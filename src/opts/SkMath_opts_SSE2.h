@@ -18,6 +18,24 @@ static inline __m128i shim_mm_div_epi32(const __m128i& a, const __m128i& b) {
     return _mm_cvttps_epi32(_mm_div_ps(x, y));
 }
 
+// Portable version of SkMulDiv is in SkMath.h.
+// a * b needs more than a float (or an int) holds, so this works in doubles, two at a time.
+// They hold any a * b of 32-bit ints that fits in 53 bits exactly, and the truncated quotient is
+// then exact too.  Lanes where c is 0 come out as 0.
+static inline __m128i SkMulDiv_SSE2(const __m128i& a, const __m128i& b, const __m128i& c) {
+    __m128i zero = _mm_cmpeq_epi32(c, _mm_setzero_si128());
+    __m128i denom = _mm_or_si128(c, _mm_and_si128(zero, _mm_set1_epi32(1)));
+
+    __m128d lo = _mm_div_pd(_mm_mul_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b)),
+                            _mm_cvtepi32_pd(denom));
+    __m128d hi = _mm_div_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(a, 8)),
+                                       _mm_cvtepi32_pd(_mm_srli_si128(b, 8))),
+                            _mm_cvtepi32_pd(_mm_srli_si128(denom, 8)));
+
+    __m128i ret = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+    return _mm_andnot_si128(zero, ret);
+}
+
 // Portable version of SkSqrtBits is in SkMath.cpp.
 static inline __m128i SkSqrtBits_SSE2(const __m128i& x, int count) {
     __m128i root =  _mm_setzero_si128();
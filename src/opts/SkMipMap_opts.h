@@ -0,0 +1,26 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipMap_opts_DEFINED
+#define SkMipMap_opts_DEFINED
+
+#include "SkMipMap.h"
+
+enum SkMipMapProcType {
+    k32_SkMipMapProcType,
+    k565_SkMipMapProcType,
+    k4444_SkMipMapProcType,
+    kA8_SkMipMapProcType,
+};
+
+/**
+ *  Returns a SIMD row proc for type that gives the same results as the
+ *  portable one in src/core/SkMipMap.cpp, or NULL if there is none.
+ */
+SkMipMap::DownsampleRowProc SkMipMapGetPlatformProc(SkMipMapProcType type);
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkColorPriv.h"
+#include "SkMipMap_opts_SSE2.h"
+
+/* SSE2 versions of the 2x2 box filter row procs.
+ * portable versions are in src/core/SkMipMap.cpp, and these give exactly the
+ * same results: each channel is the sum of its four samples, shifted down by 2.
+ */
+
+void SkMipMapDownsample32_SSE2(void* dst, const void* src0, const void* src1, int count) {
+    const uint32_t* p0 = static_cast<const uint32_t*>(src0);
+    const uint32_t* p1 = static_cast<const uint32_t*>(src1);
+    uint32_t* d = static_cast<uint32_t*>(dst);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (count >= 4) {
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + 4));
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1 + 4));
+
+        // Add the rows, widening the channels to 16 bits.
+        __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+        __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+        __m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+        __m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+        // Add each even pixel to the odd one after it.
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+        __m128i hi = _mm_add_epi16(_mm_unpacklo_epi64(s45, s67), _mm_unpackhi_epi64(s45, s67));
+
+        lo = _mm_srli_epi16(lo, 2);
+        hi = _mm_srli_epi16(hi, 2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_packus_epi16(lo, hi));
+
+        p0 += 8;
+        p1 += 8;
+        d += 4;
+        count -= 4;
+    }
+
+    while (count > 0) {
+        __m128i a = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p0));
+        __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p1));
+        __m128i s = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        s = _mm_add_epi16(s, _mm_srli_si128(s, 8));
+        s = _mm_srli_epi16(s, 2);
+        *d = _mm_cvtsi128_si32(_mm_packus_epi16(s, s));
+
+        p0 += 2;
+        p1 += 2;
+        d += 1;
+        count -= 1;
+    }
+}
+
+// Returns the average of the field at shift (of width mask) of the 2x2
+// blocks of 16 bit pixels in a (row 0) and b (row 1). Each of a and b holds
+// 16 pixels, as two registers; the 8 averages are in the low bits of each
+// 16 bit lane of the result.
+static inline __m128i average_field16(const __m128i a[2], const __m128i b[2],
+                                      int shift, const __m128i& mask) {
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sums[2];
+    for (int i = 0; i < 2; ++i) {
+        __m128i fa = _mm_and_si128(_mm_srl_epi16(a[i], _mm_cvtsi32_si128(shift)), mask);
+        __m128i fb = _mm_and_si128(_mm_srl_epi16(b[i], _mm_cvtsi32_si128(shift)), mask);
+        // madd adds each even lane to the odd one after it, into 32 bits.
+        sums[i] = _mm_madd_epi16(_mm_add_epi16(fa, fb), ones);
+    }
+    // The sums are at most 4 * 63, so pack without saturating.
+    return _mm_srli_epi16(_mm_packs_epi32(sums[0], sums[1]), 2);
+}
+
+static inline void load16(const uint16_t* p0, const uint16_t* p1, __m128i a[2], __m128i b[2]) {
+    a[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0));
+    a[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + 8));
+    b[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1));
+    b[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1 + 8));
+}
+
+void SkMipMapDownsample565_SSE2(void* dst, const void* src0, const void* src1, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(src0);
+    const uint16_t* p1 = static_cast<const uint16_t*>(src1);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+
+    while (count >= 8) {
+        __m128i a[2], b[2];
+        load16(p0, p1, a, b);
+
+        __m128i r = average_field16(a, b, SK_R16_SHIFT, mask5);
+        __m128i g = average_field16(a, b, SK_G16_SHIFT, mask6);
+        __m128i bl = average_field16(a, b, SK_B16_SHIFT, mask5);
+
+        __m128i c = _mm_or_si128(_mm_sll_epi16(r, _mm_cvtsi32_si128(SK_R16_SHIFT)),
+                    _mm_or_si128(_mm_sll_epi16(g, _mm_cvtsi32_si128(SK_G16_SHIFT)),
+                                 _mm_sll_epi16(bl, _mm_cvtsi32_si128(SK_B16_SHIFT))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), c);
+
+        p0 += 16;
+        p1 += 16;
+        d += 8;
+        count -= 8;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        unsigned r = SkGetPackedR16(p0[0]) + SkGetPackedR16(p0[1]) +
+                     SkGetPackedR16(p1[0]) + SkGetPackedR16(p1[1]);
+        unsigned g = SkGetPackedG16(p0[0]) + SkGetPackedG16(p0[1]) +
+                     SkGetPackedG16(p1[0]) + SkGetPackedG16(p1[1]);
+        unsigned b = SkGetPackedB16(p0[0]) + SkGetPackedB16(p0[1]) +
+                     SkGetPackedB16(p1[0]) + SkGetPackedB16(p1[1]);
+        d[i] = SkPackRGB16(r >> 2, g >> 2, b >> 2);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+void SkMipMapDownsample4444_SSE2(void* dst, const void* src0, const void* src1, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(src0);
+    const uint16_t* p1 = static_cast<const uint16_t*>(src1);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+    const __m128i mask4 = _mm_set1_epi16(0xF);
+
+    while (count >= 8) {
+        __m128i a[2], b[2];
+        load16(p0, p1, a, b);
+
+        __m128i c = _mm_setzero_si128();
+        for (int shift = 0; shift < 16; shift += 4) {
+            __m128i f = average_field16(a, b, shift, mask4);
+            c = _mm_or_si128(c, _mm_sll_epi16(f, _mm_cvtsi32_si128(shift)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), c);
+
+        p0 += 16;
+        p1 += 16;
+        d += 8;
+        count -= 8;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        unsigned c = 0;
+        for (int shift = 0; shift < 16; shift += 4) {
+            unsigned f = ((p0[0] >> shift) & 0xF) + ((p0[1] >> shift) & 0xF) +
+                         ((p1[0] >> shift) & 0xF) + ((p1[1] >> shift) & 0xF);
+            c |= (f >> 2) << shift;
+        }
+        d[i] = SkToU16(c);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+void SkMipMapDownsampleA8_SSE2(void* dst, const void* src0, const void* src1, int count) {
+    const uint8_t* p0 = static_cast<const uint8_t*>(src0);
+    const uint8_t* p1 = static_cast<const uint8_t*>(src1);
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const __m128i mask = _mm_set1_epi16(0xFF);
+
+    while (count >= 16) {
+        __m128i sums[2];
+        for (int i = 0; i < 2; ++i) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + 16 * i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1 + 16 * i));
+            // Each 16 bit lane gets its even byte plus its odd byte, for both rows.
+            __m128i sa = _mm_add_epi16(_mm_and_si128(a, mask), _mm_srli_epi16(a, 8));
+            __m128i sb = _mm_add_epi16(_mm_and_si128(b, mask), _mm_srli_epi16(b, 8));
+            sums[i] = _mm_srli_epi16(_mm_add_epi16(sa, sb), 2);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_packus_epi16(sums[0], sums[1]));
+
+        p0 += 32;
+        p1 += 32;
+        d += 16;
+        count -= 16;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        d[i] = (p0[0] + p0[1] + p1[0] + p1[1]) >> 2;
+        p0 += 2;
+        p1 += 2;
+    }
+}
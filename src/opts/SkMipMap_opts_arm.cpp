@@ -0,0 +1,34 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMipMap_opts.h"
+#include "SkMipMap_opts_neon.h"
+#include "SkUtilsArm.h"
+
+SkMipMap::DownsampleRowProc SkMipMapGetPlatformProc(SkMipMapProcType type) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    switch (type) {
+        case k32_SkMipMapProcType:
+            return SkMipMapDownsample32_neon;
+        case k565_SkMipMapProcType:
+            return SkMipMapDownsample565_neon;
+        case k4444_SkMipMapProcType:
+            return SkMipMapDownsample4444_neon;
+        case kA8_SkMipMapProcType:
+            return SkMipMapDownsampleA8_neon;
+        default:
+            return NULL;
+    }
+#endif
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkMipMap_opts.h"
+#include "SkMipMap_opts_neon.h"
+
+#include <arm_neon.h>
+
+/* neon versions of the 2x2 box filter row procs.
+ * portable versions are in src/core/SkMipMap.cpp, and these give exactly the
+ * same results: each channel is the sum of its four samples, shifted down by 2.
+ */
+
+void SkMipMapDownsample32_neon(void* dst, const void* src0, const void* src1, int count) {
+    const uint32_t* p0 = static_cast<const uint32_t*>(src0);
+    const uint32_t* p1 = static_cast<const uint32_t*>(src1);
+    uint32_t* d = static_cast<uint32_t*>(dst);
+
+    while (count >= 4) {
+        // Split each row into its even and odd pixels.
+        uint32x4x2_t r0 = vld2q_u32(p0);
+        uint32x4x2_t r1 = vld2q_u32(p1);
+        uint8x16_t e0 = vreinterpretq_u8_u32(r0.val[0]);
+        uint8x16_t o0 = vreinterpretq_u8_u32(r0.val[1]);
+        uint8x16_t e1 = vreinterpretq_u8_u32(r1.val[0]);
+        uint8x16_t o1 = vreinterpretq_u8_u32(r1.val[1]);
+
+        uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(e0), vget_low_u8(o0)),
+                                  vaddl_u8(vget_low_u8(e1), vget_low_u8(o1)));
+        uint16x8_t hi = vaddq_u16(vaddl_u8(vget_high_u8(e0), vget_high_u8(o0)),
+                                  vaddl_u8(vget_high_u8(e1), vget_high_u8(o1)));
+
+        uint8x16_t c = vcombine_u8(vshrn_n_u16(lo, 2), vshrn_n_u16(hi, 2));
+        vst1q_u32(d, vreinterpretq_u32_u8(c));
+
+        p0 += 8;
+        p1 += 8;
+        d += 4;
+        count -= 4;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t c, ag, rb;
+
+        c = p0[0]; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
+        c = p0[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[0]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+
+        d[i] = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+// Returns the average of the field at shift (of width mask) of the 2x2 blocks
+// whose even and odd pixels of row 0 are in r0, and of row 1 are in r1.
+static inline uint16x8_t average_field16(const uint16x8x2_t& r0, const uint16x8x2_t& r1,
+                                         int shift, uint16x8_t mask) {
+    const int16x8_t right = vdupq_n_s16(-shift);
+    uint16x8_t sum = vandq_u16(vshlq_u16(r0.val[0], right), mask);
+    sum = vaddq_u16(sum, vandq_u16(vshlq_u16(r0.val[1], right), mask));
+    sum = vaddq_u16(sum, vandq_u16(vshlq_u16(r1.val[0], right), mask));
+    sum = vaddq_u16(sum, vandq_u16(vshlq_u16(r1.val[1], right), mask));
+    return vshrq_n_u16(sum, 2);
+}
+
+static inline uint16x8_t place_field16(uint16x8_t field, int shift) {
+    return vshlq_u16(field, vdupq_n_s16(shift));
+}
+
+void SkMipMapDownsample565_neon(void* dst, const void* src0, const void* src1, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(src0);
+    const uint16_t* p1 = static_cast<const uint16_t*>(src1);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+
+    while (count >= 8) {
+        uint16x8x2_t r0 = vld2q_u16(p0);
+        uint16x8x2_t r1 = vld2q_u16(p1);
+
+        uint16x8_t r = average_field16(r0, r1, SK_R16_SHIFT, mask5);
+        uint16x8_t g = average_field16(r0, r1, SK_G16_SHIFT, mask6);
+        uint16x8_t b = average_field16(r0, r1, SK_B16_SHIFT, mask5);
+
+        vst1q_u16(d, vorrq_u16(place_field16(r, SK_R16_SHIFT),
+                               vorrq_u16(place_field16(g, SK_G16_SHIFT),
+                                         place_field16(b, SK_B16_SHIFT))));
+
+        p0 += 16;
+        p1 += 16;
+        d += 8;
+        count -= 8;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        unsigned r = SkGetPackedR16(p0[0]) + SkGetPackedR16(p0[1]) +
+                     SkGetPackedR16(p1[0]) + SkGetPackedR16(p1[1]);
+        unsigned g = SkGetPackedG16(p0[0]) + SkGetPackedG16(p0[1]) +
+                     SkGetPackedG16(p1[0]) + SkGetPackedG16(p1[1]);
+        unsigned b = SkGetPackedB16(p0[0]) + SkGetPackedB16(p0[1]) +
+                     SkGetPackedB16(p1[0]) + SkGetPackedB16(p1[1]);
+        d[i] = SkPackRGB16(r >> 2, g >> 2, b >> 2);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+void SkMipMapDownsample4444_neon(void* dst, const void* src0, const void* src1, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(src0);
+    const uint16_t* p1 = static_cast<const uint16_t*>(src1);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+    const uint16x8_t mask4 = vdupq_n_u16(0xF);
+
+    while (count >= 8) {
+        uint16x8x2_t r0 = vld2q_u16(p0);
+        uint16x8x2_t r1 = vld2q_u16(p1);
+
+        uint16x8_t c = vdupq_n_u16(0);
+        for (int shift = 0; shift < 16; shift += 4) {
+            c = vorrq_u16(c, place_field16(average_field16(r0, r1, shift, mask4), shift));
+        }
+        vst1q_u16(d, c);
+
+        p0 += 16;
+        p1 += 16;
+        d += 8;
+        count -= 8;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        unsigned c = 0;
+        for (int shift = 0; shift < 16; shift += 4) {
+            unsigned f = ((p0[0] >> shift) & 0xF) + ((p0[1] >> shift) & 0xF) +
+                         ((p1[0] >> shift) & 0xF) + ((p1[1] >> shift) & 0xF);
+            c |= (f >> 2) << shift;
+        }
+        d[i] = SkToU16(c);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+void SkMipMapDownsampleA8_neon(void* dst, const void* src0, const void* src1, int count) {
+    const uint8_t* p0 = static_cast<const uint8_t*>(src0);
+    const uint8_t* p1 = static_cast<const uint8_t*>(src1);
+    uint8_t* d = static_cast<uint8_t*>(dst);
+
+    while (count >= 8) {
+        // Pairwise add each row's adjacent bytes, then the two rows.
+        uint16x8_t sum = vpaddlq_u8(vld1q_u8(p0));
+        sum = vpadalq_u8(sum, vld1q_u8(p1));
+        vst1_u8(d, vshrn_n_u16(sum, 2));
+
+        p0 += 16;
+        p1 += 16;
+        d += 8;
+        count -= 8;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        d[i] = (p0[0] + p0[1] + p1[0] + p1[1]) >> 2;
+        p0 += 2;
+        p1 += 2;
+    }
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipMap_opts_neon_DEFINED
+#define SkMipMap_opts_neon_DEFINED
+
+void SkMipMapDownsample32_neon(void* dst, const void* src0, const void* src1, int count);
+void SkMipMapDownsample565_neon(void* dst, const void* src0, const void* src1, int count);
+void SkMipMapDownsample4444_neon(void* dst, const void* src0, const void* src1, int count);
+void SkMipMapDownsampleA8_neon(void* dst, const void* src0, const void* src1, int count);
+
+#endif
@@ -0,0 +1,790 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkColor_opts_AVX2.h"
+#include "SkMath_opts_AVX2.h"
+#include "SkXfermode.h"
+#include "SkXfermode_opts_AVX2.h"
+#include "SkXfermode_proccoeff.h"
+
+#if !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK) || SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+////////////////////////////////////////////////////////////////////////////////
+// 8 pixels AVX2 version functions, one for one with the 4 pixel SSE2 ones in
+// SkXfermode_opts_SSE2.cpp.
+////////////////////////////////////////////////////////////////////////////////
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i SkDiv255Round_AVX2(const __m256i& a) {
+    __m256i prod = _mm256_add_epi32(a, _mm256_set1_epi32(128)); // prod += 128;
+    prod = _mm256_add_epi32(prod, _mm256_srli_epi32(prod, 8));  // prod + (prod >> 8)
+    prod = _mm256_srli_epi32(prod, 8);                          // >> 8
+
+    return prod;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i saturated_add_AVX2(const __m256i& a, const __m256i& b) {
+    __m256i sum = _mm256_add_epi32(a, b);
+    __m256i cmp = _mm256_cmpgt_epi32(sum, _mm256_set1_epi32(255));
+
+    sum = _mm256_or_si256(_mm256_and_si256(cmp, _mm256_set1_epi32(255)),
+                          _mm256_andnot_si256(cmp, sum));
+    return sum;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i clamp_signed_byte_AVX2(const __m256i& n) {
+    __m256i cmp1 = _mm256_cmpgt_epi32(_mm256_setzero_si256(), n);
+    __m256i cmp2 = _mm256_cmpgt_epi32(n, _mm256_set1_epi32(255));
+    __m256i ret = _mm256_and_si256(cmp2, _mm256_set1_epi32(255));
+
+    __m256i cmp = _mm256_or_si256(cmp1, cmp2);
+    ret = _mm256_or_si256(_mm256_and_si256(cmp, ret), _mm256_andnot_si256(cmp, n));
+
+    return ret;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i clamp_div255round_AVX2(const __m256i& prod) {
+    // test if > 0
+    __m256i cmp1 = _mm256_cmpgt_epi32(prod, _mm256_setzero_si256());
+    // test if < 255*255
+    __m256i cmp2 = _mm256_cmpgt_epi32(_mm256_set1_epi32(255*255), prod);
+
+    __m256i ret = _mm256_setzero_si256();
+
+    // if value >= 255*255, value = 255
+    ret = _mm256_andnot_si256(cmp2,  _mm256_set1_epi32(255));
+
+    __m256i div = SkDiv255Round_AVX2(prod);
+
+    // test if > 0 && < 255*255
+    __m256i cmp = _mm256_and_si256(cmp1, cmp2);
+
+    ret = _mm256_or_si256(_mm256_and_si256(cmp, div), _mm256_andnot_si256(cmp, ret));
+
+    return ret;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i srcover_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(256), SkGetPackedA32_AVX2(src));
+    return _mm256_add_epi32(src, SkAlphaMulQ_AVX2(dst, isa));
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i dstover_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(256), SkGetPackedA32_AVX2(dst));
+    return _mm256_add_epi32(dst, SkAlphaMulQ_AVX2(src, ida));
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i srcin_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    return SkAlphaMulQ_AVX2(src, SkAlpha255To256_AVX2(da));
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i dstin_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    return SkAlphaMulQ_AVX2(dst, SkAlpha255To256_AVX2(sa));
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i srcout_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(256), SkGetPackedA32_AVX2(dst));
+    return SkAlphaMulQ_AVX2(src, ida);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i dstout_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(256), SkGetPackedA32_AVX2(src));
+    return SkAlphaMulQ_AVX2(dst, isa);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i srcatop_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+
+    __m256i a = da;
+
+    __m256i r1 = SkAlphaMulAlpha_AVX2(da, SkGetPackedR32_AVX2(src));
+    __m256i r2 = SkAlphaMulAlpha_AVX2(isa, SkGetPackedR32_AVX2(dst));
+    __m256i r = _mm256_add_epi32(r1, r2);
+
+    __m256i g1 = SkAlphaMulAlpha_AVX2(da, SkGetPackedG32_AVX2(src));
+    __m256i g2 = SkAlphaMulAlpha_AVX2(isa, SkGetPackedG32_AVX2(dst));
+    __m256i g = _mm256_add_epi32(g1, g2);
+
+    __m256i b1 = SkAlphaMulAlpha_AVX2(da, SkGetPackedB32_AVX2(src));
+    __m256i b2 = SkAlphaMulAlpha_AVX2(isa, SkGetPackedB32_AVX2(dst));
+    __m256i b = _mm256_add_epi32(b1, b2);
+
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i dstatop_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+
+    __m256i a = sa;
+
+    __m256i r1 = SkAlphaMulAlpha_AVX2(ida, SkGetPackedR32_AVX2(src));
+    __m256i r2 = SkAlphaMulAlpha_AVX2(sa, SkGetPackedR32_AVX2(dst));
+    __m256i r = _mm256_add_epi32(r1, r2);
+
+    __m256i g1 = SkAlphaMulAlpha_AVX2(ida, SkGetPackedG32_AVX2(src));
+    __m256i g2 = SkAlphaMulAlpha_AVX2(sa, SkGetPackedG32_AVX2(dst));
+    __m256i g = _mm256_add_epi32(g1, g2);
+
+    __m256i b1 = SkAlphaMulAlpha_AVX2(ida, SkGetPackedB32_AVX2(src));
+    __m256i b2 = SkAlphaMulAlpha_AVX2(sa, SkGetPackedB32_AVX2(dst));
+    __m256i b = _mm256_add_epi32(b1, b2);
+
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i xor_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+
+    __m256i a1 = _mm256_add_epi32(sa, da);
+    __m256i a2 = SkAlphaMulAlpha_AVX2(sa, da);
+    a2 = _mm256_slli_epi32(a2, 1);
+    __m256i a = _mm256_sub_epi32(a1, a2);
+
+    __m256i r1 = SkAlphaMulAlpha_AVX2(ida, SkGetPackedR32_AVX2(src));
+    __m256i r2 = SkAlphaMulAlpha_AVX2(isa, SkGetPackedR32_AVX2(dst));
+    __m256i r = _mm256_add_epi32(r1, r2);
+
+    __m256i g1 = SkAlphaMulAlpha_AVX2(ida, SkGetPackedG32_AVX2(src));
+    __m256i g2 = SkAlphaMulAlpha_AVX2(isa, SkGetPackedG32_AVX2(dst));
+    __m256i g = _mm256_add_epi32(g1, g2);
+
+    __m256i b1 = SkAlphaMulAlpha_AVX2(ida, SkGetPackedB32_AVX2(src));
+    __m256i b2 = SkAlphaMulAlpha_AVX2(isa, SkGetPackedB32_AVX2(dst));
+    __m256i b = _mm256_add_epi32(b1, b2);
+
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i plus_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i b = saturated_add_AVX2(SkGetPackedB32_AVX2(src),
+                                   SkGetPackedB32_AVX2(dst));
+    __m256i g = saturated_add_AVX2(SkGetPackedG32_AVX2(src),
+                                   SkGetPackedG32_AVX2(dst));
+    __m256i r = saturated_add_AVX2(SkGetPackedR32_AVX2(src),
+                                   SkGetPackedR32_AVX2(dst));
+    __m256i a = saturated_add_AVX2(SkGetPackedA32_AVX2(src),
+                                   SkGetPackedA32_AVX2(dst));
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i modulate_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i a = SkAlphaMulAlpha_AVX2(SkGetPackedA32_AVX2(src),
+                                     SkGetPackedA32_AVX2(dst));
+    __m256i r = SkAlphaMulAlpha_AVX2(SkGetPackedR32_AVX2(src),
+                                     SkGetPackedR32_AVX2(dst));
+    __m256i g = SkAlphaMulAlpha_AVX2(SkGetPackedG32_AVX2(src),
+                                     SkGetPackedG32_AVX2(dst));
+    __m256i b = SkAlphaMulAlpha_AVX2(SkGetPackedB32_AVX2(src),
+                                     SkGetPackedB32_AVX2(dst));
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i srcover_byte_AVX2(const __m256i& a, const __m256i& b) {
+    // a + b - SkAlphaMulAlpha(a, b);
+    return _mm256_sub_epi32(_mm256_add_epi32(a, b), SkAlphaMulAlpha_AVX2(a, b));
+
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i blendfunc_multiply_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                                   const __m256i& sa, const __m256i& da) {
+    // sc * (255 - da)
+    __m256i ret1 = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+    ret1 = _mm256_mullo_epi16(sc, ret1);
+
+    // dc * (255 - sa)
+    __m256i ret2 = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+    ret2 = _mm256_mullo_epi16(dc, ret2);
+
+    // sc * dc
+    __m256i ret3 = _mm256_mullo_epi16(sc, dc);
+
+    __m256i ret = _mm256_add_epi32(ret1, ret2);
+    ret = _mm256_add_epi32(ret, ret3);
+
+    return clamp_div255round_AVX2(ret);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i multiply_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    __m256i a = srcover_byte_AVX2(sa, da);
+
+    __m256i sr = SkGetPackedR32_AVX2(src);
+    __m256i dr = SkGetPackedR32_AVX2(dst);
+    __m256i r = blendfunc_multiply_byte_AVX2(sr, dr, sa, da);
+
+    __m256i sg = SkGetPackedG32_AVX2(src);
+    __m256i dg = SkGetPackedG32_AVX2(dst);
+    __m256i g = blendfunc_multiply_byte_AVX2(sg, dg, sa, da);
+
+
+    __m256i sb = SkGetPackedB32_AVX2(src);
+    __m256i db = SkGetPackedB32_AVX2(dst);
+    __m256i b = blendfunc_multiply_byte_AVX2(sb, db, sa, da);
+
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i screen_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i a = srcover_byte_AVX2(SkGetPackedA32_AVX2(src),
+                                  SkGetPackedA32_AVX2(dst));
+    __m256i r = srcover_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                  SkGetPackedR32_AVX2(dst));
+    __m256i g = srcover_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                  SkGetPackedG32_AVX2(dst));
+    __m256i b = srcover_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                  SkGetPackedB32_AVX2(dst));
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+// Portable version overlay_byte() is in SkXfermode.cpp.
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i overlay_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                        const __m256i& sa, const __m256i& da) {
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+    __m256i tmp1 = _mm256_mullo_epi16(sc, ida);
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+    __m256i tmp2 = _mm256_mullo_epi16(dc, isa);
+    __m256i tmp = _mm256_add_epi32(tmp1, tmp2);
+
+    __m256i cmp = _mm256_cmpgt_epi32(_mm256_slli_epi32(dc, 1), da);
+    __m256i rc1 = _mm256_slli_epi32(sc, 1);                        // 2 * sc
+    rc1 = _mm256_mullo_epi32(rc1, dc);                             // *dc
+
+    __m256i rc2 = _mm256_mullo_epi16(sa, da);                      // sa * da
+    __m256i tmp3 = _mm256_slli_epi32(_mm256_sub_epi32(da, dc), 1); // 2 * (da - dc)
+    tmp3 = _mm256_mullo_epi32(tmp3, _mm256_sub_epi32(sa, sc));     // * (sa - sc)
+    rc2 = _mm256_sub_epi32(rc2, tmp3);
+
+    __m256i rc = _mm256_or_si256(_mm256_andnot_si256(cmp, rc1),
+                                 _mm256_and_si256(cmp, rc2));
+    return clamp_div255round_AVX2(_mm256_add_epi32(rc, tmp));
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i overlay_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = overlay_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                  SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = overlay_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                  SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = overlay_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                  SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i darken_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                       const __m256i& sa, const __m256i& da) {
+    __m256i sd = _mm256_mullo_epi16(sc, da);
+    __m256i ds = _mm256_mullo_epi16(dc, sa);
+
+    __m256i cmp = _mm256_cmpgt_epi32(ds, sd);
+
+    __m256i tmp = _mm256_add_epi32(sc, dc);
+    __m256i ret1 = _mm256_sub_epi32(tmp, SkDiv255Round_AVX2(ds));
+    __m256i ret2 = _mm256_sub_epi32(tmp, SkDiv255Round_AVX2(sd));
+    __m256i ret = _mm256_or_si256(_mm256_and_si256(cmp, ret1),
+                                  _mm256_andnot_si256(cmp, ret2));
+    return ret;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i darken_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = darken_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                 SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = darken_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                 SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = darken_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                 SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i lighten_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                        const __m256i& sa, const __m256i& da) {
+    __m256i sd = _mm256_mullo_epi16(sc, da);
+    __m256i ds = _mm256_mullo_epi16(dc, sa);
+
+    __m256i cmp = _mm256_cmpgt_epi32(sd, ds);
+
+    __m256i tmp = _mm256_add_epi32(sc, dc);
+    __m256i ret1 = _mm256_sub_epi32(tmp, SkDiv255Round_AVX2(ds));
+    __m256i ret2 = _mm256_sub_epi32(tmp, SkDiv255Round_AVX2(sd));
+    __m256i ret = _mm256_or_si256(_mm256_and_si256(cmp, ret1),
+                                  _mm256_andnot_si256(cmp, ret2));
+    return ret;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i lighten_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = lighten_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                  SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = lighten_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                  SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = lighten_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                  SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i colordodge_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                           const __m256i& sa, const __m256i& da) {
+    __m256i diff = _mm256_sub_epi32(sa, sc);
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+
+    // if (0 == dc)
+    __m256i cmp1 = _mm256_cmpeq_epi32(dc, _mm256_setzero_si256());
+    __m256i rc1 = _mm256_and_si256(cmp1, SkAlphaMulAlpha_AVX2(sc, ida));
+
+    // else if (0 == diff)
+    __m256i cmp2 = _mm256_cmpeq_epi32(diff, _mm256_setzero_si256());
+    __m256i cmp = _mm256_andnot_si256(cmp1, cmp2);
+    __m256i tmp1 = _mm256_mullo_epi16(sa, da);
+    __m256i tmp2 = _mm256_mullo_epi16(sc, ida);
+    __m256i tmp3 = _mm256_mullo_epi16(dc, isa);
+    __m256i rc2 = _mm256_add_epi32(tmp1, tmp2);
+    rc2 = _mm256_add_epi32(rc2, tmp3);
+    rc2 = clamp_div255round_AVX2(rc2);
+    rc2 = _mm256_and_si256(cmp, rc2);
+
+    // else
+    __m256i cmp3 = _mm256_or_si256(cmp1, cmp2);
+    __m256i value = _mm256_mullo_epi16(dc, sa);
+    diff = shim_mm256_div_epi32(value, diff);
+
+    __m256i tmp4 = _mm256_min_epi32(da, diff);
+    tmp4 = _mm256_mullo_epi32(sa, tmp4);
+    __m256i rc3 = _mm256_add_epi32(tmp4, tmp2);
+    rc3 = _mm256_add_epi32(rc3, tmp3);
+    rc3 = clamp_div255round_AVX2(rc3);
+    rc3 = _mm256_andnot_si256(cmp3, rc3);
+
+    __m256i rc = _mm256_or_si256(rc1, rc2);
+    rc = _mm256_or_si256(rc, rc3);
+
+    return rc;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i colordodge_modeproc_AVX2(const __m256i& src,
+                                        const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = colordodge_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                     SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = colordodge_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                     SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = colordodge_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                     SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i colorburn_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                          const __m256i& sa, const __m256i& da) {
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+
+    // if (dc == da)
+    __m256i cmp1 = _mm256_cmpeq_epi32(dc, da);
+    __m256i tmp1 = _mm256_mullo_epi16(sa, da);
+    __m256i tmp2 = _mm256_mullo_epi16(sc, ida);
+    __m256i tmp3 = _mm256_mullo_epi16(dc, isa);
+    __m256i rc1 = _mm256_add_epi32(tmp1, tmp2);
+    rc1 = _mm256_add_epi32(rc1, tmp3);
+    rc1 = clamp_div255round_AVX2(rc1);
+    rc1 = _mm256_and_si256(cmp1, rc1);
+
+    // else if (0 == sc)
+    __m256i cmp2 = _mm256_cmpeq_epi32(sc, _mm256_setzero_si256());
+    __m256i rc2 = SkAlphaMulAlpha_AVX2(dc, isa);
+    __m256i cmp = _mm256_andnot_si256(cmp1, cmp2);
+    rc2 = _mm256_and_si256(cmp, rc2);
+
+    // else
+    __m256i cmp3 = _mm256_or_si256(cmp1, cmp2);
+    __m256i tmp4 = _mm256_sub_epi32(da, dc);
+    tmp4 = _mm256_mullo_epi32(tmp4, sa);
+    tmp4 = shim_mm256_div_epi32(tmp4, sc);
+
+    __m256i tmp5 = _mm256_sub_epi32(da, _mm256_min_epi32(da, tmp4));
+    tmp5 = _mm256_mullo_epi32(sa, tmp5);
+    __m256i rc3 = _mm256_add_epi32(tmp5, tmp2);
+    rc3 = _mm256_add_epi32(rc3, tmp3);
+    rc3 = clamp_div255round_AVX2(rc3);
+    rc3 = _mm256_andnot_si256(cmp3, rc3);
+
+    __m256i rc = _mm256_or_si256(rc1, rc2);
+    rc = _mm256_or_si256(rc, rc3);
+
+    return rc;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i colorburn_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = colorburn_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                    SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = colorburn_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                    SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = colorburn_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                    SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i hardlight_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                          const __m256i& sa, const __m256i& da) {
+    // if (2 * sc <= sa)
+    __m256i tmp1 = _mm256_slli_epi32(sc, 1);
+    __m256i cmp1 = _mm256_cmpgt_epi32(tmp1, sa);
+    __m256i rc1 = _mm256_mullo_epi16(sc, dc); // sc * dc;
+    rc1 = _mm256_slli_epi32(rc1, 1);          // 2 * sc * dc
+    rc1 = _mm256_andnot_si256(cmp1, rc1);
+
+    // else
+    tmp1 = _mm256_mullo_epi16(sa, da);
+    __m256i tmp2 = _mm256_mullo_epi32(_mm256_sub_epi32(da, dc),
+                                      _mm256_sub_epi32(sa, sc));
+    tmp2 = _mm256_slli_epi32(tmp2, 1);
+    __m256i rc2 = _mm256_sub_epi32(tmp1, tmp2);
+    rc2 = _mm256_and_si256(cmp1, rc2);
+
+    __m256i rc = _mm256_or_si256(rc1, rc2);
+
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+    tmp1 = _mm256_mullo_epi16(sc, ida);
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+    tmp2 = _mm256_mullo_epi16(dc, isa);
+    rc = _mm256_add_epi32(rc, tmp1);
+    rc = _mm256_add_epi32(rc, tmp2);
+    return clamp_div255round_AVX2(rc);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i hardlight_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = hardlight_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                    SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = hardlight_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                    SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = hardlight_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                    SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i sqrt_unit_byte_AVX2(const __m256i& n) {
+    return SkSqrtBits_AVX2(n, 15+4);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i softlight_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                          const __m256i& sa, const __m256i& da) {
+    __m256i tmp1, tmp2, tmp3;
+
+    // int m = da ? dc * 256 / da : 0;
+    __m256i cmp = _mm256_cmpeq_epi32(da, _mm256_setzero_si256());
+    __m256i m = _mm256_slli_epi32(dc, 8);
+    __m256 x = _mm256_cvtepi32_ps(m);
+    __m256 y = _mm256_cvtepi32_ps(da);
+    m = _mm256_cvttps_epi32(_mm256_div_ps(x, y));
+    m = _mm256_andnot_si256(cmp, m);
+
+    // if (2 * sc <= sa)
+    tmp1 = _mm256_slli_epi32(sc, 1);                         // 2 * sc
+    __m256i cmp1 = _mm256_cmpgt_epi32(tmp1, sa);
+    tmp1 = _mm256_sub_epi32(tmp1, sa);                       // 2 * sc - sa
+    tmp2 = _mm256_sub_epi32(_mm256_set1_epi32(256), m);      // 256 - m
+    tmp1 = _mm256_mullo_epi32(tmp1, tmp2);
+    tmp1 = _mm256_srai_epi32(tmp1, 8);
+    tmp1 = _mm256_add_epi32(sa, tmp1);
+    tmp1 = _mm256_mullo_epi32(dc, tmp1);
+    __m256i rc1 = _mm256_andnot_si256(cmp1, tmp1);
+
+    // else if (4 * dc <= da)
+    tmp2 = _mm256_slli_epi32(dc, 2);                         // dc * 4
+    __m256i cmp2 = _mm256_cmpgt_epi32(tmp2, da);
+    __m256i i = _mm256_slli_epi32(m, 2);                     // 4 * m
+    __m256i j = _mm256_add_epi32(i, _mm256_set1_epi32(256)); // 4 * m + 256
+    __m256i k = _mm256_mullo_epi32(i, j);                    // 4 * m * (4 * m + 256)
+    __m256i t = _mm256_sub_epi32(m, _mm256_set1_epi32(256)); // m - 256
+    i = _mm256_mullo_epi32(k, t);                            // 4 * m * (4 * m + 256) * (m - 256)
+    i = _mm256_srai_epi32(i, 16);                            // >> 16
+    j = _mm256_mullo_epi32(_mm256_set1_epi32(7), m);         // 7 * m
+    tmp2 = _mm256_add_epi32(i, j);
+    i = _mm256_mullo_epi32(dc, sa);                          // dc * sa
+    j = _mm256_slli_epi32(sc, 1);                            // 2 * sc
+    j = _mm256_sub_epi32(j, sa);                             // 2 * sc - sa
+    j = _mm256_mullo_epi32(da, j);                           // da * (2 * sc - sa)
+    tmp2 = _mm256_mullo_epi32(j, tmp2);                      // * tmp
+    tmp2 = _mm256_srai_epi32(tmp2, 8);                       // >> 8
+    tmp2 = _mm256_add_epi32(i, tmp2);
+    cmp = _mm256_andnot_si256(cmp2, cmp1);
+    __m256i rc2 = _mm256_and_si256(cmp, tmp2);
+    __m256i rc = _mm256_or_si256(rc1, rc2);
+
+    // else
+    tmp3 = sqrt_unit_byte_AVX2(m);
+    tmp3 = _mm256_sub_epi32(tmp3, m);
+    tmp3 = _mm256_mullo_epi32(j, tmp3);                      // j = da * (2 * sc - sa)
+    tmp3 = _mm256_srai_epi32(tmp3, 8);
+    tmp3 = _mm256_add_epi32(i, tmp3);                        // i = dc * sa
+    cmp = _mm256_and_si256(cmp1, cmp2);
+    __m256i rc3 = _mm256_and_si256(cmp, tmp3);
+    rc = _mm256_or_si256(rc, rc3);
+
+    tmp1 = _mm256_sub_epi32(_mm256_set1_epi32(255), da);     // 255 - da
+    tmp1 = _mm256_mullo_epi16(sc, tmp1);
+    tmp2 = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);     // 255 - sa
+    tmp2 = _mm256_mullo_epi16(dc, tmp2);
+    rc = _mm256_add_epi32(rc, tmp1);
+    rc = _mm256_add_epi32(rc, tmp2);
+    return clamp_div255round_AVX2(rc);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i softlight_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = softlight_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                    SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = softlight_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                    SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = softlight_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                    SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i difference_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                           const __m256i& sa, const __m256i& da) {
+    __m256i tmp1 = _mm256_mullo_epi16(sc, da);
+    __m256i tmp2 = _mm256_mullo_epi16(dc, sa);
+    __m256i tmp = _mm256_min_epi32(tmp1, tmp2);
+
+    __m256i ret1 = _mm256_add_epi32(sc, dc);
+    __m256i ret2 = _mm256_slli_epi32(SkDiv255Round_AVX2(tmp), 1);
+    __m256i ret = _mm256_sub_epi32(ret1, ret2);
+
+    ret = clamp_signed_byte_AVX2(ret);
+    return ret;
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i difference_modeproc_AVX2(const __m256i& src,
+                                        const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = difference_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                     SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = difference_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                     SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = difference_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                     SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static inline __m256i exclusion_byte_AVX2(const __m256i& sc, const __m256i& dc,
+                                          const __m256i&, __m256i&) {
+    __m256i tmp1 = _mm256_mullo_epi16(_mm256_set1_epi32(255), sc); // 255 * sc
+    __m256i tmp2 = _mm256_mullo_epi16(_mm256_set1_epi32(255), dc); // 255 * dc
+    tmp1 = _mm256_add_epi32(tmp1, tmp2);
+    tmp2 = _mm256_mullo_epi16(sc, dc);                             // sc * dc
+    tmp2 = _mm256_slli_epi32(tmp2, 1);                             // 2 * sc * dc
+
+    __m256i r = _mm256_sub_epi32(tmp1, tmp2);
+    return clamp_div255round_AVX2(r);
+}
+
+SK_ATTRIBUTE_TARGET_AVX2
+static __m256i exclusion_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+
+    __m256i a = srcover_byte_AVX2(sa, da);
+    __m256i r = exclusion_byte_AVX2(SkGetPackedR32_AVX2(src),
+                                    SkGetPackedR32_AVX2(dst), sa, da);
+    __m256i g = exclusion_byte_AVX2(SkGetPackedG32_AVX2(src),
+                                    SkGetPackedG32_AVX2(dst), sa, da);
+    __m256i b = exclusion_byte_AVX2(SkGetPackedB32_AVX2(src),
+                                    SkGetPackedB32_AVX2(dst), sa, da);
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef __m256i (*SkXfermodeProcAVX2)(const __m256i& src, const __m256i& dst);
+
+// Blends with proc up to the first 32 byte aligned dst, then 8 pixels at a time with procAVX2.
+// Returns how many pixels it blended, leaving fewer than 8.
+SK_ATTRIBUTE_TARGET_AVX2
+static int xfer32_AVX2(SkXfermodeProc proc, SkXfermodeProcAVX2 procAVX2,
+                       SkPMColor dst[], const SkPMColor src[], int count) {
+    if (count < 8) {
+        return 0;
+    }
+
+    int done = 0;
+    while (((size_t)dst & 0x1F) != 0) {
+        *dst = proc(*src, *dst);
+        dst++;
+        src++;
+        done++;
+    }
+
+    const __m256i* s = reinterpret_cast<const __m256i*>(src);
+    __m256i* d = reinterpret_cast<__m256i*>(dst);
+
+    while (count - done >= 8) {
+        __m256i src_pixel = _mm256_loadu_si256(s++);
+        __m256i dst_pixel = _mm256_load_si256(d);
+
+        dst_pixel = procAVX2(src_pixel, dst_pixel);
+        _mm256_store_si256(d++, dst_pixel);
+        done += 8;
+    }
+    return done;
+}
+
+// Built without AVX2, like everything here not marked SK_ATTRIBUTE_TARGET_AVX2.
+void SkAVX2ProcCoeffXfermode::xfer32(SkPMColor dst[], const SkPMColor src[],
+                                     int count, const SkAlpha aa[]) const {
+    SkASSERT(dst && src && count >= 0);
+
+    if (NULL != aa) {
+        this->INHERITED::xfer32(dst, src, count, aa);
+        return;
+    }
+
+    SkXfermodeProcAVX2 procAVX2 = reinterpret_cast<SkXfermodeProcAVX2>(fProcAVX2);
+    SkASSERT(procAVX2 != NULL);
+    const int done = xfer32_AVX2(this->getProc(), procAVX2, dst, src, count);
+
+    // Finish up the last few pixels 4 at a time with SSE2 if we can.
+    this->INHERITED::xfer32(dst + done, src + done, count - done, NULL);
+}
+
+#ifndef SK_IGNORE_TO_STRING
+void SkAVX2ProcCoeffXfermode::toString(SkString* str) const {
+    this->INHERITED::toString(str);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+// 8 pixels modeprocs with AVX2
+static const SkXfermodeProcAVX2 gAVX2XfermodeProcs[] = {
+    NULL, // kClear_Mode
+    NULL, // kSrc_Mode
+    NULL, // kDst_Mode
+    srcover_modeproc_AVX2,
+    dstover_modeproc_AVX2,
+    srcin_modeproc_AVX2,
+    dstin_modeproc_AVX2,
+    srcout_modeproc_AVX2,
+    dstout_modeproc_AVX2,
+    srcatop_modeproc_AVX2,
+    dstatop_modeproc_AVX2,
+    xor_modeproc_AVX2,
+    plus_modeproc_AVX2,
+    modulate_modeproc_AVX2,
+    screen_modeproc_AVX2,
+
+    overlay_modeproc_AVX2,
+    darken_modeproc_AVX2,
+    lighten_modeproc_AVX2,
+    colordodge_modeproc_AVX2,
+    colorburn_modeproc_AVX2,
+    hardlight_modeproc_AVX2,
+    softlight_modeproc_AVX2,
+    difference_modeproc_AVX2,
+    exclusion_modeproc_AVX2,
+    multiply_modeproc_AVX2,
+
+    NULL, // kHue_Mode
+    NULL, // kSaturation_Mode
+    NULL, // kColor_Mode
+    NULL, // kLuminosity_Mode
+};
+
+SkProcCoeffXfermode* SkPlatformXfermodeFactory_impl_AVX2(const ProcCoeff& rec,
+                                                         SkXfermode::Mode mode) {
+    SK_COMPILE_ASSERT(SK_ARRAY_COUNT(gAVX2XfermodeProcs) == SkXfermode::kLastMode + 1,
+                      mode_count_arg);
+
+    void* procAVX2 = reinterpret_cast<void*>(gAVX2XfermodeProcs[mode]);
+    void* procSSE2 = SkSSE2XfermodeProc(mode);
+
+    if (procAVX2 != NULL && procSSE2 != NULL) {
+        return SkNEW_ARGS(SkAVX2ProcCoeffXfermode, (rec, mode, procSSE2, procAVX2));
+    }
+    return NULL;
+}
+
+#else // !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK) || SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+SkProcCoeffXfermode* SkPlatformXfermodeFactory_impl_AVX2(const ProcCoeff& rec,
+                                                         SkXfermode::Mode mode) {
+    return NULL;
+}
+
+#endif
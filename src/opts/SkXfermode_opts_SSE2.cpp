@@ -635,6 +635,167 @@ static __m128i exclusion_modeproc_SSE2(const __m128i& src, const __m128i& dst) {
     return SkPackARGB32_SSE2(a, r, g, b);
 }
 
+// The non-separable modes.  The portable versions, which these match exactly, are in
+// SkXfermode.cpp.  Where those branch on a pixel we compute both sides and pick per lane.
+
+static inline __m128i select_SSE2(const __m128i& cmp, const __m128i& a, const __m128i& b) {
+    return _mm_or_si128(_mm_and_si128(cmp, a), _mm_andnot_si128(cmp, b));
+}
+
+static inline __m128i SkMax32_SSE2(const __m128i& a, const __m128i& b) {
+    return select_SSE2(_mm_cmpgt_epi32(a, b), a, b);
+}
+
+static inline __m128i Lum_SSE2(const __m128i& r, const __m128i& g, const __m128i& b) {
+    __m128i sum = _mm_add_epi32(Multiply32_SSE2(r, _mm_set1_epi32(77)),
+                                Multiply32_SSE2(g, _mm_set1_epi32(150)));
+    sum = _mm_add_epi32(sum, Multiply32_SSE2(b, _mm_set1_epi32(28)));
+    return SkDiv255Round_SSE2(sum);
+}
+
+static inline __m128i Sat_SSE2(const __m128i& r, const __m128i& g, const __m128i& b) {
+    return _mm_sub_epi32(SkMax32_SSE2(SkMax32_SSE2(r, g), b),
+                         SkMin32_SSE2(SkMin32_SSE2(r, g), b));
+}
+
+// Each component is scaled by s / Sat(r, g, b) after taking off the smallest, which is the same
+// as what SetSat() does to the smallest, middle and largest components, ties included.
+static inline void SetSat_SSE2(__m128i* r, __m128i* g, __m128i* b, const __m128i& s) {
+    __m128i mn = SkMin32_SSE2(SkMin32_SSE2(*r, *g), *b);
+    __m128i mx = SkMax32_SSE2(SkMax32_SSE2(*r, *g), *b);
+    __m128i sat = _mm_sub_epi32(mx, mn);  // SkMulDiv_SSE2 gives 0 where this is 0.
+
+    *r = SkMulDiv_SSE2(_mm_sub_epi32(*r, mn), s, sat);
+    *g = SkMulDiv_SSE2(_mm_sub_epi32(*g, mn), s, sat);
+    *b = SkMulDiv_SSE2(_mm_sub_epi32(*b, mn), s, sat);
+}
+
+static inline void clipColor_SSE2(__m128i* r, __m128i* g, __m128i* b, const __m128i& a) {
+    __m128i L = Lum_SSE2(*r, *g, *b);
+    __m128i n = SkMin32_SSE2(SkMin32_SSE2(*r, *g), *b);
+    __m128i x = SkMax32_SSE2(SkMax32_SSE2(*r, *g), *b);
+
+    // if (n < 0 && L - n != 0)
+    __m128i denom = _mm_sub_epi32(L, n);
+    __m128i cmp = _mm_andnot_si128(_mm_cmpeq_epi32(denom, _mm_setzero_si128()),
+                                   _mm_cmplt_epi32(n, _mm_setzero_si128()));
+    *r = select_SSE2(cmp, _mm_add_epi32(L, SkMulDiv_SSE2(_mm_sub_epi32(*r, L), L, denom)), *r);
+    *g = select_SSE2(cmp, _mm_add_epi32(L, SkMulDiv_SSE2(_mm_sub_epi32(*g, L), L, denom)), *g);
+    *b = select_SSE2(cmp, _mm_add_epi32(L, SkMulDiv_SSE2(_mm_sub_epi32(*b, L), L, denom)), *b);
+
+    // if (x > a && x - L != 0)
+    denom = _mm_sub_epi32(x, L);
+    cmp = _mm_andnot_si128(_mm_cmpeq_epi32(denom, _mm_setzero_si128()),
+                           _mm_cmpgt_epi32(x, a));
+    __m128i numer = _mm_sub_epi32(a, L);
+    *r = select_SSE2(cmp, _mm_add_epi32(L, SkMulDiv_SSE2(_mm_sub_epi32(*r, L), numer, denom)), *r);
+    *g = select_SSE2(cmp, _mm_add_epi32(L, SkMulDiv_SSE2(_mm_sub_epi32(*g, L), numer, denom)), *g);
+    *b = select_SSE2(cmp, _mm_add_epi32(L, SkMulDiv_SSE2(_mm_sub_epi32(*b, L), numer, denom)), *b);
+}
+
+static inline void SetLum_SSE2(__m128i* r, __m128i* g, __m128i* b,
+                               const __m128i& a, const __m128i& l) {
+    __m128i d = _mm_sub_epi32(l, Lum_SSE2(*r, *g, *b));
+    *r = _mm_add_epi32(*r, d);
+    *g = _mm_add_epi32(*g, d);
+    *b = _mm_add_epi32(*b, d);
+
+    clipColor_SSE2(r, g, b, a);
+}
+
+static inline __m128i blendfunc_nonsep_byte_SSE2(const __m128i& sc, const __m128i& dc,
+                                                 const __m128i& sa, const __m128i& da,
+                                                 const __m128i& blendval) {
+    __m128i tmp1 = _mm_mullo_epi16(sc, _mm_sub_epi32(_mm_set1_epi32(255), da));
+    __m128i tmp2 = _mm_mullo_epi16(dc, _mm_sub_epi32(_mm_set1_epi32(255), sa));
+    return clamp_div255round_SSE2(_mm_add_epi32(_mm_add_epi32(tmp1, tmp2), blendval));
+}
+
+// Blends src and dst given their blended (premultiplied by sa * da) color, which only counts
+// where both sa and da are non-zero.
+static inline __m128i nonsep_modeproc_SSE2(const __m128i& src, const __m128i& dst,
+                                           __m128i Br, __m128i Bg, __m128i Bb) {
+    __m128i sa = SkGetPackedA32_SSE2(src);
+    __m128i da = SkGetPackedA32_SSE2(dst);
+
+    __m128i cmp = _mm_or_si128(_mm_cmpeq_epi32(sa, _mm_setzero_si128()),
+                               _mm_cmpeq_epi32(da, _mm_setzero_si128()));
+    Br = _mm_andnot_si128(cmp, Br);
+    Bg = _mm_andnot_si128(cmp, Bg);
+    Bb = _mm_andnot_si128(cmp, Bb);
+
+    __m128i a = srcover_byte_SSE2(sa, da);
+    __m128i r = blendfunc_nonsep_byte_SSE2(SkGetPackedR32_SSE2(src), SkGetPackedR32_SSE2(dst),
+                                           sa, da, Br);
+    __m128i g = blendfunc_nonsep_byte_SSE2(SkGetPackedG32_SSE2(src), SkGetPackedG32_SSE2(dst),
+                                           sa, da, Bg);
+    __m128i b = blendfunc_nonsep_byte_SSE2(SkGetPackedB32_SSE2(src), SkGetPackedB32_SSE2(dst),
+                                           sa, da, Bb);
+    return SkPackARGB32_SSE2(a, r, g, b);
+}
+
+static __m128i hue_modeproc_SSE2(const __m128i& src, const __m128i& dst) {
+    __m128i sa = SkGetPackedA32_SSE2(src);
+    __m128i da = SkGetPackedA32_SSE2(dst);
+    __m128i dr = SkGetPackedR32_SSE2(dst);
+    __m128i dg = SkGetPackedG32_SSE2(dst);
+    __m128i db = SkGetPackedB32_SSE2(dst);
+
+    __m128i Sr = _mm_mullo_epi16(SkGetPackedR32_SSE2(src), sa);
+    __m128i Sg = _mm_mullo_epi16(SkGetPackedG32_SSE2(src), sa);
+    __m128i Sb = _mm_mullo_epi16(SkGetPackedB32_SSE2(src), sa);
+    SetSat_SSE2(&Sr, &Sg, &Sb, _mm_mullo_epi16(Sat_SSE2(dr, dg, db), sa));
+    SetLum_SSE2(&Sr, &Sg, &Sb, _mm_mullo_epi16(sa, da), Multiply32_SSE2(Lum_SSE2(dr, dg, db), sa));
+
+    return nonsep_modeproc_SSE2(src, dst, Sr, Sg, Sb);
+}
+
+static __m128i saturation_modeproc_SSE2(const __m128i& src, const __m128i& dst) {
+    __m128i sa = SkGetPackedA32_SSE2(src);
+    __m128i da = SkGetPackedA32_SSE2(dst);
+    __m128i dr = SkGetPackedR32_SSE2(dst);
+    __m128i dg = SkGetPackedG32_SSE2(dst);
+    __m128i db = SkGetPackedB32_SSE2(dst);
+    __m128i sat = Sat_SSE2(SkGetPackedR32_SSE2(src), SkGetPackedG32_SSE2(src),
+                           SkGetPackedB32_SSE2(src));
+
+    __m128i Dr = _mm_mullo_epi16(dr, sa);
+    __m128i Dg = _mm_mullo_epi16(dg, sa);
+    __m128i Db = _mm_mullo_epi16(db, sa);
+    SetSat_SSE2(&Dr, &Dg, &Db, _mm_mullo_epi16(sat, da));
+    SetLum_SSE2(&Dr, &Dg, &Db, _mm_mullo_epi16(sa, da), Multiply32_SSE2(Lum_SSE2(dr, dg, db), sa));
+
+    return nonsep_modeproc_SSE2(src, dst, Dr, Dg, Db);
+}
+
+static __m128i color_modeproc_SSE2(const __m128i& src, const __m128i& dst) {
+    __m128i sa = SkGetPackedA32_SSE2(src);
+    __m128i da = SkGetPackedA32_SSE2(dst);
+    __m128i lum = Lum_SSE2(SkGetPackedR32_SSE2(dst), SkGetPackedG32_SSE2(dst),
+                           SkGetPackedB32_SSE2(dst));
+
+    __m128i Sr = _mm_mullo_epi16(SkGetPackedR32_SSE2(src), da);
+    __m128i Sg = _mm_mullo_epi16(SkGetPackedG32_SSE2(src), da);
+    __m128i Sb = _mm_mullo_epi16(SkGetPackedB32_SSE2(src), da);
+    SetLum_SSE2(&Sr, &Sg, &Sb, _mm_mullo_epi16(sa, da), Multiply32_SSE2(lum, sa));
+
+    return nonsep_modeproc_SSE2(src, dst, Sr, Sg, Sb);
+}
+
+static __m128i luminosity_modeproc_SSE2(const __m128i& src, const __m128i& dst) {
+    __m128i sa = SkGetPackedA32_SSE2(src);
+    __m128i da = SkGetPackedA32_SSE2(dst);
+    __m128i lum = Lum_SSE2(SkGetPackedR32_SSE2(src), SkGetPackedG32_SSE2(src),
+                           SkGetPackedB32_SSE2(src));
+
+    __m128i Dr = _mm_mullo_epi16(SkGetPackedR32_SSE2(dst), sa);
+    __m128i Dg = _mm_mullo_epi16(SkGetPackedG32_SSE2(dst), sa);
+    __m128i Db = _mm_mullo_epi16(SkGetPackedB32_SSE2(dst), sa);
+    SetLum_SSE2(&Dr, &Dg, &Db, _mm_mullo_epi16(sa, da), Multiply32_SSE2(lum, da));
+
+    return nonsep_modeproc_SSE2(src, dst, Dr, Dg, Db);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 typedef __m128i (*SkXfermodeProcSIMD)(const __m128i& src, const __m128i& dst);
@@ -802,15 +963,19 @@ SkXfermodeProcSIMD gSSE2XfermodeProcs[] = {
     exclusion_modeproc_SSE2,
     multiply_modeproc_SSE2,
 
-    NULL, // kHue_Mode
-    NULL, // kSaturation_Mode
-    NULL, // kColor_Mode
-    NULL, // kLuminosity_Mode
+    hue_modeproc_SSE2,
+    saturation_modeproc_SSE2,
+    color_modeproc_SSE2,
+    luminosity_modeproc_SSE2,
 };
 
+void* SkSSE2XfermodeProc(SkXfermode::Mode mode) {
+    return reinterpret_cast<void*>(gSSE2XfermodeProcs[mode]);
+}
+
 SkProcCoeffXfermode* SkPlatformXfermodeFactory_impl_SSE2(const ProcCoeff& rec,
                                                          SkXfermode::Mode mode) {
-    void* procSIMD = reinterpret_cast<void*>(gSSE2XfermodeProcs[mode]);
+    void* procSIMD = SkSSE2XfermodeProc(mode);
 
     if (procSIMD != NULL) {
         return SkNEW_ARGS(SkSSE2ProcCoeffXfermode, (rec, mode, procSIMD));
@@ -35,4 +35,7 @@ private:
 SkProcCoeffXfermode* SkPlatformXfermodeFactory_impl_SSE2(const ProcCoeff& rec,
                                                          SkXfermode::Mode mode);
 
+// Returns the SSE2 proc for mode (to pass as procSIMD above), or NULL if there isn't one.
+void* SkSSE2XfermodeProc(SkXfermode::Mode mode);
+
 #endif // SkXfermode_opts_SSE2_DEFINED
@@ -105,6 +105,83 @@ static inline uint8x8_t clamp_div255round_simd8_32(int32x4_t val1, int32x4_t val
     return ret;
 }
 
+// Widens 8 channel values to two vectors of 4 ints, for the modes that need
+// more than 16 bits per channel.
+static inline void widen_neon8_32(uint8x8_t x, int32x4_t* lo, int32x4_t* hi) {
+    uint16x8_t tmp = vmovl_u8(x);
+
+    *lo = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(tmp)));
+#ifdef SK_CPU_ARM64
+    *hi = vreinterpretq_s32_u32(vmovl_high_u16(tmp));
+#else
+    *hi = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(tmp)));
+#endif
+}
+
+static inline int32x4_t SkDiv255Round_neon4_32(int32x4_t prod) {
+    uint32x4_t tmp = vreinterpretq_u32_s32(prod);
+
+    tmp += vdupq_n_u32(128);
+    tmp += vshrq_n_u32(tmp, 8);
+
+    return vreinterpretq_s32_u32(vshrq_n_u32(tmp, 8));
+}
+
+// Portable version of SkMulDiv is in SkMath.h.
+// There is no integer (or, on ARMv7, float) division, so the quotient of the
+// magnitudes is estimated with a refined reciprocal and then fixed up with the
+// exact remainder. The estimate is within 1 as long as the quotient stays below
+// 2^20, which is plenty for the blend modes. Lanes where c is 0 come out as 0.
+static inline int32x4_t SkMulDiv_neon4_32(int32x4_t a, int32x4_t b, int32x4_t c) {
+    uint32x4_t zero = vceqq_s32(c, vdupq_n_s32(0));
+    int32x4_t sign = vshrq_n_s32(veorq_s32(veorq_s32(a, b), c), 31);
+
+    uint32x4_t ua = vreinterpretq_u32_s32(vabsq_s32(a));
+    uint32x4_t ub = vreinterpretq_u32_s32(vabsq_s32(b));
+    uint32x4_t uc = vreinterpretq_u32_s32(vabsq_s32(c));
+    uc = vorrq_u32(uc, vandq_u32(zero, vdupq_n_u32(1)));
+
+    float32x4_t fc = vcvtq_f32_u32(uc);
+    float32x4_t recip = vrecpeq_f32(fc);
+    recip = vmulq_f32(vrecpsq_f32(fc, recip), recip);
+    recip = vmulq_f32(vrecpsq_f32(fc, recip), recip);
+    uint32x4_t q = vcvtq_u32_f32(vmulq_f32(vmulq_f32(vcvtq_f32_u32(ua),
+                                                     vcvtq_f32_u32(ub)),
+                                           recip));
+
+    // The remainder is small, so its low 32 bits are all we need.
+    int32x4_t rem = vreinterpretq_s32_u32(vmlsq_u32(vmulq_u32(ua, ub), q, uc));
+    uint32x4_t under = vcltq_s32(rem, vdupq_n_s32(0));
+    q = vaddq_u32(q, under);  // q - 1 where true
+    rem = vaddq_s32(rem, vreinterpretq_s32_u32(vandq_u32(under, uc)));
+    uint32x4_t over = vcgeq_s32(rem, vreinterpretq_s32_u32(uc));
+    q = vsubq_u32(q, over);   // q + 1 where true
+
+    int32x4_t ret = vsubq_s32(veorq_s32(vreinterpretq_s32_u32(q), sign), sign);
+    return vbicq_s32(ret, vreinterpretq_s32_u32(zero));
+}
+
+// Portable version of SkSqrtBits is in SkMath.cpp.
+static inline int32x4_t SkSqrtBits_neon4_32(int32x4_t x, int count) {
+    uint32x4_t root = vdupq_n_u32(0);
+    uint32x4_t remHi = vdupq_n_u32(0);
+    uint32x4_t remLo = vreinterpretq_u32_s32(x);
+
+    do {
+        root = vshlq_n_u32(root, 1);
+
+        remHi = vorrq_u32(vshlq_n_u32(remHi, 2), vshrq_n_u32(remLo, 30));
+        remLo = vshlq_n_u32(remLo, 2);
+
+        uint32x4_t testDiv = vaddq_u32(vshlq_n_u32(root, 1), vdupq_n_u32(1));
+        uint32x4_t cmp = vcgeq_u32(remHi, testDiv);
+        remHi = vbslq_u32(cmp, vsubq_u32(remHi, testDiv), remHi);
+        root = vsubq_u32(root, cmp);  // root + 1 where true
+    } while (--count >= 0);
+
+    return vreinterpretq_s32_u32(root);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // 1 pixel modeprocs
 ////////////////////////////////////////////////////////////////////////////////
@@ -611,6 +688,66 @@ uint8x8x4_t hardlight_modeproc_neon8(uint8x8x4_t src, uint8x8x4_t dst) {
     return ret;
 }
 
+static inline int32x4_t softlight_byte_neon4(int32x4_t sc, int32x4_t dc,
+                                             int32x4_t sa, int32x4_t da) {
+    int32x4_t m, tmp, rc1, rc2, rc3;
+    uint32x4_t cmp1, cmp2;
+
+    // int m = da ? dc * 256 / da : 0;
+    m = SkMulDiv_neon4_32(dc, vdupq_n_s32(256), da);
+
+    int32x4_t sc2_sa = vshlq_n_s32(sc, 1) - sa;         // 2 * sc - sa
+    int32x4_t dcsa = dc * sa;
+    int32x4_t dasc2_sa = da * sc2_sa;                   // da * (2 * sc - sa)
+
+    // if (2 * sc <= sa)
+    cmp1 = vcleq_s32(vshlq_n_s32(sc, 1), sa);
+    tmp = vshrq_n_s32(sc2_sa * (vdupq_n_s32(256) - m), 8);
+    rc1 = dc * (sa + tmp);
+
+    // else if (4 * dc <= da)
+    cmp2 = vcleq_s32(vshlq_n_s32(dc, 2), da);
+    int32x4_t m4 = vshlq_n_s32(m, 2);                   // 4 * m
+    tmp = m4 * (m4 + vdupq_n_s32(256)) * (m - vdupq_n_s32(256));
+    tmp = vshrq_n_s32(tmp, 16) + m * vdupq_n_s32(7);
+    rc2 = dcsa + vshrq_n_s32(dasc2_sa * tmp, 8);
+
+    // else
+    tmp = SkSqrtBits_neon4_32(m, 15+4) - m;
+    rc3 = dcsa + vshrq_n_s32(dasc2_sa * tmp, 8);
+
+    int32x4_t rc = vbslq_s32(cmp1, rc1, vbslq_s32(cmp2, rc2, rc3));
+
+    return rc + sc * (vdupq_n_s32(255) - da) + dc * (vdupq_n_s32(255) - sa);
+}
+
+static inline uint8x8_t softlight_color(uint8x8_t sc, uint8x8_t dc,
+                                        uint8x8_t sa, uint8x8_t da) {
+    int32x4_t sc1, sc2, dc1, dc2, sa1, sa2, da1, da2;
+
+    widen_neon8_32(sc, &sc1, &sc2);
+    widen_neon8_32(dc, &dc1, &dc2);
+    widen_neon8_32(sa, &sa1, &sa2);
+    widen_neon8_32(da, &da1, &da2);
+
+    return clamp_div255round_simd8_32(softlight_byte_neon4(sc1, dc1, sa1, da1),
+                                      softlight_byte_neon4(sc2, dc2, sa2, da2));
+}
+
+uint8x8x4_t softlight_modeproc_neon8(uint8x8x4_t src, uint8x8x4_t dst) {
+    uint8x8x4_t ret;
+
+    ret.val[NEON_A] = srcover_color(src.val[NEON_A], dst.val[NEON_A]);
+    ret.val[NEON_R] = softlight_color(src.val[NEON_R], dst.val[NEON_R],
+                                      src.val[NEON_A], dst.val[NEON_A]);
+    ret.val[NEON_G] = softlight_color(src.val[NEON_G], dst.val[NEON_G],
+                                      src.val[NEON_A], dst.val[NEON_A]);
+    ret.val[NEON_B] = softlight_color(src.val[NEON_B], dst.val[NEON_B],
+                                      src.val[NEON_A], dst.val[NEON_A]);
+
+    return ret;
+}
+
 static inline uint8x8_t difference_color(uint8x8_t sc, uint8x8_t dc,
                                          uint8x8_t sa, uint8x8_t da) {
     uint16x8_t sd, ds, tmp;
@@ -737,6 +874,183 @@ uint8x8x4_t multiply_modeproc_neon8(uint8x8x4_t src, uint8x8x4_t dst) {
     return ret;
 }
 
+// The non-separable modes work on 4 pixels at a time in 32 bits, and match the
+// portable versions in SkXfermode.cpp exactly. Where those branch on a pixel,
+// both sides are computed and picked per lane.
+
+static inline int32x4_t Lum_neon4(int32x4_t r, int32x4_t g, int32x4_t b) {
+    return SkDiv255Round_neon4_32(r * vdupq_n_s32(77) + g * vdupq_n_s32(150)
+                                  + b * vdupq_n_s32(28));
+}
+
+static inline int32x4_t Sat_neon4(int32x4_t r, int32x4_t g, int32x4_t b) {
+    return vmaxq_s32(vmaxq_s32(r, g), b) - vminq_s32(vminq_s32(r, g), b);
+}
+
+// Each component is scaled by s / Sat(r, g, b) after taking off the smallest,
+// which is what SetSat() does to the smallest, middle and largest components.
+static inline void SetSat_neon4(int32x4_t* r, int32x4_t* g, int32x4_t* b,
+                                int32x4_t s) {
+    int32x4_t mn = vminq_s32(vminq_s32(*r, *g), *b);
+    int32x4_t sat = vmaxq_s32(vmaxq_s32(*r, *g), *b) - mn;
+
+    // SkMulDiv_neon4_32() gives 0 where sat is 0.
+    *r = SkMulDiv_neon4_32(*r - mn, s, sat);
+    *g = SkMulDiv_neon4_32(*g - mn, s, sat);
+    *b = SkMulDiv_neon4_32(*b - mn, s, sat);
+}
+
+static inline void clipColor_neon4(int32x4_t* r, int32x4_t* g, int32x4_t* b,
+                                   int32x4_t a) {
+    int32x4_t L = Lum_neon4(*r, *g, *b);
+    int32x4_t n = vminq_s32(vminq_s32(*r, *g), *b);
+    int32x4_t x = vmaxq_s32(vmaxq_s32(*r, *g), *b);
+    int32x4_t denom, numer;
+    uint32x4_t cmp;
+
+    // if (n < 0 && L - n != 0)
+    denom = L - n;
+    cmp = vcltq_s32(n, vdupq_n_s32(0));
+    cmp = vbicq_u32(cmp, vceqq_s32(denom, vdupq_n_s32(0)));
+    *r = vbslq_s32(cmp, L + SkMulDiv_neon4_32(*r - L, L, denom), *r);
+    *g = vbslq_s32(cmp, L + SkMulDiv_neon4_32(*g - L, L, denom), *g);
+    *b = vbslq_s32(cmp, L + SkMulDiv_neon4_32(*b - L, L, denom), *b);
+
+    // if (x > a && x - L != 0)
+    denom = x - L;
+    numer = a - L;
+    cmp = vcgtq_s32(x, a);
+    cmp = vbicq_u32(cmp, vceqq_s32(denom, vdupq_n_s32(0)));
+    *r = vbslq_s32(cmp, L + SkMulDiv_neon4_32(*r - L, numer, denom), *r);
+    *g = vbslq_s32(cmp, L + SkMulDiv_neon4_32(*g - L, numer, denom), *g);
+    *b = vbslq_s32(cmp, L + SkMulDiv_neon4_32(*b - L, numer, denom), *b);
+}
+
+static inline void SetLum_neon4(int32x4_t* r, int32x4_t* g, int32x4_t* b,
+                                int32x4_t a, int32x4_t l) {
+    int32x4_t d = l - Lum_neon4(*r, *g, *b);
+
+    *r += d;
+    *g += d;
+    *b += d;
+
+    clipColor_neon4(r, g, b, a);
+}
+
+// B(Cb, Cs) = SetLum(SetSat(Cs, Sat(Cb)), Lum(Cb))
+static inline void hue_blend_neon4(const int32x4_t s[4], const int32x4_t d[4],
+                                   int32x4_t B[4]) {
+    int32x4_t sa = s[NEON_A], da = d[NEON_A];
+
+    B[NEON_R] = s[NEON_R] * sa;
+    B[NEON_G] = s[NEON_G] * sa;
+    B[NEON_B] = s[NEON_B] * sa;
+    SetSat_neon4(&B[NEON_R], &B[NEON_G], &B[NEON_B],
+                 Sat_neon4(d[NEON_R], d[NEON_G], d[NEON_B]) * sa);
+    SetLum_neon4(&B[NEON_R], &B[NEON_G], &B[NEON_B], sa * da,
+                 Lum_neon4(d[NEON_R], d[NEON_G], d[NEON_B]) * sa);
+}
+
+// B(Cb, Cs) = SetLum(SetSat(Cb, Sat(Cs)), Lum(Cb))
+static inline void saturation_blend_neon4(const int32x4_t s[4], const int32x4_t d[4],
+                                          int32x4_t B[4]) {
+    int32x4_t sa = s[NEON_A], da = d[NEON_A];
+
+    B[NEON_R] = d[NEON_R] * sa;
+    B[NEON_G] = d[NEON_G] * sa;
+    B[NEON_B] = d[NEON_B] * sa;
+    SetSat_neon4(&B[NEON_R], &B[NEON_G], &B[NEON_B],
+                 Sat_neon4(s[NEON_R], s[NEON_G], s[NEON_B]) * da);
+    SetLum_neon4(&B[NEON_R], &B[NEON_G], &B[NEON_B], sa * da,
+                 Lum_neon4(d[NEON_R], d[NEON_G], d[NEON_B]) * sa);
+}
+
+// B(Cb, Cs) = SetLum(Cs, Lum(Cb))
+static inline void color_blend_neon4(const int32x4_t s[4], const int32x4_t d[4],
+                                     int32x4_t B[4]) {
+    int32x4_t sa = s[NEON_A], da = d[NEON_A];
+
+    B[NEON_R] = s[NEON_R] * da;
+    B[NEON_G] = s[NEON_G] * da;
+    B[NEON_B] = s[NEON_B] * da;
+    SetLum_neon4(&B[NEON_R], &B[NEON_G], &B[NEON_B], sa * da,
+                 Lum_neon4(d[NEON_R], d[NEON_G], d[NEON_B]) * sa);
+}
+
+// B(Cb, Cs) = SetLum(Cb, Lum(Cs))
+static inline void luminosity_blend_neon4(const int32x4_t s[4], const int32x4_t d[4],
+                                          int32x4_t B[4]) {
+    int32x4_t sa = s[NEON_A], da = d[NEON_A];
+
+    B[NEON_R] = d[NEON_R] * sa;
+    B[NEON_G] = d[NEON_G] * sa;
+    B[NEON_B] = d[NEON_B] * sa;
+    SetLum_neon4(&B[NEON_R], &B[NEON_G], &B[NEON_B], sa * da,
+                 Lum_neon4(s[NEON_R], s[NEON_G], s[NEON_B]) * da);
+}
+
+// Returns the unclamped blendfunc_nonsep_byte() of each color channel of 4
+// pixels, with the blended color only counting where both alphas are non-zero.
+typedef void (*NonsepBlendProc)(const int32x4_t s[4], const int32x4_t d[4],
+                                int32x4_t B[4]);
+
+static inline void nonsep_neon4(const int32x4_t s[4], const int32x4_t d[4],
+                                NonsepBlendProc blend, int32x4_t rc[4]) {
+    int32x4_t sa = s[NEON_A], da = d[NEON_A];
+    int32x4_t B[4];
+
+    blend(s, d, B);
+
+    uint32x4_t clear = vorrq_u32(vceqq_s32(sa, vdupq_n_s32(0)),
+                                 vceqq_s32(da, vdupq_n_s32(0)));
+    int32x4_t isa = vdupq_n_s32(255) - sa;
+    int32x4_t ida = vdupq_n_s32(255) - da;
+
+    for (int i = 0; i < 4; i++) {
+        if (i != NEON_A) {
+            rc[i] = s[i] * ida + d[i] * isa
+                    + vbicq_s32(B[i], vreinterpretq_s32_u32(clear));
+        }
+    }
+}
+
+static inline uint8x8x4_t nonsep_modeproc_neon8(uint8x8x4_t src, uint8x8x4_t dst,
+                                                NonsepBlendProc blend) {
+    int32x4_t s1[4], s2[4], d1[4], d2[4], rc1[4], rc2[4];
+    uint8x8x4_t ret;
+
+    for (int i = 0; i < 4; i++) {
+        widen_neon8_32(src.val[i], &s1[i], &s2[i]);
+        widen_neon8_32(dst.val[i], &d1[i], &d2[i]);
+    }
+
+    nonsep_neon4(s1, d1, blend, rc1);
+    nonsep_neon4(s2, d2, blend, rc2);
+
+    ret.val[NEON_A] = srcover_color(src.val[NEON_A], dst.val[NEON_A]);
+    ret.val[NEON_R] = clamp_div255round_simd8_32(rc1[NEON_R], rc2[NEON_R]);
+    ret.val[NEON_G] = clamp_div255round_simd8_32(rc1[NEON_G], rc2[NEON_G]);
+    ret.val[NEON_B] = clamp_div255round_simd8_32(rc1[NEON_B], rc2[NEON_B]);
+
+    return ret;
+}
+
+uint8x8x4_t hue_modeproc_neon8(uint8x8x4_t src, uint8x8x4_t dst) {
+    return nonsep_modeproc_neon8(src, dst, hue_blend_neon4);
+}
+
+uint8x8x4_t saturation_modeproc_neon8(uint8x8x4_t src, uint8x8x4_t dst) {
+    return nonsep_modeproc_neon8(src, dst, saturation_blend_neon4);
+}
+
+uint8x8x4_t color_modeproc_neon8(uint8x8x4_t src, uint8x8x4_t dst) {
+    return nonsep_modeproc_neon8(src, dst, color_blend_neon4);
+}
+
+uint8x8x4_t luminosity_modeproc_neon8(uint8x8x4_t src, uint8x8x4_t dst) {
+    return nonsep_modeproc_neon8(src, dst, luminosity_blend_neon4);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 typedef uint8x8x4_t (*SkXfermodeProcSIMD)(uint8x8x4_t src, uint8x8x4_t dst);
@@ -934,15 +1248,15 @@ SkXfermodeProcSIMD gNEONXfermodeProcs[] = {
     NULL, // kColorDodge_Mode
     NULL, // kColorBurn_Mode
     hardlight_modeproc_neon8,
-    NULL, // kSoftLight_Mode
+    softlight_modeproc_neon8,
     difference_modeproc_neon8,
     exclusion_modeproc_neon8,
     multiply_modeproc_neon8,
 
-    NULL, // kHue_Mode
-    NULL, // kSaturation_Mode
-    NULL, // kColor_Mode
-    NULL, // kLuminosity_Mode
+    hue_modeproc_neon8,
+    saturation_modeproc_neon8,
+    color_modeproc_neon8,
+    luminosity_modeproc_neon8,
 };
 
 SK_COMPILE_ASSERT(
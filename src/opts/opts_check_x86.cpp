@@ -5,25 +5,35 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmapFilter_opts_AVX2.h"
 #include "SkBitmapFilter_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSSE3.h"
 #include "SkBlitMask.h"
 #include "SkBlitRect_opts_SSE2.h"
 #include "SkBlitRow.h"
+#include "SkBlitRow_opts_AVX2.h"
 #include "SkBlitRow_opts_SSE2.h"
 #include "SkBlurImage_opts_SSE2.h"
+#include "SkGradient_opts.h"
+#include "SkGradient_opts_SSE2.h"
+#include "SkMipMap_opts.h"
+#include "SkMipMap_opts_SSE2.h"
 #include "SkMorphology_opts.h"
 #include "SkMorphology_opts_SSE2.h"
 #include "SkRTConf.h"
 #include "SkUtils.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkXfermode.h"
+#include "SkXfermode_opts_AVX2.h"
 #include "SkXfermode_proccoeff.h"
 
-#if defined(_MSC_VER) && defined(_WIN64)
+#if defined(_MSC_VER)
+#include <immintrin.h>  // For _xgetbv().
+#if defined(_WIN64)
 #include <intrin.h>
 #endif
+#endif
 
 /* This file must *not* be compiled with -msse or any other optional SIMD
    extension, otherwise gcc may generate SIMD instructions even for scalar ops
@@ -33,13 +43,15 @@
 
 
 /* Function to get the CPU SSE-level in runtime, for different compilers. */
+/* Leaves with sub-leaves (e.g. 7) are always queried for sub-leaf 0. */
 #ifdef _MSC_VER
 static inline void getcpuid(int info_type, int info[4]) {
 #if defined(_WIN64)
-    __cpuid(info, info_type);
+    __cpuidex(info, info_type, 0);
 #else
     __asm {
         mov    eax, [info_type]
+        xor    ecx, ecx
         cpuid
         mov    edi, [info]
         mov    [edi], eax
@@ -54,7 +66,7 @@ static inline void getcpuid(int info_type, int info[4]) {
     asm volatile (
         "cpuid \n\t"
         : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "c"(0)
     );
 }
 #else
@@ -66,11 +78,27 @@ static inline void getcpuid(int info_type, int info[4]) {
         "movl %%ebx, %1   \n\t"
         "popl %%ebx       \n\t"
         : "=a"(info[0]), "=r"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "c"(0)
     );
 }
 #endif
 
+/* Which register state the OS saves on context switches (XCR0). Only call this if
+ * CPUID says the OS has enabled XSAVE. */
+static inline uint64_t getxcr0() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    asm volatile (
+        ".byte 0x0f, 0x01, 0xd0 \n\t"  // xgetbv, which older assemblers don't know.
+        : "=a"(eax), "=d"(edx)
+        : "c"(0)
+    );
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /* Fetch the SIMD level directly from the CPU, at run-time.
@@ -79,8 +107,22 @@ static inline void getcpuid(int info_type, int info[4]) {
 static int get_SIMD_level() {
     int cpu_info[4] = { 0 };
 
+    getcpuid(0, cpu_info);
+    const int maxLeaf = cpu_info[0];
+
     getcpuid(1, cpu_info);
-    if ((cpu_info[2] & (1<<20)) != 0) {
+    // AVX needs the OS to save the YMM registers (and so the XMM ones) for us, as well as the CPU.
+    const bool osxsave = (cpu_info[2] & (1<<27)) != 0;
+    if (osxsave && (cpu_info[2] & (1<<28)) != 0 && (getxcr0() & 6) == 6) {
+        if (maxLeaf >= 7) {
+            int ext_info[4] = { 0 };
+            getcpuid(7, ext_info);
+            if ((ext_info[1] & (1<<5)) != 0) {
+                return SK_CPU_SSE_LEVEL_AVX2;
+            }
+        }
+        return SK_CPU_SSE_LEVEL_AVX;
+    } else if ((cpu_info[2] & (1<<20)) != 0) {
         return SK_CPU_SSE_LEVEL_SSE42;
     } else if ((cpu_info[2] & (1<<9)) != 0) {
         return SK_CPU_SSE_LEVEL_SSSE3;
@@ -128,6 +170,12 @@ void SkBitmapProcState::platformConvolutionProcs(SkConvolutionProcs* procs) {
         procs->fConvolveHorizontally = &convolveHorizontally_SSE2;
         procs->fApplySIMDPadding = &applySIMDPadding_SSE2;
     }
+    // The AVX2 procs read no further past their rows than the SSE2 ones, and use the same padding.
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        procs->fConvolveVertically = &convolveVertically_AVX2;
+        procs->fConvolve4RowsHorizontally = &convolve4RowsHorizontally_AVX2;
+        procs->fConvolveHorizontally = &convolveHorizontally_AVX2;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -175,6 +223,18 @@ void SkBitmapProcState::platformProcs() {
         fMatrixProc = ClampX_ClampY_filter_affine_SSE2;
     } else if (fMatrixProc == ClampX_ClampY_nofilter_affine) {
         fMatrixProc = ClampX_ClampY_nofilter_affine_SSE2;
+    } else if (fMatrixProc == ClampX_ClampY_filter_persp) {
+        fMatrixProc = ClampX_ClampY_filter_persp_SSE2;
+    } else if (fMatrixProc == ClampX_ClampY_nofilter_persp) {
+        fMatrixProc = ClampX_ClampY_nofilter_persp_SSE2;
+    } else if (fMatrixProc == RepeatX_RepeatY_filter_affine) {
+        fMatrixProc = RepeatX_RepeatY_filter_affine_SSE2;
+    } else if (fMatrixProc == RepeatX_RepeatY_nofilter_affine) {
+        fMatrixProc = RepeatX_RepeatY_nofilter_affine_SSE2;
+    } else if (fMatrixProc == RepeatX_RepeatY_filter_persp) {
+        fMatrixProc = RepeatX_RepeatY_filter_persp_SSE2;
+    } else if (fMatrixProc == RepeatX_RepeatY_nofilter_persp) {
+        fMatrixProc = RepeatX_RepeatY_nofilter_persp_SSE2;
     }
 
     /* Check fShaderProc32 */
@@ -213,8 +273,17 @@ static SkBlitRow::Proc32 platform_32_procs[] = {
     S32A_Blend_BlitRow32_SSE2,          // S32A_Blend,
 };
 
+static SkBlitRow::Proc32 platform_32_procs_AVX2[] = {
+    NULL,                               // S32_Opaque,
+    S32_Blend_BlitRow32_SSE2,           // S32_Blend,
+    S32A_Opaque_BlitRow32_AVX2,         // S32A_Opaque
+    S32A_Blend_BlitRow32_AVX2,          // S32A_Blend,
+};
+
 SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
-    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        return platform_32_procs_AVX2[flags];
+    } else if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return platform_32_procs[flags];
     } else {
         return NULL;
@@ -222,7 +291,9 @@ SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
 }
 
 SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
-    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        return Color32_AVX2;
+    } else if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return Color32_SSE2;
     } else {
         return NULL;
@@ -258,7 +329,11 @@ SkBlitMask::ColorProc SkBlitMask::PlatformColorProcs(SkColorType dstCT,
                 // The SSE2 version is not (yet) faster for black, so we check
                 // for that.
                 if (SK_ColorBLACK != color) {
-                    proc = SkARGB32_A8_BlitMask_SSE2;
+                    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+                        proc = SkARGB32_A8_BlitMask_AVX2;
+                    } else {
+                        proc = SkARGB32_A8_BlitMask_SSE2;
+                    }
                 }
                 break;
             default:
@@ -313,6 +388,38 @@ SkMemcpy32Proc SkMemcpy32GetPlatformProc() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+SkMipMap::DownsampleRowProc SkMipMapGetPlatformProc(SkMipMapProcType type) {
+    if (!supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+        return NULL;
+    }
+    switch (type) {
+        case k32_SkMipMapProcType:
+            return SkMipMapDownsample32_SSE2;
+        case k565_SkMipMapProcType:
+            return SkMipMapDownsample565_SSE2;
+        case k4444_SkMipMapProcType:
+            return SkMipMapDownsample4444_SSE2;
+        case kA8_SkMipMapProcType:
+            return SkMipMapDownsampleA8_SSE2;
+        default:
+            return NULL;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SkGradientGetPlatformSpanProcs(SkGradientSpanProcs* procs) {
+    sk_bzero(procs, sizeof(*procs));
+    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+        procs->fRadialClamp = SkRadialClampSpan_SSE2;
+        procs->fRadial = SkRadialSpan_SSE2;
+        procs->fSweep = SkSweepSpan_SSE2;
+        procs->fTwoPointConical = SkTwoPointConicalSpan_SSE2;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 SkMorphologyImageFilter::Proc SkMorphologyGetPlatformProc(SkMorphologyProcType type) {
     if (!supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return NULL;
@@ -365,6 +472,12 @@ SkProcCoeffXfermode* SkPlatformXfermodeFactory(const ProcCoeff& rec,
 
 SkProcCoeffXfermode* SkPlatformXfermodeFactory(const ProcCoeff& rec,
                                                SkXfermode::Mode mode) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        SkProcCoeffXfermode* xfermode = SkPlatformXfermodeFactory_impl_AVX2(rec, mode);
+        if (NULL != xfermode) {
+            return xfermode;
+        }
+    }
     if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return SkPlatformXfermodeFactory_impl_SSE2(rec, mode);
     } else {
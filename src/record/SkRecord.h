@@ -61,6 +61,11 @@ public:
     }
     // TODO: It'd be nice to infer R from F for visit and mutate if we ever get std::result_of.
 
+    // Returns roughly how many bytes this SkRecord holds, not counting anything its commands ref.
+    size_t bytesUsed() const {
+        return fAlloc.totalCapacity() + fReserved * (sizeof(Record) + sizeof(Type8));
+    }
+
     // Allocate contiguous space for count Ts, to be freed when the SkRecord is destroyed.
     // Here T can be any class, not just those from SkRecords.  Throws on failure.
     template <typename T>
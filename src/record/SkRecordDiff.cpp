@@ -0,0 +1,241 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRecordDiff.h"
+
+#include "SkImageFilter.h"
+#include "SkRecordDraw.h"
+#include "SkRecords.h"
+#include "SkTDArray.h"
+
+using namespace SkRecords;
+
+namespace {
+
+// Field comparisons.  These may say two fields differ when they'd really draw the same (e.g. 0 and
+// -0, or equal bitmaps with different pixel refs), but never the other way around.
+bool same_bitmap(const SkBitmap& a, const SkBitmap& b) {
+    return a.getGenerationID() == b.getGenerationID()
+        && a.pixelRefOrigin()  == b.pixelRefOrigin()
+        && a.width()           == b.width()
+        && a.height()          == b.height()
+        && a.colorType()       == b.colorType();
+}
+
+template <typename T>
+bool equal(const Optional<T>& a, const Optional<T>& b) {
+    const T* aPtr = a;
+    const T* bPtr = b;
+    return aPtr == bPtr || (NULL != aPtr && NULL != bPtr && *aPtr == *bPtr);
+}
+
+template <typename T>
+bool equal(const T* a, const T* b, size_t count) {
+    return a == b || (NULL != a && NULL != b && 0 == memcmp(a, b, count * sizeof(T)));
+}
+
+// Op comparisons.  We only compare ops of the same type.
+#define EQUAL(T, test) bool equal(const T& a, const T& b) { return test; }
+
+EQUAL(NoOp, true)
+EQUAL(Restore, true)
+EQUAL(Save, a.flags == b.flags)
+EQUAL(SaveLayer, equal(a.bounds, b.bounds) && equal(a.paint, b.paint) && a.flags == b.flags)
+EQUAL(PushCull, a.rect == b.rect)
+EQUAL(PopCull, true)
+EQUAL(PairedPushCull, a.base->rect == b.base->rect && a.skip == b.skip)
+EQUAL(Concat, a.matrix == b.matrix)
+EQUAL(SetMatrix, a.matrix == b.matrix)
+EQUAL(ClipPath, a.path == b.path && a.op == b.op && a.doAA == b.doAA)
+EQUAL(ClipRRect, a.rrect == b.rrect && a.op == b.op && a.doAA == b.doAA)
+EQUAL(ClipRect, a.rect == b.rect && a.op == b.op && a.doAA == b.doAA)
+EQUAL(ClipRegion, a.region == b.region && a.op == b.op)
+EQUAL(Clear, a.color == b.color)
+EQUAL(DrawBitmap, equal(a.paint, b.paint) && same_bitmap(a.bitmap, b.bitmap)
+                  && a.left == b.left && a.top == b.top)
+EQUAL(DrawBitmapMatrix, equal(a.paint, b.paint) && same_bitmap(a.bitmap, b.bitmap)
+                        && a.matrix == b.matrix)
+EQUAL(DrawBitmapNine, equal(a.paint, b.paint) && same_bitmap(a.bitmap, b.bitmap)
+                      && a.center == b.center && a.dst == b.dst)
+EQUAL(DrawBitmapRectToRect, equal(a.paint, b.paint) && same_bitmap(a.bitmap, b.bitmap)
+                            && equal(a.src, b.src) && a.dst == b.dst && a.flags == b.flags)
+EQUAL(DrawDRRect, a.paint == b.paint && a.outer == b.outer && a.inner == b.inner)
+EQUAL(DrawOval, a.paint == b.paint && a.oval == b.oval)
+EQUAL(DrawPaint, a.paint == b.paint)
+EQUAL(DrawPath, a.paint == b.paint && a.path == b.path)
+EQUAL(DrawPoints, a.paint == b.paint && a.mode == b.mode && a.count == b.count
+                  && equal<SkPoint>(a.pts, b.pts, a.count))
+EQUAL(DrawPosText, a.paint == b.paint && a.byteLength == b.byteLength
+                   && equal<char>(a.text, b.text, a.byteLength)
+                   && equal<SkPoint>(a.pos, b.pos, a.paint->countText(a.text, a.byteLength)))
+EQUAL(DrawPosTextH, a.paint == b.paint && a.byteLength == b.byteLength
+                    && equal<char>(a.text, b.text, a.byteLength)
+                    && equal<SkScalar>(a.xpos, b.xpos, a.paint->countText(a.text, a.byteLength))
+                    && a.y == b.y)
+EQUAL(DrawRRect, a.paint == b.paint && a.rrect == b.rrect)
+EQUAL(DrawRect, a.paint == b.paint && a.rect == b.rect)
+EQUAL(DrawSprite, equal(a.paint, b.paint) && same_bitmap(a.bitmap, b.bitmap)
+                  && a.left == b.left && a.top == b.top)
+EQUAL(DrawText, a.paint == b.paint && a.byteLength == b.byteLength
+                && equal<char>(a.text, b.text, a.byteLength) && a.x == b.x && a.y == b.y)
+EQUAL(DrawTextOnPath, a.paint == b.paint && a.byteLength == b.byteLength
+                      && equal<char>(a.text, b.text, a.byteLength)
+                      && a.path == b.path && equal(a.matrix, b.matrix))
+EQUAL(DrawVertices, a.paint == b.paint && a.vmode == b.vmode
+                    && a.vertexCount == b.vertexCount && a.indexCount == b.indexCount
+                    && a.xmode.get() == b.xmode.get()
+                    && equal<SkPoint>(a.vertices, b.vertices, a.vertexCount)
+                    && equal<SkPoint>(a.texs, b.texs, a.vertexCount)
+                    && equal<SkColor>(a.colors, b.colors, a.vertexCount)
+                    && equal<uint16_t>(a.indices, b.indices, a.indexCount))
+EQUAL(BoundedDrawPosTextH, equal(*a.base, *b.base) && a.minY == b.minY && a.maxY == b.maxY)
+EQUAL(DrawRects, a.paint == b.paint && a.count == b.count
+                 && equal<SkRect>(a.rects, b.rects, a.count))
+
+#undef EQUAL
+
+// Remembers the type and address of an op, so OpEquals can compare another op against it.
+struct Grab {
+    template <typename T>
+    void operator()(const T& op) {
+        type = T::kType;
+        ptr = &op;
+    }
+
+    Type type;
+    const void* ptr;
+};
+
+struct OpEquals {
+    explicit OpEquals(const void* other) : other(other) {}
+
+    template <typename T>
+    bool operator()(const T& op) { return equal(op, *static_cast<const T*>(other)); }
+
+    const void* other;
+};
+
+bool op_equals(const SkRecord& a, unsigned i, const SkRecord& b, unsigned j) {
+    Grab grabbed;
+    b.visit<void>(j, grabbed);
+
+    Grab type;
+    a.visit<void>(i, type);
+    if (type.type != grabbed.type) {
+        return false;
+    }
+    OpEquals equals(grabbed.ptr);
+    return a.visit<bool>(i, equals);
+}
+
+// Walks one record in order, adding the bounds of the ops we're told have changed to a region.
+// Image filters on a SaveLayer can spread a change inside the layer out to anywhere the layer
+// draws, so changes inside such a layer add the bounds of the whole (outermost) layer instead.
+class Accumulator {
+public:
+    Accumulator(const SkRecord& record, int width, int height, SkRegion* changed)
+        : fRecord(record)
+        , fBounds(record, SkIRect::MakeWH(width, height))
+        , fIndex(0)
+        , fChanged(changed) {}
+
+    // Move along to op index, walking past every op before it.
+    void advanceTo(unsigned index) {
+        SkASSERT(index >= fIndex);
+        for (; fIndex < index; fIndex++) {
+            fRecord.visit<void>(fIndex, *this);
+        }
+    }
+
+    // Op index (which we must have advanced to) has changed.
+    void changed() {
+        const unsigned op = fFilteredLayers.isEmpty() ? fIndex : fFilteredLayers[0];
+        fChanged->op(fBounds.getBounds(op), SkRegion::kUnion_Op);
+    }
+
+    // Track the layers we're in as we walk past ops.
+    template <typename T> void operator()(const T&) {}
+    void operator()(const Save&) { *fSaves.append() = false; }
+    void operator()(const SaveLayer& op) {
+        const bool filtered = NULL != op.paint && NULL != op.paint->getImageFilter();
+        *fSaves.append() = filtered;
+        if (filtered) {
+            *fFilteredLayers.append() = fIndex;
+        }
+    }
+    void operator()(const Restore&) {
+        if (fSaves.isEmpty()) {
+            return;  // Unbalanced Restore; SkCanvas ignores these too.
+        }
+        bool filtered;
+        fSaves.pop(&filtered);
+        if (filtered) {
+            fFilteredLayers.pop();
+        }
+    }
+
+private:
+    const SkRecord& fRecord;
+    const FillBounds fBounds;
+    unsigned fIndex;
+    SkRegion* fChanged;
+
+    SkTDArray<bool> fSaves;                // Whether each open Save is an image filtered layer.
+    SkTDArray<unsigned> fFilteredLayers;   // Indices of open image filtered SaveLayers.
+};
+
+}  // namespace
+
+void SkRecordDiff(const SkRecord& before, const SkRecord& after,
+                  int width, int height, SkRegion* changed) {
+    SkASSERT(NULL != changed);
+    changed->setEmpty();
+
+    // Trim off the commands at the start and end that are the same in both records.
+    const unsigned beforeCount = before.count(), afterCount = after.count();
+    unsigned prefix = 0;
+    while (prefix < beforeCount && prefix < afterCount && op_equals(before, prefix, after, prefix)) {
+        prefix++;
+    }
+    unsigned suffix = 0;
+    while (prefix + suffix < beforeCount && prefix + suffix < afterCount &&
+           op_equals(before, beforeCount - 1 - suffix, after, afterCount - 1 - suffix)) {
+        suffix++;
+    }
+    if (prefix + suffix == beforeCount && prefix + suffix == afterCount) {
+        return;  // Nothing changed.
+    }
+
+    Accumulator beforeChanges(before, width, height, changed),
+                 afterChanges(after, width, height, changed);
+    beforeChanges.advanceTo(prefix);
+    afterChanges.advanceTo(prefix);
+
+    const unsigned beforeEnd = beforeCount - suffix, afterEnd = afterCount - suffix;
+    if (beforeEnd - prefix == afterEnd - prefix) {
+        // Probably an edit in place.  Compare command by command.
+        for (unsigned i = prefix; i < beforeEnd; i++) {
+            beforeChanges.advanceTo(i);
+            afterChanges.advanceTo(i);
+            if (!op_equals(before, i, after, i)) {
+                beforeChanges.changed();
+                afterChanges.changed();
+            }
+        }
+        return;
+    }
+
+    // Commands were added or removed.  We just assume everything in between changed.
+    for (unsigned i = prefix; i < beforeEnd; i++) {
+        beforeChanges.advanceTo(i);
+        beforeChanges.changed();
+    }
+    for (unsigned i = prefix; i < afterEnd; i++) {
+        afterChanges.advanceTo(i);
+        afterChanges.changed();
+    }
+}
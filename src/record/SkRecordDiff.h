@@ -0,0 +1,26 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordDiff_DEFINED
+#define SkRecordDiff_DEFINED
+
+#include "SkRecord.h"
+#include "SkRegion.h"
+
+// Set changed to the device-space region where drawing after may produce different pixels than
+// drawing before, both into the same width x height canvas.  Everything outside changed draws the
+// same, so only the tiles changed touches need to be redrawn.
+//
+// We line up the commands of the two records by trimming off their common prefix and suffix.  If
+// what's left is the same length in both, we compare it command by command, otherwise we assume
+// all of it changed.  changed is the union of the bounds (see SkRecords::FillBounds) of the
+// commands that differ, taken from both records.  This is conservative: changed may include pixels
+// that draw the same, but never leaves out any pixel that might differ.
+void SkRecordDiff(const SkRecord& before, const SkRecord& after,
+                  int width, int height, SkRegion* changed);
+
+#endif//SkRecordDiff_DEFINED
@@ -6,13 +6,63 @@
  */
 
 #include "SkRecordDraw.h"
+#include "SkShader.h"
+#include "SkTSort.h"
+#include "SkXfermode.h"
 
-void SkRecordDraw(const SkRecord& record, SkCanvas* canvas) {
-    for (SkRecords::Draw draw(canvas); draw.index() < record.count(); draw.next()) {
-        record.visit<void>(draw.index(), draw);
+void SkRecordDraw(const SkRecord& record, SkCanvas* canvas, SkBBoxHierarchy* bbh,
+                  SkPlaybackProfiler* profiler) {
+    if (NULL == bbh) {
+        for (SkRecords::Draw draw(canvas, profiler); draw.index() < record.count(); draw.next()) {
+            record.visit<void>(draw.index(), draw);
+        }
+        return;
+    }
+
+    // The BBH was filled in the SkRecord's coordinate space, which is this canvas' local space
+    // when we start drawing.  So the canvas' local clip bounds are exactly what we need to query.
+    SkRect clipBounds;
+    if (!canvas->getClipBounds(&clipBounds)) {
+        return;  // The clip is empty.  Nothing we could draw would show up.
+    }
+    SkIRect query;
+    clipBounds.roundOut(&query);
+
+    SkTDArray<void*> ops;
+    bbh->search(query, &ops);
+    if (ops.isEmpty()) {
+        return;
+    }
+    // Not all BBHs return their results in the order we inserted them.  We must draw in order.
+    SkTQSort(ops.begin(), ops.end() - 1, SkTCompareLT<void*>());
+
+    SkRecords::Draw draw(canvas, profiler);
+    for (int i = 0; i < ops.count(); i++) {
+        record.visit<void>((unsigned)(uintptr_t)ops[i], draw);  // See SkRecordFillBounds.
     }
 }
 
+void SkRecordFillBounds(const SkRecord& record, int width, int height, SkBBoxHierarchy* bbh) {
+    SkASSERT(NULL != bbh);
+    SkRecords::FillBounds fill(record, SkIRect::MakeWH(width, height));
+    fill.insertInto(bbh);
+}
+
+bool SkRecordIsOpaquePaint(const SkPaint& paint) {
+    const SkXfermode* xfermode = paint.getXfermode();
+    return SkColorGetA(paint.getColor()) == SK_AlphaOPAQUE
+        && (NULL == paint.getShader() || paint.getShader()->isOpaque())
+        && (NULL == xfermode ||
+            SkXfermode::IsMode(xfermode, SkXfermode::kSrcOver_Mode) ||
+            SkXfermode::IsMode(xfermode, SkXfermode::kSrc_Mode))
+        && NULL == paint.getPathEffect()
+        && NULL == paint.getMaskFilter()
+        && NULL == paint.getColorFilter()
+        && NULL == paint.getRasterizer()
+        && NULL == paint.getLooper()
+        && NULL == paint.getImageFilter();
+}
+
 namespace SkRecords {
 
 bool Draw::skip(const PairedPushCull& r) {
@@ -68,4 +118,339 @@ DRAW(DrawVertices, drawVertices(r.vmode, r.vertexCount, r.vertices, r.texs, r.co
 template <> void Draw::draw(const PairedPushCull& r) { this->draw(*r.base); }
 template <> void Draw::draw(const BoundedDrawPosTextH& r) { this->draw(*r.base); }
 
+// Can we draw these rects as one path and get exactly the same pixels as drawing them one by one?
+// Non-anti-aliased fills scan convert the same either way, and as long as each pixel's result
+// doesn't depend on what's already there, drawing an overlapping pixel twice is the same as once.
+static bool can_draw_rects_as_path(const SkPaint& paint) {
+    return !paint.isAntiAlias()
+        && SkPaint::kFill_Style == paint.getStyle()
+        && SkRecordIsOpaquePaint(paint);
+}
+
+template <> void Draw::draw(const DrawRects& r) {
+    // On the GPU, drawRect() calls are already batched together, and a path would be slower.
+    if (NULL == fCanvas->getGrContext() && can_draw_rects_as_path(r.paint)) {
+        // One draw call means we choose a blitter and set up the shader just once.
+        SkPath path;
+        path.incReserve(5 * r.count);
+        for (unsigned i = 0; i < r.count; i++) {
+            // drawRect() sorts its rect.  We must too, or an inverted rect would wind the other
+            // way and cancel out where it overlaps the others.
+            SkRect rect = r.rects[i];
+            rect.sort();
+            if (!rect.isEmpty()) {
+                path.addRect(rect);
+            }
+        }
+        fCanvas->drawPath(path, r.paint);
+        return;
+    }
+    for (unsigned i = 0; i < r.count; i++) {
+        fCanvas->drawRect(r.rects[i], r.paint);
+    }
+}
+
+FillBounds::FillBounds(const SkRecord& record, const SkIRect& canvasBounds)
+    : fCanvasBounds(canvasBounds)
+    , fBounds(record.count())
+    , fCount(record.count()) {
+    fCTM.setIdentity();
+    fCurrentClipBounds = fCanvasBounds;
+    for (fCurrentOp = 0; fCurrentOp < fCount; fCurrentOp++) {
+        fBounds[fCurrentOp].setEmpty();
+        record.visit<void>(fCurrentOp, *this);
+    }
+
+    // If we have any lingering unpaired Saves, simulate Restores to make sure all ops in those
+    // Save blocks have their bounds calculated.
+    while (!fSaveStack.isEmpty()) {
+        this->popSaveBlock();
+    }
+
+    // Any control ops not part of any Save/Restore block affect everything we draw.
+    while (!fControlIndices.isEmpty()) {
+        this->popControl(fCanvasBounds);
+    }
+}
+
+void FillBounds::insertInto(SkBBoxHierarchy* bbh) const {
+    // Ops with empty bounds can't affect any pixels, so we just leave them out.
+    for (unsigned i = 0; i < fCount; i++) {
+        if (!fBounds[i].isEmpty()) {
+            bbh->insert((void*)(uintptr_t)i, fBounds[i], true/*ok to defer*/);
+        }
+    }
+    bbh->flushDeferredInserts();
+}
+
+void FillBounds::clip(const SkRect& rect, SkRegion::Op op, bool inverseFilled) {
+    // An inverse-filled clip could cover any part of the canvas.
+    this->clipDevice(inverseFilled ? fCanvasBounds : this->mapToDevice(rect, fCanvasBounds), op);
+}
+
+void FillBounds::clipDevice(const SkIRect& devBounds, SkRegion::Op op) {
+    switch (op) {
+        case SkRegion::kIntersect_Op:
+            if (!fCurrentClipBounds.intersect(devBounds)) {
+                fCurrentClipBounds.setEmpty();
+            }
+            break;
+        case SkRegion::kReplace_Op:
+            fCurrentClipBounds = devBounds;
+            if (!fCurrentClipBounds.intersect(fCanvasBounds)) {
+                fCurrentClipBounds.setEmpty();
+            }
+            break;
+        case SkRegion::kDifference_Op:
+            // Difference can only shrink the clip, so the current bounds are still conservative.
+            break;
+        default:
+            // Union, XOR, and ReverseDifference may grow the clip to cover devBounds.
+            fCurrentClipBounds.join(devBounds);
+            if (!fCurrentClipBounds.intersect(fCanvasBounds)) {
+                fCurrentClipBounds.setEmpty();
+            }
+            break;
+    }
+}
+
+SkIRect FillBounds::mapToDevice(SkRect rect, const SkIRect& limit) const {
+    // Inverted rectangles really confuse our BBHs.
+    rect.sort();
+    fCTM.mapRect(&rect);
+
+    // Anti-aliasing can spill a pixel past the geometry, so we outset by one.  We clip to limit
+    // before rounding so huge (or non-finite) bounds don't overflow the integer conversion.
+    rect.outset(SK_Scalar1, SK_Scalar1);
+    if (limit.isEmpty() || !rect.intersect(SkRect::Make(limit))) {
+        return SkIRect::MakeEmpty();
+    }
+    SkIRect devBounds;
+    rect.roundOut(&devBounds);
+    return devBounds;
+}
+
+SkIRect FillBounds::adjustAndMap(SkRect rect, const SkPaint* paint) const {
+    if (NULL != paint) {
+        if (!paint->canComputeFastBounds() || NULL != paint->getImageFilter()) {
+            // The paint could do anything to our bounds.  The only safe answer is the clip.
+            return fCurrentClipBounds;
+        }
+        rect.sort();
+        rect = paint->computeFastBounds(rect, &rect);
+    }
+    return this->mapToDevice(rect, fCurrentClipBounds);
+}
+
+void FillBounds::pushSaveBlock(const SkPaint* paint, SkCanvas::SaveFlags flags) {
+    SaveBounds sb;
+    sb.controlOps = 0;
+    sb.bounds.setEmpty();
+    sb.paint = paint;
+    sb.flags = flags;
+    sb.ctm = fCTM;
+    sb.clipBounds = fCurrentClipBounds;
+    fSaveStack.push(sb);
+    this->pushControl();
+}
+
+SkIRect FillBounds::popSaveBlock() {
+    // We're done the Save block.  Apply the block's bounds to all control ops inside it.
+    SaveBounds sb;
+    fSaveStack.pop(&sb);
+
+    // A SaveLayer whose paint does more than blend the layer back down may touch every pixel the
+    // clip allowed when the layer was saved, not just the pixels drawn into the layer.
+    SkIRect bounds = sb.bounds;
+    if (NULL != sb.paint && (NULL != sb.paint->getImageFilter() ||
+                             NULL != sb.paint->getColorFilter() ||
+                             NULL != sb.paint->getXfermode())) {
+        bounds.join(sb.clipBounds);
+    }
+
+    while (sb.controlOps --> 0) {
+        this->popControl(bounds);
+    }
+
+    // This whole Save block may be part of another Save block.
+    this->updateSaveBounds(bounds);
+
+    // Finally, restore whatever state this Save saved.
+    if (sb.flags & SkCanvas::kMatrix_SaveFlag) {
+        fCTM = sb.ctm;
+    }
+    if (sb.flags & SkCanvas::kClip_SaveFlag) {
+        fCurrentClipBounds = sb.clipBounds;
+    }
+    return bounds;
+}
+
+void FillBounds::pushControl() {
+    fControlIndices.push(fCurrentOp);
+    if (!fSaveStack.isEmpty()) {
+        fSaveStack.top().controlOps++;
+    }
+}
+
+void FillBounds::popControl(const SkIRect& bounds) {
+    fBounds[fControlIndices.top()] = bounds;
+    fControlIndices.pop();
+}
+
+void FillBounds::updateSaveBounds(const SkIRect& bounds) {
+    // If we're in a Save block, expand its bounds to cover these bounds too.
+    if (!fSaveStack.isEmpty()) {
+        fSaveStack.top().bounds.join(bounds);
+    }
+}
+
+void FillBounds::trackBounds(const Restore&) {
+    if (fSaveStack.isEmpty()) {
+        // An unbalanced Restore does nothing, but we may as well treat it like other control ops.
+        this->pushControl();
+        return;
+    }
+    fBounds[fCurrentOp] = this->popSaveBlock();
+}
+
+// Text bounds are a guess.  Actually looking up font metrics is slow, and this overapproximation
+// is the same one SkRecordBoundDrawPosTextH uses.
+static void outset_for_text(const SkPaint& paint, SkRect* rect) {
+    const SkScalar buffer = paint.getTextSize() * 1.5f;
+    rect->outset(buffer, buffer);
+}
+
+SkIRect FillBounds::bounds(const Clear&) const { return fCanvasBounds; }  // Ignores the clip.
+SkIRect FillBounds::bounds(const DrawPaint&) const { return fCurrentClipBounds; }
+
+SkIRect FillBounds::bounds(const DrawRect& op) const {
+    return this->adjustAndMap(op.rect, op.paint.get());
+}
+SkIRect FillBounds::bounds(const DrawRects& op) const {
+    SkRect bounds;
+    bounds.setEmpty();
+    for (unsigned i = 0; i < op.count; i++) {
+        SkRect rect = op.rects[i];
+        rect.sort();
+        bounds.join(rect);
+    }
+    return this->adjustAndMap(bounds, op.paint.get());
+}
+SkIRect FillBounds::bounds(const DrawOval& op) const {
+    return this->adjustAndMap(op.oval, op.paint.get());
+}
+SkIRect FillBounds::bounds(const DrawRRect& op) const {
+    return this->adjustAndMap(op.rrect.rect(), op.paint.get());
+}
+SkIRect FillBounds::bounds(const DrawDRRect& op) const {
+    return this->adjustAndMap(op.outer.rect(), op.paint.get());
+}
+
+SkIRect FillBounds::bounds(const DrawPath& op) const {
+    if (op.path.isInverseFillType()) {
+        return fCurrentClipBounds;
+    }
+    return this->adjustAndMap(op.path.getBounds(), op.paint.get());
+}
+
+SkIRect FillBounds::bounds(const DrawPoints& op) const {
+    // Points are always stroked, whatever the paint's style.
+    if (!op.paint->canComputeFastBounds()) {
+        return fCurrentClipBounds;
+    }
+    SkRect rect;
+    rect.set(op.pts, SkToInt(op.count));
+    return this->mapToDevice(op.paint->computeFastStrokeBounds(rect, &rect), fCurrentClipBounds);
+}
+
+SkIRect FillBounds::bounds(const DrawVertices& op) const {
+    SkRect rect;
+    rect.set(op.vertices, op.vertexCount);
+    return this->adjustAndMap(rect, op.paint.get());
+}
+
+SkIRect FillBounds::bounds(const DrawBitmap& op) const {
+    const SkBitmap& bm = op.bitmap;
+    return this->adjustAndMap(SkRect::MakeXYWH(op.left, op.top,
+                                               SkIntToScalar(bm.width()),
+                                               SkIntToScalar(bm.height())),
+                              op.paint);
+}
+SkIRect FillBounds::bounds(const DrawBitmapMatrix& op) const {
+    const SkBitmap& bm = op.bitmap;
+    SkRect rect = SkRect::MakeWH(SkIntToScalar(bm.width()), SkIntToScalar(bm.height()));
+    op.matrix.mapRect(&rect);
+    return this->adjustAndMap(rect, op.paint);
+}
+SkIRect FillBounds::bounds(const DrawBitmapNine& op) const {
+    return this->adjustAndMap(op.dst, op.paint);
+}
+SkIRect FillBounds::bounds(const DrawBitmapRectToRect& op) const {
+    return this->adjustAndMap(op.dst, op.paint);
+}
+
+SkIRect FillBounds::bounds(const DrawSprite& op) const {
+    // Sprites are drawn in device space, ignoring the CTM.
+    const SkBitmap& bm = op.bitmap;
+    if (NULL != op.paint && NULL != op.paint->getImageFilter()) {
+        return fCurrentClipBounds;
+    }
+    SkIRect devBounds = SkIRect::MakeXYWH(op.left, op.top, bm.width(), bm.height());
+    if (!devBounds.intersect(fCurrentClipBounds)) {
+        return SkIRect::MakeEmpty();
+    }
+    return devBounds;
+}
+
+SkIRect FillBounds::bounds(const DrawText& op) const {
+    if (op.paint->isVerticalText()) {
+        return fCurrentClipBounds;
+    }
+    // We don't know the text alignment's effect on x, so allow the text to extend either way.
+    const SkScalar width = op.paint->measureText(op.text, op.byteLength);
+    SkRect rect = SkRect::MakeLTRB(op.x - width, op.y, op.x + width, op.y);
+    outset_for_text(op.paint, &rect);
+    return this->adjustAndMap(rect, op.paint.get());
+}
+
+SkIRect FillBounds::bounds(const DrawPosText& op) const {
+    const int points = op.paint->countText(op.text, op.byteLength);
+    if (points == 0) {
+        return SkIRect::MakeEmpty();
+    }
+    SkRect rect;
+    rect.set(op.pos, points);
+    outset_for_text(op.paint, &rect);
+    return this->adjustAndMap(rect, op.paint.get());
+}
+
+SkIRect FillBounds::bounds(const DrawPosTextH& op) const {
+    const int points = op.paint->countText(op.text, op.byteLength);
+    if (points == 0) {
+        return SkIRect::MakeEmpty();
+    }
+    SkScalar left = op.xpos[0], right = op.xpos[0];
+    for (int i = 1; i < points; i++) {
+        left  = SkMinScalar(left,  op.xpos[i]);
+        right = SkMaxScalar(right, op.xpos[i]);
+    }
+    SkRect rect = SkRect::MakeLTRB(left, op.y, right, op.y);
+    outset_for_text(op.paint, &rect);
+    return this->adjustAndMap(rect, op.paint.get());
+}
+
+SkIRect FillBounds::bounds(const BoundedDrawPosTextH& op) const {
+    return this->bounds(*op.base);
+}
+
+SkIRect FillBounds::bounds(const DrawTextOnPath& op) const {
+    if (NULL != op.matrix) {
+        // The matrix can move glyphs anywhere relative to the path.
+        return fCurrentClipBounds;
+    }
+    SkRect rect = op.path.getBounds();
+    outset_for_text(op.paint, &rect);
+    return this->adjustAndMap(rect, op.paint.get());
+}
+
 }  // namespace SkRecords
@@ -8,27 +8,48 @@
 #ifndef SkRecordDraw_DEFINED
 #define SkRecordDraw_DEFINED
 
-#include "SkRecord.h"
+#include "SkBBoxHierarchy.h"
 #include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkRecord.h"
+#include "SkTDArray.h"
+
+// Fill a bounding box hierarchy with the device-space bounds of each op in the SkRecord, as
+// recorded into a width x height canvas.  Data inserted into the BBH are op indices.
+void SkRecordFillBounds(const SkRecord&, int width, int height, SkBBoxHierarchy*);
 
 // Draw an SkRecord into an SkCanvas.  A convenience wrapper around SkRecords::Draw.
-void SkRecordDraw(const SkRecord&, SkCanvas*);
+// If bbh is non-NULL, it must have been filled by SkRecordFillBounds, and we only draw the ops
+// that may affect pixels inside the canvas' current clip.
+// If profiler is non-NULL, it's told about each op we draw.
+void SkRecordDraw(const SkRecord&, SkCanvas*, SkBBoxHierarchy* bbh = NULL,
+                  SkPlaybackProfiler* profiler = NULL);
+
+// Does this paint write opaque pixels everywhere it draws, regardless of what's already there?
+bool SkRecordIsOpaquePaint(const SkPaint&);
 
 namespace SkRecords {
 
 // This is an SkRecord visitor that will draw that SkRecord to an SkCanvas.
 class Draw : SkNoncopyable {
 public:
-    explicit Draw(SkCanvas* canvas)
-        : fInitialCTM(canvas->getTotalMatrix()), fCanvas(canvas), fIndex(0) {}
+    explicit Draw(SkCanvas* canvas, SkPlaybackProfiler* profiler = NULL)
+        : fInitialCTM(canvas->getTotalMatrix()), fCanvas(canvas), fProfiler(profiler), fIndex(0) {}
 
     unsigned index() const { return fIndex; }
     void next() { ++fIndex; }
 
     template <typename T> void operator()(const T& r) {
-        if (!this->skip(r)) {
+        if (this->skip(r)) {
+            return;
+        }
+        if (NULL != fProfiler) {
+            fProfiler->beginOp(fIndex, T::kType, TypeName(T::kType));
             this->draw(r);
+            fProfiler->endOp();
+            return;
         }
+        this->draw(r);
     }
 
 private:
@@ -47,9 +68,134 @@ private:
 
     const SkMatrix fInitialCTM;
     SkCanvas* fCanvas;
+    SkPlaybackProfiler* fProfiler;
     unsigned fIndex;
 };
 
+// This is an SkRecord visitor that calculates the device-space bounds of each op, for use with
+// an SkBBoxHierarchy.
+//
+// The interesting part here is how to calculate bounds for ops which don't draw.  What are the
+// bounds of a Save or a Concat?  We answer this by thinking about a particular definition of
+// bounds: if I don't execute this op, pixels in this rectangle might draw incorrectly.  So the
+// bounds of a Save, a Concat, a Restore, etc. are the union of the bounds of the drawing ops that
+// they might affect.  For any given Save/Restore block, the Save, the Restore, and any other
+// control ops inside get exactly the union of the bounds of the drawing ops inside that block.
+// Control ops outside any Save/Restore block get the bounds of the whole canvas.
+//
+// Culls are only hints, so we give them empty bounds, which keeps them out of the BBH entirely.
+class FillBounds : SkNoncopyable {
+public:
+    // Calculates bounds as if drawing into a canvas covering canvasBounds.
+    FillBounds(const SkRecord&, const SkIRect& canvasBounds);
+
+    // Insert the index of each op with non-empty bounds into the BBH.
+    void insertInto(SkBBoxHierarchy*) const;
+
+    // The device-space bounds of the op at index, or empty if it can never draw anything.
+    const SkIRect& getBounds(unsigned index) const {
+        SkASSERT(index < fCount);
+        return fBounds[index];
+    }
+
+    template <typename T> void operator()(const T& op) {
+        this->updateCTM(op);
+        this->updateClipBounds(op);
+        this->trackBounds(op);
+    }
+
+private:
+    struct SaveBounds {
+        int controlOps;           // Number of control ops in this Save block, including the Save.
+        SkIRect bounds;           // Bounds of everything drawn in the block.
+        const SkPaint* paint;     // Unowned.  The SaveLayer's paint, if any.
+        SkCanvas::SaveFlags flags;
+        SkMatrix ctm;             // The CTM and clip bounds to restore, if flags say so.
+        SkIRect clipBounds;
+    };
+
+    template <typename T> void updateCTM(const T&) { /* most ops don't change the CTM */ }
+    void updateCTM(const SetMatrix& op) { fCTM = op.matrix; }
+    void updateCTM(const Concat& op)    { fCTM.preConcat(op.matrix); }
+
+    template <typename T> void updateClipBounds(const T&) { /* most ops don't change the clip */ }
+    void updateClipBounds(const ClipPath& op) {
+        this->clip(op.path.getBounds(), op.op, op.path.isInverseFillType());
+    }
+    void updateClipBounds(const ClipRRect& op) { this->clip(op.rrect.getBounds(), op.op, false); }
+    void updateClipBounds(const ClipRect& op)  { this->clip(op.rect, op.op, false); }
+    void updateClipBounds(const ClipRegion& op) { this->clipDevice(op.region.getBounds(), op.op); }
+
+    // Draws get their own bounds, and expand the bounds of any Save block they're in.
+    template <typename T> void trackBounds(const T& op) {
+        fBounds[fCurrentOp] = this->bounds(op);
+        this->updateSaveBounds(fBounds[fCurrentOp]);
+    }
+
+    // Culls and NoOps never need to be replayed.
+    void trackBounds(const NoOp&) {}
+    void trackBounds(const PushCull&) {}
+    void trackBounds(const PopCull&) {}
+    void trackBounds(const PairedPushCull&) {}
+
+    // Control ops get their bounds when their Save block is complete.
+    void trackBounds(const Save& op)      { this->pushSaveBlock(NULL, op.flags); }
+    void trackBounds(const SaveLayer& op) { this->pushSaveBlock(op.paint, op.flags); }
+    void trackBounds(const Restore&);
+    void trackBounds(const SetMatrix&)  { this->pushControl(); }
+    void trackBounds(const Concat&)     { this->pushControl(); }
+    void trackBounds(const ClipRect&)   { this->pushControl(); }
+    void trackBounds(const ClipRRect&)  { this->pushControl(); }
+    void trackBounds(const ClipPath&)   { this->pushControl(); }
+    void trackBounds(const ClipRegion&) { this->pushControl(); }
+
+    void pushSaveBlock(const SkPaint*, SkCanvas::SaveFlags);
+    SkIRect popSaveBlock();
+    void pushControl();
+    void popControl(const SkIRect& bounds);
+    void updateSaveBounds(const SkIRect& bounds);
+
+    void clip(const SkRect& localBounds, SkRegion::Op, bool inverseFilled);
+    void clipDevice(const SkIRect& devBounds, SkRegion::Op);
+
+    // Map local bounds to device space, outset for anti-aliasing, and intersect with limit.
+    SkIRect mapToDevice(SkRect, const SkIRect& limit) const;
+    // Adjust local bounds for the paint (stroking, blurs, ...), then mapToDevice within the clip.
+    SkIRect adjustAndMap(SkRect, const SkPaint*) const;
+
+    // The device-space bounds of each drawing op, already clipped.
+    SkIRect bounds(const Clear&) const;
+    SkIRect bounds(const DrawPaint&) const;
+    SkIRect bounds(const DrawRect&) const;
+    SkIRect bounds(const DrawRects&) const;
+    SkIRect bounds(const DrawOval&) const;
+    SkIRect bounds(const DrawRRect&) const;
+    SkIRect bounds(const DrawDRRect&) const;
+    SkIRect bounds(const DrawPath&) const;
+    SkIRect bounds(const DrawPoints&) const;
+    SkIRect bounds(const DrawVertices&) const;
+    SkIRect bounds(const DrawBitmap&) const;
+    SkIRect bounds(const DrawBitmapMatrix&) const;
+    SkIRect bounds(const DrawBitmapNine&) const;
+    SkIRect bounds(const DrawBitmapRectToRect&) const;
+    SkIRect bounds(const DrawSprite&) const;
+    SkIRect bounds(const DrawText&) const;
+    SkIRect bounds(const DrawPosText&) const;
+    SkIRect bounds(const DrawPosTextH&) const;
+    SkIRect bounds(const BoundedDrawPosTextH&) const;
+    SkIRect bounds(const DrawTextOnPath&) const;
+
+    const SkIRect fCanvasBounds;
+    SkAutoTMalloc<SkIRect> fBounds;  // One for each op in the record.
+    const unsigned fCount;
+    unsigned fCurrentOp;
+
+    SkMatrix fCTM;
+    SkIRect fCurrentClipBounds;
+    SkTDArray<SaveBounds> fSaveStack;
+    SkTDArray<unsigned> fControlIndices;
+};
+
 }  // namespace SkRecords
 
 #endif//SkRecordDraw_DEFINED
@@ -7,14 +7,18 @@
 
 #include "SkRecordOpts.h"
 
+#include "SkRecordDraw.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
+#include "SkXfermode.h"
 
 using namespace SkRecords;
 
 void SkRecordOptimize(SkRecord* record) {
     // TODO(mtklein): fuse independent optimizations to reduce number of passes?
+    SkRecordNoopOccludedDraws(record);  // Run this first so the passes below can clean up after it.
     SkRecordNoopCulls(record);
     SkRecordNoopSaveRestores(record);
     // TODO(mtklein): figure out why we draw differently and reenable
@@ -23,6 +27,7 @@ void SkRecordOptimize(SkRecord* record) {
     SkRecordAnnotateCullingPairs(record);
     SkRecordReduceDrawPosTextStrength(record);  // Helpful to run this before BoundDrawPosTextH.
     SkRecordBoundDrawPosTextH(record);
+    SkRecordBatchDrawRects(record);
 }
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
@@ -122,7 +127,7 @@ struct SaveLayerDrawRestoreNooper {
             return KillSaveLayerAndRestore(record, begin);
         }
 
-        SkPaint* drawPaint = pattern->second<SkPaint>();
+        const SkPaint* drawPaint = pattern->second<const SkPaint>();
         if (drawPaint == NULL) {
             // We can just give the draw the SaveLayer's paint.
             // TODO(mtklein): figure out how to do this clearly
@@ -138,7 +143,8 @@ struct SaveLayerDrawRestoreNooper {
             return false;
         }
 
-        drawPaint->setColor(SkColorSetA(drawColor, SkColorGetA(layerColor)));
+        SkPaint* writablePaint = pattern->writableSecond<SkPaint>();
+        writablePaint->setColor(SkColorSetA(drawColor, SkColorGetA(layerColor)));
         return KillSaveLayerAndRestore(record, begin);
     }
 
@@ -180,7 +186,7 @@ struct StrengthReducer {
         SkASSERT(end == begin + 1);
         DrawPosText* draw = pattern->first<DrawPosText>();
 
-        const unsigned points = draw->paint.countText(draw->text, draw->byteLength);
+        const unsigned points = draw->paint->countText(draw->text, draw->byteLength);
         if (points == 0) {
             return false;  // No point (ha!).
         }
@@ -226,15 +232,15 @@ struct TextBounder {
 
         // If we're drawing vertical text, none of the checks we're about to do make any sense.
         // We'll need to call SkPaint::computeFastBounds() later, so bail if that's not possible.
-        if (draw->paint.isVerticalText() || !draw->paint.canComputeFastBounds()) {
+        if (draw->paint->isVerticalText() || !draw->paint->canComputeFastBounds()) {
             return false;
         }
 
         // Rather than checking the top and bottom font metrics, we guess.  Actually looking up the
         // top and bottom metrics is slow, and this overapproximation should be good enough.
-        const SkScalar buffer = draw->paint.getTextSize() * 1.5f;
+        const SkScalar buffer = draw->paint->getTextSize() * 1.5f;
         SkDEBUGCODE(SkPaint::FontMetrics metrics;)
-        SkDEBUGCODE(draw->paint.getFontMetrics(&metrics);)
+        SkDEBUGCODE(draw->paint->getFontMetrics(&metrics);)
         SkASSERT(-buffer <= metrics.fTop);
         SkASSERT(+buffer >= metrics.fBottom);
 
@@ -242,7 +248,7 @@ struct TextBounder {
         // 0 and 1 respectively just so the bounds rectangle isn't empty.
         SkRect bounds;
         bounds.set(0, draw->y - buffer, SK_Scalar1, draw->y + buffer);
-        SkRect adjusted = draw->paint.computeFastBounds(bounds, &bounds);
+        SkRect adjusted = draw->paint->computeFastBounds(bounds, &bounds);
 
         Adopted<DrawPosTextH> adopted(draw);
         SkNEW_PLACEMENT_ARGS(record->replace<BoundedDrawPosTextH>(begin, adopted),
@@ -256,6 +262,286 @@ void SkRecordBoundDrawPosTextH(SkRecord* record) {
     apply(&pass, record);
 }
 
+// No-ops draws that a later opaque draw will completely cover.
+// There's no efficient way to express this one as a pattern either, so it's another custom pass.
+//
+// We lean on FillBounds for conservative device bounds of everything drawn, and track just enough
+// of the matrix and clip ourselves to know which pixels an opaque draw is certain to cover.  Only
+// draws made while no layer is open can occlude anything; they can occlude any earlier draw,
+// including everything inside an earlier, already-restored layer.
+class OccludedDrawNooper : SkNoncopyable {
+public:
+    explicit OccludedDrawNooper(SkRecord* record)
+        : fRecord(record)
+        , fBounds(*record, kUnbounded)
+        , fLayerDepth(0) {
+        fState.ctm.setIdentity();
+        fState.clip.set(kUnbounded);
+        fState.clipIsRect = true;
+        fState.isLayer = false;
+        fState.flags = SkCanvas::kMatrixClip_SaveFlag;
+    }
+
+    void apply() {
+        for (fIndex = 0; fIndex < fRecord->count(); fIndex++) {
+            fRecord->mutate<void>(fIndex, *this);
+        }
+    }
+
+    // Draws might occlude earlier draws, and might themselves be occluded later.
+    template <typename T> void operator()(T* draw) {
+        SkRect covered;
+        if (0 == fLayerDepth && this->covers(*draw, &covered)) {
+            this->occlude(covered);
+        }
+        this->addCandidate(false, SkCanvas::kMatrixClip_SaveFlag);
+    }
+
+    void operator()(NoOp*) {}
+    void operator()(PushCull*) {}
+    void operator()(PopCull*) {}
+    void operator()(PairedPushCull*) {}
+
+    void operator()(Save* op) { this->save(op->flags, false); }
+    void operator()(SaveLayer* op) {
+        if (0 == fLayerDepth) {
+            // Everything drawn in this layer shows up only inside the layer's bounds.
+            fLayerBounds = fBounds.getBounds(fIndex);
+        }
+        this->addCandidate(true, op->flags);
+        this->save(op->flags, true);
+    }
+    void operator()(Restore*) {
+        if (fSaveStack.isEmpty()) {
+            return;
+        }
+        const State& saved = fSaveStack.top();
+        if (saved.isLayer) {
+            fLayerDepth--;
+        }
+        if (saved.flags & SkCanvas::kMatrix_SaveFlag) {
+            fState.ctm = saved.ctm;
+        }
+        if (saved.flags & SkCanvas::kClip_SaveFlag) {
+            fState.clip = saved.clip;
+            fState.clipIsRect = saved.clipIsRect;
+        }
+        fSaveStack.pop();
+    }
+
+    void operator()(SetMatrix* op) { fState.ctm = op->matrix; }
+    void operator()(Concat* op)    { fState.ctm.preConcat(op->matrix); }
+
+    void operator()(ClipRect* op) {
+        if (SkRegion::kIntersect_Op != op->op || !fState.ctm.rectStaysRect()) {
+            fState.clipIsRect = false;
+            return;
+        }
+        SkRect rect;
+        fState.ctm.mapRect(&rect, op->rect);
+        if (!fState.clip.intersect(rect)) {
+            fState.clip.setEmpty();
+        }
+    }
+    // These can only shrink the clip when intersecting, but it's no longer a rectangle we know.
+    void operator()(ClipRRect*)  { fState.clipIsRect = false; }
+    void operator()(ClipPath*)   { fState.clipIsRect = false; }
+    void operator()(ClipRegion*) { fState.clipIsRect = false; }
+
+private:
+    // Big enough to cover any canvas we'll ever draw to, small enough that floats stay exact.
+    static const SkIRect kUnbounded;
+
+    struct State {
+        SkMatrix ctm;
+        SkRect clip;       // Device space.  Only meaningful when clipIsRect.
+        bool clipIsRect;   // Is the clip exactly clip, as far as we know?
+        bool isLayer;      // These two are only used on the save stack.
+        SkCanvas::SaveFlags flags;
+    };
+
+    struct Candidate {
+        unsigned index;
+        SkIRect bounds;
+        bool isSaveLayer;
+        SkCanvas::SaveFlags flags;  // If isSaveLayer.
+    };
+
+    void save(SkCanvas::SaveFlags flags, bool isLayer) {
+        State* saved = fSaveStack.push();
+        *saved = fState;
+        saved->isLayer = isLayer;
+        saved->flags = flags;
+        if (isLayer) {
+            fLayerDepth++;
+        }
+    }
+
+    void addCandidate(bool isSaveLayer, SkCanvas::SaveFlags flags) {
+        // Anything drawn inside a layer may be spread around the layer (e.g. by an image filter).
+        const SkIRect& bounds = fLayerDepth > 0 ? fLayerBounds : fBounds.getBounds(fIndex);
+        if (bounds.isEmpty()) {
+            return;  // Nothing to occlude.
+        }
+        Candidate* candidate = fCandidates.append();
+        candidate->index = fIndex;
+        candidate->bounds = bounds;
+        candidate->isSaveLayer = isSaveLayer;
+        candidate->flags = flags;
+    }
+
+    // No-op every candidate inside the pixels covered by a draw that's about to happen.
+    void occlude(const SkRect& covered) {
+        // Only pixels entirely inside covered are sure to be covered, even with anti-aliasing.
+        SkIRect pixels;
+        covered.roundIn(&pixels);
+        if (pixels.isEmpty()) {
+            return;
+        }
+        int live = 0;
+        for (int i = 0; i < fCandidates.count(); i++) {
+            const Candidate& candidate = fCandidates[i];
+            if (!pixels.contains(candidate.bounds)) {
+                fCandidates[live++] = candidate;
+            } else if (candidate.isSaveLayer) {
+                // Keep the Save so its Restore still has something to pair with.
+                SkNEW_PLACEMENT_ARGS(fRecord->replace<Save>(candidate.index), Save,
+                                     (candidate.flags));
+            } else {
+                fRecord->replace<NoOp>(candidate.index);
+            }
+        }
+        fCandidates.setCount(live);
+    }
+
+    // Sets covered to an area in device space that draw will cover with opaque pixels.
+    template <typename T> bool covers(const T&, SkRect*) const { return false; }
+
+    bool covers(const Clear&, SkRect* covered) const {
+        // Clear actually ignores the clip, but it's skipped entirely if the clip is empty,
+        // so we can only be sure of the pixels inside the clip.
+        *covered = fState.clip;
+        return fState.clipIsRect;
+    }
+    bool covers(const DrawPaint& draw, SkRect* covered) const {
+        *covered = fState.clip;
+        return fState.clipIsRect && SkRecordIsOpaquePaint(draw.paint);
+    }
+    bool covers(const DrawRect& draw, SkRect* covered) const {
+        return SkPaint::kFill_Style == draw.paint->getStyle()
+            && SkRecordIsOpaquePaint(draw.paint)
+            && this->coversRect(draw.rect, covered);
+    }
+    bool covers(const DrawBitmapRectToRect& draw, SkRect* covered) const {
+        const SkBitmap& bitmap = draw.bitmap;
+        if (!bitmap.isOpaque() || (NULL != draw.paint && (NULL != draw.paint->getShader() ||
+                                                          !SkRecordIsOpaquePaint(*draw.paint)))) {
+            return false;
+        }
+        // If src hangs off the bitmap, only part of dst is drawn.
+        if (NULL != draw.src &&
+            !SkRect::MakeWH(SkIntToScalar(bitmap.width()),
+                            SkIntToScalar(bitmap.height())).contains(*draw.src)) {
+            return false;
+        }
+        return this->coversRect(draw.dst, covered);
+    }
+
+    bool coversRect(const SkRect& rect, SkRect* covered) const {
+        if (!fState.clipIsRect || !fState.ctm.rectStaysRect()) {
+            return false;
+        }
+        fState.ctm.mapRect(covered, rect);
+        return covered->intersect(fState.clip);
+    }
+
+    SkRecord* fRecord;
+    const FillBounds fBounds;
+    unsigned fIndex;
+
+    State fState;
+    SkTDArray<State> fSaveStack;
+    int fLayerDepth;
+    SkIRect fLayerBounds;  // Bounds of the outermost open layer, if fLayerDepth > 0.
+
+    SkTDArray<Candidate> fCandidates;  // Draws that we could still no-op, in order.
+};
+
+const SkIRect OccludedDrawNooper::kUnbounded = { -(1 << 24), -(1 << 24), 1 << 24, 1 << 24 };
+
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    OccludedDrawNooper pass(record);
+    pass.apply();
+}
+
+// Merges runs of DrawRect commands with equal paints, with only NoOps between them, into DrawRects.
+// Like SkRecordNoopOccludedDraws, this needs to look across arbitrarily long runs comparing paints,
+// which doesn't fit the pattern framework, so it's a custom pass.
+class RectBatcher : SkNoncopyable {
+public:
+    explicit RectBatcher(SkRecord* record) : fRecord(record) {}
+
+    void apply() {
+        unsigned i = 0;
+        while (i < fRecord->count()) {
+            Is<DrawRect> first;
+            if (!fRecord->mutate<bool>(i, first)) {
+                i++;
+                continue;
+            }
+
+            // Find every DrawRect with an equal paint until the next command that's not a NoOp.
+            fRun.rewind();
+            *fRun.append() = i;
+            unsigned next = i + 1;
+            for (; next < fRecord->count(); next++) {
+                Is<NoOp> noop;
+                if (fRecord->mutate<bool>(next, noop)) {
+                    continue;
+                }
+                Is<DrawRect> draw;
+                if (!fRecord->mutate<bool>(next, draw) ||
+                    !(draw.get()->paint == first.get()->paint)) {
+                    break;
+                }
+                *fRun.append() = next;
+            }
+
+            if (fRun.count() > 1) {
+                this->batch(first.get());
+            }
+            i = next;
+        }
+    }
+
+private:
+    void batch(DrawRect* first) {
+        const unsigned count = fRun.count();
+        SkRect* rects = fRecord->alloc<SkRect>(count);
+        for (unsigned i = 0; i < count; i++) {
+            Is<DrawRect> draw;
+            SkAssertResult(fRecord->mutate<bool>(fRun[i], draw));
+            rects[i] = draw.get()->rect;
+        }
+
+        // Keep the first DrawRect alive until we've copied its paint into the DrawRects.
+        Adopted<DrawRect> adopted(first);
+        SkNEW_PLACEMENT_ARGS(fRecord->replace<DrawRects>(fRun[0], adopted),
+                             DrawRects, (first->paint, count, rects));
+        for (unsigned i = 1; i < count; i++) {
+            fRecord->replace<NoOp>(fRun[i]);
+        }
+    }
+
+    SkRecord* fRecord;
+    SkTDArray<unsigned> fRun;  // Indices of the DrawRects we're merging.
+};
+
+void SkRecordBatchDrawRects(SkRecord* record) {
+    RectBatcher pass(record);
+    pass.apply();
+}
+
 // Replaces PushCull with PairedPushCull, which lets us skip to the paired PopCull when the canvas
 // can quickReject the cull rect.
 // There's no efficient way (yet?) to express this one as a pattern, so we write a custom pass.
@@ -23,6 +23,10 @@ void SkRecordNoopSaveRestores(SkRecord*);
 // draw, and no-op the SaveLayer and Restore.
 void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 
+// No-ops draws whose pixels are all later covered by an opaque draw (Clear, DrawPaint, DrawRect or
+// DrawBitmapRectToRect) in the same layer under a simple rectangular clip.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
 // Annotates PushCull commands with the relative offset of their paired PopCull.
 void SkRecordAnnotateCullingPairs(SkRecord*);
 
@@ -32,4 +36,7 @@ void SkRecordReduceDrawPosTextStrength(SkRecord*);
 // Calculate min and max Y bounds for DrawPosTextH commands, for use with SkCanvas::quickRejectY.
 void SkRecordBoundDrawPosTextH(SkRecord*);
 
+// Merge runs of DrawRect commands with equal paints into single DrawRects commands.
+void SkRecordBatchDrawRects(SkRecord*);
+
 #endif//SkRecordOpts_DEFINED
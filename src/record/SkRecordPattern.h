@@ -36,35 +36,39 @@ private:
 class IsDraw {
     SK_CREATE_MEMBER_DETECTOR(paint);
 public:
-    IsDraw() : fPaint(NULL) {}
+    IsDraw() : fPaint(NULL), fShared(NULL) {}
 
-    typedef SkPaint type;
-    type* get() { return fPaint; }
+    typedef const SkPaint type;
+    type* get() { return NULL != fShared ? fShared->get() : fPaint; }
+
+    // Like get(), but safe to modify: a paint shared with other commands is copied first.
+    SkPaint* writable() { return NULL != fShared ? fShared->writable() : fPaint; }
 
     template <typename T>
     SK_WHEN(HasMember_paint<T>, bool) operator()(T* draw) {
-        fPaint = AsPtr(draw->paint);
+        this->set(draw->paint);
         return true;
     }
 
     template <typename T>
     SK_WHEN(!HasMember_paint<T>, bool) operator()(T*) {
-        fPaint = NULL;
+        this->set(NULL);
         return false;
     }
 
     // SaveLayer has an SkPaint named paint, but it's not a draw.
     bool operator()(SaveLayer*) {
-        fPaint = NULL;
+        this->set(NULL);
         return false;
     }
 
 private:
-    // Abstracts away whether the paint is always part of the command or optional.
-    template <typename T> static T* AsPtr(SkRecords::Optional<T>& x) { return x; }
-    template <typename T> static T* AsPtr(T& x) { return &x; }
+    // Abstracts away whether the paint is shared with other commands or optional.
+    void set(SkPaint* paint) { fPaint = paint; fShared = NULL; }
+    void set(SkRecords::Shared<SkPaint>& paint) { fPaint = NULL; fShared = &paint; }
 
-    type* fPaint;
+    SkPaint* fPaint;
+    SkRecords::Shared<SkPaint>* fShared;
 };
 
 // Matches if Matcher doesn't.  Stores nothing.
@@ -129,6 +133,9 @@ public:
     template <typename T> T* second() { return fTail.fHead.get(); }
     template <typename T> T* third()  { return fTail.fTail.fHead.get(); }
 
+    // For matchers like IsDraw that hand out read-only data, get a copy that's safe to modify.
+    template <typename T> T* writableSecond() { return fTail.fHead.writable(); }
+
 private:
     // If head isn't a Star, try to match at i once.
     template <typename T>
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRecordPool.h"
+
+#include "SkChecksum.h"
+
+SkRecordPool::~SkRecordPool() {
+    for (SkTDynamicHash<PaintBox, SkPaint, PaintTraits>::Iter it(&fPaints); !it.done(); ++it) {
+        (*it).unref();
+    }
+    for (SkTDynamicHash<SkPath, SkPath, PathTraits>::Iter it(&fPaths); !it.done(); ++it) {
+        SkDELETE(&*it);
+    }
+}
+
+// Hashes only fields operator== compares, so equal paints always hash equal.  Anything we leave
+// out just makes for more collisions, which operator== sorts out.
+uint32_t SkRecordPool::PaintTraits::Hash(const SkPaint& paint) {
+    struct {
+        const void* effects[9];
+        SkScalar scalars[5];
+        SkColor color;
+        uint32_t flags;
+        uint32_t enums;
+    } key;
+    sk_bzero(&key, sizeof(key));  // Don't hash padding.
+
+    key.effects[0] = paint.getTypeface();
+    key.effects[1] = paint.getPathEffect();
+    key.effects[2] = paint.getShader();
+    key.effects[3] = paint.getXfermode();
+    key.effects[4] = paint.getMaskFilter();
+    key.effects[5] = paint.getColorFilter();
+    key.effects[6] = paint.getRasterizer();
+    key.effects[7] = paint.getLooper();
+    key.effects[8] = paint.getImageFilter();
+    key.scalars[0] = paint.getTextSize();
+    key.scalars[1] = paint.getTextScaleX();
+    key.scalars[2] = paint.getTextSkewX();
+    key.scalars[3] = paint.getStrokeWidth();
+    key.scalars[4] = paint.getStrokeMiter();
+    key.color = paint.getColor();
+    key.flags = paint.getFlags();
+    key.enums = paint.getTextAlign()         <<  0
+              | paint.getStrokeCap()         <<  4
+              | paint.getStrokeJoin()        <<  8
+              | paint.getStyle()             << 12
+              | paint.getTextEncoding()      << 16
+              | paint.getHinting()           << 20
+              | paint.getFilterLevel()       << 24;
+
+    SK_COMPILE_ASSERT(SkIsAlign4(sizeof(key)), KeyMustBeWordAligned);
+    return SkChecksum::Compute(reinterpret_cast<const uint32_t*>(&key), sizeof(key));
+}
+
+// Reading every point would cost as much as just copying the path, so we hash a summary.
+uint32_t SkRecordPool::PathTraits::Hash(const SkPath& path) {
+    struct {
+        SkRect bounds;
+        int32_t points, verbs;
+        uint32_t fillType, segmentMasks;
+    } key;
+
+    key.bounds = path.getBounds();
+    key.points = path.countPoints();
+    key.verbs  = path.countVerbs();
+    key.fillType = path.getFillType();
+    key.segmentMasks = path.getSegmentMasks();
+
+    SK_COMPILE_ASSERT(SkIsAlign4(sizeof(key)), KeyMustBeWordAligned);
+    return SkChecksum::Compute(reinterpret_cast<const uint32_t*>(&key), sizeof(key));
+}
+
+SkRecordPool::PaintBox* SkRecordPool::paint(const SkPaint& paint) {
+    fPaintRequests++;
+    PaintBox* box = fPaints.find(paint);
+    if (NULL == box) {
+        box = SkNEW_ARGS(PaintBox, (paint));
+        fPaints.add(box);
+    }
+    return box;
+}
+
+const SkPath& SkRecordPool::path(const SkPath& path) {
+    fPathRequests++;
+    SkPath* pooled = fPaths.find(path);
+    if (NULL == pooled) {
+        pooled = SkNEW_ARGS(SkPath, (path));
+        fPaths.add(pooled);
+        // Each pooled path has its own SkPathRef for its points and verbs.  We don't count conic
+        // weights; there's at most one per verb, and few paths have any.
+        fPathBytes += sizeof(SkPath) + sizeof(SkPathRef)
+                    + path.countPoints() * sizeof(SkPoint)
+                    + path.countVerbs()  * sizeof(uint8_t);
+    }
+    return *pooled;
+}
+
+size_t SkRecordPool::bytesUsed() const {
+    return fPaints.count() * sizeof(PaintBox) + fPathBytes;
+}
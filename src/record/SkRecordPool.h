@@ -0,0 +1,63 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordPool_DEFINED
+#define SkRecordPool_DEFINED
+
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRecords.h"
+#include "SkTDynamicHash.h"
+
+// SkRecordPool interns the paints and paths SkRecorder records, so that commands drawing with equal
+// paints share one refcounted SkPaint, and equal paths share their points and verbs.  Like the
+// SkFlatDictionaries used by SkPictureRecord, but nothing is flattened: lookups hash the paint or
+// path with SkChecksum and confirm a match with operator==.
+//
+// One pool serves one SkRecord while it's being recorded.  Records keep their own refs on anything
+// they got from the pool, so the pool may be destroyed before the SkRecord.
+class SkRecordPool : SkNoncopyable {
+public:
+    typedef SkRecords::Shared<SkPaint>::Box PaintBox;
+
+    SkRecordPool() : fPaintRequests(0), fPathRequests(0), fPathBytes(0) {}
+    ~SkRecordPool();
+
+    // Returns a shared SkPaint equal to paint.  The pool holds a ref on it; take your own.
+    PaintBox* paint(const SkPaint& paint);
+
+    // Returns an SkPath equal to path which shares its storage with all other equal paths we've
+    // returned.  Copy it, don't hold onto the reference.
+    const SkPath& path(const SkPath& path);
+
+    // Number of distinct paints and paths in the pool, and how many times each was asked for.
+    int uniquePaintCount() const { return fPaints.count(); }
+    int uniquePathCount()  const { return fPaths.count(); }
+    int paintRequestCount() const { return fPaintRequests; }
+    int pathRequestCount()  const { return fPathRequests; }
+
+    // Approximate bytes used by the distinct paints and paths the pool has handed out, including
+    // the paths' points and verbs.
+    size_t bytesUsed() const;
+
+private:
+    struct PaintTraits {
+        static const SkPaint& GetKey(const PaintBox& box) { return box.fValue; }
+        static uint32_t Hash(const SkPaint&);
+    };
+    struct PathTraits {
+        static const SkPath& GetKey(const SkPath& path) { return path; }
+        static uint32_t Hash(const SkPath&);
+    };
+
+    SkTDynamicHash<PaintBox, SkPaint, PaintTraits> fPaints;  // We hold a ref on each.
+    SkTDynamicHash<SkPath, SkPath, PathTraits> fPaths;       // We own each.
+    int fPaintRequests, fPathRequests;
+    size_t fPathBytes;  // Pooled paths, with their points and verbs.
+};
+
+#endif//SkRecordPool_DEFINED
@@ -0,0 +1,1072 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRecordSerialization.h"
+
+#include "SkColorTable.h"
+#include "SkLazyPtr.h"
+#include "SkPicture.h"
+#include "SkPtrRecorder.h"
+#include "SkReadBuffer.h"
+#include "SkTSearch.h"
+#include "SkTypeface.h"
+#include "SkValidatingReadBuffer.h"
+#include "SkWriteBuffer.h"
+#include "SkWriter32.h"
+
+// Layout of a serialized SkRecord.  Everything is 4-byte aligned.
+//
+//   Header
+//   Op[opCount]                         One per command, indexed exactly like the SkRecord.
+//   payloads                            Each Op's arguments, pointed to by Op::offset.
+//   paint table, path table, bitmap table
+//   typefaces                           Needed to unflatten paints.
+//
+// A table is uint32_t offsets[count+1] followed by its entries' bytes.  Entry i spans
+// [offsets[i], offsets[i+1]), relative to the start of the table.  Commands refer to paints,
+// paths and bitmaps by index, with -1 meaning NULL for optional arguments.  Paints are flattened
+// for SkValidatingReadBuffer, naming their effects inline rather than indexing a factory table.
+//
+// Bump kVersion whenever any of this or any command's payload changes.
+
+static const uint32_t kMagic   = SkSetFourByteTag('s', 'k', 'r', 'c');
+static const uint32_t kVersion = 3;
+
+struct SkSerializedRecord::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t opCount,     opsOffset;
+    uint32_t paintCount,  paintsOffset;
+    uint32_t pathCount,   pathsOffset;
+    uint32_t bitmapCount, bitmapsOffset;
+    uint32_t typefacesOffset, typefacesSize;
+};
+
+struct SkSerializedRecord::Op {
+    uint32_t type, offset, size;
+};
+
+typedef SkSerializedRecord::Header Header;
+typedef SkSerializedRecord::Op Op;
+
+#define COUNT(T) + 1
+static const uint32_t kTypeCount = 0 SK_RECORD_TYPES(COUNT);
+#undef COUNT
+
+namespace {
+
+// Collects everything SkRecordSerialize writes, one command at a time.
+class Serializer : SkNoncopyable {
+public:
+    Serializer()
+        : fPaintBuffer(SkWriteBuffer::kCrossProcess_Flag | SkWriteBuffer::kValidation_Flag) {
+        fPaintBuffer.setTypefaceRecorder(&fTypefaces);
+    }
+
+    template <typename T>
+    void operator()(const T& r) {
+        Op* op = fOps.append();
+        op->type   = T::kType;
+        op->offset = SkToU32(fPayloads.bytesWritten());
+        this->write(r);
+        op->size   = SkToU32(fPayloads.bytesWritten()) - op->offset;
+    }
+
+    void writeTo(SkWStream*);
+
+private:
+    int32_t paint(const SkPaint* paint) {
+        if (NULL == paint) {
+            return -1;
+        }
+        *fPaintOffsets.append() = SkToU32(fPaintBuffer.bytesWritten());
+        fPaintBuffer.writePaint(*paint);
+        return fPaintOffsets.count() - 1;
+    }
+
+    int32_t path(const SkPath& path) {
+        *fPathOffsets.append() = SkToU32(fPaths.bytesWritten());
+        fPaths.writePath(path);
+        return fPathOffsets.count() - 1;
+    }
+
+    int32_t bitmap(const SkBitmap&);
+
+    void text(const void* text, size_t byteLength) {
+        fPayloads.write32(SkToU32(byteLength));
+        fPayloads.writePad(text, byteLength);
+    }
+
+    template <typename T>
+    void array(const T* values, int count) {
+        fPayloads.write32(count);
+        fPayloads.writePad(values, count * sizeof(T));
+    }
+
+    void write(const SkRecords::NoOp&) {}
+    void write(const SkRecords::Restore&) {}
+    void write(const SkRecords::PopCull&) {}
+    void write(const SkRecords::Save& r) { fPayloads.write32(r.flags); }
+    void write(const SkRecords::SaveLayer& r) {
+        fPayloads.writeBool(NULL != r.bounds);
+        if (NULL != r.bounds) {
+            fPayloads.writeRect(*r.bounds);
+        }
+        fPayloads.write32(this->paint(r.paint));
+        fPayloads.write32(r.flags);
+    }
+    void write(const SkRecords::PushCull& r) { fPayloads.writeRect(r.rect); }
+    void write(const SkRecords::PairedPushCull& r) {
+        this->write(*r.base);
+        fPayloads.write32(r.skip);
+    }
+    void write(const SkRecords::Concat& r)    { fPayloads.writeMatrix(r.matrix); }
+    void write(const SkRecords::SetMatrix& r) { fPayloads.writeMatrix(r.matrix); }
+    void write(const SkRecords::ClipPath& r) {
+        fPayloads.write32(this->path(r.path));
+        fPayloads.write32(r.op);
+        fPayloads.writeBool(r.doAA);
+    }
+    void write(const SkRecords::ClipRRect& r) {
+        fPayloads.writeRRect(r.rrect);
+        fPayloads.write32(r.op);
+        fPayloads.writeBool(r.doAA);
+    }
+    void write(const SkRecords::ClipRect& r) {
+        fPayloads.writeRect(r.rect);
+        fPayloads.write32(r.op);
+        fPayloads.writeBool(r.doAA);
+    }
+    void write(const SkRecords::ClipRegion& r) {
+        fPayloads.writeRegion(r.region);
+        fPayloads.write32(r.op);
+    }
+    void write(const SkRecords::Clear& r) { fPayloads.write32(r.color); }
+    void write(const SkRecords::DrawBitmap& r) {
+        fPayloads.write32(this->paint(r.paint));
+        fPayloads.write32(this->bitmap(r.bitmap));
+        fPayloads.writeScalar(r.left);
+        fPayloads.writeScalar(r.top);
+    }
+    void write(const SkRecords::DrawBitmapMatrix& r) {
+        fPayloads.write32(this->paint(r.paint));
+        fPayloads.write32(this->bitmap(r.bitmap));
+        fPayloads.writeMatrix(r.matrix);
+    }
+    void write(const SkRecords::DrawBitmapNine& r) {
+        fPayloads.write32(this->paint(r.paint));
+        fPayloads.write32(this->bitmap(r.bitmap));
+        fPayloads.writeIRect(r.center);
+        fPayloads.writeRect(r.dst);
+    }
+    void write(const SkRecords::DrawBitmapRectToRect& r) {
+        fPayloads.write32(this->paint(r.paint));
+        fPayloads.write32(this->bitmap(r.bitmap));
+        fPayloads.writeBool(NULL != r.src);
+        if (NULL != r.src) {
+            fPayloads.writeRect(*r.src);
+        }
+        fPayloads.writeRect(r.dst);
+        fPayloads.write32(r.flags);
+    }
+    void write(const SkRecords::DrawDRRect& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        fPayloads.writeRRect(r.outer);
+        fPayloads.writeRRect(r.inner);
+    }
+    void write(const SkRecords::DrawOval& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        fPayloads.writeRect(r.oval);
+    }
+    void write(const SkRecords::DrawPaint& r) { fPayloads.write32(this->paint(r.paint.get())); }
+    void write(const SkRecords::DrawPath& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        fPayloads.write32(this->path(r.path));
+    }
+    void write(const SkRecords::DrawPoints& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        fPayloads.write32(r.mode);
+        this->array(r.pts, SkToInt(r.count));
+    }
+    void write(const SkRecords::DrawPosText& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        this->text(r.text, r.byteLength);
+        this->array<SkPoint>(r.pos, r.paint->countText(r.text, r.byteLength));
+    }
+    void write(const SkRecords::DrawPosTextH& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        this->text(r.text, r.byteLength);
+        this->array<SkScalar>(r.xpos, r.paint->countText(r.text, r.byteLength));
+        fPayloads.writeScalar(r.y);
+    }
+    void write(const SkRecords::DrawRRect& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        fPayloads.writeRRect(r.rrect);
+    }
+    void write(const SkRecords::DrawRect& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        fPayloads.writeRect(r.rect);
+    }
+    void write(const SkRecords::DrawRects& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        this->array<SkRect>(r.rects, SkToInt(r.count));
+    }
+    void write(const SkRecords::DrawSprite& r) {
+        fPayloads.write32(this->paint(r.paint));
+        fPayloads.write32(this->bitmap(r.bitmap));
+        fPayloads.write32(r.left);
+        fPayloads.write32(r.top);
+    }
+    void write(const SkRecords::DrawText& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        this->text(r.text, r.byteLength);
+        fPayloads.writeScalar(r.x);
+        fPayloads.writeScalar(r.y);
+    }
+    void write(const SkRecords::DrawTextOnPath& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        this->text(r.text, r.byteLength);
+        fPayloads.write32(this->path(r.path));
+        fPayloads.writeBool(NULL != r.matrix);
+        if (NULL != r.matrix) {
+            fPayloads.writeMatrix(*r.matrix);
+        }
+    }
+    void write(const SkRecords::DrawVertices& r) {
+        fPayloads.write32(this->paint(r.paint.get()));
+        // We smuggle the xfermode through the paint table, which already knows how to flatten it.
+        SkPaint xmode;
+        xmode.setXfermode(r.xmode.get());
+        fPayloads.write32(this->paint(NULL != r.xmode.get() ? &xmode : NULL));
+        fPayloads.write32(r.vmode);
+        this->array<SkPoint>(r.vertices, r.vertexCount);
+        this->array<SkPoint>(r.texs, NULL != r.texs ? r.vertexCount : 0);
+        this->array<SkColor>(r.colors, NULL != r.colors ? r.vertexCount : 0);
+        this->array<uint16_t>(r.indices, NULL != r.indices ? r.indexCount : 0);
+    }
+    void write(const SkRecords::BoundedDrawPosTextH& r) {
+        fPayloads.writeScalar(r.minY);
+        fPayloads.writeScalar(r.maxY);
+        this->write(*r.base);
+    }
+
+    // Bitmaps are often drawn many times, so we write each distinct one only once.
+    struct BitmapKey {
+        uint32_t genID;
+        int32_t x, y, width, height;
+        int32_t index;
+
+        static bool Less(const BitmapKey& a, const BitmapKey& b) {
+            return memcmp(&a, &b, offsetof(BitmapKey, index)) < 0;
+        }
+    };
+
+    SkTDArray<Op> fOps;
+    SkWriter32 fPayloads;
+
+    SkRefCntSet fTypefaces;
+    SkWriteBuffer fPaintBuffer;
+    SkTDArray<uint32_t> fPaintOffsets;
+
+    SkWriter32 fPaths;
+    SkTDArray<uint32_t> fPathOffsets;
+
+    SkWriter32 fBitmaps;
+    SkTDArray<uint32_t> fBitmapOffsets;
+    SkTDArray<BitmapKey> fBitmapKeys;  // Sorted by BitmapKey::Less.
+};
+
+int32_t Serializer::bitmap(const SkBitmap& bitmap) {
+    BitmapKey key;
+    memset(&key, 0, sizeof(key));  // We memcmp keys, so zero any padding.
+    key.genID  = bitmap.getGenerationID();
+    key.x      = bitmap.pixelRefOrigin().fX;
+    key.y      = bitmap.pixelRefOrigin().fY;
+    key.width  = bitmap.width();
+    key.height = bitmap.height();
+
+    int slot = SkTSearch<BitmapKey, BitmapKey::Less>(fBitmapKeys.begin(), fBitmapKeys.count(),
+                                                     key, sizeof(BitmapKey));
+    if (slot >= 0) {
+        return fBitmapKeys[slot].index;
+    }
+    key.index = fBitmapOffsets.count();
+    *fBitmapKeys.insert(~slot) = key;
+    *fBitmapOffsets.append() = SkToU32(fBitmaps.bytesWritten());
+
+    // Each bitmap is written as its SkImageInfo, rowBytes, its color table if it has one, and
+    // then tightly packed rows of pixels.  A bitmap that can't produce pixels is written empty.
+    SkAutoLockPixels lock(bitmap);
+    const bool hasPixels = NULL != bitmap.getPixels() &&
+                           (kIndex_8_SkColorType != bitmap.colorType() ||
+                            NULL != bitmap.getColorTable());
+    const SkImageInfo info = hasPixels ? bitmap.info() : SkImageInfo::MakeUnknown(0, 0);
+    const size_t rowBytes = info.minRowBytes();
+
+    fBitmaps.write32(info.fWidth);
+    fBitmaps.write32(info.fHeight);
+    fBitmaps.write32(info.fColorType);
+    fBitmaps.write32(info.fAlphaType);
+    fBitmaps.write32(SkToU32(rowBytes));
+
+    SkColorTable* ctable = hasPixels ? bitmap.getColorTable() : NULL;
+    if (NULL != ctable) {
+        fBitmaps.write32(ctable->count());
+        fBitmaps.write(ctable->lockColors(), ctable->count() * sizeof(SkPMColor));
+        ctable->unlockColors();
+    } else {
+        fBitmaps.write32(0);
+    }
+
+    char* dst = (char*)fBitmaps.reservePad(info.getSafeSize(rowBytes));
+    for (int y = 0; y < info.fHeight; y++) {
+        memcpy(dst + y * rowBytes, bitmap.getAddr(0, y), rowBytes);
+    }
+    return key.index;
+}
+
+// Writes a table of count entries whose bytes are in data, with entry i starting at offsets[i].
+static size_t write_table(SkWStream* stream,
+                          const SkTDArray<uint32_t>& offsets, size_t dataSize,
+                          const void* data) {
+    const uint32_t headerSize = SkToU32((offsets.count() + 1) * sizeof(uint32_t));
+    for (int i = 0; i < offsets.count(); i++) {
+        stream->write32(headerSize + offsets[i]);
+    }
+    stream->write32(SkToU32(headerSize + dataSize));
+    stream->write(data, dataSize);
+    return headerSize + dataSize;
+}
+
+static size_t table_size(const SkTDArray<uint32_t>& offsets, size_t dataSize) {
+    return (offsets.count() + 1) * sizeof(uint32_t) + dataSize;
+}
+
+static void pad_to_4(SkWStream* stream, size_t size) {
+    static const char kZeros[4] = { 0, 0, 0, 0 };
+    stream->write(kZeros, SkAlign4(size) - size);
+}
+
+void Serializer::writeTo(SkWStream* stream) {
+    SkDynamicMemoryWStream typefaces;
+    {
+        SkAutoTMalloc<SkTypeface*> array(fTypefaces.count());
+        fTypefaces.copyToArray((SkRefCnt**)array.get());
+        typefaces.write32(fTypefaces.count());
+        for (int i = 0; i < fTypefaces.count(); i++) {
+            array[i]->serialize(&typefaces);
+        }
+    }
+
+    SkAutoMalloc paints(fPaintBuffer.bytesWritten());
+    fPaintBuffer.writeToMemory(paints.get());
+
+    Header header;
+    header.magic           = kMagic;
+    header.version         = kVersion;
+    header.opCount         = fOps.count();
+    header.opsOffset       = sizeof(Header);
+    const uint32_t payloadsOffset = SkToU32(header.opsOffset + fOps.count() * sizeof(Op));
+    header.paintCount      = fPaintOffsets.count();
+    header.paintsOffset    = SkToU32(payloadsOffset + fPayloads.bytesWritten());
+    header.pathCount       = fPathOffsets.count();
+    header.pathsOffset     = SkToU32(header.paintsOffset +
+                                     table_size(fPaintOffsets, fPaintBuffer.bytesWritten()));
+    header.bitmapCount     = fBitmapOffsets.count();
+    header.bitmapsOffset   = SkToU32(header.pathsOffset +
+                                     table_size(fPathOffsets, fPaths.bytesWritten()));
+    header.typefacesOffset = SkToU32(header.bitmapsOffset +
+                                     table_size(fBitmapOffsets, fBitmaps.bytesWritten()));
+    header.typefacesSize   = SkToU32(typefaces.bytesWritten());
+
+    stream->write(&header, sizeof(header));
+    for (int i = 0; i < fOps.count(); i++) {
+        Op op = fOps[i];
+        op.offset += payloadsOffset;
+        stream->write(&op, sizeof(op));
+    }
+    fPayloads.writeToStream(stream);
+    write_table(stream, fPaintOffsets, fPaintBuffer.bytesWritten(), paints.get());
+    write_table(stream, fPathOffsets, fPaths.bytesWritten(), fPaths.contiguousArray());
+    write_table(stream, fBitmapOffsets, fBitmaps.bytesWritten(), fBitmaps.contiguousArray());
+    SkAutoTUnref<SkData> typefaceData(typefaces.copyToData());
+    stream->write(typefaceData->data(), typefaceData->size());
+    pad_to_4(stream, typefaceData->size());
+}
+
+}  // namespace
+
+void SkRecordSerialize(const SkRecord& record, SkWStream* stream) {
+    Serializer serializer;
+    for (unsigned i = 0; i < record.count(); i++) {
+        record.visit<void>(i, serializer);
+    }
+    serializer.writeTo(stream);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Reads an Op's payload in place, checking every read stays inside it.
+// Once any read fails, all further reads fail too, and ok() returns false.
+class Cursor {
+public:
+    Cursor(const void* data, size_t size) : fPtr((const char*)data), fRemaining(size) {}
+
+    bool ok() const { return NULL != fPtr; }
+
+    // Returns a pointer to count Ts, or NULL if there aren't that many left.
+    template <typename T>
+    const T* skip(size_t count = 1) {
+        if (NULL == fPtr || count > fRemaining / sizeof(T)) {
+            return this->fail<T>();
+        }
+        const size_t bytes = SkAlign4(count * sizeof(T));
+        if (bytes > fRemaining) {
+            return this->fail<T>();
+        }
+        const T* ptr = (const T*)fPtr;
+        fPtr += bytes;
+        fRemaining -= bytes;
+        return ptr;
+    }
+
+    // Reads one T, or returns 0 on failure.
+    template <typename T>
+    T read() {
+        const T* ptr = this->skip<T>();
+        return NULL != ptr ? *ptr : T(0);
+    }
+
+    bool readBool() { return 0 != this->read<uint32_t>(); }
+
+    // Reads an enum, failing if it's past last.
+    template <typename T>
+    T readEnum(T last) {
+        const uint32_t value = this->read<uint32_t>();
+        if (value > (uint32_t)last) {
+            this->fail<void>();
+            return (T)0;
+        }
+        return (T)value;
+    }
+
+    // Reads a set of flags, failing if any outside mask are set.
+    template <typename T>
+    T readFlags(uint32_t mask) {
+        const uint32_t value = this->read<uint32_t>();
+        if (value & ~mask) {
+            this->fail<void>();
+            return (T)0;
+        }
+        return (T)value;
+    }
+
+    // Reads a length-prefixed array, leaving its length in count.
+    template <typename T>
+    const T* readArray(int* count) {
+        *count = this->read<int32_t>();
+        return *count >= 0 ? this->skip<T>(*count) : this->fail<T>();
+    }
+
+    // Reads an SkMatrix, SkRRect or SkRegion written by SkWriter32.
+    template <typename T>
+    void readFlat(T* obj) {
+        const size_t size = NULL != fPtr ? obj->readFromMemory(fPtr, fRemaining) : 0;
+        if (0 == size || SkAlign4(size) > fRemaining) {
+            this->fail<void>();
+            return;
+        }
+        fPtr += SkAlign4(size);
+        fRemaining -= SkAlign4(size);
+    }
+
+    template <typename T>
+    const T* fail() {
+        fPtr = NULL;
+        fRemaining = 0;
+        return NULL;
+    }
+
+private:
+    const char* fPtr;
+    size_t fRemaining;
+};
+
+}  // namespace
+
+// The typefaces we need to unflatten any paint.
+struct SkSerializedRecord::Flattenables {
+    ~Flattenables() {
+        for (int i = 0; i < typefaces.count(); i++) {
+            typefaces[i]->unref();
+        }
+    }
+    SkTDArray<SkTypeface*> typefaces;
+};
+
+static SkSerializedRecord::Flattenables* create_flattenables(const void* base,
+                                                             const Header& header) {
+    SkSerializedRecord::Flattenables* flattenables = SkNEW(SkSerializedRecord::Flattenables);
+
+    SkMemoryStream typefaces((const char*)base + header.typefacesOffset, header.typefacesSize);
+    const uint32_t typefaceCount = typefaces.readU32();
+    for (uint32_t i = 0; i < typefaceCount && !typefaces.isAtEnd(); i++) {
+        SkTypeface* typeface = SkTypeface::Deserialize(&typefaces);
+        *flattenables->typefaces.append() = NULL != typeface ? typeface : SkTypeface::RefDefault();
+    }
+    return flattenables;
+}
+
+SkSerializedRecord* SkSerializedRecord::Create(SkData* data) {
+    if (NULL == data || data->size() < sizeof(Header) || !SkIsAlign4((uintptr_t)data->data())) {
+        return NULL;
+    }
+    const size_t size = data->size();
+    const Header& header = *(const Header*)data->data();
+    if (header.magic != kMagic || header.version != kVersion) {
+        return NULL;
+    }
+
+    // Make sure every section we might read from is in bounds.  (64-bit math to avoid overflow.)
+    const uint64_t sections[][2] = {
+        { header.opsOffset,       (uint64_t)header.opCount     * sizeof(Op)       },
+        { header.paintsOffset,    (header.paintCount  + 1ull) * sizeof(uint32_t)  },
+        { header.pathsOffset,     (header.pathCount   + 1ull) * sizeof(uint32_t)  },
+        { header.bitmapsOffset,   (header.bitmapCount + 1ull) * sizeof(uint32_t)  },
+        { header.typefacesOffset, header.typefacesSize                           },
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(sections); i++) {
+        if (!SkIsAlign4(sections[i][0]) || sections[i][0] + sections[i][1] > size) {
+            return NULL;
+        }
+    }
+
+    // The op table is small compared to the payloads it points to, so we check it all up front.
+    // That lets draw() trust every Op's type and payload bounds.
+    const Op* ops = (const Op*)(data->bytes() + header.opsOffset);
+    for (uint32_t i = 0; i < header.opCount; i++) {
+        if (ops[i].type >= kTypeCount ||
+            !SkIsAlign4(ops[i].offset) ||
+            (uint64_t)ops[i].offset + ops[i].size > size) {
+            return NULL;
+        }
+    }
+    return SkNEW_ARGS(SkSerializedRecord, (data));
+}
+
+SkSerializedRecord::SkSerializedRecord(SkData* data)
+    : fData(SkRef(data))
+    , fHeader((const Header*)data->data())
+    , fOps((const Op*)(data->bytes() + fHeader->opsOffset))
+    , fPaints(fHeader->paintCount)
+    , fPaths(fHeader->pathCount)
+    , fBitmaps(fHeader->bitmapCount)
+    , fFlattenables(NULL) {
+    sk_bzero(fPaints.get(),  fHeader->paintCount  * sizeof(void*));
+    sk_bzero(fPaths.get(),   fHeader->pathCount   * sizeof(void*));
+    sk_bzero(fBitmaps.get(), fHeader->bitmapCount * sizeof(void*));
+}
+
+SkSerializedRecord::~SkSerializedRecord() {
+    for (uint32_t i = 0; i < fHeader->paintCount; i++) {
+        SkDELETE((SkPaint*)fPaints[i]);
+    }
+    for (uint32_t i = 0; i < fHeader->pathCount; i++) {
+        SkDELETE((SkPath*)fPaths[i]);
+    }
+    for (uint32_t i = 0; i < fHeader->bitmapCount; i++) {
+        SkDELETE((SkBitmap*)fBitmaps[i]);
+    }
+    SkDELETE((Flattenables*)fFlattenables);
+}
+
+unsigned SkSerializedRecord::count() const { return fHeader->opCount; }
+
+void SkSerializedRecord::serialize(SkWStream* stream) const {
+    stream->write(fData->data(), fData->size());
+}
+
+const void* SkSerializedRecord::tableEntry(uint32_t tableOffset, uint32_t count, int index,
+                                           size_t* size) const {
+    if (index < 0 || (uint32_t)index >= count) {
+        return NULL;
+    }
+    const uint32_t* offsets = (const uint32_t*)(fData->bytes() + tableOffset);
+    const uint32_t start = offsets[index], stop = offsets[index + 1];
+    if (start > stop || !SkIsAlign4(start) || (uint64_t)tableOffset + stop > fData->size()) {
+        return NULL;
+    }
+    *size = stop - start;
+    return fData->bytes() + tableOffset + start;
+}
+
+const SkSerializedRecord::Flattenables* SkSerializedRecord::flattenables() const {
+    Flattenables* ptr = (Flattenables*)sk_acquire_load(&fFlattenables);
+    return ptr ? ptr : Private::try_cas<Flattenables*, Private::sk_delete<Flattenables> >(
+            &fFlattenables, create_flattenables(fData->data(), *fHeader));
+}
+
+const SkPaint* SkSerializedRecord::paint(int index) const {
+    size_t size;
+    const void* bytes = this->tableEntry(fHeader->paintsOffset, fHeader->paintCount, index, &size);
+    if (NULL == bytes) {
+        return NULL;
+    }
+    SkPaint* ptr = (SkPaint*)sk_acquire_load(&fPaints[index]);
+    if (NULL == ptr) {
+        const Flattenables* flattenables = this->flattenables();
+        SkValidatingReadBuffer buffer(bytes, size);
+        buffer.setFlags(SkReadBuffer::kCrossProcess_Flag | SkReadBuffer::kValidation_Flag);
+        buffer.setTypefaceArray(const_cast<SkTypeface**>(flattenables->typefaces.begin()),
+                                flattenables->typefaces.count());
+        ptr = SkNEW(SkPaint);
+        buffer.readPaint(ptr);
+        if (!buffer.isValid()) {
+            // Don't cache a bad paint; commands using it are skipped.
+            SkDELETE(ptr);
+            return NULL;
+        }
+        ptr = Private::try_cas<SkPaint*, Private::sk_delete<SkPaint> >(&fPaints[index], ptr);
+    }
+    return ptr;
+}
+
+const SkPath* SkSerializedRecord::path(int index) const {
+    size_t size;
+    const void* bytes = this->tableEntry(fHeader->pathsOffset, fHeader->pathCount, index, &size);
+    if (NULL == bytes) {
+        return NULL;
+    }
+    SkPath* ptr = (SkPath*)sk_acquire_load(&fPaths[index]);
+    if (NULL == ptr) {
+        ptr = SkNEW(SkPath);
+        if (0 == ptr->readFromMemory(bytes, size)) {
+            ptr->reset();
+        }
+        ptr = Private::try_cas<SkPath*, Private::sk_delete<SkPath> >(&fPaths[index], ptr);
+    }
+    return ptr;
+}
+
+static void unref_data(void*, void* data) { ((SkData*)data)->unref(); }
+
+const SkBitmap* SkSerializedRecord::bitmap(int index) const {
+    size_t size;
+    const void* bytes =
+        this->tableEntry(fHeader->bitmapsOffset, fHeader->bitmapCount, index, &size);
+    if (NULL == bytes) {
+        return NULL;
+    }
+    SkBitmap* ptr = (SkBitmap*)sk_acquire_load(&fBitmaps[index]);
+    if (NULL == ptr) {
+        ptr = SkNEW(SkBitmap);
+
+        Cursor cursor(bytes, size);
+        const int width     = cursor.read<int32_t>();
+        const int height    = cursor.read<int32_t>();
+        const int colorType = cursor.read<int32_t>();
+        const int alphaType = cursor.read<int32_t>();
+        const size_t rowBytes = cursor.read<uint32_t>();
+        int ctCount;
+        const SkPMColor* colors = cursor.readArray<SkPMColor>(&ctCount);
+
+        if (cursor.ok() &&
+            colorType >= 0 && SkColorTypeIsValid(colorType) &&
+            alphaType >= 0 && SkAlphaTypeIsValid(alphaType)) {
+            const SkImageInfo info = SkImageInfo::Make(width, height,
+                                                       (SkColorType)colorType,
+                                                       (SkAlphaType)alphaType);
+            const void* pixels = info.validRowBytes(rowBytes)
+                               ? cursor.skip<char>(info.getSafeSize(rowBytes))
+                               : NULL;
+            // Index8 pixels may hold any index, so pad their table out to all 256 colors.
+            SkAutoTUnref<SkColorTable> ctable;
+            if (kIndex_8_SkColorType == info.fColorType && ctCount > 0 && ctCount <= 256) {
+                SkPMColor padded[256];
+                memcpy(padded, colors, ctCount * sizeof(SkPMColor));
+                sk_bzero(padded + ctCount, (256 - ctCount) * sizeof(SkPMColor));
+                ctable.reset(SkNEW_ARGS(SkColorTable, (padded, 256, info.fAlphaType)));
+            }
+            if (NULL != pixels && info.fWidth > 0 && info.fHeight > 0 &&
+                (kIndex_8_SkColorType != info.fColorType || NULL != ctable.get())) {
+                // The pixels stay in our data, which the bitmap keeps alive with a ref.
+                fData.get()->ref();
+                if (ptr->installPixels(info, const_cast<void*>(pixels), rowBytes, ctable,
+                                       unref_data, fData.get())) {
+                    ptr->setImmutable();
+                } else {
+                    fData.get()->unref();
+                }
+            }
+        }
+        ptr = Private::try_cas<SkBitmap*, Private::sk_delete<SkBitmap> >(&fBitmaps[index], ptr);
+    }
+    return ptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Plays back one Op at a time, mirroring SkRecords::Draw.
+class SkSerializedRecord::Player {
+public:
+    Player(const SkSerializedRecord& record, SkCanvas* canvas, SkPlaybackProfiler* profiler)
+        : fRecord(record)
+        , fCanvas(canvas)
+        , fProfiler(profiler)
+        , fInitialCTM(canvas->getTotalMatrix()) {}
+
+    void draw() {
+        const unsigned count = fRecord.count();
+        for (fIndex = 0; fIndex < count; fIndex++) {
+            const Op& op = fRecord.fOps[fIndex];
+            Cursor cursor(fRecord.fData->bytes() + op.offset, op.size);
+            if (NULL != fProfiler) {
+                const SkRecords::Type type = (SkRecords::Type)op.type;
+                fProfiler->beginOp(fIndex, type, SkRecords::TypeName(type));
+                this->draw(op.type, &cursor);
+                fProfiler->endOp();
+                continue;
+            }
+            this->draw(op.type, &cursor);
+        }
+    }
+
+private:
+    // These return NULL on failure, in which case the command is skipped.
+    const SkPaint* paint(Cursor* c) {
+        const int index = c->read<int32_t>();
+        const SkPaint* paint = fRecord.paint(index);
+        return NULL != paint || !c->ok() ? paint : c->fail<SkPaint>();
+    }
+    const SkPaint* optionalPaint(Cursor* c) {
+        const int index = c->read<int32_t>();
+        if (-1 == index) {
+            return NULL;
+        }
+        const SkPaint* paint = fRecord.paint(index);
+        return NULL != paint || !c->ok() ? paint : c->fail<SkPaint>();
+    }
+    const SkPath* path(Cursor* c) {
+        const SkPath* path = fRecord.path(c->read<int32_t>());
+        return NULL != path || !c->ok() ? path : c->fail<SkPath>();
+    }
+    const SkBitmap* bitmap(Cursor* c) {
+        const SkBitmap* bitmap = fRecord.bitmap(c->read<int32_t>());
+        return NULL != bitmap || !c->ok() ? bitmap : c->fail<SkBitmap>();
+    }
+    template <typename T>
+    const T* optional(Cursor* c) {
+        return c->readBool() ? c->skip<T>() : NULL;
+    }
+
+    // Text and its positions, checked against each other so the canvas never reads past the end.
+    template <typename T>
+    bool posText(Cursor* c, const SkPaint& paint,
+                 const char** text, size_t* byteLength, const T** pos) {
+        *byteLength = c->read<uint32_t>();
+        *text = c->skip<char>(*byteLength);
+        int count;
+        *pos = c->readArray<T>(&count);
+        return c->ok() && paint.countText(*text, *byteLength) <= count;
+    }
+
+    void draw(uint32_t type, Cursor* c);
+
+    const SkSerializedRecord& fRecord;
+    SkCanvas* fCanvas;
+    SkPlaybackProfiler* fProfiler;
+    const SkMatrix fInitialCTM;
+    unsigned fIndex;
+};
+
+void SkSerializedRecord::Player::draw(uint32_t type, Cursor* c) {
+    switch ((SkRecords::Type)type) {
+        case SkRecords::NoOp_Type: return;
+        case SkRecords::Restore_Type: fCanvas->restore(); return;
+        case SkRecords::PopCull_Type: fCanvas->popCull(); return;
+        case SkRecords::Save_Type: {
+            const SkCanvas::SaveFlags flags =
+                c->readFlags<SkCanvas::SaveFlags>(SkCanvas::kARGB_ClipLayer_SaveFlag);
+            // Like SaveLayer, we must always save to keep the save/restore balance.
+            fCanvas->save(flags);
+        } return;
+        case SkRecords::SaveLayer_Type: {
+            const SkRect* bounds = this->optional<SkRect>(c);
+            const SkPaint* paint = this->optionalPaint(c);
+            const SkCanvas::SaveFlags flags =
+                c->readFlags<SkCanvas::SaveFlags>(SkCanvas::kARGB_ClipLayer_SaveFlag);
+            // We must always save to keep the save/restore balance, even if the args are bad.
+            fCanvas->saveLayer(c->ok() ? bounds : NULL, c->ok() ? paint : NULL, flags);
+        } return;
+        case SkRecords::PushCull_Type: {
+            const SkRect* rect = c->skip<SkRect>();
+            if (c->ok()) {
+                fCanvas->pushCull(*rect);
+            }
+        } return;
+        case SkRecords::PairedPushCull_Type: {
+            const SkRect* rect = c->skip<SkRect>();
+            const uint32_t skip = c->read<uint32_t>();
+            if (!c->ok()) {
+                return;
+            }
+            if (fCanvas->quickReject(*rect) && skip < fRecord.count() - fIndex) {
+                fIndex += skip;
+                return;
+            }
+            fCanvas->pushCull(*rect);
+        } return;
+        case SkRecords::Concat_Type:
+        case SkRecords::SetMatrix_Type: {
+            SkMatrix matrix;
+            c->readFlat(&matrix);
+            if (!c->ok()) {
+                return;
+            }
+            if (SkRecords::Concat_Type == type) {
+                fCanvas->concat(matrix);
+            } else {
+                fCanvas->setMatrix(SkMatrix::Concat(fInitialCTM, matrix));
+            }
+        } return;
+        case SkRecords::ClipPath_Type: {
+            const SkPath* path = this->path(c);
+            const SkRegion::Op op = c->readEnum(SkRegion::kReplace_Op);
+            const bool doAA = c->readBool();
+            if (c->ok()) {
+                fCanvas->clipPath(*path, op, doAA);
+            }
+        } return;
+        case SkRecords::ClipRRect_Type: {
+            SkRRect rrect;
+            c->readFlat(&rrect);
+            const SkRegion::Op op = c->readEnum(SkRegion::kReplace_Op);
+            const bool doAA = c->readBool();
+            if (c->ok()) {
+                fCanvas->clipRRect(rrect, op, doAA);
+            }
+        } return;
+        case SkRecords::ClipRect_Type: {
+            const SkRect* rect = c->skip<SkRect>();
+            const SkRegion::Op op = c->readEnum(SkRegion::kReplace_Op);
+            const bool doAA = c->readBool();
+            if (c->ok()) {
+                fCanvas->clipRect(*rect, op, doAA);
+            }
+        } return;
+        case SkRecords::ClipRegion_Type: {
+            SkRegion region;
+            c->readFlat(&region);
+            const SkRegion::Op op = c->readEnum(SkRegion::kReplace_Op);
+            if (c->ok()) {
+                fCanvas->clipRegion(region, op);
+            }
+        } return;
+        case SkRecords::Clear_Type: {
+            const SkColor color = c->read<SkColor>();
+            if (c->ok()) {
+                fCanvas->clear(color);
+            }
+        } return;
+        case SkRecords::DrawBitmap_Type: {
+            const SkPaint* paint = this->optionalPaint(c);
+            const SkBitmap* bitmap = this->bitmap(c);
+            const SkScalar left = c->read<SkScalar>();
+            const SkScalar top  = c->read<SkScalar>();
+            if (c->ok()) {
+                fCanvas->drawBitmap(*bitmap, left, top, paint);
+            }
+        } return;
+        case SkRecords::DrawBitmapMatrix_Type: {
+            const SkPaint* paint = this->optionalPaint(c);
+            const SkBitmap* bitmap = this->bitmap(c);
+            SkMatrix matrix;
+            c->readFlat(&matrix);
+            if (c->ok()) {
+                fCanvas->drawBitmapMatrix(*bitmap, matrix, paint);
+            }
+        } return;
+        case SkRecords::DrawBitmapNine_Type: {
+            const SkPaint* paint = this->optionalPaint(c);
+            const SkBitmap* bitmap = this->bitmap(c);
+            const SkIRect* center = c->skip<SkIRect>();
+            const SkRect* dst = c->skip<SkRect>();
+            if (c->ok()) {
+                fCanvas->drawBitmapNine(*bitmap, *center, *dst, paint);
+            }
+        } return;
+        case SkRecords::DrawBitmapRectToRect_Type: {
+            const SkPaint* paint = this->optionalPaint(c);
+            const SkBitmap* bitmap = this->bitmap(c);
+            const SkRect* src = this->optional<SkRect>(c);
+            const SkRect* dst = c->skip<SkRect>();
+            const SkCanvas::DrawBitmapRectFlags flags =
+                c->readFlags<SkCanvas::DrawBitmapRectFlags>(SkCanvas::kBleed_DrawBitmapRectFlag);
+            if (c->ok()) {
+                fCanvas->drawBitmapRectToRect(*bitmap, src, *dst, paint, flags);
+            }
+        } return;
+        case SkRecords::DrawDRRect_Type: {
+            const SkPaint* paint = this->paint(c);
+            SkRRect outer, inner;
+            c->readFlat(&outer);
+            c->readFlat(&inner);
+            if (c->ok()) {
+                fCanvas->drawDRRect(outer, inner, *paint);
+            }
+        } return;
+        case SkRecords::DrawOval_Type: {
+            const SkPaint* paint = this->paint(c);
+            const SkRect* oval = c->skip<SkRect>();
+            if (c->ok()) {
+                fCanvas->drawOval(*oval, *paint);
+            }
+        } return;
+        case SkRecords::DrawPaint_Type: {
+            const SkPaint* paint = this->paint(c);
+            if (c->ok()) {
+                fCanvas->drawPaint(*paint);
+            }
+        } return;
+        case SkRecords::DrawPath_Type: {
+            const SkPaint* paint = this->paint(c);
+            const SkPath* path = this->path(c);
+            if (c->ok()) {
+                fCanvas->drawPath(*path, *paint);
+            }
+        } return;
+        case SkRecords::DrawPoints_Type: {
+            const SkPaint* paint = this->paint(c);
+            const SkCanvas::PointMode mode = c->readEnum(SkCanvas::kPolygon_PointMode);
+            int count;
+            const SkPoint* pts = c->readArray<SkPoint>(&count);
+            if (c->ok()) {
+                fCanvas->drawPoints(mode, count, pts, *paint);
+            }
+        } return;
+        case SkRecords::DrawPosText_Type: {
+            const SkPaint* paint = this->paint(c);
+            const char* text;
+            size_t byteLength;
+            const SkPoint* pos;
+            if (c->ok() && this->posText(c, *paint, &text, &byteLength, &pos)) {
+                fCanvas->drawPosText(text, byteLength, pos, *paint);
+            }
+        } return;
+        case SkRecords::BoundedDrawPosTextH_Type: {
+            const SkScalar minY = c->read<SkScalar>();
+            const SkScalar maxY = c->read<SkScalar>();
+            if (!c->ok() || fCanvas->quickRejectY(minY, maxY)) {
+                return;
+            }
+        }   // Fall through to draw the DrawPosTextH that follows.
+        case SkRecords::DrawPosTextH_Type: {
+            const SkPaint* paint = this->paint(c);
+            const char* text;
+            size_t byteLength;
+            const SkScalar* xpos;
+            if (c->ok() && this->posText(c, *paint, &text, &byteLength, &xpos)) {
+                const SkScalar y = c->read<SkScalar>();
+                if (c->ok()) {
+                    fCanvas->drawPosTextH(text, byteLength, xpos, y, *paint);
+                }
+            }
+        } return;
+        case SkRecords::DrawRRect_Type: {
+            const SkPaint* paint = this->paint(c);
+            SkRRect rrect;
+            c->readFlat(&rrect);
+            if (c->ok()) {
+                fCanvas->drawRRect(rrect, *paint);
+            }
+        } return;
+        case SkRecords::DrawRect_Type: {
+            const SkPaint* paint = this->paint(c);
+            const SkRect* rect = c->skip<SkRect>();
+            if (c->ok()) {
+                fCanvas->drawRect(*rect, *paint);
+            }
+        } return;
+        case SkRecords::DrawRects_Type: {
+            const SkPaint* paint = this->paint(c);
+            int count;
+            const SkRect* rects = c->readArray<SkRect>(&count);
+            if (c->ok()) {
+                for (int i = 0; i < count; i++) {
+                    fCanvas->drawRect(rects[i], *paint);
+                }
+            }
+        } return;
+        case SkRecords::DrawSprite_Type: {
+            const SkPaint* paint = this->optionalPaint(c);
+            const SkBitmap* bitmap = this->bitmap(c);
+            const int left = c->read<int32_t>();
+            const int top  = c->read<int32_t>();
+            if (c->ok()) {
+                fCanvas->drawSprite(*bitmap, left, top, paint);
+            }
+        } return;
+        case SkRecords::DrawText_Type: {
+            const SkPaint* paint = this->paint(c);
+            const size_t byteLength = c->read<uint32_t>();
+            const char* text = c->skip<char>(byteLength);
+            const SkScalar x = c->read<SkScalar>();
+            const SkScalar y = c->read<SkScalar>();
+            if (c->ok()) {
+                fCanvas->drawText(text, byteLength, x, y, *paint);
+            }
+        } return;
+        case SkRecords::DrawTextOnPath_Type: {
+            const SkPaint* paint = this->paint(c);
+            const size_t byteLength = c->read<uint32_t>();
+            const char* text = c->skip<char>(byteLength);
+            const SkPath* path = this->path(c);
+            SkMatrix matrix;
+            const bool hasMatrix = c->readBool();
+            if (hasMatrix) {
+                c->readFlat(&matrix);
+            }
+            if (c->ok()) {
+                fCanvas->drawTextOnPath(text, byteLength, *path, hasMatrix ? &matrix : NULL,
+                                        *paint);
+            }
+        } return;
+        case SkRecords::DrawVertices_Type: {
+            const SkPaint* paint = this->paint(c);
+            const SkPaint* xmode = this->optionalPaint(c);
+            const SkCanvas::VertexMode vmode = c->readEnum(SkCanvas::kTriangleFan_VertexMode);
+            int vertexCount, texCount, colorCount, indexCount;
+            const SkPoint* vertices = c->readArray<SkPoint>(&vertexCount);
+            const SkPoint* texs     = c->readArray<SkPoint>(&texCount);
+            const SkColor* colors   = c->readArray<SkColor>(&colorCount);
+            const uint16_t* indices = c->readArray<uint16_t>(&indexCount);
+            if (!c->ok() ||
+                (texCount   != 0 && texCount   != vertexCount) ||
+                (colorCount != 0 && colorCount != vertexCount)) {
+                return;
+            }
+            for (int i = 0; i < indexCount; i++) {
+                if (indices[i] >= vertexCount) {
+                    return;
+                }
+            }
+            fCanvas->drawVertices(vmode, vertexCount, vertices,
+                                  texCount   ? texs    : NULL,
+                                  colorCount ? colors  : NULL,
+                                  xmode ? xmode->getXfermode() : NULL,
+                                  indexCount ? indices : NULL, indexCount,
+                                  *paint);
+        } return;
+    }
+    SkASSERT(false);  // Create() checked every Op's type.
+}
+
+void SkSerializedRecord::draw(SkCanvas* canvas, SkPlaybackProfiler* profiler) const {
+    Player(*this, canvas, profiler).draw();
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordSerialization_DEFINED
+#define SkRecordSerialization_DEFINED
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkRecord.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+class SkPlaybackProfiler;
+
+// Writes the commands in an SkRecord to a stream in a versioned format designed to be played back
+// in place by SkSerializedRecord.  POD data (rects, matrices, point arrays, text) is laid out
+// 4-byte aligned right in the command stream; paints, paths and bitmaps live in side tables.
+void SkRecordSerialize(const SkRecord&, SkWStream*);
+
+// SkSerializedRecord plays back the output of SkRecordSerialize directly out of an SkData, which
+// will usually be a memory-mapped file (e.g. SkData::NewFromFileName()).  Commands and their POD
+// arguments are read straight from the data.  Paints, paths and bitmaps are only materialized the
+// first time a command needs them; bitmap pixels keep pointing into the data.
+//
+// Like SkRecord, SkSerializedRecord may be drawn from many threads at once.
+class SkSerializedRecord : SkNoncopyable {
+public:
+    // Takes a ref on the data.  Returns NULL if data doesn't hold a valid serialized SkRecord.
+    static SkSerializedRecord* Create(SkData*);
+    ~SkSerializedRecord();
+
+    // Returns the number of canvas commands in this record.
+    unsigned count() const;
+
+    void draw(SkCanvas*, SkPlaybackProfiler* = NULL) const;
+
+    // Writes out the data we're playing back, which is already in SkRecordSerialize's format.
+    void serialize(SkWStream*) const;
+
+    struct Header;
+    struct Op;
+    struct Flattenables;
+
+private:
+    class Player;
+
+    explicit SkSerializedRecord(SkData*);
+
+    const SkPaint* paint(int index) const;
+    const SkPath* path(int index) const;
+    const SkBitmap* bitmap(int index) const;
+
+    // Finds the bytes of entry index in one of our side tables, or returns NULL if it's invalid.
+    const void* tableEntry(uint32_t tableOffset, uint32_t count, int index, size_t* size) const;
+    const Flattenables* flattenables() const;
+
+    SkAutoTUnref<SkData> fData;
+    const Header* fHeader;
+    const Op* fOps;
+
+    // Lazily materialized objects, filled in with sk_atomic_cas as we need them.
+    mutable SkAutoTMalloc<void*> fPaints, fPaths, fBitmaps;
+    mutable void* fFlattenables;
+};
+
+#endif//SkRecordSerialization_DEFINED
@@ -29,9 +29,12 @@ void SkRecorder::forgetRecord() {
 // non-trivial copy constructors, we skip the first copy (and its destruction) by wrapping the value
 // with delay_copy(), forcing the argument to be passed by const&.
 //
-// This is used below for SkBitmap, SkPaint, SkPath, and SkRegion, which all have non-trivial copy
+// This is used below for SkBitmap, SkPath, and SkRegion, which all have non-trivial copy
 // constructors and destructors.  You'll know you've got a good candidate T if you see ~T() show up
 // unexpectedly on a profile of record time.  Otherwise don't bother.
+//
+// Most paints aren't copied at all: fPool.paint() hands back a refcounted paint shared by every
+// command that draws with an equal one.  Paths go through fPool too, so equal paths share storage.
 template <typename T>
 class Reference {
 public:
@@ -86,34 +89,34 @@ void SkRecorder::clear(SkColor color) {
 }
 
 void SkRecorder::drawPaint(const SkPaint& paint) {
-    APPEND(DrawPaint, delay_copy(paint));
+    APPEND(DrawPaint, fPool.paint(paint));
 }
 
 void SkRecorder::drawPoints(PointMode mode,
                             size_t count,
                             const SkPoint pts[],
                             const SkPaint& paint) {
-    APPEND(DrawPoints, delay_copy(paint), mode, count, this->copy(pts, count));
+    APPEND(DrawPoints, fPool.paint(paint), mode, count, this->copy(pts, count));
 }
 
 void SkRecorder::drawRect(const SkRect& rect, const SkPaint& paint) {
-    APPEND(DrawRect, delay_copy(paint), rect);
+    APPEND(DrawRect, fPool.paint(paint), rect);
 }
 
 void SkRecorder::drawOval(const SkRect& oval, const SkPaint& paint) {
-    APPEND(DrawOval, delay_copy(paint), oval);
+    APPEND(DrawOval, fPool.paint(paint), oval);
 }
 
 void SkRecorder::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    APPEND(DrawRRect, delay_copy(paint), rrect);
+    APPEND(DrawRRect, fPool.paint(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    APPEND(DrawDRRect, delay_copy(paint), outer, inner);
+    APPEND(DrawDRRect, fPool.paint(paint), outer, inner);
 }
 
 void SkRecorder::drawPath(const SkPath& path, const SkPaint& paint) {
-    APPEND(DrawPath, delay_copy(paint), delay_copy(path));
+    APPEND(DrawPath, fPool.paint(paint), delay_copy(fPool.path(path)));
 }
 
 void SkRecorder::drawBitmap(const SkBitmap& bitmap,
@@ -152,14 +155,14 @@ void SkRecorder::drawSprite(const SkBitmap& bitmap, int left, int top, const SkP
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     APPEND(DrawText,
-           delay_copy(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
+           fPool.paint(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
 }
 
 void SkRecorder::onDrawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosText,
-           delay_copy(paint),
+           fPool.paint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(pos, points));
@@ -169,7 +172,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
                                 const SkScalar xpos[], SkScalar constY, const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosTextH,
-           delay_copy(paint),
+           fPool.paint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(xpos, points),
@@ -179,10 +182,10 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
 void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                   const SkMatrix* matrix, const SkPaint& paint) {
     APPEND(DrawTextOnPath,
-           delay_copy(paint),
+           fPool.paint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
-           delay_copy(path),
+           delay_copy(fPool.path(path)),
            this->copy(matrix));
 }
 
@@ -195,7 +198,7 @@ void SkRecorder::drawVertices(VertexMode vmode,
                               const SkPoint texs[], const SkColor colors[],
                               SkXfermode* xmode,
                               const uint16_t indices[], int indexCount, const SkPaint& paint) {
-    APPEND(DrawVertices, delay_copy(paint),
+    APPEND(DrawVertices, fPool.paint(paint),
                          vmode,
                          vertexCount,
                          this->copy(vertices, vertexCount),
@@ -253,7 +256,7 @@ void SkRecorder::onClipRRect(const SkRRect& rrect, SkRegion::Op op, ClipEdgeStyl
 }
 
 void SkRecorder::onClipPath(const SkPath& path, SkRegion::Op op, ClipEdgeStyle edgeStyle) {
-    APPEND(ClipPath, delay_copy(path), op, edgeStyle == kSoft_ClipEdgeStyle);
+    APPEND(ClipPath, delay_copy(fPool.path(path)), op, edgeStyle == kSoft_ClipEdgeStyle);
     INHERITED(updateClipConservativelyUsingBounds, path.getBounds(), op, path.isInverseFillType());
 }
 
@@ -10,6 +10,7 @@
 
 #include "SkCanvas.h"
 #include "SkRecord.h"
+#include "SkRecordPool.h"
 #include "SkRecords.h"
 
 // SkRecorder provides an SkCanvas interface for recording into an SkRecord.
@@ -22,6 +23,9 @@ public:
     // Make SkRecorder forget entirely about its SkRecord*; all calls to SkRecorder will fail.
     void forgetRecord();
 
+    // The paints and paths recorded so far, shared by the commands that use them.
+    const SkRecordPool& pool() const { return fPool; }
+
     void clear(SkColor) SK_OVERRIDE;
     void drawPaint(const SkPaint& paint) SK_OVERRIDE;
     void drawPoints(PointMode mode,
@@ -107,6 +111,7 @@ private:
     T* copy(const T[], unsigned count);
 
     SkRecord* fRecord;
+    SkRecordPool fPool;
 };
 
 #endif//SkRecorder_DEFINED
@@ -7,36 +7,127 @@
 
 #include "SkRecording.h"
 
+#include "SkBBHFactory.h"
+#include "SkBBoxHierarchy.h"
 #include "SkRecord.h"
 #include "SkRecordOpts.h"
 #include "SkRecordDraw.h"
+#include "SkRecordSerialization.h"
 #include "SkRecorder.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
 
 namespace EXPERIMENTAL {
 
-SkPlayback::SkPlayback(const SkRecord* record) : fRecord(record) {}
+SkPlayback::SkPlayback(const SkRecord* record, SkBBoxHierarchy* bbh)
+    : fRecord(record)
+    , fBBH(SkSafeRef(bbh))
+    {}
+
+SkPlayback::SkPlayback(const SkSerializedRecord* serialized) : fSerialized(serialized) {}
 
 SkPlayback::~SkPlayback() {}
 
-void SkPlayback::draw(SkCanvas* canvas) const {
+void SkPlayback::draw(SkCanvas* canvas, SkPlaybackProfiler* profiler) const {
+    if (fSerialized.get() != NULL) {
+        fSerialized->draw(canvas, profiler);
+        return;
+    }
     SkASSERT(fRecord.get() != NULL);
-    SkRecordDraw(*fRecord, canvas);
+    SkRecordDraw(*fRecord, canvas, fBBH.get(), profiler);
 }
 
-SkRecording::SkRecording(int width, int height)
+namespace {
+
+// Draws one tile of a drawTiled() call.  Every tile shares the same SkPlayback.
+class TileRunnable : public SkRunnable {
+public:
+    TileRunnable(const SkPlayback* playback, const SkBitmap* dst, const SkIRect& tile)
+        : fPlayback(playback), fDst(dst), fTile(tile) {}
+
+    virtual void run() SK_OVERRIDE {
+        SkBitmap subset;
+        if (!fDst->extractSubset(&subset, fTile)) {
+            return;
+        }
+        SkCanvas canvas(subset);
+        canvas.translate(-SkIntToScalar(fTile.fLeft), -SkIntToScalar(fTile.fTop));
+        fPlayback->draw(&canvas);
+    }
+
+private:
+    const SkPlayback* fPlayback;
+    const SkBitmap* fDst;
+    const SkIRect fTile;
+};
+
+}  // namespace
+
+void SkPlayback::drawTiled(const SkBitmap& dst,
+                           int tileWidth, int tileHeight, bool threaded) const {
+    SkASSERT(tileWidth > 0 && tileHeight > 0);
+    SkAutoLockPixels lock(dst);
+
+    SkTArray<TileRunnable> tiles;
+    for (int y = 0; y < dst.height(); y += tileHeight) {
+        for (int x = 0; x < dst.width(); x += tileWidth) {
+            const SkIRect tile = SkIRect::MakeXYWH(x, y, tileWidth, tileHeight);
+            tiles.push_back(TileRunnable(this, &dst, tile));
+        }
+    }
+
+    if (!threaded) {
+        for (int i = 0; i < tiles.count(); i++) {
+            tiles[i].run();
+        }
+        return;
+    }
+    SkTaskGroup group;
+    for (int i = 0; i < tiles.count(); i++) {
+        group.add(&tiles[i]);
+    }
+    group.wait();
+}
+
+void SkPlayback::serialize(SkWStream* stream) const {
+    if (fSerialized.get() != NULL) {
+        fSerialized->serialize(stream);
+        return;
+    }
+    SkASSERT(fRecord.get() != NULL);
+    SkRecordSerialize(*fRecord, stream);
+}
+
+SkPlayback* SkPlayback::CreateFromData(SkData* data) {
+    SkSerializedRecord* serialized = SkSerializedRecord::Create(data);
+    return serialized ? SkNEW_ARGS(SkPlayback, (serialized)) : NULL;
+}
+
+SkRecording::SkRecording(int width, int height, SkBBHFactory* factory)
     : fRecord(SkNEW(SkRecord))
     , fRecorder(SkNEW_ARGS(SkRecorder, (fRecord.get(), width, height)))
+    , fBBH(factory ? (*factory)(width, height) : NULL)
+    , fWidth(width)
+    , fHeight(height)
     {}
 
 SkPlayback* SkRecording::releasePlayback() {
     SkASSERT(fRecorder->unique());
     fRecorder->forgetRecord();
     SkRecordOptimize(fRecord.get());
-    return SkNEW_ARGS(SkPlayback, (fRecord.detach()));
+    if (fBBH.get()) {
+        SkRecordFillBounds(*fRecord, fWidth, fHeight, fBBH.get());
+    }
+    return SkNEW_ARGS(SkPlayback, (fRecord.detach(), fBBH.get()));
 }
 
 SkRecording::~SkRecording() {}
 
+size_t SkRecording::approximateBytesUsed() const {
+    SkASSERT(fRecord.get() != NULL);
+    return fRecord->bytesUsed() + fRecorder->pool().bytesUsed();
+}
+
 SkCanvas* SkRecording::canvas() {
     return fRecord.get() ? fRecorder.get() : NULL;
 }
@@ -54,13 +54,22 @@ namespace SkRecords {
     M(DrawText)                                                     \
     M(DrawTextOnPath)                                               \
     M(DrawVertices)                                                 \
-    M(BoundedDrawPosTextH)    /*From SkRecordBoundDrawPosTextH*/
+    M(BoundedDrawPosTextH)    /*From SkRecordBoundDrawPosTextH*/    \
+    M(DrawRects)              /*From SkRecordBatchDrawRects*/
 
 // Defines SkRecords::Type, an enum of all record types.
 #define ENUM(T) T##_Type,
 enum Type { SK_RECORD_TYPES(ENUM) };
 #undef ENUM
 
+// The name of a record type, e.g. "DrawRect".
+inline const char* TypeName(Type type) {
+#define NAME(T) #T,
+    static const char* kNames[] = { SK_RECORD_TYPES(NAME) };
+#undef NAME
+    return kNames[type];
+}
+
 // Macros to make it easier to define a record for a draw call with 0 args, 1 args, 2 args, etc.
 // These should be clearer when you look at their use below.
 #define RECORD0(T)                      \
@@ -161,6 +170,48 @@ private:
 
 #undef ACT_AS_PTR
 
+// Shared refs a T which other records may share, e.g. a paint interned by SkRecordPool.
+// The T must not change while it's shared, so call writable() before modifying it.
+template <typename T>
+class Shared {
+public:
+    // The refcounted home of a shared T.
+    class Box : public SkRefCnt {
+    public:
+        explicit Box(const T& value) : fValue(value) {}
+        T fValue;
+    };
+
+    Shared(const T& value) : fBox(SkNEW_ARGS(Box, (value))) {}
+    Shared(Box* box) : fBox(SkRef(box)) {}
+    Shared(const Shared& that) : fBox(SkRef(that.fBox)) {}
+    ~Shared() { fBox->unref(); }
+
+    operator const T&() const { return fBox->fValue; }
+    const T* operator->() const { return &fBox->fValue; }
+    const T* get() const { return &fBox->fValue; }
+
+    // Shared Ts are equal if they're the same T, or if their Ts compare equal.
+    bool operator==(const Shared& that) const {
+        return fBox == that.fBox || fBox->fValue == that.fBox->fValue;
+    }
+
+    // Returns a T only this Shared refers to, copying it first if anyone else refs it.
+    T* writable() {
+        if (!fBox->unique()) {
+            Box* copy = SkNEW_ARGS(Box, (fBox->fValue));
+            fBox->unref();
+            fBox = copy;
+        }
+        return &fBox->fValue;
+    }
+
+private:
+    Shared& operator=(const Shared&);
+
+    Box* fBox;
+};
+
 // Like SkBitmap, but deep copies pixels if they're not immutable.
 // Using this, we guarantee the immutability of all bitmaps we record.
 class ImmutableBitmap {
@@ -213,29 +264,32 @@ RECORD5(DrawBitmapRectToRect, Optional<SkPaint>, paint,
                               Optional<SkRect>, src,
                               SkRect, dst,
                               SkCanvas::DrawBitmapRectFlags, flags);
-RECORD3(DrawDRRect, SkPaint, paint, SkRRect, outer, SkRRect, inner);
-RECORD2(DrawOval, SkPaint, paint, SkRect, oval);
-RECORD1(DrawPaint, SkPaint, paint);
-RECORD2(DrawPath, SkPaint, paint, SkPath, path);
-RECORD4(DrawPoints, SkPaint, paint, SkCanvas::PointMode, mode, size_t, count, SkPoint*, pts);
-RECORD4(DrawPosText, SkPaint, paint,
+RECORD3(DrawDRRect, Shared<SkPaint>, paint, SkRRect, outer, SkRRect, inner);
+RECORD2(DrawOval, Shared<SkPaint>, paint, SkRect, oval);
+RECORD1(DrawPaint, Shared<SkPaint>, paint);
+RECORD2(DrawPath, Shared<SkPaint>, paint, SkPath, path);
+RECORD4(DrawPoints, Shared<SkPaint>, paint,
+                    SkCanvas::PointMode, mode,
+                    size_t, count,
+                    SkPoint*, pts);
+RECORD4(DrawPosText, Shared<SkPaint>, paint,
                      PODArray<char>, text,
                      size_t, byteLength,
                      PODArray<SkPoint>, pos);
-RECORD5(DrawPosTextH, SkPaint, paint,
+RECORD5(DrawPosTextH, Shared<SkPaint>, paint,
                       PODArray<char>, text,
                       size_t, byteLength,
                       PODArray<SkScalar>, xpos,
                       SkScalar, y);
-RECORD2(DrawRRect, SkPaint, paint, SkRRect, rrect);
-RECORD2(DrawRect, SkPaint, paint, SkRect, rect);
+RECORD2(DrawRRect, Shared<SkPaint>, paint, SkRRect, rrect);
+RECORD2(DrawRect, Shared<SkPaint>, paint, SkRect, rect);
 RECORD4(DrawSprite, Optional<SkPaint>, paint, ImmutableBitmap, bitmap, int, left, int, top);
-RECORD5(DrawText, SkPaint, paint,
+RECORD5(DrawText, Shared<SkPaint>, paint,
                   PODArray<char>, text,
                   size_t, byteLength,
                   SkScalar, x,
                   SkScalar, y);
-RECORD5(DrawTextOnPath, SkPaint, paint,
+RECORD5(DrawTextOnPath, Shared<SkPaint>, paint,
                         PODArray<char>, text,
                         size_t, byteLength,
                         SkPath, path,
@@ -245,7 +299,7 @@ RECORD5(DrawTextOnPath, SkPaint, paint,
 struct DrawVertices {
     static const Type kType = DrawVertices_Type;
 
-    DrawVertices(const SkPaint& paint,
+    DrawVertices(const Shared<SkPaint>& paint,
                  SkCanvas::VertexMode vmode,
                  int vertexCount,
                  SkPoint* vertices,
@@ -264,7 +318,7 @@ struct DrawVertices {
         , indices(indices)
         , indexCount(indexCount) {}
 
-    SkPaint paint;
+    Shared<SkPaint> paint;
     SkCanvas::VertexMode vmode;
     int vertexCount;
     PODArray<SkPoint> vertices;
@@ -278,6 +332,7 @@ struct DrawVertices {
 // Records added by optimizations.
 RECORD2(PairedPushCull, Adopted<PushCull>, base, unsigned, skip);
 RECORD3(BoundedDrawPosTextH, Adopted<DrawPosTextH>, base, SkScalar, minY, SkScalar, maxY);
+RECORD3(DrawRects, Shared<SkPaint>, paint, unsigned, count, PODArray<SkRect>, rects);
 
 #undef RECORD0
 #undef RECORD1
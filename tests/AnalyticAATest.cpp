@@ -0,0 +1,143 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBlitter.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkRegion.h"
+#include "SkScan.h"
+#include "Test.h"
+
+static const int kSize = 64;
+
+// Fills path with analytic coverage into an A8 bitmap.  This goes straight to SkScan, on a
+// blitter of our own, so we don't have to flip SkGraphics::SetAnalyticAA() under other tests.
+static void fill(const SkPath& path, SkBitmap* bm, const SkRegion* clip = NULL) {
+    bm->allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    bm->eraseColor(SK_ColorTRANSPARENT);
+
+    SkRegion rgn(SkIRect::MakeWH(kSize, kSize));
+    if (NULL != clip) {
+        rgn.op(*clip, SkRegion::kIntersect_Op);
+    }
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    SkTBlitterAllocator allocator;
+    SkBlitter* blitter = SkBlitter::Choose(*bm, SkMatrix::I(), paint, &allocator);
+    SkAssertResult(SkScan::AnalyticFillPath(path, rgn, blitter));
+}
+
+// What analytic coverage should come to: the path filled without anti-aliasing at 16x16 the
+// resolution, box filtered back down.
+static void reference(const SkPath& path, SkBitmap* bm, const SkRegion* clip = NULL) {
+    static const int kScale = 16;
+    SkBitmap big;
+    big.allocPixels(SkImageInfo::MakeA8(kSize * kScale, kSize * kScale));
+    big.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(big);
+    canvas.scale(SkIntToScalar(kScale), SkIntToScalar(kScale));
+    canvas.drawPath(path, SkPaint());
+
+    bm->allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            int sum = 0;
+            for (int j = 0; j < kScale; ++j) {
+                for (int i = 0; i < kScale; ++i) {
+                    sum += *big.getAddr8(x * kScale + i, y * kScale + j);
+                }
+            }
+            const bool inClip = NULL == clip || clip->contains(x, y);
+            *bm->getAddr8(x, y) = inClip ? SkToU8(sum / (kScale * kScale)) : 0;
+        }
+    }
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    int diff = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            diff = SkTMax(diff, SkAbs32(*a.getAddr8(x, y) - *b.getAddr8(x, y)));
+        }
+    }
+    return diff;
+}
+
+// Rects make it easy to know exactly what coverage should be.
+static void test_rect(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(10.5f, 10, 20.25f, 20.75f));
+
+    SkBitmap bm;
+    fill(path, &bm);
+    REPORTER_ASSERT(reporter, 0   == *bm.getAddr8( 9, 15));
+    REPORTER_ASSERT(reporter, 128 == *bm.getAddr8(10, 15));
+    REPORTER_ASSERT(reporter, 255 == *bm.getAddr8(15, 15));
+    REPORTER_ASSERT(reporter, 64  == *bm.getAddr8(20, 15));
+    REPORTER_ASSERT(reporter, 0   == *bm.getAddr8(21, 15));
+    REPORTER_ASSERT(reporter, 191 == *bm.getAddr8(15, 20));
+    REPORTER_ASSERT(reporter, 96  == *bm.getAddr8(10, 20));
+}
+
+// A diagonal cuts the pixels it crosses exactly in half.
+static void test_diagonal(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.moveTo(10, 10);
+    path.lineTo(30, 30);
+    path.lineTo(10, 30);
+    path.close();
+
+    SkBitmap bm;
+    fill(path, &bm);
+    for (int i = 10; i < 30; ++i) {
+        REPORTER_ASSERT(reporter, 128 == *bm.getAddr8(i, i));
+        REPORTER_ASSERT(reporter, 255 == *bm.getAddr8(i - 1, i) || i == 10);
+        REPORTER_ASSERT(reporter, 0   == *bm.getAddr8(i + 1, i));
+    }
+}
+
+// Curves, holes and clipping should all get close to the reference coverage.  (Supersampling gets
+// as much as a quarter of a pixel's coverage wrong, so we don't compare against it.)
+static void test_paths(skiatest::Reporter* reporter) {
+    SkPath paths[4];
+    paths[0].addCircle(32, 32, 25);
+    paths[0].addCircle(32, 32, 12, SkPath::kCCW_Direction);
+    paths[1].moveTo(5, 60);
+    paths[1].cubicTo(20, -20, 44, 90, 59, 3);
+    paths[1].quadTo(70, 40, 5, 60);
+    // Hanging off every side of the bitmap.
+    paths[2].addOval(SkRect::MakeLTRB(-20, -10, 80, 90));
+    // Winding would fill the hole in this one.  (Where a path crosses itself inside a pixel, the
+    // coverage is only approximate, so we steer clear of that.)
+    paths[3].addOval(SkRect::MakeLTRB(3, 5, 61, 59));
+    paths[3].addOval(SkRect::MakeLTRB(20.3f, 16.6f, 40.1f, 48.2f));
+    paths[3].setFillType(SkPath::kEvenOdd_FillType);
+
+    SkRegion complex;
+    complex.setRect(0, 0, kSize, kSize / 2);
+    complex.op(SkIRect::MakeXYWH(kSize / 4, kSize / 2, kSize / 2, kSize / 4),
+               SkRegion::kUnion_Op);
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(paths); ++i) {
+        SkBitmap analytic, expected;
+        fill(paths[i], &analytic);
+        reference(paths[i], &expected);
+        REPORTER_ASSERT(reporter, max_diff(analytic, expected) <= 12);
+
+        fill(paths[i], &analytic, &complex);
+        reference(paths[i], &expected, &complex);
+        REPORTER_ASSERT(reporter, max_diff(analytic, expected) <= 12);
+    }
+}
+
+DEF_TEST(AnalyticAA, reporter) {
+    test_rect(reporter);
+    test_diagonal(reporter);
+    test_paths(reporter);
+}
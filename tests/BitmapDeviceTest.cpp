@@ -0,0 +1,108 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapDevice.h"
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkPath.h"
+#include "SkShader.h"
+#include "Test.h"
+
+static const int kWidth = 640, kHeight = 480;
+
+// Draws a little of everything SkBitmapDevice may split into bands, all big enough to be split.
+// Unless edges is true, nothing drawn has an edge that isn't pixel aligned.
+static void draw(SkCanvas* canvas, bool edges) {
+    const SkPoint pts[] = { { 0, 0 }, { kWidth, kHeight } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkAutoTUnref<SkShader> gradient(
+            SkGradientShader::CreateLinear(pts, colors, NULL, 2, SkShader::kClamp_TileMode));
+
+    SkPaint paint;
+    paint.setShader(gradient);
+    canvas->drawPaint(paint);
+
+    paint.setShader(NULL);
+    paint.setAntiAlias(true);
+    if (edges) {
+        paint.setColor(SK_ColorGREEN);
+        SkPath path;
+        path.moveTo(20, 20);
+        path.lineTo(600, 70);
+        path.lineTo(320, 460);
+        path.close();
+        canvas->drawPath(path, paint);
+    }
+
+    SkAutoTUnref<SkMaskFilter> blur(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 8));
+    paint.setMaskFilter(blur);
+    paint.setColor(0x80000000);
+    canvas->drawRect(SkRect::MakeLTRB(100, 50, 540, 420), paint);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 48);
+    bitmap.eraseColor(SK_ColorYELLOW);
+    bitmap.eraseArea(SkIRect::MakeLTRB(16, 12, 48, 36), SK_ColorMAGENTA);
+    SkPaint bitmapPaint;
+    bitmapPaint.setFilterLevel(SkPaint::kHigh_FilterLevel);
+    canvas->save();
+    canvas->translate(40, 30);
+    if (edges) {
+        canvas->rotate(5);
+    }
+    canvas->scale(8, 8);
+    canvas->drawBitmap(bitmap, 0, 0, &bitmapPaint);
+    canvas->restore();
+
+    // A layer should split its draws too.
+    canvas->saveLayer(NULL, NULL);
+    paint.setMaskFilter(NULL);
+    paint.setColor(0x800000FF);
+    canvas->clipRect(SkRect::MakeLTRB(0, 100, kWidth, 300));
+    if (edges) {
+        canvas->drawCircle(320, 240, 200, paint);
+    } else {
+        canvas->drawRect(SkRect::MakeLTRB(120, 40, 520, 440), paint);
+    }
+    canvas->restore();
+}
+
+// Returns how many pixels differ.
+static int draw_with_and_without_bands(bool edges, skiatest::Reporter* reporter) {
+    SkBitmap expected, banded;
+    expected.allocN32Pixels(kWidth, kHeight);
+    banded.allocN32Pixels(kWidth, kHeight);
+
+    {
+        SkCanvas canvas(expected);
+        draw(&canvas, edges);
+    }
+    {
+        SkAutoTUnref<SkBitmapDevice> device(SkNEW_ARGS(SkBitmapDevice, (banded)));
+        device->setRasterThreads(4);
+        REPORTER_ASSERT(reporter, 4 == device->getRasterThreads());
+        SkCanvas canvas(device);
+        draw(&canvas, edges);
+    }
+
+    int different = 0;
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            different += *expected.getAddr32(x, y) != *banded.getAddr32(x, y);
+        }
+    }
+    return different;
+}
+
+DEF_TEST(BitmapDevice_RasterThreads, reporter) {
+    REPORTER_ASSERT(reporter, 0 == draw_with_and_without_bands(false, reporter));
+
+    // Each band clips the edges of what it draws to itself, which can nudge where an edge that
+    // crosses the band falls by a bit, just as drawing in tiles can.
+    REPORTER_ASSERT(reporter, draw_with_and_without_bands(true, reporter) < kWidth * kHeight / 500);
+}
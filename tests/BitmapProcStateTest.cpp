@@ -0,0 +1,142 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBitmapProcState.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkShader.h"
+#include "SkUtils.h"
+#include "Test.h"
+
+class BitmapProcStateTester {
+public:
+    // Sets up state as SkBitmapProcShader does, which picks the platform's procs.
+    static bool Choose(SkBitmapProcState* state, const SkBitmap& src,
+                       SkShader::TileMode mode, const SkMatrix& inv,
+                       SkPaint::FilterLevel level) {
+        state->fOrigBitmap = src;
+        state->fTileModeX = state->fTileModeY = mode;
+
+        SkPaint paint;
+        paint.setFilterLevel(level);
+        return state->chooseProcs(inv, paint);
+    }
+
+    static SkBitmapProcState::MatrixProc PlatformMatrixProc(const SkBitmapProcState& state) {
+        return state.fMatrixProc;
+    }
+
+    // The proc chooseProcs() picked before platformProcs() had its say.
+    static SkBitmapProcState::MatrixProc PortableMatrixProc(SkBitmapProcState* state) {
+        return state->chooseMatrixProc(false);
+    }
+};
+
+static const char* gTileModeName[] = { "clamp", "repeat", "mirror" };
+
+// Enough for a filtered span of 17, plus some to catch writing past it.
+static const int kMaxWidth = 17;
+static const int kBufferCount = 2 * kMaxWidth + 8;
+
+static void test_matrix_procs(skiatest::Reporter* reporter, const SkBitmap& src,
+                              SkShader::TileMode mode, const SkMatrix& inv,
+                              SkPaint::FilterLevel level) {
+    SkBitmapProcState state;
+    if (!BitmapProcStateTester::Choose(&state, src, mode, inv, level)) {
+        ERRORF(reporter, "chooseProcs failed for %s", gTileModeName[mode]);
+        return;
+    }
+    SkBitmapProcState::MatrixProc platform = BitmapProcStateTester::PlatformMatrixProc(state);
+    SkBitmapProcState::MatrixProc portable = BitmapProcStateTester::PortableMatrixProc(&state);
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // SSE2 has clamp and repeat procs for every non-scale matrix, but not mirror.
+    const bool hasSSE2 = SkShader::kMirror_TileMode != mode;
+    REPORTER_ASSERT(reporter, hasSSE2 == (platform != portable));
+#endif
+
+    static const int gY[] = { 0, 3, 11, 37 };
+    static const int gX[] = { 0, 1, 6, 29 };
+
+    // The affine procs, like the shader that calls them, require count > 0.
+    const int minWidth = inv.hasPerspective() ? 0 : 1;
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gY); ++i) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(gX); ++j) {
+            for (int width = minWidth; width <= kMaxWidth; ++width) {
+                uint32_t expected[kBufferCount], actual[kBufferCount];
+                sk_memset32(expected, 0xDEADBEEF, kBufferCount);
+                sk_memset32(actual,   0xDEADBEEF, kBufferCount);
+
+                portable(state, expected, width, gX[j], gY[i]);
+                platform(state, actual,   width, gX[j], gY[i]);
+
+                if (memcmp(expected, actual, sizeof(expected))) {
+                    ERRORF(reporter, "MatrixProc %s filter=%d bitmap %dx%d [%d %d] width %d",
+                           gTileModeName[mode], level, src.width(), src.height(),
+                           gX[j], gY[i], width);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+// The platform's matrix procs must give exactly the coordinates the portable
+// ones do, for every tile mode, with and without filtering.
+DEF_TEST(BitmapProcState_MatrixProcs, reporter) {
+    static const struct {
+        int fWidth, fHeight;
+    } gSizes[] = {
+        { 1, 1 },
+        { 5, 7 },
+        { 100, 37 },
+        { 0x10001, 2 },   // too wide for the SSE2 repeat procs; they fall back
+    };
+
+    static const SkShader::TileMode gModes[] = {
+        SkShader::kClamp_TileMode,
+        SkShader::kRepeat_TileMode,
+        SkShader::kMirror_TileMode,
+    };
+
+    static const SkPaint::FilterLevel gLevels[] = {
+        SkPaint::kNone_FilterLevel,
+        SkPaint::kLow_FilterLevel,
+    };
+
+    // Inverse matrices: from device space back to the bitmap.
+    SkMatrix matrices[5];
+    matrices[0].setRotate(30);
+    matrices[0].postScale(0.75f, 1.5f);
+    matrices[1].setSkew(0.25f, -0.5f, 3, 4);
+    matrices[2].reset();
+    matrices[2].setPerspX(0.001f);
+    matrices[2].setPerspY(0.002f);
+    matrices[3].setRotate(-60, 10, 10);
+    matrices[3].setPerspX(-0.004f);
+    matrices[3].setPerspY(0.0005f);
+    // Steep enough that coordinates run past 16 bits.
+    matrices[4].setScale(300, 200);
+    matrices[4].setPerspX(0.02f);
+    matrices[4].setPerspY(-0.03f);
+
+    for (size_t s = 0; s < SK_ARRAY_COUNT(gSizes); ++s) {
+        SkBitmap src;
+        src.allocN32Pixels(gSizes[s].fWidth, gSizes[s].fHeight);
+        src.eraseColor(SK_ColorWHITE);
+
+        for (size_t m = 0; m < SK_ARRAY_COUNT(gModes); ++m) {
+            for (size_t l = 0; l < SK_ARRAY_COUNT(gLevels); ++l) {
+                for (size_t i = 0; i < SK_ARRAY_COUNT(matrices); ++i) {
+                    test_matrix_procs(reporter, src, gModes[m], matrices[i], gLevels[l]);
+                }
+            }
+        }
+    }
+}
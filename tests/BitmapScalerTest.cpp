@@ -0,0 +1,104 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBitmapProcState.h"
+#include "SkBitmapScaler.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static void make_noise(SkBitmap* bm, int w, int h, bool opaque, SkRandom& rand) {
+    bm->allocN32Pixels(w, h, opaque);
+    SkAutoLockPixels alp(*bm);
+    for (int y = 0; y < h; ++y) {
+        SkPMColor* row = bm->getAddr32(0, y);
+        for (int x = 0; x < w; ++x) {
+            SkColor c = rand.nextU();
+            if (opaque) {
+                c = SkColorSetA(c, 0xFF);
+            }
+            row[x] = SkPreMultiplyColor(c);
+        }
+    }
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    SkAutoLockPixels alpa(a), alpb(b);
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Resizing must give the same pixels whichever convolution procs it uses, and
+// however many threads it splits the work across.
+DEF_TEST(BitmapScaler, reporter) {
+    SkConvolutionProcs portableProcs;
+    sk_bzero(&portableProcs, sizeof(portableProcs));
+
+    SkConvolutionProcs platformProcs;
+    sk_bzero(&platformProcs, sizeof(platformProcs));
+    SkBitmapProcState state;
+    state.platformConvolutionProcs(&platformProcs);
+
+    static const struct {
+        int fSrcWidth, fSrcHeight;
+        float fDstWidth, fDstHeight;
+    } gSizes[] = {
+        { 1000, 700, 320, 240 },
+        {  300, 300, 517, 263 },
+        {  257, 513,  93, 707 },
+        {   64,  48,  17,  11 },
+    };
+
+    static const SkBitmapScaler::ResizeMethod gMethods[] = {
+        SkBitmapScaler::RESIZE_BOX,
+        SkBitmapScaler::RESIZE_HAMMING,
+        SkBitmapScaler::RESIZE_LANCZOS3,
+        SkBitmapScaler::RESIZE_MITCHELL,
+    };
+
+    static const int gThreads[] = { 2, 3, -1 };
+
+    SkRandom rand;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gSizes); ++i) {
+        for (int opaque = 0; opaque <= 1; ++opaque) {
+            SkBitmap src;
+            make_noise(&src, gSizes[i].fSrcWidth, gSizes[i].fSrcHeight, SkToBool(opaque), rand);
+
+            for (size_t m = 0; m < SK_ARRAY_COUNT(gMethods); ++m) {
+                SkBitmap expected;
+                REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&expected, src, gMethods[m],
+                                                                 gSizes[i].fDstWidth,
+                                                                 gSizes[i].fDstHeight,
+                                                                 portableProcs));
+
+                SkBitmap actual;
+                REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&actual, src, gMethods[m],
+                                                                 gSizes[i].fDstWidth,
+                                                                 gSizes[i].fDstHeight,
+                                                                 platformProcs));
+                REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+
+                for (size_t t = 0; t < SK_ARRAY_COUNT(gThreads); ++t) {
+                    REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&actual, src, gMethods[m],
+                                                                     gSizes[i].fDstWidth,
+                                                                     gSizes[i].fDstHeight,
+                                                                     platformProcs, NULL,
+                                                                     gThreads[t]));
+                    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+                }
+            }
+        }
+    }
+}
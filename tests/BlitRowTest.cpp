@@ -6,9 +6,12 @@
  */
 
 #include "SkBitmap.h"
+#include "SkBlitMask.h"
+#include "SkBlitRow.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkGradientShader.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "Test.h"
 
@@ -258,7 +261,125 @@ static void test_diagonal(skiatest::Reporter* reporter) {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Whatever procs the factories pick for this CPU (SSE2, AVX2, NEON...) should give exactly what
+// the portable procs do, for any length and alignment of row.
+
+static const int kRowCount = 67;
+
+static SkPMColor random_pmcolor(SkRandom* rand) {
+    switch (rand->nextU() % 4) {
+        case 0:
+            return 0;
+        case 1:
+            return SkPreMultiplyColor(rand->nextU() | 0xFF000000);
+        default:
+            return SkPreMultiplyColor(rand->nextU());
+    }
+}
+
+static void random_row(SkRandom* rand, SkPMColor row[], int count) {
+    for (int i = 0; i < count; ++i) {
+        row[i] = random_pmcolor(rand);
+    }
+}
+
+static void test_procs_32(skiatest::Reporter* reporter) {
+    static const unsigned gFlags[] = {
+        SkBlitRow::kGlobalAlpha_Flag32,
+        SkBlitRow::kSrcPixelAlpha_Flag32,
+        SkBlitRow::kGlobalAlpha_Flag32 | SkBlitRow::kSrcPixelAlpha_Flag32,
+    };
+    SkRandom rand;
+    for (size_t f = 0; f < SK_ARRAY_COUNT(gFlags); ++f) {
+        SkBlitRow::Proc32 proc = SkBlitRow::Factory32(gFlags[f]);
+        for (int offset = 0; offset < 8; ++offset) {
+            SkPMColor src[kRowCount], dst[kRowCount + 8], expected[kRowCount];
+            random_row(&rand, src, kRowCount);
+            random_row(&rand, dst + offset, kRowCount);
+            const unsigned alpha = (gFlags[f] & SkBlitRow::kGlobalAlpha_Flag32)
+                                 ? rand.nextU() % 255 : 255;
+            const int count = kRowCount - offset;
+            for (int i = 0; i < count; ++i) {
+                const SkPMColor d = dst[offset + i];
+                switch (gFlags[f]) {
+                    case SkBlitRow::kGlobalAlpha_Flag32:
+                        expected[i] = SkAlphaMulQ(src[i], SkAlpha255To256(alpha)) +
+                                      SkAlphaMulQ(d, 256 - SkAlpha255To256(alpha));
+                        break;
+                    case SkBlitRow::kSrcPixelAlpha_Flag32:
+                        expected[i] = SkPMSrcOver(src[i], d);
+                        break;
+                    default:
+                        expected[i] = SkBlendARGB32(src[i], d, alpha);
+                        break;
+                }
+            }
+            proc(dst + offset, src, count, alpha);
+            for (int i = 0; i < count; ++i) {
+                if (expected[i] != dst[offset + i]) {
+                    ERRORF(reporter, "Proc32 flags=%d [%d] expected %x got %x",
+                           gFlags[f], i, expected[i], dst[offset + i]);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static void test_color_proc(skiatest::Reporter* reporter) {
+    SkBlitRow::ColorProc proc = SkBlitRow::ColorProcFactory();
+    SkRandom rand;
+    for (int offset = 0; offset < 8; ++offset) {
+        SkPMColor src[kRowCount], dst[kRowCount + 8];
+        random_row(&rand, src, kRowCount);
+        const SkPMColor color = SkPreMultiplyColor(rand.nextU());
+        const int count = kRowCount - offset;
+        proc(dst + offset, src, count, color);
+        for (int i = 0; i < count; ++i) {
+            SkPMColor expected = src[i];
+            SkBlitRow::Color32(&expected, &expected, 1, color);
+            if (expected != dst[offset + i]) {
+                ERRORF(reporter, "ColorProc [%d] expected %x got %x",
+                       i, expected, dst[offset + i]);
+                break;
+            }
+        }
+    }
+}
+
+static void test_a8_mask(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 16; ++i) {
+        const SkColor color = rand.nextU();
+        SkBlitMask::ColorProc proc = SkBlitMask::ColorFactory(kN32_SkColorType,
+                                                             SkMask::kA8_Format, color);
+        // Two rows, each starting at a different alignment.
+        SkPMColor dst[2 * kRowCount + 1], expected[2 * kRowCount + 1];
+        uint8_t mask[2 * kRowCount + 1];
+        random_row(&rand, dst, SK_ARRAY_COUNT(dst));
+        for (size_t j = 0; j < SK_ARRAY_COUNT(mask); ++j) {
+            mask[j] = j % 5 ? rand.nextU() & 0xFF : (j % 2 ? 0 : 0xFF);
+        }
+        memcpy(expected, dst, sizeof(dst));
+        for (int y = 0; y < 2; ++y) {
+            const int start = y * (kRowCount + 1);
+            for (int x = 0; x < kRowCount; ++x) {
+                expected[start + x] = SkBlendARGB32(SkPreMultiplyColor(color),
+                                                    expected[start + x], mask[start + x]);
+            }
+        }
+        proc(dst, (kRowCount + 1) * sizeof(SkPMColor), mask, kRowCount + 1,
+             color, kRowCount, 2);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected, dst, sizeof(dst)));
+    }
+}
+
 DEF_TEST(BlitRow, reporter) {
     test_00_FF(reporter);
     test_diagonal(reporter);
+    test_procs_32(reporter);
+    test_color_proc(reporter);
+    test_a8_mask(reporter);
 }
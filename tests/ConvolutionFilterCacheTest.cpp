@@ -0,0 +1,134 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBitmapScaler.h"
+#include "SkColorPriv.h"
+#include "SkConvolutionFilterCache.h"
+#include "SkGraphics.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static void make_filter(SkConvolutionFilter1D* filter, int n) {
+    static const float kWeights[] = { 0.25f, 0.5f, 0.25f };
+    for (int i = 0; i < n; ++i) {
+        filter->AddFilter(i, kWeights, SK_ARRAY_COUNT(kWeights));
+    }
+}
+
+static bool same_filters(const SkConvolutionFilter1D& a, const SkConvolutionFilter1D& b) {
+    if (a.numValues() != b.numValues() || a.maxFilter() != b.maxFilter()) {
+        return false;
+    }
+    for (int i = 0; i < a.numValues(); ++i) {
+        int offsetA, lengthA, offsetB, lengthB;
+        const SkConvolutionFilter1D::ConvolutionFixed* valuesA =
+            a.FilterForValue(i, &offsetA, &lengthA);
+        const SkConvolutionFilter1D::ConvolutionFixed* valuesB =
+            b.FilterForValue(i, &offsetB, &lengthB);
+        if (offsetA != offsetB || lengthA != lengthB ||
+            memcmp(valuesA, valuesB, lengthA * sizeof(*valuesA))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_cache(skiatest::Reporter* reporter) {
+    SkConvolutionFilterCache cache(8 * 1024);
+    for (int i = 1; i <= 10; ++i) {
+        SkConvolutionFilter1D filter;
+        make_filter(&filter, i * 20);
+
+        SkConvolutionFilterCache::Key key;
+        SkConvolutionFilterCache::ComputeKey(SkBitmapScaler::RESIZE_LANCZOS3, 1000, i * 0.02f,
+                                             0, i * 20.0f, false, &key);
+
+        SkConvolutionFilter1D found;
+        REPORTER_ASSERT(reporter, !cache.find(key, &found));
+        cache.add(key, filter);
+        REPORTER_ASSERT(reporter, cache.find(key, &found));
+        REPORTER_ASSERT(reporter, same_filters(filter, found));
+        REPORTER_ASSERT(reporter, cache.getBytesUsed() <= cache.getByteLimit());
+    }
+    REPORTER_ASSERT(reporter, 10 == cache.getHitCount());
+    REPORTER_ASSERT(reporter, 10 == cache.getMissCount());
+
+    cache.setByteLimit(0);
+    REPORTER_ASSERT(reporter, 0 == cache.getBytesUsed());
+}
+
+static void test_key(skiatest::Reporter* reporter) {
+    SkConvolutionFilterCache::Key key0, key1;
+    SkConvolutionFilterCache::ComputeKey(SkBitmapScaler::RESIZE_MITCHELL, 640, 0.5f,
+                                         0, 320, true, &key0);
+    SkConvolutionFilterCache::ComputeKey(SkBitmapScaler::RESIZE_MITCHELL, 640, 0.5f,
+                                         0, 320, true, &key1);
+    REPORTER_ASSERT(reporter, key0 == key1);
+
+    SkConvolutionFilterCache::ComputeKey(SkBitmapScaler::RESIZE_LANCZOS3, 640, 0.5f,
+                                         0, 320, true, &key1);
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+    SkConvolutionFilterCache::ComputeKey(SkBitmapScaler::RESIZE_MITCHELL, 641, 0.5f,
+                                         0, 320, true, &key1);
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+    SkConvolutionFilterCache::ComputeKey(SkBitmapScaler::RESIZE_MITCHELL, 640, 0.25f,
+                                         0, 320, true, &key1);
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+    SkConvolutionFilterCache::ComputeKey(SkBitmapScaler::RESIZE_MITCHELL, 640, 0.5f,
+                                         16, 320, true, &key1);
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+    SkConvolutionFilterCache::ComputeKey(SkBitmapScaler::RESIZE_MITCHELL, 640, 0.5f,
+                                         0, 320, false, &key1);
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+}
+
+// Resizing must give the same pixels whether or not its filters come from the cache.
+static void test_resize(skiatest::Reporter* reporter) {
+    SkBitmap src;
+    src.allocN32Pixels(200, 150, true);
+    {
+        SkAutoLockPixels alp(src);
+        SkRandom rand;
+        for (int y = 0; y < src.height(); ++y) {
+            for (int x = 0; x < src.width(); ++x) {
+                *src.getAddr32(x, y) = SkPreMultiplyColor(SkColorSetA(rand.nextU(), 0xFF));
+            }
+        }
+    }
+
+    SkConvolutionProcs procs;
+    sk_bzero(&procs, sizeof(procs));
+
+    size_t prevLimit = SkGraphics::SetConvolutionFilterCacheByteLimit(0);
+    SkBitmap expected;
+    REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&expected, src,
+                                                     SkBitmapScaler::RESIZE_LANCZOS3,
+                                                     75, 120, procs));
+    REPORTER_ASSERT(reporter, 0 == SkGraphics::GetConvolutionFilterCacheBytesUsed());
+
+    SkGraphics::SetConvolutionFilterCacheByteLimit(1024 * 1024);
+    for (int i = 0; i < 2; ++i) {
+        SkBitmap actual;
+        REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&actual, src,
+                                                         SkBitmapScaler::RESIZE_LANCZOS3,
+                                                         75, 120, procs));
+        REPORTER_ASSERT(reporter, SkGraphics::GetConvolutionFilterCacheBytesUsed() > 0);
+
+        SkAutoLockPixels alpe(expected), alpa(actual);
+        REPORTER_ASSERT(reporter, expected.getSize() == actual.getSize());
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                              expected.getSize()));
+    }
+    SkGraphics::SetConvolutionFilterCacheByteLimit(prevLimit);
+}
+
+DEF_TEST(ConvolutionFilterCache, reporter) {
+    test_cache(reporter);
+    test_key(reporter);
+    test_resize(reporter);
+}
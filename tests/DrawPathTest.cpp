@@ -275,6 +275,114 @@ static void test_crbug_165432(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, filteredPath.isEmpty());
 }
 
+static bool bitmaps_nearly_equal(const SkBitmap& a, const SkBitmap& b, int tolerance) {
+    SkAutoLockPixels alpa(a), alpb(b);
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            SkPMColor ca = *a.getAddr32(x, y);
+            SkPMColor cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                int da = (ca >> shift) & 0xFF;
+                int db = (cb >> shift) & 0xFF;
+                if (SkAbs32(da - db) > tolerance) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Dashed lines are drawn without building the dashed path; check that they
+// match the dashed path drawn without the path effect.
+static void test_dashed_lines(skiatest::Reporter* reporter) {
+    SkPath zigzag;
+    zigzag.moveTo(2, 3);
+    zigzag.lineTo(30, 50);
+    zigzag.lineTo(40, 10.5f);
+    zigzag.lineTo(61, 40);
+    zigzag.moveTo(5, 60);
+    zigzag.lineTo(60, 55);
+
+    SkPath triangle;
+    triangle.moveTo(10, 10);
+    triangle.lineTo(50, 20);
+    triangle.lineTo(20, 55);
+    triangle.close();
+
+    SkPath hline;
+    hline.moveTo(-1000, 20.25f);
+    hline.lineTo(1000, 20.25f);
+
+    SkPath vline;
+    vline.moveTo(31.5f, 4);
+    vline.lineTo(31.5f, 60);
+
+    SkPath rect;
+    rect.addRect(SkRect::MakeLTRB(6.5f, 8, 52, 50.75f));
+
+    const struct {
+        const SkPath*   fPath;
+        SkScalar        fWidth;
+        SkPaint::Cap    fCap;
+        bool            fAA;
+        SkScalar        fPhase;
+        SkScalar        fScale;
+    } gRec[] = {
+        { &zigzag,      0, SkPaint::kButt_Cap,     true,   2, 1 },
+        { &zigzag,      0, SkPaint::kButt_Cap,     false,  0, 1 },
+        { &triangle,    0, SkPaint::kButt_Cap,     true,   7, 1 },
+        { &hline,       0, SkPaint::kButt_Cap,     true,   1, 1 },
+        { &hline,       3, SkPaint::kButt_Cap,     true,   1, 1 },
+        { &vline,       4, SkPaint::kSquare_Cap,   false,  3, 1 },
+        { &rect,        3, SkPaint::kButt_Cap,     true,   0, 1 },
+        { &rect,        2, SkPaint::kSquare_Cap,   true,   5, 1 },
+        { &rect,        2, SkPaint::kButt_Cap,     false,  4, 1.25f },
+    };
+
+    const SkScalar intervals[] = { 7, 5, 2, 6 };
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gRec); ++i) {
+        SkAutoTUnref<SkPathEffect> dash(SkDashPathEffect::Create(intervals,
+                                                                 SK_ARRAY_COUNT(intervals),
+                                                                 gRec[i].fPhase));
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(gRec[i].fWidth);
+        paint.setStrokeCap(gRec[i].fCap);
+        paint.setAntiAlias(gRec[i].fAA);
+
+        SkPaint dashPaint(paint);
+        dashPaint.setPathEffect(dash);
+
+        SkBitmap actual, expected;
+        actual.allocPixels(info);
+        actual.eraseColor(SK_ColorTRANSPARENT);
+        expected.allocPixels(info);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+
+        SkCanvas actualCanvas(actual);
+        actualCanvas.scale(gRec[i].fScale, gRec[i].fScale);
+        actualCanvas.drawPath(*gRec[i].fPath, dashPaint);
+
+        SkPath fillPath;
+        SkPaint fillPaint(paint);
+        if (dashPaint.getFillPath(*gRec[i].fPath, &fillPath)) {
+            fillPaint.setStyle(SkPaint::kFill_Style);
+        } else {
+            fillPaint.setStrokeWidth(0);
+        }
+        SkCanvas expectedCanvas(expected);
+        expectedCanvas.scale(gRec[i].fScale, gRec[i].fScale);
+        expectedCanvas.drawPath(fillPath, fillPaint);
+
+        // The dashes are placed to within float rounding of SkPathMeasure's,
+        // and thick ones are blitted as rects rather than scan converted.
+        const int tolerance = 4;
+        REPORTER_ASSERT(reporter, bitmaps_nearly_equal(actual, expected, tolerance));
+    }
+}
+
 DEF_TEST(DrawPath, reporter) {
     test_giantaa();
     test_bug533();
@@ -288,4 +396,5 @@ DEF_TEST(DrawPath, reporter) {
     test_infinite_dash(reporter);
     test_crbug_165432(reporter);
     test_big_aa_rect(reporter);
+    test_dashed_lines(reporter);
 }
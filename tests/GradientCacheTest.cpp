@@ -0,0 +1,130 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradientCache.h"
+#include "SkGradientShader.h"
+#include "SkGradientShaderPriv.h"
+#include "Test.h"
+
+class CountedRefCnt : public SkRefCnt {
+public:
+    explicit CountedRefCnt(int* liveCount) : fLiveCount(liveCount) { *fLiveCount += 1; }
+    virtual ~CountedRefCnt() { *fLiveCount -= 1; }
+
+private:
+    int* fLiveCount;
+};
+
+static void test_cache(skiatest::Reporter* reporter) {
+    int liveCount = 0;
+    {
+        SkGradientCache cache(10 * 1024);
+        for (int i = 1; i <= 20; ++i) {
+            uint32_t data[3] = { 0xFF, (uint32_t)i, 0x12345678 };
+            SkGradientCache::Key key(data, SK_ARRAY_COUNT(data));
+
+            REPORTER_ASSERT(reporter, NULL == cache.findAndRef(key));
+            SkAutoTUnref<CountedRefCnt> value(SkNEW_ARGS(CountedRefCnt, (&liveCount)));
+            cache.add(key, value, 1024);
+
+            // The cache keeps its own copy of the key's data.
+            uint32_t copy[3] = { 0xFF, (uint32_t)i, 0x12345678 };
+            SkAutoTUnref<SkRefCnt> found(cache.findAndRef(SkGradientCache::Key(copy, 3)));
+            REPORTER_ASSERT(reporter, found.get() == value.get());
+            REPORTER_ASSERT(reporter, cache.getBytesUsed() <= cache.getByteLimit());
+        }
+        REPORTER_ASSERT(reporter, 20 == cache.getHitCount());
+        REPORTER_ASSERT(reporter, 20 == cache.getMissCount());
+        // Purged values have been unreffed.
+        REPORTER_ASSERT(reporter, 10 == liveCount);
+
+        // Too big to cache at all.
+        uint32_t data[1] = { 0 };
+        SkAutoTUnref<CountedRefCnt> value(SkNEW_ARGS(CountedRefCnt, (&liveCount)));
+        cache.add(SkGradientCache::Key(data, 1), value, 20 * 1024);
+        REPORTER_ASSERT(reporter, NULL == cache.findAndRef(SkGradientCache::Key(data, 1)));
+
+        cache.setByteLimit(0);
+        REPORTER_ASSERT(reporter, 0 == cache.getBytesUsed());
+        REPORTER_ASSERT(reporter, 1 == liveCount);
+    }
+    REPORTER_ASSERT(reporter, 0 == liveCount);
+}
+
+static void test_key(skiatest::Reporter* reporter) {
+    uint32_t data0[] = { 1, 2, 3, 4 };
+    uint32_t data1[] = { 1, 2, 3, 4 };
+    uint32_t data2[] = { 1, 2, 3, 5 };
+    REPORTER_ASSERT(reporter, SkGradientCache::Key(data0, 4) == SkGradientCache::Key(data1, 4));
+    REPORTER_ASSERT(reporter, !(SkGradientCache::Key(data0, 4) == SkGradientCache::Key(data2, 4)));
+    REPORTER_ASSERT(reporter, !(SkGradientCache::Key(data0, 4) == SkGradientCache::Key(data0, 3)));
+}
+
+static SkShader* make_shader(int type, SkShader::TileMode mode) {
+    static const SkPoint gPts[] = { { 10, 20 }, { 90, 70 } };
+    static const SkColor gColors[] = { SK_ColorRED, 0x8000FF00, SK_ColorBLUE, SK_ColorWHITE };
+    static const SkScalar gPos[] = { 0, 0.25f, 0.5f, 1 };
+    switch (type) {
+        case 0:
+            return SkGradientShader::CreateLinear(gPts, gColors, gPos, 4, mode);
+        case 1:
+            return SkGradientShader::CreateRadial(gPts[0], 60, gColors, gPos, 4, mode);
+        case 2:
+            return SkGradientShader::CreateSweep(50, 50, gColors, gPos, 4);
+        default:
+            return SkGradientShader::CreateTwoPointConical(gPts[0], 10, gPts[1], 50,
+                                                           gColors, gPos, 4, mode);
+    }
+}
+
+typedef SkGradientShaderBase::GradientShaderCache GradientShaderCache;
+
+static bool same_tables(GradientShaderCache* a, GradientShaderCache* b) {
+    return 0 == memcmp(a->getCache32(), b->getCache32(),
+                       SkGradientShaderBase::kCache32Count * 4 * sizeof(SkPMColor)) &&
+           0 == memcmp(a->getCache16(), b->getCache16(),
+                       SkGradientShaderBase::kCache16Count * 2 * sizeof(uint16_t));
+}
+
+// Gradients with the same stops must share tables, which must match the ones
+// each would build for itself.
+static void test_shared(skiatest::Reporter* reporter) {
+    static const U8CPU gAlphas[] = { 0xFF, 0x80 };
+    for (int type = 0; type < 4; ++type) {
+        for (size_t a = 0; a < SK_ARRAY_COUNT(gAlphas); ++a) {
+            SkGradientCache cache(1024 * 1024);
+            SkAutoTUnref<SkShader> shader0(make_shader(type, SkShader::kClamp_TileMode));
+            SkAutoTUnref<SkShader> shader1(make_shader(type, SkShader::kClamp_TileMode));
+            const SkGradientShaderBase* base0 = static_cast<SkGradientShaderBase*>(shader0.get());
+            const SkGradientShaderBase* base1 = static_cast<SkGradientShaderBase*>(shader1.get());
+
+            SkAutoTUnref<GradientShaderCache> shared0(base0->findOrMakeCache(gAlphas[a], &cache));
+            SkAutoTUnref<GradientShaderCache> shared1(base1->findOrMakeCache(gAlphas[a], &cache));
+            REPORTER_ASSERT(reporter, shared0.get() == shared1.get());
+            REPORTER_ASSERT(reporter, 1 == cache.getHitCount());
+
+            SkAutoTUnref<GradientShaderCache> own(SkNEW_ARGS(GradientShaderCache,
+                                                             (gAlphas[a], *base1)));
+            REPORTER_ASSERT(reporter, same_tables(shared1, own));
+        }
+    }
+
+    // A different alpha needs different tables.
+    SkGradientCache cache(1024 * 1024);
+    SkAutoTUnref<SkShader> shader(make_shader(0, SkShader::kClamp_TileMode));
+    const SkGradientShaderBase* base = static_cast<SkGradientShaderBase*>(shader.get());
+    SkAutoTUnref<GradientShaderCache> opaque(base->findOrMakeCache(0xFF, &cache));
+    SkAutoTUnref<GradientShaderCache> faded(base->findOrMakeCache(0x40, &cache));
+    REPORTER_ASSERT(reporter, opaque.get() != faded.get());
+    REPORTER_ASSERT(reporter, 0x40 == faded->getAlpha());
+}
+
+DEF_TEST(GradientCache, reporter) {
+    test_cache(reporter);
+    test_key(reporter);
+    test_shared(reporter);
+}
@@ -6,9 +6,12 @@
  */
 
 #include "SkBitmapDevice.h"
+#include "SkColorPriv.h"
 #include "SkColorShader.h"
 #include "SkEmptyShader.h"
 #include "SkGradientShader.h"
+#include "SkGradient_opts.h"
+#include "SkRandom.h"
 #include "SkShader.h"
 #include "SkTemplates.h"
 #include "Test.h"
@@ -156,6 +159,246 @@ static void TestConstantGradient(skiatest::Reporter*) {
     }
 }
 
+static int max_component_diff(SkPMColor a, SkPMColor b) {
+    int diff = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        diff = SkMax32(diff, SkAbs32((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)));
+    }
+    return diff;
+}
+
+// The float span path should agree with the cached 8 bit path, up to the
+// quantization of the 256 entry cache (and its dithering).
+static void test_shade_span_4f(skiatest::Reporter* reporter, SkShader* shader) {
+    SkBitmap device;
+    device.allocN32Pixels(64, 8);
+    SkPaint paint;
+    SkMatrix matrix;
+    matrix.reset();
+    SkShader::ContextRec rec(device, paint, matrix);
+
+    SkAutoMalloc storage(shader->contextSize());
+    SkShader::Context* ctx = shader->createContext(rec, storage.get());
+    REPORTER_ASSERT(reporter, ctx);
+    if (NULL == ctx) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, SkToBool(ctx->getFlags() & SkShader::kSupports4f_Flag));
+
+    const int kCount = 64;
+    SkPMColor span[kCount];
+    SkPM4f span4f[kCount];
+    for (int y = 0; y < 8; ++y) {
+        ctx->shadeSpan(0, y, span, kCount);
+        ctx->shadeSpan4f(0, y, span4f, kCount);
+        for (int x = 0; x < kCount; ++x) {
+            REPORTER_ASSERT(reporter, max_component_diff(span4f[x].toPMColor(), span[x]) <= 8);
+        }
+    }
+    ctx->~Context();
+}
+
+static void TestGradientShadeSpan4f(skiatest::Reporter* reporter) {
+    static const SkColor gColors[] = { SK_ColorRED, SK_ColorGREEN, 0x800000FF };
+    static const SkScalar gPos[] = { 0, 0.25f, SK_Scalar1 };
+    const SkPoint pts[] = {
+        { SkIntToScalar(4), 0 },
+        { SkIntToScalar(36), SkIntToScalar(6) }
+    };
+
+    for (int mode = 0; mode < SkShader::kTileModeCount; ++mode) {
+        SkShader::TileMode tm = (SkShader::TileMode)mode;
+        SkAutoTUnref<SkShader> linear(SkGradientShader::CreateLinear(pts, gColors, gPos,
+                                                                     SK_ARRAY_COUNT(gColors), tm));
+        SkAutoTUnref<SkShader> radial(SkGradientShader::CreateRadial(pts[0], SkIntToScalar(20),
+                                                                     gColors, NULL,
+                                                                     SK_ARRAY_COUNT(gColors), tm));
+        test_shade_span_4f(reporter, linear);
+        test_shade_span_4f(reporter, radial);
+    }
+    SkAutoTUnref<SkShader> sweep(SkGradientShader::CreateSweep(SkIntToScalar(32), SkIntToScalar(4),
+                                                               gColors, gPos,
+                                                               SK_ARRAY_COUNT(gColors)));
+    test_shade_span_4f(reporter, sweep);
+}
+
+// Portable versions of the span procs' math, from src/effects/gradients.
+
+static uint32_t radial_clamp_index(SkFixed fx, SkFixed fy) {
+    unsigned xx = SkPin32(fx, -0xFFFF >> 1, 0xFFFF >> 1);
+    unsigned yy = SkPin32(fy, -0xFFFF >> 1, 0xFFFF >> 1);
+    return SkFastMin32((xx * xx + yy * yy) >> (14 + 16 - 11), 0xFFFF >> (16 - 11));
+}
+
+static int sweep_index(float fy, float fx) {
+    float result = sk_float_atan2(fy, fx);
+    if (result < 0) {
+        result += 2 * SK_ScalarPI;
+    }
+    return (int)(result * 40.584510488433314f);
+}
+
+static SkFixed conical_t(const SkTwoPointConicalSpan& span, float relX, float relY, float B) {
+    static const SkFixed kDontDrawT = (SkFixed)0x80000000;
+    float C = relX * relX + relY * relY - span.fRadius2;
+    float roots[2];
+    int count;
+    if (0 == span.fA) {
+        if (0 == B) {
+            return kDontDrawT;
+        }
+        roots[0] = -C / B;
+        count = 1;
+    } else {
+        float R = B * B - 4 * span.fA * C;
+        if (R < 0) {
+            return kDontDrawT;
+        }
+        R = sk_float_sqrt(R);
+        float Q = B < 0 ? B - R : B + R;
+        Q *= -0.5f;
+        if (0 == Q) {
+            roots[0] = 0;
+            count = 1;
+        } else {
+            float r0 = Q / span.fA;
+            float r1 = C / Q;
+            roots[0] = r0 < r1 ? r0 : r1;
+            roots[1] = r0 > r1 ? r0 : r1;
+            if (span.fFlipped) {
+                SkTSwap(roots[0], roots[1]);
+            }
+            count = 2;
+        }
+    }
+    float t = roots[count - 1];
+    if (span.fRadius + t * span.fDRadius <= 0) {
+        t = roots[0];
+        if (span.fRadius + t * span.fDRadius <= 0) {
+            return kDontDrawT;
+        }
+    }
+    return SkFloatToFixed(t);
+}
+
+// NEON estimates square roots and reciprocals, so its radial and conical t may
+// be a few float ulps off the portable math. Elsewhere they must match exactly.
+static bool close_t(SkFixed expected, SkFixed actual) {
+    if (expected == actual) {
+        return true;
+    }
+#if defined(SK_CPU_ARM32) || defined(SK_CPU_ARM64)
+    // Plus one for truncating to fixed point. Neither may be kDontDrawT.
+    const SkFixed kDontDrawT = (SkFixed)0x80000000;
+    return kDontDrawT != expected && kDontDrawT != actual &&
+           SkAbs32(expected - actual) <= 1 + (SkAbs32(expected) >> 18);
+#else
+    return false;
+#endif
+}
+
+// Whether t is drawn with a radius so close to 0 that an estimate may have
+// taken the other root, or skipped the pixel.
+static bool nearly_zero_radius(const SkTwoPointConicalSpan& span, SkFixed t) {
+#if defined(SK_CPU_ARM32) || defined(SK_CPU_ARM64)
+    return (SkFixed)0x80000000 != t &&
+           SkScalarNearlyZero(span.fRadius + SkFixedToFloat(t) * span.fDRadius, 1.0f / (1 << 14));
+#else
+    return false;
+#endif
+}
+
+// The platform's span procs must match the portable math (up to close_t()),
+// except for sweep, whose indices may be one off (0 and 254 being neighbors).
+static void TestGradientSpanProcs(skiatest::Reporter* reporter) {
+    SkGradientSpanProcs procs;
+    SkGradientGetPlatformSpanProcs(&procs);
+
+    SkRandom rand;
+    const int kMaxCount = 37;
+    uint32_t out[kMaxCount];
+    for (int i = 0; i < 200; ++i) {
+        const int count = 1 + i % kMaxCount;
+        // Points from well inside to well outside the unit circle.
+        float fx = rand.nextRangeF(-1.5f, 1.5f);
+        float fy = rand.nextRangeF(-1.5f, 1.5f);
+        float dx = rand.nextRangeF(-0.1f, 0.1f);
+        float dy = rand.nextRangeF(-0.1f, 0.1f);
+        if (0 == i % 4) {
+            dy = 0;
+        }
+
+        if (procs.fRadialClamp) {
+            SkFixed x = SkFloatToFixed(fx) >> 1, dfx = SkFloatToFixed(dx) >> 1;
+            SkFixed y = SkFloatToFixed(fy) >> 1, dfy = SkFloatToFixed(dy) >> 1;
+            procs.fRadialClamp(x, dfx, y, dfy, count, out);
+            for (int j = 0; j < count; ++j) {
+                REPORTER_ASSERT(reporter, radial_clamp_index(x, y) == out[j]);
+                x += dfx;
+                y += dfy;
+            }
+        }
+
+        if (procs.fRadial) {
+            procs.fRadial(fx, dx, fy, dy, count, reinterpret_cast<SkFixed*>(out));
+            float x = fx, y = fy;
+            for (int j = 0; j < count; ++j) {
+                SkFixed dist = SkFloatToFixed(sk_float_sqrt(x * x + y * y));
+                REPORTER_ASSERT(reporter, close_t(dist, (SkFixed)out[j]));
+                x += dx;
+                y += dy;
+            }
+        }
+
+        if (procs.fSweep) {
+            float sx = 100 * fx, sy = 100 * fy;
+            procs.fSweep(sx, dx, sy, dy, count, out);
+            for (int j = 0; j < count; ++j) {
+                int diff = SkAbs32(sweep_index(sy, sx) - (int)out[j]);
+                REPORTER_ASSERT(reporter, out[j] <= 255 && (diff <= 1 || diff >= 254));
+                sx += dx;
+                sy += dy;
+            }
+        }
+
+        if (procs.fTwoPointConical) {
+            SkTwoPointConicalSpan span;
+            float dcx = rand.nextRangeF(-1, 1);
+            float dcy = rand.nextRangeF(-1, 1);
+            span.fRadius = rand.nextRangeF(0, 1);
+            span.fDRadius = rand.nextRangeF(-1, 1);
+            // Concentric, and touching, circles give the A == 0 cases.
+            if (0 == i % 5) {
+                dcx = dcy = 0;
+            } else if (1 == i % 5) {
+                span.fDRadius = dcx;
+                dcy = 0;
+            }
+            span.fA = dcx * dcx + dcy * dcy - span.fDRadius * span.fDRadius;
+            span.fRadius2 = span.fRadius * span.fRadius;
+            span.fFlipped = SkToBool(i & 1);
+            span.fRelX = fx;
+            span.fRelY = fy;
+            span.fIncX = dx;
+            span.fIncY = dy;
+            span.fB = -2 * (dcx * fx + dcy * fy + span.fRadius * span.fDRadius);
+            span.fDB = -2 * (dcx * dx + dcy * dy);
+
+            procs.fTwoPointConical(span, count, reinterpret_cast<SkFixed*>(out));
+            float x = fx, y = fy, B = span.fB;
+            for (int j = 0; j < count; ++j) {
+                SkFixed expected = conical_t(span, x, y, B);
+                REPORTER_ASSERT(reporter, close_t(expected, (SkFixed)out[j]) ||
+                                          nearly_zero_radius(span, expected) ||
+                                          nearly_zero_radius(span, (SkFixed)out[j]));
+                x += dx;
+                y += dy;
+                B += span.fDB;
+            }
+        }
+    }
+}
+
 typedef void (*GradProc)(skiatest::Reporter* reporter, const GradRec&);
 
 static void TestGradientShaders(skiatest::Reporter* reporter) {
@@ -193,4 +436,6 @@ static void TestGradientShaders(skiatest::Reporter* reporter) {
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestConstantGradient(reporter);
+    TestGradientShadeSpan4f(reporter);
+    TestGradientSpanProcs(reporter);
 }
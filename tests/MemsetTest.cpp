@@ -35,6 +35,25 @@ static void test_chunkalloc(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, !alloc.contains(ptr));
     REPORTER_ASSERT(reporter, 0 == alloc.totalCapacity());
     REPORTER_ASSERT(reporter, 0 == alloc.totalUsed());
+
+    // rewind() should leave one block with room for everything allocated before it.
+    for (int i = 0; i < 10; ++i) {
+        alloc.allocThrow(min);
+    }
+    REPORTER_ASSERT(reporter, alloc.blockCount() > 1);
+    const size_t capacity = alloc.totalCapacity();
+    alloc.rewind();
+    REPORTER_ASSERT(reporter, 1 == alloc.blockCount());
+    REPORTER_ASSERT(reporter, capacity == alloc.totalCapacity());
+    REPORTER_ASSERT(reporter, 0 == alloc.totalUsed());
+    for (int i = 0; i < 10; ++i) {
+        alloc.allocThrow(min);
+    }
+    REPORTER_ASSERT(reporter, 1 == alloc.blockCount());
+
+    alloc.rewind();
+    REPORTER_ASSERT(reporter, 1 == alloc.blockCount());
+    REPORTER_ASSERT(reporter, capacity == alloc.totalCapacity());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
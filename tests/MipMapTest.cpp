@@ -6,6 +6,8 @@
  */
 
 #include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkColorTable.h"
 #include "SkMipMap.h"
 #include "SkRandom.h"
 #include "Test.h"
@@ -19,6 +21,155 @@ static void make_bitmap(SkBitmap* bm, SkRandom& rand) {
     bm->eraseColor(SK_ColorWHITE);
 }
 
+static void make_random_bitmap(SkBitmap* bm, SkColorType ct, int w, int h, SkRandom& rand) {
+    SkColorTable* ctable = NULL;
+    if (kIndex_8_SkColorType == ct) {
+        SkPMColor colors[256];
+        for (int i = 0; i < 256; ++i) {
+            colors[i] = SkPreMultiplyColor(rand.nextU());
+        }
+        ctable = SkNEW_ARGS(SkColorTable, (colors, 256, kPremul_SkAlphaType));
+    }
+    bm->allocPixels(SkImageInfo::Make(w, h, ct, kPremul_SkAlphaType), NULL, ctable);
+    SkSafeUnref(ctable);
+
+    SkAutoLockPixels alp(*bm);
+    for (int y = 0; y < h; ++y) {
+        uint8_t* row = static_cast<uint8_t*>(bm->getAddr(0, y));
+        for (size_t i = 0; i < bm->info().minRowBytes(); ++i) {
+            row[i] = rand.nextU() & 0xFF;
+        }
+    }
+    if (kRGBA_8888_SkColorType == ct || kBGRA_8888_SkColorType == ct) {
+        // keep the pixels premultiplied, though the averaging doesn't care
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                uint32_t* c = bm->getAddr32(x, y);
+                *c = SkPreMultiplyColor(*c);
+            }
+        }
+    }
+}
+
+// Returns pixel (x, y) of a level or bitmap, as 32 bits.
+static uint32_t get_pixel(const void* pixels, size_t rowBytes, int bpp, int x, int y) {
+    const char* row = static_cast<const char*>(pixels) + y * rowBytes;
+    switch (bpp) {
+        case 1: return reinterpret_cast<const uint8_t*>(row)[x];
+        case 2: return reinterpret_cast<const uint16_t*>(row)[x];
+        default: return reinterpret_cast<const uint32_t*>(row)[x];
+    }
+}
+
+// Returns the 2x2 box filter of a, b, c and d, one field at a time.
+static uint32_t average(SkColorType ct, uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    static const int k565Shifts[] = { SK_R16_SHIFT, SK_G16_SHIFT, SK_B16_SHIFT };
+    static const int k565Bits[] = { SK_R16_BITS, SK_G16_BITS, SK_B16_BITS };
+    uint32_t result = 0;
+    int fields = 4;
+    for (int i = 0; i < 4; ++i) {
+        int shift, bits;
+        switch (ct) {
+            case kRGB_565_SkColorType:
+                fields = 3;
+                shift = k565Shifts[i % 3];
+                bits = k565Bits[i % 3];
+                break;
+            case kARGB_4444_SkColorType:
+                shift = 4 * i;
+                bits = 4;
+                break;
+            case kAlpha_8_SkColorType:
+                fields = 1;
+                shift = 0;
+                bits = 8;
+                break;
+            default:
+                shift = 8 * i;
+                bits = 8;
+                break;
+        }
+        if (i >= fields) {
+            break;
+        }
+        uint32_t mask = (1 << bits) - 1;
+        uint32_t sum = ((a >> shift) & mask) + ((b >> shift) & mask) +
+                       ((c >> shift) & mask) + ((d >> shift) & mask);
+        result |= (sum >> 2) << shift;
+    }
+    return result;
+}
+
+static void test_levels(skiatest::Reporter* reporter, SkColorType ct,
+                        SkMipMap::BuildMode mode, SkRandom& rand) {
+    const int w = 3 + rand.nextU() % 150;
+    const int h = 3 + rand.nextU() % 150;
+    SkBitmap bm;
+    make_random_bitmap(&bm, ct, w, h, rand);
+
+    SkAutoTUnref<SkMipMap> mm(SkMipMap::Build(bm, mode));
+    REPORTER_ASSERT(reporter, mm);
+    if (NULL == mm) {
+        return;
+    }
+
+    // A lazy mipmap counts the source pixels it holds until it builds its first level.
+    const size_t initialSize = mm->getSize();
+    REPORTER_ASSERT(reporter, mm->extractLevel(SK_ScalarHalf, NULL));
+    if (SkMipMap::kLazy_BuildMode == mode) {
+        SkMipMap::Level level;
+        REPORTER_ASSERT(reporter, mm->extractLevel(SK_ScalarHalf, &level));
+        REPORTER_ASSERT(reporter, initialSize == mm->getSize() + bm.getSize());
+    } else {
+        REPORTER_ASSERT(reporter, initialSize == mm->getSize());
+    }
+
+    // Index8 levels are expanded to N32.
+    SkBitmap src;
+    if (kIndex_8_SkColorType == ct) {
+        REPORTER_ASSERT(reporter, bm.copyTo(&src, kN32_SkColorType));
+        ct = kN32_SkColorType;
+    } else {
+        src = bm;
+    }
+    SkAutoLockPixels alp(src);
+    const int bpp = SkColorTypeBytesPerPixel(ct);
+
+    const void* srcPixels = src.getPixels();
+    size_t srcRowBytes = src.rowBytes();
+    int srcWidth = w;
+    SkScalar scale = SK_Scalar1;
+    for (;;) {
+        scale = SkScalarHalf(scale);
+        SkMipMap::Level level;
+        if (!mm->extractLevel(scale, &level) || (int)level.fWidth == srcWidth) {
+            break;
+        }
+        REPORTER_ASSERT(reporter, level.fColorType == ct);
+        REPORTER_ASSERT(reporter, (int)level.fWidth == srcWidth / 2);
+
+        bool match = true;
+        for (uint32_t y = 0; y < level.fHeight && match; ++y) {
+            for (uint32_t x = 0; x < level.fWidth; ++x) {
+                uint32_t expected = average(ct,
+                        get_pixel(srcPixels, srcRowBytes, bpp, 2 * x, 2 * y),
+                        get_pixel(srcPixels, srcRowBytes, bpp, 2 * x + 1, 2 * y),
+                        get_pixel(srcPixels, srcRowBytes, bpp, 2 * x, 2 * y + 1),
+                        get_pixel(srcPixels, srcRowBytes, bpp, 2 * x + 1, 2 * y + 1));
+                if (expected != get_pixel(level.fPixels, level.fRowBytes, bpp, x, y)) {
+                    match = false;
+                    break;
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, match);
+
+        srcPixels = level.fPixels;
+        srcRowBytes = level.fRowBytes;
+        srcWidth = level.fWidth;
+    }
+}
+
 DEF_TEST(MipMap, reporter) {
     SkBitmap bm;
     SkRandom rand;
@@ -52,4 +203,15 @@ DEF_TEST(MipMap, reporter) {
             }
         }
     }
+
+    const SkColorType colorTypes[] = {
+        kN32_SkColorType, kRGB_565_SkColorType, kARGB_4444_SkColorType,
+        kAlpha_8_SkColorType, kIndex_8_SkColorType,
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(colorTypes); ++i) {
+        for (int j = 0; j < 10; ++j) {
+            test_levels(reporter, colorTypes[i], SkMipMap::kEager_BuildMode, rand);
+            test_levels(reporter, colorTypes[i], SkMipMap::kLazy_BuildMode, rand);
+        }
+    }
 }
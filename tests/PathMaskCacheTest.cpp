@@ -0,0 +1,208 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkDraw.h"
+#include "SkPath.h"
+#include "SkPathMaskCache.h"
+#include "SkRasterClip.h"
+#include "Test.h"
+
+static void make_mask(SkMask* mask, int w, int h) {
+    mask->fBounds.set(0, 0, w, h);
+    mask->fFormat = SkMask::kA8_Format;
+    mask->fRowBytes = w;
+    mask->fImage = SkMask::AllocImage(mask->computeImageSize());
+}
+
+static void make_key(SkPathMaskCache::Key* key, const SkPath& path, SkScalar scale) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkMatrix matrix;
+    matrix.setScale(scale, scale);
+    SkIPoint offset;
+    bool ok = SkPathMaskCache::ComputeKey(path, paint, matrix, key, &offset);
+    SkASSERT(ok);
+    SkASSERT(0 == offset.fX && 0 == offset.fY);
+    sk_ignore_unused_variable(ok);
+}
+
+static const int COUNT = 10;
+static const int DIM = 64;
+
+static void test_cache(skiatest::Reporter* reporter) {
+    SkPathMaskCache cache(COUNT * DIM * DIM);
+    SkPath path;
+    path.addCircle(8, 8, 8);
+
+    for (int i = 0; i < COUNT; ++i) {
+        SkPathMaskCache::Key key;
+        make_key(&key, path, SkIntToScalar(i + 1));
+
+        SkMask tmp;
+        SkPathMaskCache::ID* id = cache.findAndLock(key, &tmp);
+        REPORTER_ASSERT(reporter, NULL == id);
+
+        make_mask(&tmp, DIM, DIM);
+        id = cache.addAndLock(key, tmp);
+        REPORTER_ASSERT(reporter, NULL != id);
+
+        SkMask tmp2;
+        SkPathMaskCache::ID* id2 = cache.findAndLock(key, &tmp2);
+        REPORTER_ASSERT(reporter, id == id2);
+        REPORTER_ASSERT(reporter, tmp.fImage == tmp2.fImage);
+        REPORTER_ASSERT(reporter, tmp.fBounds == tmp2.fBounds);
+        cache.unlock(id2);
+
+        cache.unlock(id);
+    }
+    REPORTER_ASSERT(reporter, cache.getBytesUsed() == (size_t)(COUNT * DIM * DIM));
+
+    // stress test, should trigger purges
+    for (int i = COUNT; i < COUNT * 10; ++i) {
+        SkPathMaskCache::Key key;
+        make_key(&key, path, SkIntToScalar(i + 1) / 16);
+
+        SkMask tmp;
+        make_mask(&tmp, DIM, DIM);
+        SkPathMaskCache::ID* id = cache.addAndLock(key, tmp);
+        REPORTER_ASSERT(reporter, NULL != id);
+        cache.unlock(id);
+        REPORTER_ASSERT(reporter, cache.getBytesUsed() <= cache.getByteLimit());
+    }
+
+    cache.setByteLimit(0);
+    REPORTER_ASSERT(reporter, 0 == cache.getBytesUsed());
+}
+
+static void test_key(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.addCircle(8, 8, 8);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    SkMatrix matrix;
+    matrix.setTranslate(SkIntToScalar(3), SkFloatToScalar(4.25f));
+    SkPathMaskCache::Key key0, key1;
+    SkIPoint offset;
+    REPORTER_ASSERT(reporter, SkPathMaskCache::ComputeKey(path, paint, matrix, &key0, &offset));
+    REPORTER_ASSERT(reporter, 3 == offset.fX && 4 == offset.fY);
+
+    // integer translations share a key
+    matrix.postTranslate(SkIntToScalar(-10), SkIntToScalar(20));
+    REPORTER_ASSERT(reporter, SkPathMaskCache::ComputeKey(path, paint, matrix, &key1, &offset));
+    REPORTER_ASSERT(reporter, -7 == offset.fX && 24 == offset.fY);
+    REPORTER_ASSERT(reporter, key0 == key1);
+
+    // ...but fractional ones do not
+    matrix.postTranslate(SkFloatToScalar(0.5f), 0);
+    REPORTER_ASSERT(reporter, SkPathMaskCache::ComputeKey(path, paint, matrix, &key1, &offset));
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+    matrix.postTranslate(SkFloatToScalar(-0.5f), 0);
+
+    // editing the path changes its key
+    path.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, SkPathMaskCache::ComputeKey(path, paint, matrix, &key1, &offset));
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+
+    SkPaint strokePaint(paint);
+    strokePaint.setStyle(SkPaint::kStroke_Style);
+    strokePaint.setStrokeWidth(2);
+    REPORTER_ASSERT(reporter, SkPathMaskCache::ComputeKey(path, strokePaint, matrix, &key0, &offset));
+    strokePaint.setStrokeWidth(3);
+    REPORTER_ASSERT(reporter, SkPathMaskCache::ComputeKey(path, strokePaint, matrix, &key1, &offset));
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+
+    // uncacheable cases
+    strokePaint.setStrokeWidth(0);
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::ComputeKey(path, strokePaint, matrix, &key0, &offset));
+    SkPaint bwPaint;
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::ComputeKey(path, bwPaint, matrix, &key0, &offset));
+    SkPath bigPath;
+    bigPath.addCircle(500, 500, 500);
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::ComputeKey(bigPath, paint, matrix, &key0, &offset));
+}
+
+// Draws path into bm, translated by (dx, dy), through our own cache rather than
+// the global one.
+static void draw_path(SkBitmap* bm, const SkPath& path, const SkPaint& paint,
+                      SkScalar dx, SkScalar dy, SkPathMaskCache* cache) {
+    SkMatrix matrix;
+    matrix.setTranslate(dx, dy);
+    SkRasterClip rc(SkIRect::MakeWH(bm->width(), bm->height()));
+
+    SkDraw draw;
+    draw.fBitmap = bm;
+    draw.fMatrix = &matrix;
+    draw.fRC = &rc;
+    draw.fClip = &rc.bwRgn();
+    draw.fPathMaskCache = cache;
+    draw.drawPath(path, paint);
+}
+
+// Drawing through the cache must match drawing directly, at each offset. The
+// offsets keep the path's bounds inside the bitmap, since a clipped path is flattened
+// after clipping when drawn directly, and so may differ slightly.
+static void test_draw(skiatest::Reporter* reporter) {
+    const int W = 64;
+    const int H = 64;
+
+    SkPath path;
+    path.moveTo(2, 3);
+    path.cubicTo(30, 0, 0, 30, 20, 20);
+    path.quadTo(5, 25, 2, 3);
+
+    SkPaint paints[2];
+    paints[0].setAntiAlias(true);
+    paints[0].setColor(0xFF336699);
+    paints[1] = paints[0];
+    paints[1].setStyle(SkPaint::kStroke_Style);
+    paints[1].setStrokeWidth(SkFloatToScalar(2.5f));
+
+    const SkPoint offsets[] = {
+        { 0, 0 }, { 10, 5 }, { 30, 31 },
+        { SkFloatToScalar(10.25f), SkFloatToScalar(5.75f) }, { 33, 2 },
+    };
+
+    SkPathMaskCache disabled(0);
+    for (size_t p = 0; p < SK_ARRAY_COUNT(paints); ++p) {
+        for (size_t i = 0; i < SK_ARRAY_COUNT(offsets); ++i) {
+            SkPathMaskCache cache(1024 * 1024);
+            const SkScalar dx = offsets[i].fX;
+            const SkScalar dy = offsets[i].fY;
+
+            SkBitmap direct, cached, scratch;
+            direct.allocN32Pixels(W, H);
+            cached.allocN32Pixels(W, H);
+            scratch.allocN32Pixels(W, H);
+            direct.eraseColor(SK_ColorWHITE);
+            cached.eraseColor(SK_ColorWHITE);
+
+            draw_path(&direct, path, paints[p], dx, dy, &disabled);
+            REPORTER_ASSERT(reporter, 0 == disabled.getBytesUsed());
+
+            // The first draw adds the mask, at a different integer offset,
+            // and the second finds it.
+            draw_path(&scratch, path, paints[p], dx + 1, dy - 2, &cache);
+            size_t bytesUsed = cache.getBytesUsed();
+            REPORTER_ASSERT(reporter, bytesUsed > 0);
+
+            draw_path(&cached, path, paints[p], dx, dy, &cache);
+            REPORTER_ASSERT(reporter, cache.getBytesUsed() == bytesUsed);
+
+            SkAutoLockPixels alp0(direct), alp1(cached);
+            REPORTER_ASSERT(reporter, 0 == memcmp(direct.getPixels(), cached.getPixels(),
+                                                  direct.getSize()));
+        }
+    }
+}
+
+DEF_TEST(PathMaskCache, reporter) {
+    test_cache(reporter);
+    test_key(reporter);
+    test_draw(reporter);
+}
@@ -20,6 +20,7 @@
 #include "SkImageGenerator.h"
 #include "SkPaint.h"
 #include "SkPicture.h"
+#include "SkPictureFlat.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
 #include "SkRRect.h"
@@ -1233,6 +1234,95 @@ static void test_clone_empty(skiatest::Reporter* reporter) {
     }
 }
 
+// Clones share their paints unless one needs a deep copy.  Either way they must draw the same.
+static void test_clone_draws_same(skiatest::Reporter* reporter) {
+    for (int imageFilter = 0; imageFilter < 2; imageFilter++) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(50, 50, NULL, 0);
+        SkPaint paint;
+        for (int i = 0; i < 5; i++) {
+            paint.setColor(SkColorSetRGB(i * 50, 0, 255 - i * 50));
+            canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(i * 10), 0, 10, 50), paint);
+        }
+        if (imageFilter) {
+            SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(2, 2));
+            paint.setImageFilter(blur);
+            canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), paint);
+        }
+        SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+        SkBitmap expected;
+        make_bm(&expected, 50, 50, SK_ColorWHITE, false);
+        SkCanvas expectedCanvas(expected);
+        picture->draw(&expectedCanvas);
+
+        SkPicture clones[2];
+        picture->clone(clones, SK_ARRAY_COUNT(clones));
+        for (size_t i = 0; i < SK_ARRAY_COUNT(clones); i++) {
+            SkBitmap actual;
+            make_bm(&actual, 50, 50, SK_ColorWHITE, false);
+            SkCanvas actualCanvas(actual);
+            clones[i].draw(&actualCanvas);
+
+            SkAutoLockPixels expectedLock(expected), actualLock(actual);
+            REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                                  expected.getSize()));
+        }
+    }
+}
+
+// CreateFromData() plays back from the serialized data in place, and so must keep it alive.
+// It must draw the same as the original.
+static void test_create_from_data(skiatest::Reporter* reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(50, 50, NULL, 0);
+    canvas->drawColor(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(5, 5, 20, 20), paint);
+    canvas->drawText("Hamburgefons", 12, 10, 40, paint);
+    SkAutoTUnref<SkPicture> nested(recorder.endRecording());
+
+    canvas = recorder.beginRecording(50, 50, NULL, 0);
+    canvas->drawPicture(nested);
+    paint.setColor(SK_ColorRED);
+    canvas->drawCircle(25, 25, 10, paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkBitmap expected;
+    make_bm(&expected, 50, 50, SK_ColorBLACK, false);
+    SkCanvas expectedCanvas(expected);
+    picture->draw(&expectedCanvas);
+    SkAutoLockPixels expectedLock(expected);
+
+    // The ops are padded to be aligned in the stream they were written to, however far into it
+    // the picture starts, and however far that is from the start of the data we read.
+    for (size_t offset = 0; offset < 4; ++offset) {
+        SkDynamicMemoryWStream wStream;
+        wStream.write("123", offset);
+        picture->serialize(&wStream);
+        SkAutoTUnref<SkData> padded(wStream.copyToData());
+        SkAutoTUnref<SkData> data(SkData::NewSubset(padded, offset, padded->size() - offset));
+        SkAutoTUnref<SkPicture> fromData(SkPicture::CreateFromData(data));
+        REPORTER_ASSERT(reporter, NULL != fromData.get());
+        if (NULL == fromData.get()) {
+            continue;
+        }
+        REPORTER_ASSERT(reporter, !data->unique());
+
+        SkBitmap actual;
+        make_bm(&actual, 50, 50, SK_ColorBLACK, false);
+        SkCanvas actualCanvas(actual);
+        fromData->draw(&actualCanvas);
+
+        SkAutoLockPixels actualLock(actual);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                              expected.getSize()));
+    }
+
+    REPORTER_ASSERT(reporter, NULL == SkPicture::CreateFromData(NULL));
+}
+
 static void test_draw_empty(skiatest::Reporter* reporter) {
     SkBitmap result;
     make_bm(&result, 2, 2, SK_ColorBLACK, false);
@@ -1484,6 +1574,45 @@ static void test_hierarchical(skiatest::Reporter* reporter) {
     }
 }
 
+// Counts the ops of each type it's told about.
+class CountingProfiler : public SkPlaybackProfiler {
+public:
+    CountingProfiler() : fBegins(0), fEnds(0) { sk_bzero(fCounts, sizeof(fCounts)); }
+
+    virtual void beginOp(uint32_t, int type, const char*) SK_OVERRIDE {
+        fBegins++;
+        if (type >= 0 && type < (int)SK_ARRAY_COUNT(fCounts)) {
+            fCounts[type]++;
+        }
+    }
+    virtual void endOp() SK_OVERRIDE { fEnds++; }
+
+    int fBegins, fEnds;
+    int fCounts[LAST_DRAWTYPE_ENUM + 1];
+};
+
+static void test_profiler(skiatest::Reporter* reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100, NULL, 0);
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    canvas->drawOval(SkRect::MakeWH(20, 20), SkPaint());
+    canvas->drawRect(SkRect::MakeWH(30, 30), SkPaint());
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    CountingProfiler profiler;
+    picture->EXPERIMENTAL_setProfiler(&profiler);
+    SkCanvas target(100, 100);
+    picture->draw(&target);
+    REPORTER_ASSERT(reporter, profiler.fBegins == profiler.fEnds);
+    REPORTER_ASSERT(reporter, 2 == profiler.fCounts[DRAW_RECT]);
+    REPORTER_ASSERT(reporter, 1 == profiler.fCounts[DRAW_OVAL]);
+
+    const int begins = profiler.fBegins;
+    picture->EXPERIMENTAL_setProfiler(NULL);
+    picture->draw(&target);
+    REPORTER_ASSERT(reporter, begins == profiler.fBegins);
+}
+
 static void test_gen_id(skiatest::Reporter* reporter) {
 
     SkPicture empty;
@@ -1545,11 +1674,14 @@ DEF_TEST(Picture, reporter) {
     test_gatherpixelrefsandrects(reporter);
     test_bitmap_with_encoded_data(reporter);
     test_clone_empty(reporter);
+    test_clone_draws_same(reporter);
+    test_create_from_data(reporter);
     test_draw_empty(reporter);
     test_clip_bound_opt(reporter);
     test_clip_expansion(reporter);
     test_hierarchical(reporter);
     test_gen_id(reporter);
+    test_profiler(reporter);
 }
 
 #if SK_SUPPORT_GPU
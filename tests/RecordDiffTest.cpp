@@ -0,0 +1,113 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "SkBlurImageFilter.h"
+#include "SkRecord.h"
+#include "SkRecordDiff.h"
+#include "SkRecorder.h"
+
+static const int W = 1920, H = 1080;
+
+// Records the same page each time, except for the pieces picked by the arguments.
+static void draw_page(SkRecord* record, SkColor buttonColor, int extraRects) {
+    SkRecorder recorder(record, W, H);
+
+    SkPaint paint;
+    recorder.clear(SK_ColorWHITE);
+    recorder.save();
+        recorder.translate(100, 100);
+        paint.setColor(buttonColor);
+        recorder.drawRect(SkRect::MakeWH(50, 20), paint);
+    recorder.restore();
+    for (int i = 0; i < extraRects; i++) {
+        paint.setColor(SK_ColorGREEN);
+        recorder.drawRect(SkRect::MakeXYWH(SkIntToScalar(500 + 10 * i), 500, 5, 5), paint);
+    }
+    paint.setColor(SK_ColorBLACK);
+    recorder.drawRect(SkRect::MakeXYWH(1000, 10, 20, 20), paint);
+}
+
+DEF_TEST(RecordDiff_Same, r) {
+    SkRecord before, after;
+    draw_page(&before, SK_ColorRED, 2);
+    draw_page(&after,  SK_ColorRED, 2);
+
+    SkRegion changed;
+    SkRecordDiff(before, after, W, H, &changed);
+    REPORTER_ASSERT(r, changed.isEmpty());
+}
+
+DEF_TEST(RecordDiff_EditInPlace, r) {
+    SkRecord before, after;
+    draw_page(&before, SK_ColorRED,  2);
+    draw_page(&after,  SK_ColorBLUE, 2);
+
+    SkRegion changed;
+    SkRecordDiff(before, after, W, H, &changed);
+
+    // Only the button changed.  Its bounds are outset a little for anti-aliasing.
+    REPORTER_ASSERT(r, changed.contains(SkIRect::MakeXYWH(100, 100, 50, 20)));
+    REPORTER_ASSERT(r, changed.isRect());
+    REPORTER_ASSERT(r, SkIRect::MakeXYWH(99, 99, 52, 22).contains(changed.getBounds()));
+}
+
+DEF_TEST(RecordDiff_Insert, r) {
+    SkRecord before, after;
+    draw_page(&before, SK_ColorRED, 2);
+    draw_page(&after,  SK_ColorRED, 3);
+
+    SkRegion changed;
+    SkRecordDiff(before, after, W, H, &changed);
+
+    // The new rect changed, and nothing outside the green rects did.
+    REPORTER_ASSERT(r, changed.contains(SkIRect::MakeXYWH(520, 500, 5, 5)));
+    REPORTER_ASSERT(r, SkIRect::MakeLTRB(499, 499, 526, 506).contains(changed.getBounds()));
+}
+
+DEF_TEST(RecordDiff_Matrix, r) {
+    SkRecord before, after;
+    {
+        SkRecorder recorder(&before, W, H);
+        recorder.translate(10, 10);
+        recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    }
+    {
+        SkRecorder recorder(&after, W, H);
+        recorder.translate(20, 20);
+        recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    }
+
+    // The draws are the same, but the matrix isn't.  Outside any Save block, it could affect
+    // anything, so the whole canvas has changed.
+    SkRegion changed;
+    SkRecordDiff(before, after, W, H, &changed);
+    REPORTER_ASSERT(r, changed.contains(SkIRect::MakeWH(W, H)));
+}
+
+DEF_TEST(RecordDiff_ImageFilteredLayer, r) {
+    SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(10, 10));
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(blur);
+
+    SkRecord before, after;
+    for (int i = 0; i < 2; i++) {
+        SkRecorder recorder(i == 0 ? &before : &after, W, H);
+        recorder.clipRect(SkRect::MakeWH(400, 400));
+        recorder.saveLayer(NULL, &layerPaint);
+            SkPaint paint;
+            paint.setColor(i == 0 ? SK_ColorRED : SK_ColorBLUE);
+            recorder.drawRect(SkRect::MakeXYWH(100, 100, 10, 10), paint);
+        recorder.restore();
+    }
+
+    // The blur can spread the change anywhere the layer might draw.
+    SkRegion changed;
+    SkRecordDiff(before, after, W, H, &changed);
+    REPORTER_ASSERT(r, changed.contains(SkIRect::MakeWH(400, 400)));
+}
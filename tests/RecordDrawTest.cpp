@@ -8,12 +8,15 @@
 #include "Test.h"
 #include "RecordTestUtils.h"
 
+#include "SkBBHFactory.h"
 #include "SkDebugCanvas.h"
 #include "SkRecord.h"
 #include "SkRecordOpts.h"
 #include "SkRecordDraw.h"
 #include "SkRecorder.h"
 #include "SkRecords.h"
+#include "SkString.h"
+#include "SkTArray.h"
 
 static const int W = 1920, H = 1080;
 
@@ -28,10 +31,11 @@ static void draw_pos_text_h(SkCanvas* canvas, const char* text, SkScalar y) {
 
 // Rerecord into another SkRecord using full SkCanvas semantics,
 // tracking clips and allowing SkRecordDraw's quickReject() calls to work.
-static void record_clipped(const SkRecord& record, SkRect clip, SkRecord* clipped) {
+static void record_clipped(const SkRecord& record, SkRect clip, SkRecord* clipped,
+                           SkBBoxHierarchy* bbh = NULL) {
     SkRecorder recorder(clipped, W, H);
     recorder.clipRect(clip);
-    SkRecordDraw(record, &recorder);
+    SkRecordDraw(record, &recorder, bbh);
 }
 
 DEF_TEST(RecordDraw_PosTextHQuickReject, r) {
@@ -103,3 +107,218 @@ DEF_TEST(RecordDraw_SetMatrixClobber, r) {
     expected.postConcat(translate);
     REPORTER_ASSERT(r, setMatrix->matrix == expected);
 }
+
+DEF_TEST(RecordDraw_BBH, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.save();
+        recorder.translate(500, 0);
+        recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());
+    recorder.restore();
+    recorder.drawRect(SkRect::MakeXYWH(0, 500, 100, 100), SkPaint());
+    recorder.drawRect(SkRect::MakeXYWH(0, 0, 100, 100), SkPaint());
+
+    SkTileGridFactory::TileGridInfo info;
+    info.fTileInterval.set(256, 256);
+    info.fMargin.setEmpty();
+    info.fOffset.setZero();
+    SkTileGridFactory factory(info);
+    SkAutoTUnref<SkBBoxHierarchy> bbh(factory(W, H));
+    SkRecordFillBounds(record, W, H, bbh);
+
+    // Only the last drawRect is inside this clip.
+    SkRecord topLeft;
+    record_clipped(record, SkRect::MakeWH(200, 200), &topLeft, bbh);
+    // clipRect and the last drawRect.
+    REPORTER_ASSERT(r, 2 == topLeft.count());
+    const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, topLeft, 1);
+    REPORTER_ASSERT(r, drawRect->rect == SkRect::MakeWH(100, 100));
+
+    // Only the translated drawRect is inside this clip, so we need its save block too.
+    SkRecord topRight;
+    record_clipped(record, SkRect::MakeXYWH(450, 0, 200, 200), &topRight, bbh);
+    // clipRect, save, concat, drawRect, restore.
+    REPORTER_ASSERT(r, 5 == topRight.count());
+    assert_type<SkRecords::Save>(r, topRight, 1);
+    assert_type<SkRecords::Concat>(r, topRight, 2);
+    assert_type<SkRecords::DrawRect>(r, topRight, 3);
+    assert_type<SkRecords::Restore>(r, topRight, 4);
+}
+
+// Draw the same record with and without an RTree, tile by tile, and make sure the pixels match.
+DEF_TEST(RecordDraw_BBHMatchesLinear, r) {
+    static const int kSize = 256, kTile = 64;
+
+    SkRecord record;
+    SkRecorder recorder(&record, kSize, kSize);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 20; i++) {
+        paint.setColor(0xFF000000 | (i * 0x0C1F37));
+        recorder.save();
+            recorder.translate(SkIntToScalar(i * 11), SkIntToScalar(i * 7));
+            recorder.clipRect(SkRect::MakeWH(SkIntToScalar(40 + i), SkIntToScalar(60)));
+            recorder.rotate(SkIntToScalar(i * 5));
+            recorder.drawOval(SkRect::MakeWH(SkIntToScalar(50), SkIntToScalar(30 + i)), paint);
+        recorder.restore();
+        recorder.drawCircle(SkIntToScalar(kSize - i * 9), SkIntToScalar(i * 9), 10, paint);
+    }
+
+    SkRTreeFactory factory;
+    SkAutoTUnref<SkBBoxHierarchy> bbh(factory(kSize, kSize));
+    SkRecordFillBounds(record, kSize, kSize, bbh);
+
+    for (int y = 0; y < kSize; y += kTile) {
+        for (int x = 0; x < kSize; x += kTile) {
+            SkBitmap linear, bounded;
+            linear.allocN32Pixels(kTile, kTile);
+            bounded.allocN32Pixels(kTile, kTile);
+            linear.eraseColor(SK_ColorWHITE);
+            bounded.eraseColor(SK_ColorWHITE);
+
+            SkCanvas linearCanvas(linear), boundedCanvas(bounded);
+            linearCanvas.translate(SkIntToScalar(-x), SkIntToScalar(-y));
+            boundedCanvas.translate(SkIntToScalar(-x), SkIntToScalar(-y));
+            SkRecordDraw(record, &linearCanvas);
+            SkRecordDraw(record, &boundedCanvas, bbh);
+
+            SkAutoLockPixels linearLock(linear), boundedLock(bounded);
+            REPORTER_ASSERT(r, 0 == memcmp(linear.getPixels(), bounded.getPixels(),
+                                           linear.getSize()));
+        }
+    }
+}
+
+// Batched DrawRects must draw exactly the same pixels as the DrawRects they replaced.
+DEF_TEST(RecordDraw_BatchedRectsMatchUnbatched, r) {
+    static const int kSize = 128;
+
+    SkPaint opaque, translucent, aa;
+    opaque.setColor(SK_ColorRED);        // Drawn as a single path.
+    translucent.setColor(0x8000FF00);    // Overlaps would blend twice, so drawn one by one.
+    aa.setColor(SK_ColorBLUE);
+    aa.setAntiAlias(true);               // Seams between rects would differ as a path.
+    const SkPaint* paints[] = { &opaque, &translucent, &aa };
+
+    for (int i = 0; i < 2 * (int)SK_ARRAY_COUNT(paints); i++) {
+        const SkPaint& paint = *paints[i / 2];
+        const bool rotated = i % 2 == 1;
+
+        SkRecord record;
+        SkRecorder recorder(&record, kSize, kSize);
+        if (rotated) {
+            recorder.rotate(7);
+        }
+        for (int j = 0; j < 30; j++) {
+            const SkScalar x = SkIntToScalar(j * 37 % 100) + 0.25f * (j % 4),
+                           y = SkIntToScalar(j * 53 % 100) + 0.3f * (j % 3);
+            recorder.drawRect(SkRect::MakeXYWH(x, y, 20.5f, 13.75f), paint);
+        }
+
+        SkBitmap unbatched, batched;
+        unbatched.allocN32Pixels(kSize, kSize);
+        batched.allocN32Pixels(kSize, kSize);
+        unbatched.eraseColor(SK_ColorWHITE);
+        batched.eraseColor(SK_ColorWHITE);
+
+        SkCanvas unbatchedCanvas(unbatched);
+        SkRecordDraw(record, &unbatchedCanvas);
+
+        SkRecordBatchDrawRects(&record);
+        assert_type<SkRecords::DrawRects>(r, record, rotated ? 1 : 0);
+        SkCanvas batchedCanvas(batched);
+        SkRecordDraw(record, &batchedCanvas);
+
+        SkAutoLockPixels unbatchedLock(unbatched), batchedLock(batched);
+        REPORTER_ASSERT(r, 0 == memcmp(unbatched.getPixels(), batched.getPixels(),
+                                       unbatched.getSize()));
+    }
+}
+
+// drawRect() sorts inverted rects, so batching them must not wind them the other way.
+DEF_TEST(RecordDraw_BatchedInvertedRects, r) {
+    static const int kSize = 64;
+
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+
+    SkRecord record;
+    SkRecorder recorder(&record, kSize, kSize);
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 40, 40), paint);
+    recorder.drawRect(SkRect::MakeLTRB(50, 20, 20, 50), paint);  // Left > right.
+    recorder.drawRect(SkRect::MakeLTRB(30, 60, 60, 30), paint);  // Top > bottom.
+    recorder.drawRect(SkRect::MakeLTRB(5, 5, 5, 30), paint);     // Empty.
+
+    SkBitmap unbatched, batched;
+    unbatched.allocN32Pixels(kSize, kSize);
+    batched.allocN32Pixels(kSize, kSize);
+    unbatched.eraseColor(SK_ColorWHITE);
+    batched.eraseColor(SK_ColorWHITE);
+
+    SkCanvas unbatchedCanvas(unbatched);
+    SkRecordDraw(record, &unbatchedCanvas);
+
+    SkRecordBatchDrawRects(&record);
+    assert_type<SkRecords::DrawRects>(r, record, 0);
+    SkCanvas batchedCanvas(batched);
+    SkRecordDraw(record, &batchedCanvas);
+
+    // The overlaps are painted, not holes.
+    REPORTER_ASSERT(r, SK_ColorRED == batched.getColor(35, 35));
+    REPORTER_ASSERT(r, SK_ColorRED == batched.getColor(45, 45));
+    SkAutoLockPixels unbatchedLock(unbatched), batchedLock(batched);
+    REPORTER_ASSERT(r, 0 == memcmp(unbatched.getPixels(), batched.getPixels(),
+                                   unbatched.getSize()));
+}
+
+// Remembers the ops it's told about, and checks that calls pair up.
+class RecordingProfiler : public SkPlaybackProfiler {
+public:
+    RecordingProfiler() : fInOp(false), fUnpaired(0) {}
+
+    virtual void beginOp(uint32_t opID, int type, const char* typeName) SK_OVERRIDE {
+        fUnpaired += fInOp;
+        fInOp = true;
+        *fIDs.append() = opID;
+        *fTypes.append() = type;
+        fNames.push_back(SkString(typeName));
+    }
+    virtual void endOp() SK_OVERRIDE {
+        fUnpaired += !fInOp;
+        fInOp = false;
+    }
+
+    bool fInOp;
+    int fUnpaired;
+    SkTDArray<uint32_t> fIDs;
+    SkTDArray<int> fTypes;
+    SkTArray<SkString> fNames;
+};
+
+DEF_TEST(RecordDraw_Profiler, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+    recorder.save();
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.restore();
+    recorder.drawRect(SkRect::MakeWH(20, 20), SkPaint());
+
+    RecordingProfiler profiler;
+    SkCanvas canvas;
+    SkRecordDraw(record, &canvas, NULL, &profiler);
+
+    REPORTER_ASSERT(r, !profiler.fInOp);
+    REPORTER_ASSERT(r, 0 == profiler.fUnpaired);
+    REPORTER_ASSERT(r, 4 == profiler.fIDs.count());
+    static const SkRecords::Type kTypes[] = {
+        SkRecords::Save_Type, SkRecords::DrawRect_Type, SkRecords::Restore_Type,
+        SkRecords::DrawRect_Type,
+    };
+    for (int i = 0; i < profiler.fIDs.count() && i < (int)SK_ARRAY_COUNT(kTypes); i++) {
+        REPORTER_ASSERT(r, (uint32_t)i == profiler.fIDs[i]);
+        REPORTER_ASSERT(r, kTypes[i] == profiler.fTypes[i]);
+        REPORTER_ASSERT(r, profiler.fNames[i].equals(SkRecords::TypeName(kTypes[i])));
+    }
+    REPORTER_ASSERT(r, 0 == strcmp("DrawRect", SkRecords::TypeName(SkRecords::DrawRect_Type)));
+}
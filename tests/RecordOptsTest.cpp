@@ -241,5 +241,111 @@ DEF_TEST(RecordOpts_NoopSaveLayerDrawRestore, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, record, 16);
     REPORTER_ASSERT(r, drawRect != NULL);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == 0x03020202);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0x03020202);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque, translucent, stroke;
+    opaque.setColor(SK_ColorRED);
+    translucent.setColor(0x80FF0000);
+    stroke.setStyle(SkPaint::kStroke_Style);
+
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 20, 20), opaque);       // 0: Occluded by 8.
+    recorder.drawRect(SkRect::MakeXYWH(90, 90, 20, 20), opaque);       // 1: Sticks out of 8.
+    recorder.saveLayer(NULL, NULL);                                    // 2: Becomes a Save.
+        recorder.drawRect(SkRect::MakeXYWH(20, 20, 10, 10), opaque);   // 3: Occluded by 8.
+    recorder.restore();                                                // 4
+    recorder.drawRect(SkRect::MakeXYWH(5, 5, 90, 90), translucent);    // 5: Occluded by 8.
+    recorder.drawRect(SkRect::MakeXYWH(0, 0, 100, 100), stroke);       // 6: Can't be covered by 8.
+    recorder.drawRect(SkRect::MakeXYWH(0, 0, 100, 100), translucent);  // 7: Doesn't occlude.
+    recorder.drawRect(SkRect::MakeXYWH(0, 0, 100, 100), opaque);       // 8: Occludes.
+
+    SkRecordNoopOccludedDraws(&record);
+
+    assert_type<SkRecords::NoOp>    (r, record, 0);
+    assert_type<SkRecords::DrawRect>(r, record, 1);
+    assert_type<SkRecords::Save>    (r, record, 2);
+    assert_type<SkRecords::NoOp>    (r, record, 3);
+    assert_type<SkRecords::Restore> (r, record, 4);
+    assert_type<SkRecords::NoOp>    (r, record, 5);
+    assert_type<SkRecords::DrawRect>(r, record, 6);
+    assert_type<SkRecords::DrawRect>(r, record, 7);
+    assert_type<SkRecords::DrawRect>(r, record, 8);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDrawsRespectsClipsAndLayers, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque;
+    opaque.setColor(SK_ColorBLUE);
+
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 20, 20), opaque);  // 0
+    recorder.save();                                             // 1
+        recorder.clipRect(SkRect::MakeWH(15, 15));               // 2
+        recorder.drawPaint(opaque);                              // 3: Covers only part of 0.
+    recorder.restore();                                          // 4
+    recorder.save();                                             // 5
+        recorder.clipPath(SkPath(), SkRegion::kUnion_Op);        // 6
+        recorder.drawPaint(opaque);                              // 7: Clip is too complex.
+    recorder.restore();                                          // 8
+    recorder.saveLayer(NULL, NULL);                              // 9
+        recorder.drawPaint(opaque);                              // 10: Inside a layer.
+    recorder.restore();                                          // 11
+
+    SkRecordNoopOccludedDraws(&record);
+
+    assert_type<SkRecords::DrawRect> (r, record, 0);
+    assert_type<SkRecords::DrawPaint>(r, record, 3);
+    assert_type<SkRecords::DrawPaint>(r, record, 7);
+    assert_type<SkRecords::SaveLayer>(r, record, 9);
+    assert_type<SkRecords::DrawPaint>(r, record, 10);
+
+    // Clear ignores the clip and color, so it occludes everything, even when transparent.
+    recorder.clear(SK_ColorTRANSPARENT);                         // 12
+
+    SkRecordNoopOccludedDraws(&record);
+
+    assert_type<SkRecords::NoOp>     (r, record, 0);
+    assert_type<SkRecords::NoOp>     (r, record, 3);
+    assert_type<SkRecords::NoOp>     (r, record, 7);
+    assert_type<SkRecords::Save>     (r, record, 9);
+    assert_type<SkRecords::NoOp>     (r, record, 10);
+    assert_type<SkRecords::Clear>    (r, record, 12);
+}
+
+DEF_TEST(RecordOpts_BatchDrawRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    recorder.drawRect(SkRect::MakeXYWH( 0, 0, 10, 10), red);   // 0: Batched with 1 and 4.
+    recorder.drawRect(SkRect::MakeXYWH(20, 0, 10, 10), red);   // 1
+    recorder.save();                                           // 2: NoOp'd by NoopSaveRestores.
+    recorder.restore();                                        // 3
+    recorder.drawRect(SkRect::MakeXYWH(40, 0, 10, 10), red);   // 4
+    recorder.drawRect(SkRect::MakeXYWH( 0, 20, 10, 10), blue); // 5: Different paint, alone.
+    recorder.translate(5, 5);                                  // 6
+    recorder.drawRect(SkRect::MakeXYWH( 0, 40, 10, 10), blue); // 7: Batched with 8.
+    recorder.drawRect(SkRect::MakeXYWH(20, 40, 10, 10), blue); // 8
+
+    SkRecordNoopSaveRestores(&record);
+    SkRecordBatchDrawRects(&record);
+
+    const SkRecords::DrawRects* batch = assert_type<SkRecords::DrawRects>(r, record, 0);
+    REPORTER_ASSERT(r, 3 == batch->count);
+    REPORTER_ASSERT(r, SkRect::MakeXYWH(40, 0, 10, 10) == batch->rects[2]);
+    assert_type<SkRecords::NoOp>     (r, record, 1);
+    assert_type<SkRecords::NoOp>     (r, record, 4);
+    assert_type<SkRecords::DrawRect> (r, record, 5);
+    assert_type<SkRecords::Concat>   (r, record, 6);
+    batch = assert_type<SkRecords::DrawRects>(r, record, 7);
+    REPORTER_ASSERT(r, 2 == batch->count);
+    assert_type<SkRecords::NoOp>     (r, record, 8);
 }
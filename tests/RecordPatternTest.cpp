@@ -118,15 +118,44 @@ DEF_TEST(RecordPattern_IsDraw, r) {
 
     REPORTER_ASSERT(r, pattern.match(&record, 3));
     REPORTER_ASSERT(r, pattern.first<Save>()    != NULL);
-    REPORTER_ASSERT(r, pattern.second<SkPaint>()->getColor() == 0xEEAA8822);
+    REPORTER_ASSERT(r, pattern.second<const SkPaint>()->getColor() == 0xEEAA8822);
     REPORTER_ASSERT(r, pattern.third<Restore>() != NULL);
 
     REPORTER_ASSERT(r, pattern.match(&record, 6));
     REPORTER_ASSERT(r, pattern.first<Save>()    != NULL);
-    REPORTER_ASSERT(r, pattern.second<SkPaint>()->getColor() == 0xFACEFACE);
+    REPORTER_ASSERT(r, pattern.second<const SkPaint>()->getColor() == 0xFACEFACE);
     REPORTER_ASSERT(r, pattern.third<Restore>() != NULL);
 }
 
+DEF_TEST(RecordPattern_IsDrawOnlyCopiesToWrite, r) {
+    Pattern3<Is<Save>, IsDraw, Is<Restore> > pattern;
+
+    SkRecord record;
+    SkRecorder recorder(&record, 1920, 1200);
+
+    SkPaint paint;
+    paint.setColor(0xEEAA8822);
+    recorder.save();
+        recorder.drawRect(SkRect::MakeWH(300, 200), paint);
+    recorder.restore();
+    recorder.drawRect(SkRect::MakeWH(30, 20), paint);
+
+    Is<DrawRect> other;
+    record.mutate<bool>(3, other);
+    const SkPaint* shared = other.get()->paint.get();
+
+    // Reading the paint must leave it shared...
+    REPORTER_ASSERT(r, pattern.match(&record, 0));
+    REPORTER_ASSERT(r, pattern.second<const SkPaint>() == shared);
+
+    // ... and only writing it may copy it, leaving the other draw alone.
+    SkPaint* writable = pattern.writableSecond<SkPaint>();
+    REPORTER_ASSERT(r, writable != shared);
+    writable->setColor(0xFACEFACE);
+    REPORTER_ASSERT(r, pattern.second<const SkPaint>()->getColor() == 0xFACEFACE);
+    REPORTER_ASSERT(r, other.get()->paint->getColor() == 0xEEAA8822);
+}
+
 DEF_TEST(RecordPattern_Complex, r) {
     Pattern3<Is<Save>,
              Star<Not<Or3<Is<Save>,
@@ -6,6 +6,7 @@
  */
 
 #include "Test.h"
+#include "RecordTestUtils.h"
 
 #include "SkRecord.h"
 #include "SkRecorder.h"
@@ -68,3 +69,42 @@ DEF_TEST(Recorder_RefLeaking, r) {
     }
     REPORTER_ASSERT(r, paint.getShader()->unique());
 }
+
+// Equal paints and paths should be recorded once and shared between commands.
+DEF_TEST(Recorder_Pool, r) {
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    SkPath path, samePath;
+    path.addCircle(20, 20, 10);
+    samePath.addCircle(20, 20, 10);
+
+    SkRecord record;
+    SkRecorder recorder(&record, 1920, 1080);
+    recorder.drawRect(SkRect::MakeWH(10, 10), red);
+    recorder.drawPath(path, SkPaint(red));
+    recorder.drawPath(samePath, blue);
+
+    const SkRecords::DrawRect* rect  = assert_type<SkRecords::DrawRect>(r, record, 0);
+    const SkRecords::DrawPath* path0 = assert_type<SkRecords::DrawPath>(r, record, 1);
+    const SkRecords::DrawPath* path1 = assert_type<SkRecords::DrawPath>(r, record, 2);
+    REPORTER_ASSERT(r, rect->paint.get() == path0->paint.get());
+    REPORTER_ASSERT(r, path0->paint.get() != path1->paint.get());
+    REPORTER_ASSERT(r, path0->path.getGenerationID() == path1->path.getGenerationID());
+
+    REPORTER_ASSERT(r, 2 == recorder.pool().uniquePaintCount());
+    REPORTER_ASSERT(r, 3 == recorder.pool().paintRequestCount());
+    REPORTER_ASSERT(r, 1 == recorder.pool().uniquePathCount());
+    REPORTER_ASSERT(r, 2 == recorder.pool().pathRequestCount());
+
+    // The pooled path's points and verbs count toward the pool's size.
+    REPORTER_ASSERT(r, recorder.pool().bytesUsed() >=
+                       path.countPoints() * sizeof(SkPoint) + path.countVerbs());
+
+    // Changing a shared paint must not change it for anyone else.
+    SkRecords::DrawRect* writableRect = const_cast<SkRecords::DrawRect*>(rect);
+    writableRect->paint.writable()->setColor(SK_ColorGREEN);
+    REPORTER_ASSERT(r, SK_ColorGREEN == rect->paint->getColor());
+    REPORTER_ASSERT(r, SK_ColorRED == path0->paint->getColor());
+}
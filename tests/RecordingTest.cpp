@@ -7,7 +7,11 @@
 
 #include "Test.h"
 
+#include "SkBBHFactory.h"
+#include "SkColorFilter.h"
+#include "SkData.h"
 #include "SkRecording.h"
+#include "SkStream.h"
 
 // Minimally exercise the public SkRecording API.
 
@@ -27,3 +31,250 @@ DEF_TEST(RecordingTest, r) {
     EXPERIMENTAL::SkRecording pointless(1920, 1080);
     pointless.canvas()->clipRect(SkRect::MakeWH(320, 240));
 }
+
+static void draw_everything(SkCanvas* canvas) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+
+    canvas->clear(SK_ColorWHITE);
+    canvas->save();
+        canvas->translate(10, 10);
+        canvas->clipRect(SkRect::MakeWH(100, 100));
+        canvas->drawRect(SkRect::MakeWH(50, 50), paint);
+    canvas->restore();
+
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(40, 90);
+    path.quadTo(80, 0, 120, 60);
+    path.close();
+    paint.setColor(SK_ColorRED);
+    canvas->drawPath(path, paint);
+
+    const SkPoint pts[] = { {5, 5}, {60, 70}, {100, 20} };
+    canvas->drawPoints(SkCanvas::kPolygon_PointMode, SK_ARRAY_COUNT(pts), pts, paint);
+
+    paint.setColor(SK_ColorBLACK);
+    paint.setTextSize(20);
+    canvas->drawText("Hello", 5, 20, 150, paint);
+    const SkPoint pos[] = { {20, 180}, {35, 185}, {50, 190} };
+    canvas->drawPosText("abc", 3, pos, paint);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorGREEN);
+    canvas->drawBitmap(bitmap, 150, 150);
+    canvas->drawBitmap(bitmap, 170, 150);  // Same bitmap again should not be written twice.
+
+    SkPaint layerPaint;
+    layerPaint.setAlpha(0x80);
+    canvas->saveLayer(NULL, &layerPaint);
+        canvas->drawOval(SkRect::MakeXYWH(120, 10, 60, 40), paint);
+    canvas->restore();
+}
+
+DEF_TEST(RecordingTest_Serialize, r) {
+    EXPERIMENTAL::SkRecording recording(200, 200);
+    draw_everything(recording.canvas());
+    SkAutoTDelete<const EXPERIMENTAL::SkPlayback> playback(recording.releasePlayback());
+
+    SkDynamicMemoryWStream stream;
+    playback->serialize(&stream);
+    SkAutoTUnref<SkData> data(stream.copyToData());
+
+    SkAutoTDelete<const EXPERIMENTAL::SkPlayback> loaded(
+            EXPERIMENTAL::SkPlayback::CreateFromData(data));
+    REPORTER_ASSERT(r, NULL != loaded.get());
+    if (NULL == loaded.get()) {
+        return;
+    }
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(200, 200);
+    actual.allocN32Pixels(200, 200);
+    expected.eraseColor(SK_ColorTRANSPARENT);
+    actual.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(expected);
+        playback->draw(&canvas);
+    }
+    {
+        // Draw twice to exercise both materializing and reusing paints, paths and bitmaps.
+        SkCanvas canvas(actual);
+        loaded->draw(&canvas);
+        loaded->draw(&canvas);
+    }
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(), expected.getSize()));
+
+    // A loaded playback serializes to exactly the data it came from.
+    SkDynamicMemoryWStream restream;
+    loaded->serialize(&restream);
+    SkAutoTUnref<SkData> redata(restream.copyToData());
+    REPORTER_ASSERT(r, redata->equals(data));
+
+    // Truncated or garbage data should fail to load.
+    SkAutoTUnref<SkData> truncated(SkData::NewWithCopy(data->data(), data->size() / 2));
+    REPORTER_ASSERT(r, NULL == EXPERIMENTAL::SkPlayback::CreateFromData(truncated));
+    SkAutoTUnref<SkData> garbage(SkData::NewWithCopy("not a playback", 14));
+    REPORTER_ASSERT(r, NULL == EXPERIMENTAL::SkPlayback::CreateFromData(garbage));
+}
+
+// Draws data's playback onto white, and returns the color where its triangle would be.
+static SkColor draw_vertices_playback(skiatest::Reporter* r, SkData* data) {
+    SkAutoTDelete<const EXPERIMENTAL::SkPlayback> loaded(
+            EXPERIMENTAL::SkPlayback::CreateFromData(data));
+    REPORTER_ASSERT(r, NULL != loaded.get());
+    if (NULL == loaded.get()) {
+        return SK_ColorTRANSPARENT;
+    }
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    loaded->draw(&canvas);
+    return bitmap.getColor(46, 36);
+}
+
+// Draws data's playback onto white, and returns the color in the middle.
+static SkColor draw_paint_playback(skiatest::Reporter* r, SkData* data) {
+    SkAutoTDelete<const EXPERIMENTAL::SkPlayback> loaded(
+            EXPERIMENTAL::SkPlayback::CreateFromData(data));
+    REPORTER_ASSERT(r, NULL != loaded.get());
+    if (NULL == loaded.get()) {
+        return SK_ColorTRANSPARENT;
+    }
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    loaded->draw(&canvas);
+    return bitmap.getColor(50, 50);
+}
+
+// Paints are unflattened with an SkValidatingReadBuffer, so one cut short must be skipped.
+DEF_TEST(RecordingTest_SerializeBadPaint, r) {
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    paint.setColorFilter(SkColorFilter::CreateModeFilter(SK_ColorRED,
+                                                         SkXfermode::kSrc_Mode))->unref();
+
+    EXPERIMENTAL::SkRecording recording(100, 100);
+    recording.canvas()->drawRect(SkRect::MakeWH(100, 100), paint);
+    SkAutoTDelete<const EXPERIMENTAL::SkPlayback> playback(recording.releasePlayback());
+    SkDynamicMemoryWStream stream;
+    playback->serialize(&stream);
+    SkAutoTUnref<SkData> data(stream.copyToData());
+    REPORTER_ASSERT(r, SK_ColorRED == draw_paint_playback(r, data));
+
+    // The paint table is offsets { start, end } from the table's start, then the paint, which
+    // begins with its text size, text scale, text skew, stroke width, stroke miter, and color.
+    const SkScalar pod[] = { paint.getTextSize(), paint.getTextScaleX(), paint.getTextSkewX(),
+                             paint.getStrokeWidth(), paint.getStrokeMiter() };
+    const char* bytes = (const char*)data->data();
+    const char* found = NULL;
+    for (size_t i = 0; i + sizeof(pod) + sizeof(SkColor) <= data->size(); i += 4) {
+        if (0 == memcmp(bytes + i, pod, sizeof(pod)) &&
+            SK_ColorBLUE == *(const SkColor*)(bytes + i + sizeof(pod))) {
+            found = bytes + i;
+        }
+    }
+    REPORTER_ASSERT(r, NULL != found);
+    if (NULL == found) {
+        return;
+    }
+
+    SkAutoTMalloc<char> copy(data->size());
+    memcpy(copy.get(), bytes, data->size());
+    uint32_t* offsets = (uint32_t*)(copy.get() + (found - bytes)) - 2;
+    REPORTER_ASSERT(r, 2 * sizeof(uint32_t) == offsets[0]);
+    offsets[1] = offsets[0] + sizeof(pod);
+    SkAutoTUnref<SkData> shortPaint(SkData::NewWithCopy(copy.get(), data->size()));
+    REPORTER_ASSERT(r, SK_ColorWHITE == draw_paint_playback(r, shortPaint));
+}
+
+// A corrupt DrawVertices must be skipped, not read past the end of its arrays.
+DEF_TEST(RecordingTest_SerializeBadVertices, r) {
+    const SkPoint vertices[] = { {11.5f, 13.25f}, {87.75f, 19.5f}, {41.125f, 77.375f} };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorRED, SK_ColorRED };
+    const uint16_t indices[] = { 0, 1, 2 };
+
+    EXPERIMENTAL::SkRecording recording(100, 100);
+    recording.canvas()->drawVertices(SkCanvas::kTriangles_VertexMode, 3, vertices, NULL, colors,
+                                     NULL, indices, 3, SkPaint());
+    SkAutoTDelete<const EXPERIMENTAL::SkPlayback> playback(recording.releasePlayback());
+    SkDynamicMemoryWStream stream;
+    playback->serialize(&stream);
+    SkAutoTUnref<SkData> data(stream.copyToData());
+    REPORTER_ASSERT(r, SK_ColorWHITE != draw_vertices_playback(r, data));
+
+    // The payload is ... vmode, vertexCount, vertices, texCount, colorCount, colors, indexCount,
+    // indices.
+    const char* bytes = (const char*)data->data();
+    const char* found = NULL;
+    for (size_t i = 0; i + sizeof(vertices) <= data->size(); i += 4) {
+        if (0 == memcmp(bytes + i, vertices, sizeof(vertices))) {
+            found = bytes + i;
+        }
+    }
+    REPORTER_ASSERT(r, NULL != found);
+    if (NULL == found) {
+        return;
+    }
+    const size_t vmodeOffset = found - bytes - 2 * sizeof(uint32_t);
+    const size_t indexOffset =
+            found - bytes + sizeof(vertices) + sizeof(colors) + 3 * sizeof(uint32_t);
+    REPORTER_ASSERT(r, 0 == memcmp(bytes + indexOffset, indices, sizeof(indices)));
+
+    SkAutoTMalloc<char> copy(data->size());
+    memcpy(copy.get(), bytes, data->size());
+    *(uint32_t*)(copy.get() + vmodeOffset) = 99;
+    SkAutoTUnref<SkData> badMode(SkData::NewWithCopy(copy.get(), data->size()));
+    REPORTER_ASSERT(r, SK_ColorWHITE == draw_vertices_playback(r, badMode));
+
+    memcpy(copy.get(), bytes, data->size());
+    ((uint16_t*)(copy.get() + indexOffset))[1] = 3;
+    SkAutoTUnref<SkData> badIndex(SkData::NewWithCopy(copy.get(), data->size()));
+    REPORTER_ASSERT(r, SK_ColorWHITE == draw_vertices_playback(r, badIndex));
+}
+
+DEF_TEST(RecordingTest_DrawTiled, r) {
+    SkRTreeFactory factory;
+    EXPERIMENTAL::SkRecording recording(200, 200, &factory);
+    draw_everything(recording.canvas());
+    SkAutoTDelete<const EXPERIMENTAL::SkPlayback> playback(recording.releasePlayback());
+
+    // Tile sizes that do and don't evenly divide the bitmap, drawn on this thread and on the pool.
+    const int kTileSizes[] = { 200, 64, 37 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kTileSizes); i++) {
+        const int tile = kTileSizes[i];
+
+        // Anti-aliasing can differ slightly under different clips, so we compare against drawing
+        // each tile one at a time into its own bitmap.
+        SkBitmap expected;
+        expected.allocN32Pixels(200, 200);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(expected);
+        for (int y = 0; y < 200; y += tile) {
+            for (int x = 0; x < 200; x += tile) {
+                SkBitmap scratch;
+                scratch.allocN32Pixels(SkTMin(tile, 200 - x), SkTMin(tile, 200 - y));
+                scratch.eraseColor(SK_ColorTRANSPARENT);
+                SkCanvas scratchCanvas(scratch);
+                scratchCanvas.translate(-SkIntToScalar(x), -SkIntToScalar(y));
+                playback->draw(&scratchCanvas);
+                canvas.drawBitmap(scratch, SkIntToScalar(x), SkIntToScalar(y));
+            }
+        }
+
+        for (int threaded = 0; threaded < 2; threaded++) {
+            SkBitmap actual;
+            actual.allocN32Pixels(200, 200);
+            actual.eraseColor(SK_ColorTRANSPARENT);
+            playback->drawTiled(actual, tile, tile, SkToBool(threaded));
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(),
+                                           actual.getPixels(),
+                                           expected.getSize()));
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDashPathEffect.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkStrokeCache.h"
+#include "Test.h"
+
+static void make_polyline(SkPath* path, int n) {
+    path->moveTo(0, 0);
+    for (int i = 1; i <= n; ++i) {
+        path->lineTo(SkIntToScalar(i * 10), SkIntToScalar((i & 1) * 10));
+    }
+}
+
+static void test_cache(skiatest::Reporter* reporter) {
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+
+    SkStrokeCache cache(10 * 1024);
+    for (int i = 1; i <= 10; ++i) {
+        SkPath path, fillPath;
+        make_polyline(&path, i);
+        REPORTER_ASSERT(reporter, paint.getFillPath(path, &fillPath));
+
+        SkStrokeCache::Key key;
+        REPORTER_ASSERT(reporter, SkStrokeCache::ComputeKey(path, paint, NULL, &key));
+
+        SkPath found;
+        bool doFill;
+        REPORTER_ASSERT(reporter, !cache.find(key, &found, &doFill));
+        // The first add only notes the key, so that one-off paths aren't cached.
+        cache.add(key, fillPath, true);
+        REPORTER_ASSERT(reporter, !cache.find(key, &found, &doFill));
+        cache.add(key, fillPath, true);
+        REPORTER_ASSERT(reporter, cache.find(key, &found, &doFill));
+        REPORTER_ASSERT(reporter, doFill);
+        REPORTER_ASSERT(reporter, found == fillPath);
+        REPORTER_ASSERT(reporter, cache.getBytesUsed() <= cache.getByteLimit());
+    }
+    REPORTER_ASSERT(reporter, 10 == cache.getHitCount());
+    REPORTER_ASSERT(reporter, 20 == cache.getMissCount());
+
+    cache.setByteLimit(0);
+    REPORTER_ASSERT(reporter, 0 == cache.getBytesUsed());
+}
+
+static void test_key(skiatest::Reporter* reporter) {
+    SkPath path;
+    make_polyline(&path, 4);
+
+    SkPaint paint;
+    SkStrokeCache::Key key0, key1;
+    // plain fills and hairlines are not cached
+    REPORTER_ASSERT(reporter, !SkStrokeCache::ComputeKey(path, paint, NULL, &key0));
+    paint.setStyle(SkPaint::kStroke_Style);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::ComputeKey(path, paint, NULL, &key0));
+
+    paint.setStrokeWidth(2);
+    REPORTER_ASSERT(reporter, SkStrokeCache::ComputeKey(path, paint, NULL, &key0));
+    REPORTER_ASSERT(reporter, SkStrokeCache::ComputeKey(path, paint, NULL, &key1));
+    REPORTER_ASSERT(reporter, key0 == key1);
+
+    SkPaint joinPaint(paint);
+    joinPaint.setStrokeJoin(SkPaint::kRound_Join);
+    REPORTER_ASSERT(reporter, SkStrokeCache::ComputeKey(path, joinPaint, NULL, &key1));
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+
+    SkPath copy(path);
+    REPORTER_ASSERT(reporter, SkStrokeCache::ComputeKey(copy, paint, NULL, &key1));
+    REPORTER_ASSERT(reporter, key0 == key1);
+    copy.lineTo(50, 50);
+    REPORTER_ASSERT(reporter, SkStrokeCache::ComputeKey(copy, paint, NULL, &key1));
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+
+    // a dash that might be culled is only cached if the cull rect can't change it
+    const SkScalar intervals[] = { 4, 2 };
+    SkAutoTUnref<SkPathEffect> dash(SkDashPathEffect::Create(intervals, 2, 0));
+    paint.setPathEffect(dash);
+    SkRect bigCull = SkRect::MakeLTRB(-10, -10, 100, 100);
+    SkRect smallCull = SkRect::MakeLTRB(0, 0, 10, 10);
+    REPORTER_ASSERT(reporter, SkStrokeCache::ComputeKey(path, paint, &bigCull, &key1));
+    REPORTER_ASSERT(reporter, !(key0 == key1));
+    REPORTER_ASSERT(reporter, !SkStrokeCache::ComputeKey(path, paint, &smallCull, &key1));
+}
+
+// A fill path found in the cache must match what getFillPath() computes.
+static void test_fill_path(skiatest::Reporter* reporter) {
+    SkPath path;
+    make_polyline(&path, 8);
+    path.quadTo(40, 40, 0, 20);
+
+    const SkScalar intervals[] = { 5, 3 };
+    SkAutoTUnref<SkPathEffect> dash(SkDashPathEffect::Create(intervals, 2, 0));
+
+    SkPaint paints[3];
+    paints[0].setStyle(SkPaint::kStroke_Style);
+    paints[0].setStrokeWidth(4);
+    paints[1] = paints[0];
+    paints[1].setStyle(SkPaint::kStrokeAndFill_Style);
+    paints[1].setStrokeJoin(SkPaint::kRound_Join);
+    paints[2] = paints[0];
+    paints[2].setPathEffect(dash);
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(paints); ++i) {
+        SkPath expected;
+        bool expectedFill = paints[i].getFillPath(path, &expected);
+
+        SkStrokeCache cache(1024 * 1024);
+        SkStrokeCache::Key key;
+        REPORTER_ASSERT(reporter, SkStrokeCache::ComputeKey(path, paints[i], NULL, &key));
+        for (int j = 0; j < 3; ++j) {
+            SkPath fillPath;
+            bool doFill;
+            if (!cache.find(key, &fillPath, &doFill)) {
+                doFill = paints[i].getFillPath(path, &fillPath);
+                cache.add(key, fillPath, doFill);
+            }
+            REPORTER_ASSERT(reporter, expectedFill == doFill);
+            REPORTER_ASSERT(reporter, expected == fillPath);
+        }
+        REPORTER_ASSERT(reporter, 1 == cache.getHitCount());
+        REPORTER_ASSERT(reporter, 2 == cache.getMissCount());
+
+        // getFillPath allows dst == src
+        SkPath inPlace(path);
+        paints[i].getFillPath(inPlace, &inPlace);
+        REPORTER_ASSERT(reporter, expected == inPlace);
+    }
+}
+
+DEF_TEST(StrokeCache, reporter) {
+    test_cache(reporter);
+    test_key(reporter);
+    test_fill_path(reporter);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTaskGroup.h"
+#include "SkThread.h"
+#include "Test.h"
+
+class Adder : public SkRunnable {
+public:
+    Adder() : fCount(NULL), fAmount(0) {}
+
+    virtual void run() SK_OVERRIDE {
+        sk_atomic_add(fCount, fAmount);
+    }
+
+    int32_t* fCount;
+    int32_t  fAmount;
+};
+
+DEF_TEST(TaskGroup, r) {
+    const int kTasks = 64;
+
+    int32_t count = 0;
+    Adder adders[kTasks];
+    SkTaskGroup group;
+    for (int i = 0; i < kTasks; i++) {
+        adders[i].fCount = &count;
+        adders[i].fAmount = i;
+        group.add(&adders[i]);
+    }
+    group.wait();
+    REPORTER_ASSERT(r, kTasks * (kTasks - 1) / 2 == count);
+
+    // A group can be used again once it's been waited on.
+    for (int i = 0; i < kTasks; i++) {
+        group.add(&adders[i]);
+    }
+    group.wait();
+    REPORTER_ASSERT(r, kTasks * (kTasks - 1) == count);
+
+    REPORTER_ASSERT(r, SkTaskGroup::NumCores() >= 1);
+}
+
+// Work that makes and waits on a group of its own, as a banded draw of a high
+// quality bitmap does. This must not run out of threads, however many there are.
+class Nester : public SkRunnable {
+public:
+    Nester() : fCount(NULL) {}
+
+    virtual void run() SK_OVERRIDE {
+        Adder adders[8];
+        SkTaskGroup group;
+        for (int i = 0; i < 8; i++) {
+            adders[i].fCount = fCount;
+            adders[i].fAmount = 1;
+            group.add(&adders[i]);
+        }
+    }
+
+    int32_t* fCount;
+};
+
+DEF_TEST(TaskGroup_Nested, r) {
+    const int kTasks = 4 * SkTaskGroup::NumCores();
+
+    int32_t count = 0;
+    SkAutoTArray<Nester> nesters(kTasks);
+    {
+        SkTaskGroup group;
+        for (int i = 0; i < kTasks; i++) {
+            nesters[i].fCount = &count;
+            group.add(&nesters[i]);
+        }
+    }
+    REPORTER_ASSERT(r, 8 * kTasks == count);
+}
@@ -6,6 +6,8 @@
  */
 
 #include "SkColor.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
 #include "SkXfermode.h"
 #include "Test.h"
 
@@ -51,7 +53,49 @@ static void test_IsMode(skiatest::Reporter* reporter) {
     }
 }
 
+// Whatever SIMD xfer32 this CPU gets for a mode should match the portable proc exactly.
+static void test_xfer32(skiatest::Reporter* reporter) {
+    static const int kCount = 67;
+    SkRandom rand;
+    SkPMColor src[kCount], dst[kCount + 8];
+    for (int mode = 0; mode <= SkXfermode::kLastMode; mode++) {
+        SkXfermode* xfer = SkXfermode::Create((SkXfermode::Mode) mode);
+        if (NULL == xfer) {
+            continue;
+        }
+        const SkXfermodeProc proc = SkXfermode::GetProc((SkXfermode::Mode) mode);
+        for (int offset = 0; offset < 8; ++offset) {
+            for (int i = 0; i < kCount; ++i) {
+                src[i] = SkPreMultiplyColor(rand.nextU());
+                if (0 == i % 5) {
+                    // Grays and clear pixels take their own paths through the non-separable modes.
+                    const SkColor gray = SkColorSetARGB(i % 2 ? 0 : rand.nextU() & 0xFF,
+                                                        i, i, i);
+                    src[i] = SkPreMultiplyColor(gray);
+                }
+                dst[offset + i] = SkPreMultiplyColor(i % 3 ? rand.nextU()
+                                                           : rand.nextU() | 0xFF000000);
+            }
+            const int count = kCount - offset;
+            SkPMColor expected[kCount];
+            for (int i = 0; i < count; ++i) {
+                expected[i] = proc(src[i], dst[offset + i]);
+            }
+            xfer->xfer32(dst + offset, src, count, NULL);
+            for (int i = 0; i < count; ++i) {
+                if (expected[i] != dst[offset + i]) {
+                    ERRORF(reporter, "xfer32 mode=%d [%d] expected %x got %x",
+                           mode, i, expected[i], dst[offset + i]);
+                    break;
+                }
+            }
+        }
+        xfer->unref();
+    }
+}
+
 DEF_TEST(Xfermode, reporter) {
     test_asMode(reporter);
     test_IsMode(reporter);
+    test_xfer32(reporter);
 }
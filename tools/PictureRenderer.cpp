@@ -67,6 +67,7 @@ void PictureRenderer::init(SkPicture* pict, const SkString* writePath, const SkS
     }
 
     fPicture.reset(pict)->ref();
+    fPicture->EXPERIMENTAL_setProfiler(fProfiler);
     fCanvas.reset(this->setupCanvas());
 }
 
@@ -182,6 +183,9 @@ void PictureRenderer::scaleToScaleFactor(SkCanvas* canvas) {
 
 void PictureRenderer::end() {
     this->resetState(true);
+    if (NULL != fPicture) {
+        fPicture->EXPERIMENTAL_setProfiler(NULL);
+    }
     fPicture.reset(NULL);
     fCanvas.reset(NULL);
 }
@@ -216,9 +220,15 @@ void PictureRenderer::buildBBoxHierarchy() {
         SkCanvas* canvas = recorder.beginRecording(fPicture->width(), fPicture->height(),
                                                    factory.get(),
                                                    this->recordFlags());
+        // Don't profile the draws made just to re-record the picture.
+        fPicture->EXPERIMENTAL_setProfiler(NULL);
         fPicture->draw(canvas);
         fPicture.reset(recorder.endRecording());
     }
+    // Subclasses that don't call PictureRenderer::init() rely on this to set up profiling.
+    if (NULL != fPicture) {
+        fPicture->EXPERIMENTAL_setProfiler(fProfiler);
+    }
 }
 
 void PictureRenderer::resetState(bool callFinish) {
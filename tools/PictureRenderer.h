@@ -113,6 +113,13 @@ public:
      */
     void setScaleFactor(SkScalar scale) { fScaleFactor = scale; }
 
+    /**
+     *  Tell profiler about each op the picture draws when rendered (see
+     *  SkPicture::EXPERIMENTAL_setProfiler).  Must be called before init().  Renderers that draw
+     *  clones of the picture on other threads aren't profiled.
+     */
+    void setProfiler(SkPlaybackProfiler* profiler) { fProfiler = profiler; }
+
     /**
      * Perform any setup that should done prior to each iteration of render() which should not be
      * timed.
@@ -355,7 +362,8 @@ public:
     }
 
     PictureRenderer()
-        : fJsonSummaryPtr(NULL)
+        : fProfiler(NULL)
+        , fJsonSummaryPtr(NULL)
         , fDeviceType(kBitmap_DeviceType)
         , fEnableWrites(false)
         , fBBoxHierarchyType(kNone_BBoxHierarchyType)
@@ -381,6 +389,7 @@ public:
 protected:
     SkAutoTUnref<SkCanvas> fCanvas;
     SkAutoTUnref<SkPicture> fPicture;
+    SkPlaybackProfiler*    fProfiler;
     bool                   fUseChecksumBasedFilenames;
     ImageResultsAndExpectations*   fJsonSummaryPtr;
     SkDeviceTypes          fDeviceType;
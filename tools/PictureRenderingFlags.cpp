@@ -69,11 +69,14 @@ DEFINE_string(mode, "simple", "Run in the corresponding mode:\n"
 DEFINE_int32(multi, 1, "Set the number of threads for multi threaded drawing. "
              "If > 1, requires tiled rendering.");
 DEFINE_bool(pipe, false, "Use SkGPipe rendering. Currently incompatible with \"mode\".");
+DEFINE_bool(profileOps, false, "With --writeProfilePath, also profile each individual op.");
 DEFINE_string2(readPath, r, "", "skp files or directories of skp files to process.");
 DEFINE_double(scale, 1, "Set the scale factor.");
 DEFINE_string(tiles, "", "Used with --mode copyTile to specify number of tiles per larger tile "
               "in the x and y directions.");
 DEFINE_string(viewport, "", "width height: Set the viewport.");
+DEFINE_string(writeProfilePath, "", "File to write a JSON profile of the time spent drawing each "
+              "type of op to.  Incompatible with --multi.");
 
 sk_tools::PictureRenderer* parseRenderer(SkString& error, PictureTool tool) {
     error.reset();
@@ -83,6 +86,11 @@ sk_tools::PictureRenderer* parseRenderer(SkString& error, PictureTool tool) {
         return NULL;
     }
 
+    if (FLAGS_multi > 1 && FLAGS_writeProfilePath.count() > 0) {
+        error.printf("--writeProfilePath is not compatible with --multi.\n");
+        return NULL;
+    }
+
     bool useTiles = false;
     const char* widthString = NULL;
     const char* heightString = NULL;
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "PlaybackProfile.h"
+
+#include "SkJSONCPP.h"
+#include "SkStream.h"
+#include "SkTSearch.h"
+
+#if defined(SK_BUILD_FOR_WIN32)
+    #include "BenchSysTimer_windows.h"
+#elif defined(SK_BUILD_FOR_MAC)
+    #include "BenchSysTimer_mach.h"
+#elif defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)
+    #include "BenchSysTimer_posix.h"
+#else
+    #include "BenchSysTimer_c.h"
+#endif
+
+namespace sk_tools {
+
+PlaybackProfile::PlaybackProfile(bool profileOps)
+    : fProfileOps(profileOps)
+    , fTimer(SkNEW(BenchSysTimer))
+    , fCurrentType(NULL)
+    , fCurrentOp(NULL) {}
+
+PlaybackProfile::~PlaybackProfile() {
+    SkDELETE(fTimer);
+}
+
+void PlaybackProfile::beginPicture(const char* name) {
+    SkASSERT(NULL == fCurrentType);
+    fPictures.push_back().fName.set(name);
+}
+
+PlaybackProfile::Stat* PlaybackProfile::findOp(uint32_t opID, const char* typeName) {
+    SkTDArray<Stat>& ops = fPictures.back().fOps;
+    Stat key;
+    key.fID = opID;
+    int index = SkTSearch<Stat, IDLess>(ops.begin(), ops.count(), key, sizeof(Stat));
+    if (index < 0) {
+        index = ~index;
+        Stat* op = ops.insert(index);
+        op->fID = opID;
+        op->fTypeName = typeName;
+        op->fCount = 0;
+        op->fMs = 0;
+    }
+    return &ops[index];
+}
+
+void PlaybackProfile::beginOp(uint32_t opID, int type, const char* typeName) {
+    SkASSERT(NULL == fCurrentType);  // beginOp() and endOp() calls must not nest.
+    SkASSERT(type >= 0);
+    if (fPictures.empty()) {
+        this->beginPicture("");
+    }
+
+    SkTDArray<Stat>& types = fPictures.back().fTypes;
+    if (type >= types.count()) {
+        const int oldCount = types.count();
+        types.setCount(type + 1);
+        sk_bzero(types.begin() + oldCount, (types.count() - oldCount) * sizeof(Stat));
+    }
+    fCurrentType = &types[type];
+    fCurrentType->fTypeName = typeName;
+    fCurrentOp = fProfileOps ? this->findOp(opID, typeName) : NULL;
+
+    // Start timing last, so the bookkeeping above isn't counted.
+    fTimer->startWall();
+}
+
+void PlaybackProfile::endOp() {
+    const double ms = fTimer->endWall();
+    SkASSERT(NULL != fCurrentType);
+
+    fCurrentType->fCount++;
+    fCurrentType->fMs += ms;
+    if (NULL != fCurrentOp) {
+        fCurrentOp->fCount++;
+        fCurrentOp->fMs += ms;
+    }
+    fCurrentType = NULL;
+    fCurrentOp = NULL;
+}
+
+static Json::Value stat_to_json(int count, double ms) {
+    Json::Value stat(Json::objectValue);
+    stat["count"] = count;
+    stat["ms"] = ms;
+    return stat;
+}
+
+void PlaybackProfile::writeJSON(SkWStream* stream) const {
+    Json::Value root(Json::objectValue);
+    for (int i = 0; i < fPictures.count(); i++) {
+        const Picture& picture = fPictures[i];
+
+        Json::Value types(Json::objectValue);
+        for (int j = 0; j < picture.fTypes.count(); j++) {
+            const Stat& type = picture.fTypes[j];
+            if (0 == type.fCount) {
+                continue;  // Never drawn.
+            }
+            SkString name;
+            if (NULL != type.fTypeName) {
+                name.set(type.fTypeName);
+            } else {
+                name.printf("UNKNOWN_%d", j);
+            }
+            types[name.c_str()] = stat_to_json(type.fCount, type.fMs);
+        }
+
+        Json::Value& node = root[picture.fName.c_str()];
+        node["types"] = types;
+
+        if (fProfileOps) {
+            Json::Value ops(Json::arrayValue);
+            for (int j = 0; j < picture.fOps.count(); j++) {
+                const Stat& op = picture.fOps[j];
+                Json::Value value = stat_to_json(op.fCount, op.fMs);
+                value["id"] = Json::UInt(op.fID);
+                value["type"] = NULL != op.fTypeName ? Json::Value(op.fTypeName) : Json::Value();
+                ops.append(value);
+            }
+            node["ops"] = ops;
+        }
+    }
+
+    const std::string json = Json::StyledWriter().write(root);
+    stream->write(json.c_str(), json.length());
+}
+
+bool PlaybackProfile::writeJSON(const char path[]) const {
+    SkFILEWStream stream(path);
+    if (!stream.isValid()) {
+        return false;
+    }
+    this->writeJSON(&stream);
+    return true;
+}
+
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef PlaybackProfile_DEFINED
+#define PlaybackProfile_DEFINED
+
+#include "SkPicture.h"
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+
+class BenchSysTimer;
+class SkWStream;
+
+namespace sk_tools {
+
+/**
+ * Accumulates the wall time spent in, and the number of calls to, each type of op a picture draws,
+ * and optionally each individual op.  Results are kept separately for each picture (see
+ * beginPicture()), and written out as JSON:
+ *
+ *   { "foo.skp": { "types": { "DRAW_RECT": { "count": 12, "ms": 0.34 }, ... },
+ *                  "ops":   [ { "id": 64, "type": "DRAW_RECT", "count": 1, "ms": 0.03 }, ... ] },
+ *     ... }
+ *
+ * "ops" is only present when profiling individual ops, and lists them in the order of their ids.
+ * A type the picture has no name for is listed as "UNKNOWN_<type>", and its ops' "type" is null.
+ * Install with SkPicture::EXPERIMENTAL_setProfiler() (or PictureRenderer::setProfiler()).
+ * Not thread safe: only one picture may draw into a PlaybackProfile at a time.
+ */
+class PlaybackProfile : public SkPlaybackProfiler {
+public:
+    explicit PlaybackProfile(bool profileOps);
+    virtual ~PlaybackProfile();
+
+    /**
+     * Start accumulating results for a new picture, named name.
+     */
+    void beginPicture(const char* name);
+
+    /**
+     * Write the results for every picture so far to stream, or to a file at path.
+     */
+    void writeJSON(SkWStream* stream) const;
+    bool writeJSON(const char path[]) const;
+
+    virtual void beginOp(uint32_t opID, int type, const char* typeName) SK_OVERRIDE;
+    virtual void endOp() SK_OVERRIDE;
+
+private:
+    struct Stat {
+        uint32_t fID;            // Only used for ops.
+        const char* fTypeName;   // NULL if the picture didn't name the type.
+        int fCount;
+        double fMs;
+    };
+
+    struct Picture {
+        SkString fName;
+        SkTDArray<Stat> fTypes;  // Indexed by type.
+        SkTDArray<Stat> fOps;    // Sorted by fID.
+    };
+
+    static bool IDLess(const Stat& a, const Stat& b) { return a.fID < b.fID; }
+    Stat* findOp(uint32_t opID, const char* typeName);
+
+    const bool fProfileOps;
+    SkTArray<Picture> fPictures;
+    BenchSysTimer* fTimer;
+    Stat* fCurrentType;
+    Stat* fCurrentOp;
+};
+
+}
+
+#endif  // PlaybackProfile_DEFINED
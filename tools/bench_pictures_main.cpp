@@ -10,6 +10,7 @@
 #include "LazyDecodeBitmap.h"
 #include "PictureBenchmark.h"
 #include "PictureRenderingFlags.h"
+#include "PlaybackProfile.h"
 #include "SkBenchLogger.h"
 #include "SkCommandLineFlags.h"
 #include "SkData.h"
@@ -44,7 +45,9 @@ DEFINE_string(jsonLog, "", "Destination for writing JSON data.");
 #endif
 DEFINE_bool(min, false, "Print the minimum times (instead of average).");
 DECLARE_int32(multi);
+DECLARE_bool(profileOps);
 DECLARE_string(readPath);
+DECLARE_string(writeProfilePath);
 DEFINE_int32(repeat, 1, "Set the number of times to repeat each test.");
 DEFINE_bool(timeIndividualTiles, false, "Report times for drawing individual tiles, rather than "
             "times for drawing the whole page. Requires tiled rendering.");
@@ -156,6 +159,9 @@ static int32_t gTotalCacheHits;
 static int32_t gTotalCacheMisses;
 #endif
 
+// Non-NULL with --writeProfilePath.
+static sk_tools::PlaybackProfile* gProfile = NULL;
+
 static bool run_single_benchmark(const SkString& inputPath,
                                  sk_tools::PictureBenchmark& benchmark) {
     SkFILEStream inputStream;
@@ -196,6 +202,10 @@ static bool run_single_benchmark(const SkString& inputPath,
 
     gWriter.bench(filename.c_str(), picture->width(), picture->height());
 
+    if (NULL != gProfile) {
+        // The profile sums over every time the benchmark draws the picture.
+        gProfile->beginPicture(filename.c_str());
+    }
     benchmark.run(picture);
 
 #if SK_LAZY_CACHE_STATS
@@ -362,6 +372,7 @@ static void setup_benchmark(sk_tools::PictureBenchmark* benchmark) {
     } else {
         benchmark->setTimerResultType(TimerData::kAvg_Result);
     }
+    renderer->setProfiler(gProfile);
     benchmark->setRenderer(renderer);
     benchmark->setRepeats(FLAGS_repeat);
     benchmark->setWriter(&gWriter);
@@ -437,6 +448,12 @@ int tool_main(int argc, char** argv) {
 #endif
     SkAutoGraphics ag;
 
+    SkAutoTDelete<sk_tools::PlaybackProfile> profile;
+    if (FLAGS_writeProfilePath.count() == 1) {
+        profile.reset(SkNEW_ARGS(sk_tools::PlaybackProfile, (FLAGS_profileOps)));
+        gProfile = profile.get();
+    }
+
     sk_tools::PictureBenchmark benchmark;
 
     setup_benchmark(&benchmark);
@@ -445,6 +462,11 @@ int tool_main(int argc, char** argv) {
     for (int i = 0; i < FLAGS_readPath.count(); ++i) {
         failures += process_input(FLAGS_readPath[i], benchmark);
     }
+    if (NULL != profile.get() && !profile->writeJSON(FLAGS_writeProfilePath[0])) {
+        SkString err;
+        err.printf("Could not write profile to %s\n", FLAGS_writeProfilePath[0]);
+        gLogger.logError(err);
+    }
 
     if (failures != 0) {
         SkString err;
@@ -6,7 +6,9 @@
  */
 
 #include "BenchTimer.h"
+#include "LazyDecodeBitmap.h"
 #include "SkCommandLineFlags.h"
+#include "SkData.h"
 #include "SkForceLinking.h"
 #include "SkGraphics.h"
 #include "SkOSFile.h"
@@ -22,8 +24,12 @@ DEFINE_string2(skps, r, "skps", "Directory containing SKPs to read and re-record
 DEFINE_int32(loops, 10, "Number of times to play back each SKP.");
 DEFINE_bool(skr, false, "Play via SkRecord instead of SkPicture.");
 DEFINE_int32(tile, 1000000000, "Simulated tile size.");
+DEFINE_bool(threads, false, "With --skr, draw all tiles in parallel, one thread per core.");
 DEFINE_string(match, "", "The usual filters on file names of SKPs to bench.");
 DEFINE_string(timescale, "ms", "Print times in ms, us, or ns");
+DEFINE_bool(mmap, false, "Map SKPs into memory, decode their bitmaps lazily, and play them "
+                         "back as loaded rather than re-recorded.");
+DEFINE_bool(load, false, "Time loading each SKP instead of playing it back.");
 
 static double scale_time(double ms) {
     if (FLAGS_timescale.contains("us")) ms *= 1000;
@@ -31,12 +37,16 @@ static double scale_time(double ms) {
     return ms;
 }
 
-static SkPicture* rerecord_with_tilegrid(SkPicture& src) {
+static SkTileGridFactory::TileGridInfo tile_grid_info() {
     SkTileGridFactory::TileGridInfo info;
     info.fTileInterval.set(FLAGS_tile, FLAGS_tile);
     info.fMargin.setEmpty();
     info.fOffset.setZero();
-    SkTileGridFactory factory(info);
+    return info;
+}
+
+static SkPicture* rerecord_with_tilegrid(SkPicture& src) {
+    SkTileGridFactory factory(tile_grid_info());
 
     SkPictureRecorder recorder;
     src.draw(recorder.beginRecording(src.width(), src.height(), &factory,
@@ -45,13 +55,16 @@ static SkPicture* rerecord_with_tilegrid(SkPicture& src) {
 }
 
 static EXPERIMENTAL::SkPlayback* rerecord_with_skr(SkPicture& src) {
-    EXPERIMENTAL::SkRecording recording(src.width(), src.height());
+    SkTileGridFactory factory(tile_grid_info());
+
+    EXPERIMENTAL::SkRecording recording(src.width(), src.height(), &factory);
     src.draw(recording.canvas());
     return recording.releasePlayback();
 }
 
 static void bench(SkPMColor* scratch, SkPicture& src, const char* name) {
-    SkAutoTUnref<SkPicture> picture(rerecord_with_tilegrid(src));
+    // Re-recording would copy the ops out of the mapped file, so --mmap plays src itself.
+    SkAutoTUnref<SkPicture> picture(FLAGS_mmap ? SkRef(&src) : rerecord_with_tilegrid(src));
     SkAutoTDelete<EXPERIMENTAL::SkPlayback> record(rerecord_with_skr(src));
 
     SkAutoTDelete<SkCanvas> canvas(SkCanvas::NewRasterDirectN32(src.width(),
@@ -60,10 +73,18 @@ static void bench(SkPMColor* scratch, SkPicture& src, const char* name) {
                                                                 src.width() * sizeof(SkPMColor)));
     canvas->clipRect(SkRect::MakeWH(SkIntToScalar(FLAGS_tile), SkIntToScalar(FLAGS_tile)));
 
+    SkBitmap bitmap;
+    bitmap.installPixels(SkImageInfo::MakeN32Premul(src.width(), src.height()),
+                         scratch,
+                         src.width() * sizeof(SkPMColor));
+
+    const bool threaded = FLAGS_skr && FLAGS_threads;
     BenchTimer timer;
     timer.start();
     for (int i = 0; i < FLAGS_loops; i++) {
-        if (FLAGS_skr) {
+        if (threaded) {
+            record->drawTiled(bitmap, FLAGS_tile, FLAGS_tile);
+        } else if (FLAGS_skr) {
             record->draw(canvas.get());
         } else {
             picture->draw(canvas.get());
@@ -71,7 +92,8 @@ static void bench(SkPMColor* scratch, SkPicture& src, const char* name) {
     }
     timer.end();
 
-    const double msPerLoop = timer.fCpu / (double)FLAGS_loops;
+    // Threaded playback is measured in wall time; CPU time would sum across all threads.
+    const double msPerLoop = (threaded ? timer.fWall : timer.fCpu) / (double)FLAGS_loops;
     printf("%f\t%s\n", scale_time(msPerLoop), name);
 }
 
@@ -94,18 +116,36 @@ int tool_main(int argc, char** argv) {
 
         const SkString path = SkOSPath::SkPathJoin(FLAGS_skps[0], filename.c_str());
 
-        SkAutoTUnref<SkStream> stream(SkStream::NewFromFile(path.c_str()));
-        if (!stream) {
-            SkDebugf("Could not read %s.\n", path.c_str());
-            failed = true;
-            continue;
+        BenchTimer timer;
+        timer.start();
+        SkAutoTUnref<SkPicture> src;
+        if (FLAGS_mmap) {
+            SkAutoTUnref<SkData> data(SkData::NewFromFileName(path.c_str()));
+            if (!data) {
+                SkDebugf("Could not map %s.\n", path.c_str());
+                failed = true;
+                continue;
+            }
+            src.reset(SkPicture::CreateFromData(data, &sk_tools::LazyDecodeBitmap));
+        } else {
+            SkAutoTUnref<SkStream> stream(SkStream::NewFromFile(path.c_str()));
+            if (!stream) {
+                SkDebugf("Could not read %s.\n", path.c_str());
+                failed = true;
+                continue;
+            }
+            src.reset(SkPicture::CreateFromStream(stream));
         }
-        SkAutoTUnref<SkPicture> src(SkPicture::CreateFromStream(stream));
+        timer.end();
         if (!src) {
             SkDebugf("Could not read %s as an SkPicture.\n", path.c_str());
             failed = true;
             continue;
         }
+        if (FLAGS_load) {
+            printf("%f\t%s\n", scale_time(timer.fWall), filename.c_str());
+            continue;
+        }
 
         if (src->width() * src->height() > kMaxArea) {
             SkDebugf("%s (%dx%d) is larger than hardcoded scratch bitmap (%dpx).\n",
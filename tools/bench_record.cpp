@@ -62,7 +62,24 @@ static SkBBHFactory* parse_FLAGS_bbh() {
     return NULL;
 }
 
+// SkPicture doesn't say how much memory it uses, so we measure it serialized.  That's its op
+// stream plus its flattened paints, paths, and bitmaps, close to what it keeps in memory.
+static size_t picture_bytes_used(SkPicture* src, SkBBHFactory* bbhFactory) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(src ? src->width()  : FLAGS_nullSize,
+                                               src ? src->height() : FLAGS_nullSize,
+                                               bbhFactory, FLAGS_flags);
+    if (NULL != src) {
+        src->draw(canvas);
+    }
+    SkAutoTUnref<SkPicture> dst(recorder.endRecording());
+    SkDynamicMemoryWStream stream;
+    dst->serialize(&stream);
+    return stream.bytesWritten();
+}
+
 static void bench_record(SkPicture* src, const char* name, SkBBHFactory* bbhFactory) {
+    size_t bytesUsed = 0;
     BenchTimer timer;
     timer.start();
     const int width  = src ? src->width()  : FLAGS_nullSize;
@@ -74,6 +91,7 @@ static void bench_record(SkPicture* src, const char* name, SkBBHFactory* bbhFact
             if (NULL != src) {
                 src->draw(recording.canvas());
             }
+            bytesUsed = recording.approximateBytesUsed();
             // Release and delete the SkPlayback so that recording optimizes its SkRecord.
             SkDELETE(recording.releasePlayback());
         } else {
@@ -89,8 +107,13 @@ static void bench_record(SkPicture* src, const char* name, SkBBHFactory* bbhFact
     }
     timer.end();
 
+    // Also print how many KB the recording takes: for SKR before it's optimized, for SKP serialized.
+    if (!FLAGS_skr) {
+        bytesUsed = picture_bytes_used(src, bbhFactory);
+    }
+
     const double msPerLoop = timer.fCpu / (double)FLAGS_loops;
-    printf("%f\t%s\n", scale_time(msPerLoop), name);
+    printf("%f\t%.1fKB\t%s\n", scale_time(msPerLoop), bytesUsed / 1024.0, name);
 }
 
 int tool_main(int argc, char** argv);
@@ -23,6 +23,7 @@
 #include "image_expectations.h"
 #include "PictureRenderer.h"
 #include "PictureRenderingFlags.h"
+#include "PlaybackProfile.h"
 #include "picture_utils.h"
 
 // Flags used by this file, alphabetically:
@@ -34,7 +35,9 @@ DEFINE_int32(maxComponentDiff, 256, "Maximum diff on a component, 0 - 256. Compo
 DEFINE_string(mismatchPath, "", "Write images for tests that failed due to "
               "pixel mismatches into this directory.");
 DEFINE_string(readJsonSummaryPath, "", "JSON file to read image expectations from.");
+DECLARE_bool(profileOps);
 DECLARE_string(readPath);
+DECLARE_string(writeProfilePath);
 DEFINE_bool(writeChecksumBasedFilenames, false,
             "When writing out images, use checksum-based filenames.");
 DEFINE_bool(writeEncodedImages, false, "Any time the skp contains an encoded image, write it to a "
@@ -52,6 +55,9 @@ DEFINE_bool(bench_record, false, "If true, drop into an infinite loop of recordi
 
 DEFINE_bool(preprocess, false, "If true, perform device specific preprocessing before rendering.");
 
+// Non-NULL with --writeProfilePath.
+static sk_tools::PlaybackProfile* gProfile = NULL;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -269,11 +275,18 @@ static bool render_picture(const SkString& inputPath, const SkString* writePath,
     int diffs[256] = {0};
     SkBitmap* bitmap = NULL;
     renderer.setJsonSummaryPtr(jsonSummaryPtr);
+    if (NULL != gProfile) {
+        SkString name;
+        sk_tools::get_basename(&name, inputPath);
+        gProfile->beginPicture(name.c_str());
+        renderer.setProfiler(gProfile);
+    }
     bool success = render_picture_internal(inputPath,
         FLAGS_writeWholeImage ? NULL : writePath,
         FLAGS_writeWholeImage ? NULL : mismatchPath,
         renderer,
         FLAGS_validate || FLAGS_writeWholeImage ? &bitmap : NULL);
+    renderer.setProfiler(NULL);  // Don't profile the reference renderer used by --validate.
 
     if (!success || ((FLAGS_validate || FLAGS_writeWholeImage) && bitmap == NULL)) {
         SkDebugf("Failed to draw the picture.\n");
@@ -474,11 +487,20 @@ int tool_main(int argc, char** argv) {
         }
     }
 
+    SkAutoTDelete<sk_tools::PlaybackProfile> profile;
+    if (FLAGS_writeProfilePath.count() == 1) {
+        profile.reset(SkNEW_ARGS(sk_tools::PlaybackProfile, (FLAGS_profileOps)));
+        gProfile = profile.get();
+    }
+
     int failures = 0;
     for (int i = 0; i < FLAGS_readPath.count(); i ++) {
         failures += process_input(FLAGS_readPath[i], &writePath, &mismatchPath, *renderer.get(),
                                   jsonSummaryPtr);
     }
+    if (NULL != profile.get() && !profile->writeJSON(FLAGS_writeProfilePath[0])) {
+        SkDebugf("Could not write profile to %s\n", FLAGS_writeProfilePath[0]);
+    }
     if (failures != 0) {
         SkDebugf("Failed to render %i pictures.\n", failures);
         return 1;